@@ -45,28 +45,89 @@ void CommandQueueMT::wait_for_flush() {
 	OS::get_singleton()->delay_usec(1000);
 }
 
-CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
-	int idx = -1;
+void CommandQueueMT::wait_for_commands() {
+	// Announce the consumer is going to sleep, then check again so a push that
+	// missed the flag is not left waiting for the next one.
+	consumer_sleeping.store(true);
+	if (pending_commands.load() > 0) {
+		// A producer may still post for this; the extra wakeup is harmless.
+		consumer_sleeping.store(false);
+		return;
+	}
+	sync->wait();
+}
 
+CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	while (true) {
-		lock();
 		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
-				idx = i;
-				break;
+			bool expected = false;
+			if (!sync_sems[i].in_use.load(std::memory_order_relaxed) && sync_sems[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				return &sync_sems[i];
 			}
 		}
-		unlock();
 
-		if (idx == -1) {
-			wait_for_flush();
-		} else {
-			break;
+		wait_for_flush();
+	}
+}
+
+bool CommandQueueMT::flush_one_lock_free() {
+	// Commands in the ring are always older than spilled ones, so drain it first.
+	if (read_ptr == ring_write.load(std::memory_order_acquire)) {
+		if (spill_commands.load(std::memory_order_acquire) == 0) {
+			return false;
+		}
+
+		spill_mutex.lock();
+		// A ring command published before the spilled ones became visible must still go first.
+		if (read_ptr == ring_write.load(std::memory_order_acquire)) {
+			SpillChunk *chunk = spill_first;
+			while (chunk->read_ptr == chunk->write_ptr) {
+				spill_first = chunk->next;
+				memfree(chunk->mem);
+				memdelete(chunk);
+				chunk = spill_first;
+			}
+
+			uint32_t size = *(uint32_t *)&chunk->mem[chunk->read_ptr];
+			CommandBase *cmd = reinterpret_cast<CommandBase *>(&chunk->mem[chunk->read_ptr + 8]);
+			chunk->read_ptr += size + 8;
+			spill_commands.fetch_sub(1, std::memory_order_relaxed);
+			spill_mutex.unlock();
+
+			cmd->call();
+			cmd->post();
+			cmd->~CommandBase();
+			pending_commands.fetch_sub(1);
+
+			spill_mutex.lock();
+			if (chunk == spill_last && chunk->read_ptr == chunk->write_ptr) {
+				// Reuse the chunk rather than allocating a new one on the next spill.
+				chunk->read_ptr = 0;
+				chunk->write_ptr = 0;
+			}
+			spill_mutex.unlock();
+			return true;
 		}
+		spill_mutex.unlock();
 	}
 
-	return &sync_sems[idx];
+	uint32_t size = *(uint32_t *)&command_mem[read_ptr];
+	if (size == 0) {
+		// End of ringbuffer, wrap.
+		read_ptr = 0;
+		ring_read.store(0, std::memory_order_release);
+		size = *(uint32_t *)&command_mem[0];
+	}
+
+	CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr + 8]);
+	cmd->call();
+	cmd->post();
+	cmd->~CommandBase();
+
+	read_ptr += size + 8;
+	ring_read.store(read_ptr, std::memory_order_release);
+	pending_commands.fetch_sub(1);
+	return true;
 }
 
 bool CommandQueueMT::dealloc_one() {
@@ -93,15 +154,24 @@ tryagain:
 	return true;
 }
 
-CommandQueueMT::CommandQueueMT(bool p_sync) {
+CommandQueueMT::CommandQueueMT(bool p_sync, bool p_lock_free) {
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
+	// Only the creating thread writes to the ring, other threads go through the spill chunks.
+	lock_free = p_lock_free;
+	producer_thread = Thread::get_caller_id();
 }
 
 CommandQueueMT::~CommandQueueMT() {
 	if (sync) {
 		memdelete(sync);
 	}
+	while (spill_first) {
+		SpillChunk *next = spill_first->next;
+		memfree(spill_first->mem);
+		memdelete(spill_first);
+		spill_first = next;
+	}
 	memfree(command_mem);
 }
@@ -34,9 +34,12 @@
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -252,9 +255,7 @@
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		commit_and_unlock(cmd);                                              \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -269,9 +270,7 @@
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
+		commit_and_unlock(cmd);                                                                \
 		ss->sem.wait();                                                                        \
 		ss->in_use = false;                                                                    \
 	}
@@ -287,9 +286,7 @@
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
+		commit_and_unlock(cmd);                                                       \
 		ss->sem.wait();                                                               \
 		ss->in_use = false;                                                           \
 	}
@@ -299,7 +296,7 @@
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
-		bool in_use = false;
+		std::atomic<bool> in_use = { false };
 	};
 
 	struct CommandBase {
@@ -332,9 +329,20 @@ class CommandQueueMT {
 	enum {
 		COMMAND_MEM_SIZE_KB = 256,
 		COMMAND_MEM_SIZE = COMMAND_MEM_SIZE_KB * 1024,
+		SPILL_CHUNK_SIZE_KB = 64,
+		SPILL_CHUNK_SIZE = SPILL_CHUNK_SIZE_KB * 1024,
 		SYNC_SEMAPHORES = 8
 	};
 
+	// Overflow storage for the lock-free mode, used instead of blocking when the ring is full.
+	struct SpillChunk {
+		SpillChunk *next = nullptr;
+		uint8_t *mem = nullptr;
+		uint32_t size = 0;
+		uint32_t read_ptr = 0;
+		uint32_t write_ptr = 0;
+	};
+
 	uint8_t *command_mem = (uint8_t *)memalloc(COMMAND_MEM_SIZE);
 	uint32_t read_ptr = 0;
 	uint32_t write_ptr = 0;
@@ -343,6 +351,77 @@ class CommandQueueMT {
 	Mutex mutex;
 	Semaphore *sync = nullptr;
 
+	// Lock-free mode: the producer thread writes to the ring without locking and
+	// publishes through ring_write, the consumer frees space through ring_read.
+	// Pushes from other threads, and from the producer while the ring is full or
+	// spilled commands are pending, go to the spill chunks under spill_mutex.
+	bool lock_free = false;
+	Thread::ID producer_thread = 0;
+	std::atomic<uint32_t> ring_read = { 0 };
+	std::atomic<uint32_t> ring_write = { 0 };
+	SpillChunk *spill_first = nullptr;
+	SpillChunk *spill_last = nullptr;
+	std::atomic<uint32_t> spill_commands = { 0 };
+	Mutex spill_mutex;
+	std::atomic<bool> consumer_sleeping = { false };
+
+	std::atomic<uint32_t> pending_commands = { 0 };
+	std::atomic<uint64_t> stall_count = { 0 };
+
+	template <class T>
+	T *allocate_ring() {
+		// Same layout as the locking mode, minus the 'in use' bit: the consumer
+		// only moves ring_read past a command once it is done with it.
+		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1)) + 8;
+		uint32_t read = ring_read.load(std::memory_order_acquire);
+
+		if (write_ptr >= read) {
+			// Keep room at the end for the wrap marker.
+			if ((COMMAND_MEM_SIZE - write_ptr) < alloc_size + 8) {
+				if (read <= alloc_size) {
+					// Wrapping would catch up with the consumer.
+					return nullptr;
+				}
+				// Zero means, wrap to beginning. It is published with the next command.
+				*(uint32_t *)&command_mem[write_ptr] = 0;
+				write_ptr = 0;
+			}
+		}
+		if (write_ptr < read && (read - write_ptr) <= alloc_size) {
+			return nullptr;
+		}
+
+		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		*(uint32_t *)&command_mem[write_ptr] = size;
+		T *cmd = memnew_placement(&command_mem[write_ptr + 8], T);
+		write_ptr += size + 8;
+		return cmd;
+	}
+
+	template <class T>
+	T *allocate_spill() {
+		// Must be called with spill_mutex locked.
+		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		uint32_t alloc_size = size + 8;
+
+		if (!spill_last || (spill_last->size - spill_last->write_ptr) < alloc_size) {
+			SpillChunk *chunk = memnew(SpillChunk);
+			chunk->size = MAX((uint32_t)SPILL_CHUNK_SIZE, alloc_size);
+			chunk->mem = (uint8_t *)memalloc(chunk->size);
+			if (spill_last) {
+				spill_last->next = chunk;
+			} else {
+				spill_first = chunk;
+			}
+			spill_last = chunk;
+		}
+
+		*(uint32_t *)&spill_last->mem[spill_last->write_ptr] = size;
+		T *cmd = memnew_placement(&spill_last->mem[spill_last->write_ptr + 8], T);
+		spill_last->write_ptr += alloc_size;
+		return cmd;
+	}
+
 	template <class T>
 	T *allocate() {
 		// alloc size is size+T+safeguard
@@ -399,19 +478,63 @@ class CommandQueueMT {
 
 	template <class T>
 	T *allocate_and_lock() {
+		if (lock_free) {
+			// Spilled commands must run first, so keep spilling until the consumer catches up.
+			if (spill_commands.load(std::memory_order_acquire) == 0 && Thread::get_caller_id() == producer_thread) {
+				T *ret = allocate_ring<T>();
+				if (ret) {
+					return ret;
+				}
+				stall_count.fetch_add(1, std::memory_order_relaxed);
+			}
+			spill_mutex.lock();
+			return allocate_spill<T>();
+		}
+
 		lock();
-		T *ret;
+		T *ret = allocate<T>();
 
-		while ((ret = allocate<T>()) == nullptr) {
-			unlock();
-			// sleep a little until fetch happened and some room is made
-			wait_for_flush();
-			lock();
+		if (!ret) {
+			stall_count.fetch_add(1, std::memory_order_relaxed);
+			do {
+				unlock();
+				// sleep a little until fetch happened and some room is made
+				wait_for_flush();
+				lock();
+			} while ((ret = allocate<T>()) == nullptr);
 		}
 
 		return ret;
 	}
 
+	void commit_and_unlock(CommandBase *p_cmd) {
+		if (!lock_free) {
+			pending_commands.fetch_add(1, std::memory_order_relaxed);
+			unlock();
+			if (sync) {
+				sync->post();
+			}
+			return;
+		}
+
+		// Counted before the command is published, the consumer may run it and
+		// decrement the count right away.
+		pending_commands.fetch_add(1);
+
+		if ((uint8_t *)p_cmd >= command_mem && (uint8_t *)p_cmd < command_mem + COMMAND_MEM_SIZE) {
+			ring_write.store(write_ptr, std::memory_order_release);
+		} else {
+			spill_commands.fetch_add(1, std::memory_order_release);
+			spill_mutex.unlock();
+		}
+
+		// Pairs with wait_for_commands(): only post when the consumer went to sleep,
+		// so a burst of pushes costs a single wakeup.
+		if (sync && consumer_sleeping.load() && consumer_sleeping.exchange(false)) {
+			sync->post();
+		}
+	}
+
 	bool flush_one(bool p_lock = true) {
 		if (p_lock) {
 			lock();
@@ -452,6 +575,7 @@ class CommandQueueMT {
 		cmd->post();
 		cmd->~CommandBase();
 		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+		pending_commands.fetch_sub(1, std::memory_order_relaxed);
 
 		if (p_lock) {
 			unlock();
@@ -459,9 +583,12 @@ class CommandQueueMT {
 		return true;
 	}
 
+	bool flush_one_lock_free();
+
 	void lock();
 	void unlock();
 	void wait_for_flush();
+	void wait_for_commands();
 	SyncSemaphore *_alloc_sync_sem();
 	bool dealloc_one();
 
@@ -480,19 +607,37 @@ public:
 
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
+		if (lock_free) {
+			if (!flush_one_lock_free()) {
+				wait_for_commands();
+				flush_one_lock_free();
+			}
+			return;
+		}
 		sync->wait();
 		flush_one();
 	}
 
 	void flush_all() {
 		//ERR_FAIL_COND(sync);
+		if (lock_free) {
+			while (flush_one_lock_free()) {
+			}
+			return;
+		}
 		lock();
 		while (flush_one(false)) {
 		}
 		unlock();
 	}
 
-	CommandQueueMT(bool p_sync);
+	bool is_lock_free() const { return lock_free; }
+	// Commands pushed but not yet executed.
+	uint32_t get_pending_commands() const { return pending_commands.load(std::memory_order_relaxed); }
+	// Pushes that found the ring full: blocked in the locking mode, spilled in the lock-free mode.
+	uint64_t get_stall_count() const { return stall_count.load(std::memory_order_relaxed); }
+
+	CommandQueueMT(bool p_sync, bool p_lock_free = false);
 	~CommandQueueMT();
 };
 
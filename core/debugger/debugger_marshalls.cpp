@@ -126,11 +126,12 @@ Array DebuggerMarshalls::ServersProfilerFrame::serialize() {
 	for (int i = 0; i < servers.size(); i++) {
 		ServerInfo &s = servers[i];
 		arr.push_back(s.name);
-		arr.push_back(s.functions.size() * 2);
+		arr.push_back(s.functions.size() * 3);
 		for (int j = 0; j < s.functions.size(); j++) {
 			ServerFunctionInfo &f = s.functions[j];
 			arr.push_back(f.name);
 			arr.push_back(f.time);
+			arr.push_back(f.calls);
 		}
 	}
 
@@ -162,11 +163,12 @@ bool DebuggerMarshalls::ServersProfilerFrame::deserialize(const Array &p_arr) {
 		int sub_data_size = p_arr[idx + 1];
 		idx += 2;
 		CHECK_SIZE(p_arr, idx + sub_data_size, "ServersProfilerFrame");
-		for (int j = 0; j < sub_data_size / 2; j++) {
+		for (int j = 0; j < sub_data_size / 3; j++) {
 			ServerFunctionInfo sf;
 			sf.name = p_arr[idx];
 			sf.time = p_arr[idx + 1];
-			idx += 2;
+			sf.calls = p_arr[idx + 2];
+			idx += 3;
 			si.functions.push_back(sf);
 		}
 		servers.push_back(si);
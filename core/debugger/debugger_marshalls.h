@@ -91,6 +91,7 @@ struct DebuggerMarshalls {
 	struct ServerFunctionInfo {
 		StringName name;
 		float time = 0;
+		int calls = 1;
 	};
 
 	struct ServerInfo {
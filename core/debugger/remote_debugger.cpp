@@ -290,6 +290,11 @@ struct RemoteDebugger::ServersProfiler {
 			_send_frame_data(true); // Send final frame.
 		}
 		scripts_profiler.toggle(p_enable, p_opts);
+		if (p_enable) {
+			Object::signal_profiling_start();
+		} else {
+			Object::signal_profiling_stop();
+		}
 	}
 
 	void add(const Array &p_data) {
@@ -330,6 +335,22 @@ struct RemoteDebugger::ServersProfiler {
 			E->get().functions.clear();
 			E = E->next();
 		}
+		if (!p_final) {
+			List<Object::SignalProfilingInfo> signals;
+			Object::signal_profiling_get_frame_data(&signals);
+			if (signals.size()) {
+				ServerInfo signal_info;
+				signal_info.name = "signals";
+				for (List<Object::SignalProfilingInfo>::Element *S = signals.front(); S; S = S->next()) {
+					ServerFunctionInfo fi;
+					fi.name = S->get().signal;
+					fi.time = USEC_TO_SEC(S->get().total_time);
+					fi.calls = S->get().emit_count;
+					signal_info.functions.push_back(fi);
+				}
+				frame.servers.push_back(signal_info);
+			}
+		}
 		uint64_t time = 0;
 		scripts_profiler.write_frame_data(frame.script_functions, time, p_final);
 		frame.script_time = USEC_TO_SEC(time);
@@ -34,12 +34,18 @@
 #include "core/hash_map.h"
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
+#include "core/job_system.h"
 #include "core/math/math_funcs.h"
 #include "core/os/copymem.h"
 #include "core/print_string.h"
 
 #include <stdio.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SSE2_ENABLED
+#include <emmintrin.h>
+#endif
+
 const char *Image::format_names[Image::FORMAT_MAX] = {
 	"Lum8", //luminance
 	"LumAlpha8", //luminance-alpha
@@ -463,15 +469,66 @@ int Image::get_mipmap_count() const {
 	}
 }
 
+// Large images are split in bands of rows that run on the worker threads.
+// Every row is computed exactly like in a single threaded run, so results do
+// not depend on the amount of threads.
+#define IMAGE_PARALLEL_MIN_PIXELS (256 * 256)
+
+typedef void (*ImageRowsFunc)(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row);
+
+struct _ImageRowBands {
+	ImageRowsFunc function = nullptr;
+	void *userdata = nullptr;
+	uint32_t rows = 0;
+	uint32_t rows_per_band = 1;
+
+	void process_band(uint32_t p_band, void *p_unused) {
+		uint32_t from = p_band * rows_per_band;
+		function(userdata, from, MIN(from + rows_per_band, rows));
+	}
+};
+
+static void _process_image_rows(uint32_t p_rows, uint32_t p_row_pixels, ImageRowsFunc p_function, void *p_userdata) {
+	JobSystem *job_system = JobSystem::get_singleton();
+	uint32_t threads = job_system ? job_system->get_thread_count() : 0;
+
+	if (threads == 0 || p_rows < 2 || uint64_t(p_rows) * p_row_pixels < IMAGE_PARALLEL_MIN_PIXELS) {
+		p_function(p_userdata, 0, p_rows);
+		return;
+	}
+
+	// A few bands per thread, so uneven rows (like lanczos borders) balance out.
+	uint32_t band_count = MIN(p_rows, (threads + 1) * 4);
+
+	_ImageRowBands bands;
+	bands.function = p_function;
+	bands.userdata = p_userdata;
+	bands.rows = p_rows;
+	bands.rows_per_band = (p_rows + band_count - 1) / band_count;
+	band_count = (p_rows + bands.rows_per_band - 1) / bands.rows_per_band;
+
+	job_system->parallel_for(band_count, &bands, &_ImageRowBands::process_band, (void *)nullptr);
+}
+
+struct _ConvertParams {
+	int width;
+	const uint8_t *src;
+	uint8_t *dst;
+};
+
 //using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
-static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+static void _convert_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _ConvertParams &params = *(const _ConvertParams *)p_userdata;
+	const int width = params.width;
+	const uint8_t *__restrict src = params.src;
+	uint8_t *__restrict dst = params.dst;
 	uint32_t max_bytes = MAX(read_bytes, write_bytes);
 
-	for (int y = 0; y < p_height; y++) {
-		for (int x = 0; x < p_width; x++) {
-			const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
-			uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
+	for (int y = p_from_row; y < (int)p_to_row; y++) {
+		for (int x = 0; x < width; x++) {
+			const uint8_t *rofs = &src[((y * width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
+			uint8_t *wofs = &dst[((y * width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
 
 			uint8_t rgba[4];
 
@@ -505,6 +562,31 @@ static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p
 	}
 }
 
+template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
+static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+	_ConvertParams params = { p_width, p_src, p_dst };
+	_process_image_rows(p_height, p_width, _convert_rows<read_bytes, read_alpha, write_bytes, write_alpha, read_gray, write_gray>, &params);
+}
+
+struct _ConvertColorsParams {
+	const Image *src_image;
+	Image *dst_image;
+	int width;
+	const uint8_t *src;
+	uint8_t *dst;
+};
+
+static void _convert_colors_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _ConvertColorsParams &params = *(const _ConvertColorsParams *)p_userdata;
+
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
+		uint32_t ofs = y * params.width;
+		for (int x = 0; x < params.width; x++) {
+			params.dst_image->_set_color_at_ofs(params.dst, ofs + x, params.src_image->_get_color_at_ofs(params.src, ofs + x));
+		}
+	}
+}
+
 void Image::convert(Format p_new_format) {
 	if (data.size() == 0) {
 		return;
@@ -518,14 +600,17 @@ void Image::convert(Format p_new_format) {
 		ERR_FAIL_MSG("Cannot convert to <-> from compressed formats. Use compress() and decompress() instead.");
 
 	} else if (format > FORMAT_RGBA8 || p_new_format > FORMAT_RGBA8) {
-		//use put/set pixel which is slower but works with non byte formats
+		//go through Color which is slower but works with non byte formats
 		Image new_img(width, height, false, p_new_format);
 
-		for (int i = 0; i < width; i++) {
-			for (int j = 0; j < height; j++) {
-				new_img.set_pixel(i, j, get_pixel(i, j));
-			}
-		}
+		_ConvertColorsParams params;
+		params.src_image = this;
+		params.dst_image = &new_img;
+		params.width = width;
+		params.src = data.ptr();
+		params.dst = new_img.data.ptrw();
+
+		_process_image_rows(height, width, _convert_colors_rows, &params);
 
 		if (has_mipmaps()) {
 			new_img.generate_mipmaps();
@@ -663,13 +748,28 @@ static double _bicubic_interp_kernel(double x) {
 	return bc;
 }
 
+struct _ScaleParams {
+	const uint8_t *src;
+	uint8_t *dst;
+	uint32_t src_width;
+	uint32_t src_height;
+	uint32_t dst_width;
+	uint32_t dst_height;
+};
+
 template <int CC, class T>
-static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _ScaleParams &params = *(const _ScaleParams *)p_userdata;
+	const uint8_t *__restrict p_src = params.src;
+	uint8_t *__restrict p_dst = params.dst;
+	uint32_t p_src_width = params.src_width;
+	uint32_t p_dst_width = params.dst_width;
+
 	// get source image size
-	int width = p_src_width;
-	int height = p_src_height;
-	double xfac = (double)width / p_dst_width;
-	double yfac = (double)height / p_dst_height;
+	int width = params.src_width;
+	int height = params.src_height;
+	double xfac = (double)width / params.dst_width;
+	double yfac = (double)height / params.dst_height;
 	// coordinates of source points and coefficients
 	double ox, oy, dx, dy, k1, k2;
 	int ox1, oy1, ox2, oy2;
@@ -679,7 +779,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int xmax = width - 1;
 	// temporary pointer
 
-	for (uint32_t y = 0; y < p_dst_height; y++) {
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
 		// Y coordinates
 		oy = (double)y * yfac - 0.5f;
 		oy1 = (int)oy;
@@ -751,15 +851,100 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 }
 
 template <int CC, class T>
-static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	_ScaleParams params = { p_src, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height };
+	_process_image_rows(p_dst_height, p_dst_width, _scale_cubic_rows<CC, T>, &params);
+}
+
+enum {
+	BILINEAR_FRAC_BITS = 8,
+	BILINEAR_FRAC_LEN = (1 << BILINEAR_FRAC_BITS),
+	BILINEAR_FRAC_HALF = (BILINEAR_FRAC_LEN >> 1),
+	BILINEAR_FRAC_MASK = BILINEAR_FRAC_LEN - 1
+};
+
+struct _ScaleBilinearParams : public _ScaleParams {
+	// Source offsets (already multiplied by the component count) and
+	// fractions of each destination column, the same for all rows.
+	const uint32_t *xofs_left;
+	const uint32_t *xofs_right;
+	const uint32_t *xofs_frac;
+};
+
+#ifdef IMAGE_SSE2_ENABLED
+// One RGBA pixel per iteration, one component per lane. The results are the
+// same as the scalar loop's, bit for bit.
+
+static void _scale_bilinear_row_rgba8(const uint8_t *__restrict p_up, const uint8_t *__restrict p_down, uint8_t *__restrict p_dst, const uint32_t *__restrict p_xofs_left, const uint32_t *__restrict p_xofs_right, const uint32_t *__restrict p_xofs_frac, uint32_t p_yofs_frac, uint32_t p_width) {
+	const __m128i zero = _mm_setzero_si128();
+	// up * (1 - y) + down * y, with integers below 2^24 so floats are exact.
+	const __m128 weight_up = _mm_set1_ps(float(BILINEAR_FRAC_LEN - p_yofs_frac));
+	const __m128 weight_down = _mm_set1_ps(float(p_yofs_frac));
+
+	for (uint32_t j = 0; j < p_width; j++) {
+		uint32_t frac = p_xofs_frac[j];
+		// Pairs of 16 bit weights, left * (1 - x) + right * x in a single multiply-add.
+		const __m128i weight_x = _mm_set1_epi32(int32_t((frac << 16) | (BILINEAR_FRAC_LEN - frac)));
+
+		int32_t up_left, up_right, down_left, down_right;
+		copymem(&up_left, p_up + p_xofs_left[j], 4);
+		copymem(&up_right, p_up + p_xofs_right[j], 4);
+		copymem(&down_left, p_down + p_xofs_left[j], 4);
+		copymem(&down_right, p_down + p_xofs_right[j], 4);
+
+		__m128i up = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(up_left), _mm_cvtsi32_si128(up_right)), zero);
+		__m128i down = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128(down_left), _mm_cvtsi32_si128(down_right)), zero);
+		__m128 interp_up = _mm_cvtepi32_ps(_mm_madd_epi16(up, weight_x));
+		__m128 interp_down = _mm_cvtepi32_ps(_mm_madd_epi16(down, weight_x));
+
+		__m128 interp = _mm_add_ps(_mm_mul_ps(interp_up, weight_up), _mm_mul_ps(interp_down, weight_down));
+		__m128i result = _mm_srli_epi32(_mm_cvtps_epi32(interp), BILINEAR_FRAC_BITS * 2);
+		result = _mm_packus_epi16(_mm_packs_epi32(result, zero), zero);
+
+		int32_t pixel = _mm_cvtsi128_si32(result);
+		copymem(p_dst + j * 4, &pixel, 4);
+	}
+}
+
+static void _scale_bilinear_row_rgbaf(const float *__restrict p_up, const float *__restrict p_down, float *__restrict p_dst, const uint32_t *__restrict p_xofs_left, const uint32_t *__restrict p_xofs_right, const uint32_t *__restrict p_xofs_frac, uint32_t p_yofs_frac, uint32_t p_width) {
+	const __m128 yofs_frac = _mm_set1_ps(float(p_yofs_frac) / (1 << BILINEAR_FRAC_BITS));
+
+	for (uint32_t j = 0; j < p_width; j++) {
+		const __m128 xofs_frac = _mm_set1_ps(float(p_xofs_frac[j]) / (1 << BILINEAR_FRAC_BITS));
+
+		__m128 p00 = _mm_loadu_ps(p_up + p_xofs_left[j]);
+		__m128 p10 = _mm_loadu_ps(p_up + p_xofs_right[j]);
+		__m128 p01 = _mm_loadu_ps(p_down + p_xofs_left[j]);
+		__m128 p11 = _mm_loadu_ps(p_down + p_xofs_right[j]);
+
+		__m128 interp_up = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p10, p00), xofs_frac));
+		__m128 interp_down = _mm_add_ps(p01, _mm_mul_ps(_mm_sub_ps(p11, p01), xofs_frac));
+		_mm_storeu_ps(p_dst + j * 4, _mm_add_ps(interp_up, _mm_mul_ps(_mm_sub_ps(interp_down, interp_up), yofs_frac)));
+	}
+}
+#endif // IMAGE_SSE2_ENABLED
+
+template <int CC, class T>
+static void _scale_bilinear_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
 	enum {
-		FRAC_BITS = 8,
-		FRAC_LEN = (1 << FRAC_BITS),
-		FRAC_HALF = (FRAC_LEN >> 1),
-		FRAC_MASK = FRAC_LEN - 1
+		FRAC_BITS = BILINEAR_FRAC_BITS,
+		FRAC_LEN = BILINEAR_FRAC_LEN,
+		FRAC_HALF = BILINEAR_FRAC_HALF,
+		FRAC_MASK = BILINEAR_FRAC_MASK
 	};
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	const _ScaleBilinearParams &params = *(const _ScaleBilinearParams *)p_userdata;
+	const uint8_t *__restrict p_src = params.src;
+	uint8_t *__restrict p_dst = params.dst;
+	uint32_t p_src_width = params.src_width;
+	uint32_t p_src_height = params.src_height;
+	uint32_t p_dst_width = params.dst_width;
+	uint32_t p_dst_height = params.dst_height;
+	const uint32_t *__restrict xofs_left = params.xofs_left;
+	const uint32_t *__restrict xofs_right = params.xofs_right;
+	const uint32_t *__restrict xofs_frac = params.xofs_frac;
+
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		// Add 0.5 in order to interpolate based on pixel center
 		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
 		// Calculate nearest src pixel center above current, and truncate to get y index
@@ -775,18 +960,21 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 		uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
 		uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
 
-		for (uint32_t j = 0; j < p_dst_width; j++) {
-			uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
-			uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
-			uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
-			if (src_xofs_right >= p_src_width) {
-				src_xofs_right = p_src_width - 1;
-			}
-			uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
-			src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
+#ifdef IMAGE_SSE2_ENABLED
+		if (CC == 4 && sizeof(T) == 1) {
+			_scale_bilinear_row_rgba8(p_src + y_ofs_up, p_src + y_ofs_down, p_dst + i * p_dst_width * CC, xofs_left, xofs_right, xofs_frac, src_yofs_frac, p_dst_width);
+			continue;
+		} else if (CC == 4 && sizeof(T) == 4) {
+			const float *src = (const float *)p_src;
+			_scale_bilinear_row_rgbaf(src + y_ofs_up, src + y_ofs_down, (float *)p_dst + i * p_dst_width * CC, xofs_left, xofs_right, xofs_frac, src_yofs_frac, p_dst_width);
+			continue;
+		}
+#endif
 
-			src_xofs_left *= CC;
-			src_xofs_right *= CC;
+		for (uint32_t j = 0; j < p_dst_width; j++) {
+			uint32_t src_xofs_left = xofs_left[j];
+			uint32_t src_xofs_right = xofs_right[j];
+			uint32_t src_xofs_frac = xofs_frac[j];
 
 			for (uint32_t l = 0; l < CC; l++) {
 				if (sizeof(T) == 1) { //uint8
@@ -841,8 +1029,58 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 }
 
 template <int CC, class T>
-static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	enum {
+		FRAC_BITS = BILINEAR_FRAC_BITS,
+		FRAC_LEN = BILINEAR_FRAC_LEN,
+		FRAC_HALF = BILINEAR_FRAC_HALF,
+		FRAC_MASK = BILINEAR_FRAC_MASK
+	};
+
+	uint32_t *xofs = memnew_arr(uint32_t, p_dst_width * 3);
+
+	for (uint32_t j = 0; j < p_dst_width; j++) {
+		uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
+		uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
+		uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
+		if (src_xofs_right >= p_src_width) {
+			src_xofs_right = p_src_width - 1;
+		}
+		uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
+		src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
+
+		xofs[j] = src_xofs_left * CC;
+		xofs[p_dst_width + j] = src_xofs_right * CC;
+		xofs[p_dst_width * 2 + j] = src_xofs_frac;
+	}
+
+	_ScaleBilinearParams params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.src_width = p_src_width;
+	params.src_height = p_src_height;
+	params.dst_width = p_dst_width;
+	params.dst_height = p_dst_height;
+	params.xofs_left = xofs;
+	params.xofs_right = xofs + p_dst_width;
+	params.xofs_frac = xofs + p_dst_width * 2;
+
+	_process_image_rows(p_dst_height, p_dst_width, _scale_bilinear_rows<CC, T>, &params);
+
+	memdelete_arr(xofs);
+}
+
+template <int CC, class T>
+static void _scale_nearest_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _ScaleParams &params = *(const _ScaleParams *)p_userdata;
+	const T *__restrict src = (const T *)params.src;
+	T *__restrict dst = (T *)params.dst;
+	uint32_t p_src_width = params.src_width;
+	uint32_t p_src_height = params.src_height;
+	uint32_t p_dst_width = params.dst_width;
+	uint32_t p_dst_height = params.dst_height;
+
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		uint32_t src_yofs = i * p_src_height / p_dst_height;
 		uint32_t y_ofs = src_yofs * p_src_width * CC;
 
@@ -851,9 +1089,6 @@ static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict
 			src_xofs *= CC;
 
 			for (uint32_t l = 0; l < CC; l++) {
-				const T *src = ((const T *)p_src);
-				T *dst = ((T *)p_dst);
-
 				T p = src[y_ofs + src_xofs + l];
 				dst[i * p_dst_width * CC + j * CC + l] = p;
 			}
@@ -861,135 +1096,216 @@ static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict
 	}
 }
 
+template <int CC, class T>
+static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	_ScaleParams params = { p_src, p_dst, p_src_width, p_src_height, p_dst_width, p_dst_height };
+	_process_image_rows(p_dst_height, p_dst_width, _scale_nearest_rows<CC, T>, &params);
+}
+
 #define LANCZOS_TYPE 3
 
 static float _lanczos(float p_x) {
 	return Math::abs(p_x) >= LANCZOS_TYPE ? 0 : Math::sincn(p_x) * Math::sincn(p_x / LANCZOS_TYPE);
 }
 
+struct _ScaleLanczosParams : public _ScaleParams {
+	float *buffer; // Result of the first pass, src_height rows of dst_width pixels.
+
+	// First pass kernels, one per buffer column.
+	const int32_t *column_start;
+	const int32_t *column_end;
+	const float *column_kernels;
+	int32_t column_kernel_size;
+
+	float y_scale;
+	float y_scale_factor;
+	int32_t y_half_kernel;
+};
+
 template <int CC, class T>
-static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	int32_t src_width = p_src_width;
-	int32_t src_height = p_src_height;
-	int32_t dst_height = p_dst_height;
-	int32_t dst_width = p_dst_width;
+static void _scale_lanczos_first_pass_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	// FIRST PASS (horizontal)
+	const _ScaleLanczosParams &params = *(const _ScaleLanczosParams *)p_userdata;
+	int32_t src_width = params.src_width;
+	int32_t dst_width = params.dst_width;
 
-	uint32_t buffer_size = src_height * dst_width * CC;
-	float *buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
+	for (int32_t buffer_y = p_from_row; buffer_y < (int32_t)p_to_row; buffer_y++) {
+		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
+			int32_t start_x = params.column_start[buffer_x];
+			int32_t end_x = params.column_end[buffer_x];
+			const float *kernel = params.column_kernels + buffer_x * params.column_kernel_size;
 
-	{ // FIRST PASS (horizontal)
+			float pixel[CC] = { 0 };
+			float weight = 0;
 
-		float x_scale = float(src_width) / float(dst_width);
+			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
+				float lanczos_val = kernel[target_x - start_x];
+				weight += lanczos_val;
 
-		float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+				const T *__restrict src_data = ((const T *)params.src) + (buffer_y * src_width + target_x) * CC;
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+				for (uint32_t i = 0; i < CC; i++) {
+					if (sizeof(T) == 2) { //half float
+						pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
+					} else {
+						pixel[i] += src_data[i] * lanczos_val;
+					}
+				}
+			}
 
-		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
-			// The corresponding point on the source image
-			float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
-			int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
-			int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
+			float *dst_data = params.buffer + (buffer_y * dst_width + buffer_x) * CC;
 
-			// Create the kernel used by all the pixels of the column
-			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-				kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
+			for (uint32_t i = 0; i < CC; i++) {
+				dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
 			}
+		}
+	}
+}
 
-			for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+template <int CC, class T>
+static void _scale_lanczos_second_pass_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	// SECOND PASS (vertical + result)
+	const _ScaleLanczosParams &params = *(const _ScaleLanczosParams *)p_userdata;
+	int32_t src_height = params.src_height;
+	int32_t dst_width = params.dst_width;
+	const float *buffer = params.buffer;
 
-				for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-					float lanczos_val = kernel[target_x - start_x];
-					weight += lanczos_val;
+	float *kernel = memnew_arr(float, params.y_half_kernel * 2);
 
-					const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
+	for (int32_t dst_y = p_from_row; dst_y < (int32_t)p_to_row; dst_y++) {
+		float buffer_y = (dst_y + 0.5f) * params.y_scale;
+		int32_t start_y = MAX(0, int32_t(buffer_y) - params.y_half_kernel + 1);
+		int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + params.y_half_kernel);
 
-					for (uint32_t i = 0; i < CC; i++) {
-						if (sizeof(T) == 2) { //half float
-							pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
-						} else {
-							pixel[i] += src_data[i] * lanczos_val;
-						}
-					}
-				}
+		for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+			kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / params.y_scale_factor);
+		}
+
+		for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
+			float pixel[CC] = { 0 };
+			float weight = 0;
+
+			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+				float lanczos_val = kernel[target_y - start_y];
+				weight += lanczos_val;
 
-				float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
+				const float *buffer_data = buffer + (target_y * dst_width + dst_x) * CC;
 
 				for (uint32_t i = 0; i < CC; i++) {
-					dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
+					pixel[i] += buffer_data[i] * lanczos_val;
 				}
 			}
-		}
 
-		memdelete_arr(kernel);
-	} // End of first pass
+			T *dst_data = ((T *)params.dst) + (dst_y * dst_width + dst_x) * CC;
 
-	{ // SECOND PASS (vertical + result)
+			for (uint32_t i = 0; i < CC; i++) {
+				pixel[i] /= weight;
 
-		float y_scale = float(src_height) / float(dst_height);
+				if (sizeof(T) == 1) { //byte
+					dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
+				} else if (sizeof(T) == 2) { //half float
+					dst_data[i] = Math::make_half_float(pixel[i]);
+				} else { // float
+					dst_data[i] = pixel[i];
+				}
+			}
+		}
+	}
 
-		float scale_factor = MAX(y_scale, 1);
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+	memdelete_arr(kernel);
+}
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+template <int CC, class T>
+static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	int32_t src_width = p_src_width;
+	int32_t src_height = p_src_height;
+	int32_t dst_height = p_dst_height;
+	int32_t dst_width = p_dst_width;
 
-		for (int32_t dst_y = 0; dst_y < dst_height; dst_y++) {
-			float buffer_y = (dst_y + 0.5f) * y_scale;
-			int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
-			int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
+	_ScaleLanczosParams params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.src_width = p_src_width;
+	params.src_height = p_src_height;
+	params.dst_width = p_dst_width;
+	params.dst_height = p_dst_height;
 
-			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-				kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
-			}
+	uint32_t buffer_size = src_height * dst_width * CC;
+	params.buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
 
-			for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+	// The kernels of the first pass only depend on the column, build them
+	// once so the pass can go row by row.
+	float x_scale = float(src_width) / float(dst_width);
 
-				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-					float lanczos_val = kernel[target_y - start_y];
-					weight += lanczos_val;
+	float x_scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
+	int32_t x_half_kernel = LANCZOS_TYPE * x_scale_factor;
 
-					float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
+	int32_t *column_bounds = memnew_arr(int32_t, dst_width * 2);
+	float *column_kernels = memnew_arr(float, dst_width * x_half_kernel * 2);
 
-					for (uint32_t i = 0; i < CC; i++) {
-						pixel[i] += buffer_data[i] * lanczos_val;
-					}
-				}
+	for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
+		// The corresponding point on the source image
+		float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
+		int32_t start_x = MAX(0, int32_t(src_x) - x_half_kernel + 1);
+		int32_t end_x = MIN(src_width - 1, int32_t(src_x) + x_half_kernel);
 
-				T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
+		column_bounds[buffer_x] = start_x;
+		column_bounds[dst_width + buffer_x] = end_x;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					pixel[i] /= weight;
-
-					if (sizeof(T) == 1) { //byte
-						dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
-					} else if (sizeof(T) == 2) { //half float
-						dst_data[i] = Math::make_half_float(pixel[i]);
-					} else { // float
-						dst_data[i] = pixel[i];
-					}
-				}
-			}
+		// Create the kernel used by all the pixels of the column
+		float *kernel = column_kernels + buffer_x * x_half_kernel * 2;
+		for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
+			kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / x_scale_factor);
 		}
+	}
+
+	params.column_start = column_bounds;
+	params.column_end = column_bounds + dst_width;
+	params.column_kernels = column_kernels;
+	params.column_kernel_size = x_half_kernel * 2;
 
-		memdelete_arr(kernel);
-	} // End of second pass
+	_process_image_rows(src_height, dst_width, _scale_lanczos_first_pass_rows<CC, T>, &params);
 
-	memdelete_arr(buffer);
+	memdelete_arr(column_kernels);
+	memdelete_arr(column_bounds);
+
+	params.y_scale = float(src_height) / float(dst_height);
+	params.y_scale_factor = MAX(params.y_scale, 1);
+	params.y_half_kernel = LANCZOS_TYPE * params.y_scale_factor;
+
+	_process_image_rows(dst_height, dst_width, _scale_lanczos_second_pass_rows<CC, T>, &params);
+
+	memdelete_arr(params.buffer);
 }
 
-static void _overlay(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, float p_alpha, uint32_t p_width, uint32_t p_height, uint32_t p_pixel_size) {
-	uint16_t alpha = MIN((uint16_t)(p_alpha * 256.0f), 256);
+struct _OverlayParams {
+	const uint8_t *src;
+	uint8_t *dst;
+	uint16_t alpha;
+	uint32_t row_size;
+};
+
+static void _overlay_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _OverlayParams &params = *(const _OverlayParams *)p_userdata;
+	const uint8_t *__restrict src = params.src;
+	uint8_t *__restrict dst = params.dst;
+	uint16_t alpha = params.alpha;
 
-	for (uint32_t i = 0; i < p_width * p_height * p_pixel_size; i++) {
-		p_dst[i] = (p_dst[i] * (256 - alpha) + p_src[i] * alpha) >> 8;
+	for (uint32_t i = p_from_row * params.row_size; i < p_to_row * params.row_size; i++) {
+		dst[i] = (dst[i] * (256 - alpha) + src[i] * alpha) >> 8;
 	}
 }
 
+static void _overlay(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, float p_alpha, uint32_t p_width, uint32_t p_height, uint32_t p_pixel_size) {
+	_OverlayParams params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.alpha = MIN((uint16_t)(p_alpha * 256.0f), 256);
+	params.row_size = p_width * p_pixel_size;
+
+	_process_image_rows(p_height, p_width, _overlay_rows, &params);
+}
+
 bool Image::is_size_po2() const {
 	return uint32_t(width) == next_power_of_2(width) && uint32_t(height) == next_power_of_2(height);
 }
@@ -1487,21 +1803,80 @@ bool Image::_can_modify(Format p_format) const {
 	return p_format <= FORMAT_RGBE9995;
 }
 
+struct _MipmapParams {
+	const void *src;
+	void *dst;
+	uint32_t width;
+	uint32_t height;
+};
+
+#ifdef IMAGE_SSE2_ENABLED
+// Four destination pixels per iteration, rounded as in Image::average_4_uint8().
+static uint32_t _average_2x2_row_rgba8(const uint8_t *__restrict p_up, const uint8_t *__restrict p_down, uint8_t *__restrict p_dst, uint32_t p_width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+
+	uint32_t x = 0;
+	for (; x + 4 <= p_width; x += 4) {
+		__m128 up_a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p_up + x * 8)));
+		__m128 up_b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p_up + x * 8 + 16)));
+		__m128 down_a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p_down + x * 8)));
+		__m128 down_b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p_down + x * 8 + 16)));
+
+		// Left and right pixels of each block.
+		__m128i up_left = _mm_castps_si128(_mm_shuffle_ps(up_a, up_b, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i up_right = _mm_castps_si128(_mm_shuffle_ps(up_a, up_b, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m128i down_left = _mm_castps_si128(_mm_shuffle_ps(down_a, down_b, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i down_right = _mm_castps_si128(_mm_shuffle_ps(down_a, down_b, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128i sum_lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(up_left, zero), _mm_unpacklo_epi8(up_right, zero)), _mm_add_epi16(_mm_unpacklo_epi8(down_left, zero), _mm_unpacklo_epi8(down_right, zero)));
+		__m128i sum_hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(up_left, zero), _mm_unpackhi_epi8(up_right, zero)), _mm_add_epi16(_mm_unpackhi_epi8(down_left, zero), _mm_unpackhi_epi8(down_right, zero)));
+		sum_lo = _mm_srli_epi16(_mm_add_epi16(sum_lo, two), 2);
+		sum_hi = _mm_srli_epi16(_mm_add_epi16(sum_hi, two), 2);
+
+		_mm_storeu_si128((__m128i *)(p_dst + x * 4), _mm_packus_epi16(sum_lo, sum_hi));
+	}
+	return x;
+}
+#endif // IMAGE_SSE2_ENABLED
+
 template <class Component, int CC, bool renormalize,
 		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
 		void (*renormalize_func)(Component *)>
-static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
-	//fast power of 2 mipmap generation
+static void _generate_po2_mipmap_rows(void *p_userdata, uint32_t p_from_row, uint32_t p_to_row) {
+	const _MipmapParams &params = *(const _MipmapParams *)p_userdata;
+	const Component *__restrict p_src = (const Component *)params.src;
+	Component *__restrict p_dst = (Component *)params.dst;
+	uint32_t p_width = params.width;
+	uint32_t p_height = params.height;
+
 	uint32_t dst_w = MAX(p_width >> 1, 1);
-	uint32_t dst_h = MAX(p_height >> 1, 1);
 
 	int right_step = (p_width == 1) ? 0 : CC;
 	int down_step = (p_height == 1) ? 0 : (p_width * CC);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		const Component *rup_ptr = &p_src[i * 2 * down_step];
 		const Component *rdown_ptr = rup_ptr + down_step;
 		Component *dst_ptr = &p_dst[i * dst_w * CC];
+
+		if (!renormalize && right_step == CC) {
+			uint32_t from_x = 0;
+#ifdef IMAGE_SSE2_ENABLED
+			// 8 bit components are only averaged with average_4_uint8().
+			if (CC == 4 && sizeof(Component) == 1) {
+				from_x = _average_2x2_row_rgba8((const uint8_t *)rup_ptr, (const uint8_t *)rdown_ptr, (uint8_t *)dst_ptr, dst_w);
+			}
+#endif
+			// Common case with constant strides, also the pixels left over by the SIMD path.
+			for (uint32_t x = from_x; x < dst_w; x++) {
+				for (int j = 0; j < CC; j++) {
+					average_func(dst_ptr[x * CC + j], rup_ptr[x * CC * 2 + j], rup_ptr[x * CC * 2 + CC + j], rdown_ptr[x * CC * 2 + j], rdown_ptr[x * CC * 2 + CC + j]);
+				}
+			}
+			continue;
+		}
+
 		uint32_t count = dst_w;
 
 		while (count) {
@@ -1521,6 +1896,18 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 	}
 }
 
+template <class Component, int CC, bool renormalize,
+		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
+		void (*renormalize_func)(Component *)>
+static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
+	//fast power of 2 mipmap generation
+	_MipmapParams params = { p_src, p_dst, p_width, p_height };
+	uint32_t dst_w = MAX(p_width >> 1, 1);
+	uint32_t dst_h = MAX(p_height >> 1, 1);
+
+	_process_image_rows(dst_h, dst_w, _generate_po2_mipmap_rows<Component, CC, renormalize, average_func, renormalize_func>, &params);
+}
+
 void Image::shrink_x2() {
 	ERR_FAIL_COND(data.size() == 0);
 
@@ -81,16 +81,16 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
+	read_ptr = buffer.ptr();
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
-	read_pos = 0;
+	JobSystem *job_system = JobSystem::get_singleton();
+	read_ahead = read_ahead_enabled && job_system && job_system->get_thread_count() > 0 && bc > 2;
+
+	read_block = -1;
+	_load_block(0);
 
 	return OK;
 }
@@ -154,17 +154,27 @@ void FileAccessCompressed::close() {
 			f->store_32(0); //compressed sizes, will update later
 		}
 
-		Vector<int> block_sizes;
+		// Blocks are independent, compress them all in parallel before writing them in order.
+		LocalVector<WriteBlock> blocks;
+		blocks.resize(bc);
 		for (int i = 0; i < bc; i++) {
-			int bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
+			blocks[i].size = i == (bc - 1) ? write_max % block_size : block_size;
+			blocks[i].src = &write_ptr[i * block_size];
+		}
 
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+		JobSystem *job_system = JobSystem::get_singleton();
+		if (job_system && bc > 1) {
+			job_system->parallel_for(bc, this, &FileAccessCompressed::_compress_block, blocks.ptr());
+		} else {
+			for (int i = 0; i < bc; i++) {
+				_compress_block(i, blocks.ptr());
+			}
+		}
 
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
+		Vector<int> block_sizes;
+		for (int i = 0; i < bc; i++) {
+			f->store_buffer(blocks[i].compressed.ptr(), blocks[i].compressed_size);
+			block_sizes.push_back(blocks[i].compressed_size);
 		}
 
 		f->seek(16); //ok write block sizes
@@ -177,6 +187,14 @@ void FileAccessCompressed::close() {
 		buffer.clear();
 
 	} else {
+		for (int i = 0; i < READ_AHEAD_SLOTS; i++) {
+			_wait_slot(read_slots[i]);
+			read_slots[i].block = -1;
+			read_slots[i].data.clear();
+			read_slots[i].comp.clear();
+			read_slots[i].comp_ptr = nullptr;
+		}
+		read_ahead = false;
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -199,22 +217,15 @@ void FileAccessCompressed::seek(size_t p_position) {
 
 	} else {
 		ERR_FAIL_COND(p_position > read_total);
-		if (p_position == read_total) {
-			at_end = true;
-		} else {
-			at_end = false;
-			read_eof = false;
-			int block_idx = p_position / block_size;
-			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			}
-
-			read_pos = p_position % block_size;
+		// The end is in the last block, which is empty if the size is a multiple of the block size.
+		at_end = p_position == read_total;
+		read_eof = false;
+		int block_idx = p_position / block_size;
+		if (block_idx != read_block) {
+			_load_block(block_idx);
 		}
+
+		read_pos = p_position % block_size;
 	}
 }
 
@@ -267,17 +278,10 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-			read_pos = 0;
-
+		if (read_block + 1 < read_block_count) {
+			_load_block(read_block + 1);
+			at_end = read_block_size == 0;
 		} else {
-			read_block--;
 			at_end = true;
 		}
 	}
@@ -294,26 +298,23 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 		return 0;
 	}
 
-	for (int i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
-
-			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
-				read_pos = 0;
+	int total = 0;
+	while (total < p_length) {
+		int to_copy = MIN(p_length - total, read_block_size - read_pos);
+		memcpy(p_dst + total, read_ptr + read_pos, to_copy);
+		total += to_copy;
+		read_pos += to_copy;
 
+		if (read_pos >= read_block_size) {
+			if (read_block + 1 < read_block_count) {
+				_load_block(read_block + 1);
+				at_end = read_block_size == 0;
 			} else {
-				read_block--;
 				at_end = true;
-				if (i < p_length - 1) {
+				if (total < p_length) {
 					read_eof = true;
 				}
-				return i;
+				return total;
 			}
 		}
 	}
@@ -321,6 +322,90 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 	return p_length;
 }
 
+void FileAccessCompressed::_load_block(int p_block) const {
+	bool sequential = p_block == read_block + 1;
+
+	read_block = p_block;
+	read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+	read_pos = 0;
+
+	if (!read_ahead) {
+		f->seek(read_blocks[read_block].offset);
+		f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
+		Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
+		read_ptr = buffer.ptr();
+		return;
+	}
+
+	ReadSlot &slot = read_slots[p_block % READ_AHEAD_SLOTS];
+	if (slot.block != p_block) {
+		_wait_slot(slot);
+		_fetch_slot(slot, p_block);
+		_decompress_slot(&slot);
+	} else {
+		_wait_slot(slot);
+	}
+	read_ptr = slot.data.ptr();
+
+	// Random access only decompresses what it needs, so seeking around stays cheap.
+	if (!sequential) {
+		return;
+	}
+
+	for (int i = 1; i < READ_AHEAD_SLOTS; i++) {
+		int next_block = p_block + i;
+		if (next_block >= read_block_count) {
+			break;
+		}
+
+		ReadSlot &next = read_slots[next_block % READ_AHEAD_SLOTS];
+		if (next.block == next_block) {
+			continue;
+		}
+		_wait_slot(next);
+		_fetch_slot(next, next_block);
+		next.job = JobSystem::get_singleton()->add_job(this, &FileAccessCompressed::_decompress_slot, &next);
+	}
+}
+
+// Compressed data is read on the calling thread, only decompression runs on workers.
+void FileAccessCompressed::_fetch_slot(ReadSlot &r_slot, int p_block) const {
+	const ReadBlock &rb = read_blocks[p_block];
+
+	r_slot.block = p_block;
+	r_slot.comp_size = rb.csize;
+	if (r_slot.data.size() != int(block_size)) {
+		r_slot.data.resize(block_size);
+	}
+
+	f->seek(rb.offset);
+	r_slot.comp_ptr = f->get_mapped_buffer(rb.csize);
+	if (!r_slot.comp_ptr) {
+		if (r_slot.comp.size() < rb.csize) {
+			r_slot.comp.resize(rb.csize);
+		}
+		f->get_buffer(r_slot.comp.ptrw(), rb.csize);
+		r_slot.comp_ptr = r_slot.comp.ptr();
+	}
+}
+
+void FileAccessCompressed::_decompress_slot(ReadSlot *p_slot) const {
+	Compression::decompress(p_slot->data.ptrw(), read_blocks.size() == 1 ? read_total : block_size, p_slot->comp_ptr, p_slot->comp_size, cmode);
+}
+
+void FileAccessCompressed::_wait_slot(ReadSlot &r_slot) const {
+	if (r_slot.job.is_valid()) {
+		JobSystem::get_singleton()->wait(r_slot.job);
+		r_slot.job = JobSystem::Handle();
+	}
+}
+
+void FileAccessCompressed::_compress_block(uint32_t p_index, WriteBlock *p_blocks) {
+	WriteBlock &block = p_blocks[p_index];
+	block.compressed.resize(Compression::get_max_compressed_buffer_size(block.size, cmode));
+	block.compressed_size = Compression::compress(block.compressed.ptrw(), block.src, block.size, cmode);
+}
+
 Error FileAccessCompressed::get_error() const {
 	return read_eof ? ERR_FILE_EOF : OK;
 }
@@ -32,6 +32,8 @@
 #define FILE_ACCESS_COMPRESSED_H
 
 #include "core/io/compression.h"
+#include "core/job_system.h"
+#include "core/local_vector.h"
 #include "core/os/file_access.h"
 
 class FileAccessCompressed : public FileAccess {
@@ -51,7 +53,7 @@ class FileAccessCompressed : public FileAccess {
 	};
 
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable const uint8_t *read_ptr = nullptr;
 	mutable int read_block = 0;
 	int read_block_count = 0;
 	mutable int read_block_size = 0;
@@ -59,12 +61,46 @@ class FileAccessCompressed : public FileAccess {
 	Vector<ReadBlock> read_blocks;
 	uint32_t read_total = 0;
 
+	enum {
+		READ_AHEAD_SLOTS = 4,
+	};
+
+	// With read-ahead, sequential reads decompress the next blocks on worker
+	// threads into a small ring of slots, block N living in slot N % READ_AHEAD_SLOTS.
+	struct ReadSlot {
+		int block = -1;
+		Vector<uint8_t> data;
+		Vector<uint8_t> comp; // Only used when the compressed block is not mapped.
+		const uint8_t *comp_ptr = nullptr;
+		int comp_size = 0;
+		JobSystem::Handle job;
+	};
+
+	bool read_ahead_enabled = true;
+	mutable bool read_ahead = false;
+	mutable ReadSlot read_slots[READ_AHEAD_SLOTS];
+
+	struct WriteBlock {
+		const uint8_t *src = nullptr;
+		int size = 0;
+		Vector<uint8_t> compressed;
+		int compressed_size = 0;
+	};
+
 	String magic = "GCMP";
 	mutable Vector<uint8_t> buffer;
 	FileAccess *f = nullptr;
 
+	void _load_block(int p_block) const;
+	void _fetch_slot(ReadSlot &r_slot, int p_block) const;
+	void _decompress_slot(ReadSlot *p_slot) const;
+	void _wait_slot(ReadSlot &r_slot) const;
+	void _compress_block(uint32_t p_index, WriteBlock *p_blocks);
+
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 4096);
+	// Decompress upcoming blocks on worker threads while reading sequentially, enabled by default. Set before opening.
+	void set_read_ahead(bool p_enable) { read_ahead_enabled = p_enable; }
 
 	Error open_after_magic(FileAccess *p_base);
 
@@ -30,6 +30,7 @@
 
 #include "file_access_pack.h"
 
+#include "core/hash_map.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/script_language.h"
 #include "core/version.h"
@@ -37,6 +38,7 @@
 #include <stdio.h>
 
 Error PackedData::add_pack(const String &p_path, bool p_replace_files, size_t p_offset) {
+	layer_count++;
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
 			return OK;
@@ -61,6 +63,8 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.layer = layer_count;
+	pf.replace = p_replace_files;
 
 	if (!exists || p_replace_files) {
 		files[pmd5] = pf;
@@ -95,6 +99,106 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	}
 }
 
+void PackedData::add_index(PackIndex *p_index, bool p_replace_files) {
+	p_index->layer = layer_count;
+	p_index->replace = p_replace_files;
+	indexes.push_back(p_index);
+}
+
+// Resolves a path across the legacy table and the directory indexes the same
+// way add_path() would have: the last pack replacing files wins, otherwise
+// the first pack providing the path.
+bool PackedData::_find_file(const PathMD5 &p_md5, PackedFile &r_file) const {
+	const Map<PathMD5, PackedFile>::Element *E = files.find(p_md5);
+	const PackIndex *best_index = nullptr;
+	int best_entry = -1;
+	bool found = E != nullptr;
+	uint32_t best_layer = E ? E->get().layer : 0;
+	bool best_replace = E ? E->get().replace : false;
+
+	for (int i = 0; i < indexes.size(); i++) {
+		const PackIndex *index = indexes[i];
+		int entry = index->find_entry(p_md5.a, p_md5.b);
+		if (entry < 0) {
+			continue;
+		}
+
+		bool take;
+		if (!found) {
+			take = true;
+		} else if (index->replace) {
+			take = !best_replace || index->layer > best_layer;
+		} else {
+			take = !best_replace && index->layer < best_layer;
+		}
+
+		if (take) {
+			found = true;
+			best_index = index;
+			best_entry = entry;
+			best_layer = index->layer;
+			best_replace = index->replace;
+		}
+	}
+
+	if (best_index) {
+		best_index->get_entry(best_entry, r_file);
+	} else if (E) {
+		r_file = E->get();
+	}
+	return found;
+}
+
+FileAccess *PackedData::_try_open_indexed_path(const String &p_path, const PathMD5 &p_md5) {
+	PackedFile pf;
+	if (!_find_file(p_md5, pf)) {
+		return nullptr; //not found
+	}
+	if (pf.offset == 0) {
+		return nullptr; //was erased
+	}
+
+	return pf.src->get_file(p_path, &pf);
+}
+
+bool PackedData::_has_indexed_path(const PathMD5 &p_md5) const {
+	for (int i = 0; i < indexes.size(); i++) {
+		if (indexes[i]->find_entry(p_md5.a, p_md5.b) >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+PackedData::PackedDir *PackedData::_find_packed_dir(const String &p_dir) const {
+	PackedDir *pd = root;
+	if (p_dir.empty()) {
+		return pd;
+	}
+
+	Vector<String> ds = p_dir.split("/");
+	for (int i = 0; i < ds.size(); i++) {
+		Map<String, PackedDir *>::Element *E = pd->subdirs.find(ds[i]);
+		if (!E) {
+			return nullptr;
+		}
+		pd = E->get();
+	}
+	return pd;
+}
+
+bool PackedData::_has_dir(const String &p_dir) const {
+	if (_find_packed_dir(p_dir)) {
+		return true;
+	}
+	for (int i = 0; i < indexes.size(); i++) {
+		if (indexes[i]->find_dir(p_dir) >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 	if (p_source != nullptr) {
 		sources.push_back(p_source);
@@ -118,10 +222,374 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 }
 
 PackedData::~PackedData() {
+	for (int i = 0; i < indexes.size(); i++) {
+		memdelete(indexes[i]);
+	}
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
 	_free_packed_dirs(root);
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////
+
+// Index layout, all values little endian:
+//
+// Header: entry count, dir count, child count, file ref count, string size, reserved (uint32 each).
+// Entries, sorted by path MD5: hash a, hash b, offset, size (uint64), md5[16], flags, path offset, path length, reserved (uint32).
+// Dirs, sorted by path relative to "res://": path offset, path length, first child, child count, first file ref, file ref count (uint32).
+// Children: dir indices, sorted by name within each dir (uint32).
+// File refs: entry indices, sorted by name within each dir (uint32).
+// Strings: UTF-8 paths, not null terminated.
+
+static int _compare_utf8(const char *p_a, uint32_t p_a_len, const char *p_b, uint32_t p_b_len) {
+	int cmp = memcmp(p_a, p_b, MIN(p_a_len, p_b_len));
+	if (cmp != 0) {
+		return cmp;
+	}
+	return p_a_len < p_b_len ? -1 : (p_a_len > p_b_len ? 1 : 0);
+}
+
+static uint32_t _last_slash(const char *p_str, uint32_t p_len) {
+	for (uint32_t i = p_len; i > 0; i--) {
+		if (p_str[i - 1] == '/') {
+			return i;
+		}
+	}
+	return 0;
+}
+
+uint64_t PackedData::PackIndex::get_size(const uint8_t *p_header) {
+	uint64_t size = uint64_t(decode_uint32(p_header + 0)) * ENTRY_SIZE;
+	size += uint64_t(decode_uint32(p_header + 4)) * DIR_SIZE;
+	size += uint64_t(decode_uint32(p_header + 8)) * 4;
+	size += uint64_t(decode_uint32(p_header + 12)) * 4;
+	size += decode_uint32(p_header + 16);
+	return size;
+}
+
+bool PackedData::PackIndex::set_data(const uint8_t *p_header, const uint8_t *p_data) {
+	entry_count = decode_uint32(p_header + 0);
+	dir_count = decode_uint32(p_header + 4);
+	child_count = decode_uint32(p_header + 8);
+	file_ref_count = decode_uint32(p_header + 12);
+	string_size = decode_uint32(p_header + 16);
+
+	entries = p_data;
+	dirs = entries + uint64_t(entry_count) * ENTRY_SIZE;
+	children = dirs + uint64_t(dir_count) * DIR_SIZE;
+	file_refs = children + uint64_t(child_count) * 4;
+	strings = (const char *)(file_refs + uint64_t(file_ref_count) * 4);
+
+	// Only check what lookups rely on, the index is otherwise trusted like the file table.
+	for (uint32_t i = 0; i < entry_count; i++) {
+		const uint8_t *e = entries + i * ENTRY_SIZE;
+		ERR_FAIL_COND_V(uint64_t(decode_uint32(e + 52)) + decode_uint32(e + 56) > string_size, false);
+	}
+	for (uint32_t i = 0; i < dir_count; i++) {
+		const uint8_t *d = dirs + i * DIR_SIZE;
+		ERR_FAIL_COND_V(uint64_t(decode_uint32(d + 0)) + decode_uint32(d + 4) > string_size, false);
+		ERR_FAIL_COND_V(uint64_t(decode_uint32(d + 8)) + decode_uint32(d + 12) > child_count, false);
+		ERR_FAIL_COND_V(uint64_t(decode_uint32(d + 16)) + decode_uint32(d + 20) > file_ref_count, false);
+	}
+	for (uint32_t i = 0; i < child_count; i++) {
+		ERR_FAIL_COND_V(decode_uint32(children + i * 4) >= dir_count, false);
+	}
+	for (uint32_t i = 0; i < file_ref_count; i++) {
+		ERR_FAIL_COND_V(decode_uint32(file_refs + i * 4) >= entry_count, false);
+	}
+	return true;
+}
+
+int PackedData::PackIndex::find_entry(uint64_t p_a, uint64_t p_b) const {
+	int low = 0;
+	int high = int(entry_count) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		const uint8_t *e = entries + middle * ENTRY_SIZE;
+		uint64_t a = decode_uint64(e);
+		uint64_t b = decode_uint64(e + 8);
+		if (a == p_a && b == p_b) {
+			return middle;
+		} else if (a < p_a || (a == p_a && b < p_b)) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return -1;
+}
+
+void PackedData::PackIndex::get_entry(int p_entry, PackedFile &r_file) const {
+	const uint8_t *e = entries + p_entry * ENTRY_SIZE;
+	r_file.pack = pack;
+	r_file.offset = base + decode_uint64(e + 16);
+	r_file.size = decode_uint64(e + 24);
+	memcpy(r_file.md5, e + 32, 16);
+	r_file.src = src;
+	r_file.encrypted = decode_uint32(e + 48) & PACK_FILE_ENCRYPTED;
+	r_file.layer = layer;
+	r_file.replace = replace;
+}
+
+String PackedData::PackIndex::get_entry_name(int p_entry) const {
+	const uint8_t *e = entries + p_entry * ENTRY_SIZE;
+	const char *path = strings + decode_uint32(e + 52);
+	uint32_t len = decode_uint32(e + 56);
+	uint32_t from = _last_slash(path, len);
+
+	String name;
+	name.parse_utf8(path + from, len - from);
+	return name;
+}
+
+int PackedData::PackIndex::find_dir(const String &p_dir) const {
+	CharString dir = p_dir.utf8();
+	int low = 0;
+	int high = int(dir_count) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		const uint8_t *d = dirs + middle * DIR_SIZE;
+		int cmp = _compare_utf8(strings + decode_uint32(d), decode_uint32(d + 4), dir.get_data(), dir.length());
+		if (cmp == 0) {
+			return middle;
+		} else if (cmp < 0) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return -1;
+}
+
+String PackedData::PackIndex::get_dir_child(int p_dir, uint32_t p_child) const {
+	const uint8_t *d = dirs + p_dir * DIR_SIZE;
+	const uint8_t *c = dirs + decode_uint32(children + (decode_uint32(d + 8) + p_child) * 4) * DIR_SIZE;
+	const char *path = strings + decode_uint32(c);
+	uint32_t len = decode_uint32(c + 4);
+	uint32_t from = _last_slash(path, len);
+
+	String name;
+	name.parse_utf8(path + from, len - from);
+	return name;
+}
+
+String PackedData::PackIndex::get_dir_file(int p_dir, uint32_t p_file) const {
+	const uint8_t *d = dirs + p_dir * DIR_SIZE;
+	return get_entry_name(decode_uint32(file_refs + (decode_uint32(d + 16) + p_file) * 4));
+}
+
+bool PackedData::PackIndex::has_dir_child(int p_dir, const String &p_name) const {
+	const uint8_t *d = dirs + p_dir * DIR_SIZE;
+	const uint8_t *first = children + decode_uint32(d + 8) * 4;
+	CharString name = p_name.utf8();
+	int low = 0;
+	int high = int(decode_uint32(d + 12)) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		const uint8_t *c = dirs + decode_uint32(first + middle * 4) * DIR_SIZE;
+		const char *path = strings + decode_uint32(c);
+		uint32_t len = decode_uint32(c + 4);
+		uint32_t from = _last_slash(path, len);
+		int cmp = _compare_utf8(path + from, len - from, name.get_data(), name.length());
+		if (cmp == 0) {
+			return true;
+		} else if (cmp < 0) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return false;
+}
+
+bool PackedData::PackIndex::has_dir_file(int p_dir, const String &p_name) const {
+	const uint8_t *d = dirs + p_dir * DIR_SIZE;
+	const uint8_t *first = file_refs + decode_uint32(d + 16) * 4;
+	CharString name = p_name.utf8();
+	int low = 0;
+	int high = int(decode_uint32(d + 20)) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		const uint8_t *e = entries + decode_uint32(first + middle * 4) * ENTRY_SIZE;
+		const char *path = strings + decode_uint32(e + 52);
+		uint32_t len = decode_uint32(e + 56);
+		uint32_t from = _last_slash(path, len);
+		int cmp = _compare_utf8(path + from, len - from, name.get_data(), name.length());
+		if (cmp == 0) {
+			return true;
+		} else if (cmp < 0) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return false;
+}
+
+struct _PackIndexEntry {
+	uint64_t a;
+	uint64_t b;
+	int file;
+
+	bool operator<(const _PackIndexEntry &p_entry) const {
+		return a == p_entry.a ? b < p_entry.b : a < p_entry.a;
+	}
+};
+
+struct _PackIndexName {
+	CharString name;
+	uint32_t index;
+
+	bool operator<(const _PackIndexName &p_name) const {
+		return _compare_utf8(name.get_data(), name.length(), p_name.name.get_data(), p_name.name.length()) < 0;
+	}
+};
+
+struct _PackIndexDir {
+	CharString path;
+	Vector<uint32_t> children;
+	Vector<_PackIndexName> files;
+
+	bool operator<(const _PackIndexDir &p_dir) const {
+		return _compare_utf8(path.get_data(), path.length(), p_dir.path.get_data(), p_dir.path.length()) < 0;
+	}
+};
+
+void PackedData::store_index(FileAccess *p_file, const Vector<IndexedFile> &p_files) {
+	Vector<_PackIndexEntry> entries;
+	entries.resize(p_files.size());
+	for (int i = 0; i < p_files.size(); i++) {
+		String path;
+		path.parse_utf8(p_files[i].path.get_data());
+		PathMD5 pmd5(path.md5_buffer());
+		entries.write[i].a = pmd5.a;
+		entries.write[i].b = pmd5.b;
+		entries.write[i].file = i;
+	}
+	entries.sort();
+
+	// Collect every directory, including the parents of the ones holding files.
+	Set<String> dir_set;
+	dir_set.insert(String());
+	for (int i = 0; i < p_files.size(); i++) {
+		String path;
+		path.parse_utf8(p_files[i].path.get_data());
+		String dir = path.replace_first("res://", "").get_base_dir();
+		while (!dir.empty() && !dir_set.has(dir)) {
+			dir_set.insert(dir);
+			dir = dir.get_base_dir();
+		}
+	}
+
+	Vector<_PackIndexDir> dirs;
+	for (Set<String>::Element *E = dir_set.front(); E; E = E->next()) {
+		_PackIndexDir dir;
+		dir.path = E->get().utf8();
+		dirs.push_back(dir);
+	}
+	dirs.sort();
+
+	HashMap<String, uint32_t> dir_map;
+	for (int i = 0; i < dirs.size(); i++) {
+		String path;
+		path.parse_utf8(dirs[i].path.get_data(), dirs[i].path.length());
+		dir_map[path] = i;
+	}
+	// Dirs are sorted by full path, so children end up sorted by name.
+	for (int i = 0; i < dirs.size(); i++) {
+		if (dirs[i].path.length() == 0) {
+			continue;
+		}
+		String path;
+		path.parse_utf8(dirs[i].path.get_data(), dirs[i].path.length());
+		dirs.write[dir_map[path.get_base_dir()]].children.push_back(i);
+	}
+
+	for (int i = 0; i < entries.size(); i++) {
+		const CharString &cs = p_files[entries[i].file].path;
+		uint32_t from = _last_slash(cs.get_data(), cs.length());
+		if (from == uint32_t(cs.length())) {
+			continue; // Points to a directory.
+		}
+		String path;
+		path.parse_utf8(cs.get_data());
+		_PackIndexName name;
+		name.name = path.get_file().utf8();
+		name.index = i;
+		dirs.write[dir_map[path.replace_first("res://", "").get_base_dir()]].files.push_back(name);
+	}
+
+	uint32_t child_count = 0;
+	uint32_t file_ref_count = 0;
+	uint32_t string_size = 0;
+	for (int i = 0; i < dirs.size(); i++) {
+		dirs.write[i].files.sort();
+		child_count += dirs[i].children.size();
+		file_ref_count += dirs[i].files.size();
+		string_size += dirs[i].path.length();
+	}
+	for (int i = 0; i < p_files.size(); i++) {
+		string_size += p_files[i].path.length();
+	}
+
+	p_file->store_32(entries.size());
+	p_file->store_32(dirs.size());
+	p_file->store_32(child_count);
+	p_file->store_32(file_ref_count);
+	p_file->store_32(string_size);
+	p_file->store_32(0); // reserved
+
+	uint32_t string_ofs = 0;
+	for (int i = 0; i < entries.size(); i++) {
+		const IndexedFile &file = p_files[entries[i].file];
+		p_file->store_64(entries[i].a);
+		p_file->store_64(entries[i].b);
+		p_file->store_64(file.offset);
+		p_file->store_64(file.size);
+		p_file->store_buffer(file.md5, 16);
+		p_file->store_32(file.flags);
+		p_file->store_32(string_ofs);
+		p_file->store_32(file.path.length());
+		p_file->store_32(0); // reserved
+		string_ofs += file.path.length();
+	}
+
+	uint32_t first_child = 0;
+	uint32_t first_file = 0;
+	for (int i = 0; i < dirs.size(); i++) {
+		p_file->store_32(string_ofs);
+		p_file->store_32(dirs[i].path.length());
+		p_file->store_32(first_child);
+		p_file->store_32(dirs[i].children.size());
+		p_file->store_32(first_file);
+		p_file->store_32(dirs[i].files.size());
+		string_ofs += dirs[i].path.length();
+		first_child += dirs[i].children.size();
+		first_file += dirs[i].files.size();
+	}
+
+	for (int i = 0; i < dirs.size(); i++) {
+		for (int j = 0; j < dirs[i].children.size(); j++) {
+			p_file->store_32(dirs[i].children[j]);
+		}
+	}
+	for (int i = 0; i < dirs.size(); i++) {
+		for (int j = 0; j < dirs[i].files.size(); j++) {
+			p_file->store_32(dirs[i].files[j].index);
+		}
+	}
+
+	for (int i = 0; i < entries.size(); i++) {
+		const CharString &path = p_files[entries[i].file].path;
+		p_file->store_buffer((const uint8_t *)path.get_data(), path.length());
+	}
+	for (int i = 0; i < dirs.size(); i++) {
+		p_file->store_buffer((const uint8_t *)dirs[i].path.get_data(), dirs[i].path.length());
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -184,14 +652,25 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	uint32_t pack_flags = f->get_32();
 	uint64_t file_base = f->get_64();
+	uint64_t index_ofs = f->get_64();
 
 	bool enc_directory = (pack_flags & PACK_DIR_ENCRYPTED);
 
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < 14; i++) {
 		//reserved
 		f->get_32();
 	}
 
+	if ((pack_flags & PACK_DIR_INDEX) && !enc_directory && index_ofs != 0) {
+		// The file table is still there for older versions, only fall back to it if the index can't be used.
+		if (_load_index(p_path, p_replace_files, index_ofs + p_offset, file_base + p_offset)) {
+			f->close();
+			memdelete(f);
+			return true;
+		}
+		WARN_PRINT("Can't use the directory index of pack '" + p_path + "', reading its file table instead.");
+	}
+
 	int file_count = f->get_32();
 
 	if (enc_directory) {
@@ -239,6 +718,57 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	f->close();
 	memdelete(f);
+
+	FileAccess *pack = FileAccess::open(p_path, FileAccess::READ);
+	if (pack) {
+		open_packs.push_back(pack);
+	}
+
+	return true;
+}
+
+bool PackedSourcePCK::_load_index(const String &p_path, bool p_replace_files, uint64_t p_index_ofs, uint64_t p_file_base) {
+	FileAccess *pack = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!pack, false);
+
+	pack->seek(p_index_ofs);
+	uint8_t header[PackedData::PackIndex::HEADER_SIZE];
+	if (pack->get_buffer(header, sizeof(header)) != int(sizeof(header))) {
+		memdelete(pack);
+		return false;
+	}
+
+	uint64_t size = PackedData::PackIndex::get_size(header);
+	if (p_index_ofs + sizeof(header) + size > pack->get_len() || size > INT32_MAX) {
+		memdelete(pack);
+		return false;
+	}
+
+	PackedData::PackIndex *index = memnew(PackedData::PackIndex);
+	// Query the index in place if the pack is mapped, otherwise read it in one go.
+	const uint8_t *data = pack->get_mapped_buffer(size);
+	if (!data) {
+		index->storage.resize(size);
+		if (pack->get_buffer(index->storage.ptrw(), size) != int(size)) {
+			memdelete(index);
+			memdelete(pack);
+			return false;
+		}
+		data = index->storage.ptr();
+	}
+
+	if (!index->set_data(header, data)) {
+		memdelete(index);
+		memdelete(pack);
+		return false;
+	}
+
+	index->pack = p_path;
+	index->base = p_file_base;
+	index->src = this;
+	PackedData::get_singleton()->add_index(index, p_replace_files);
+
+	open_packs.push_back(pack);
 	return true;
 }
 
@@ -246,6 +776,12 @@ FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFi
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (int i = 0; i < open_packs.size(); i++) {
+		memdelete(open_packs[i]);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -298,6 +834,32 @@ uint8_t FileAccessPack::get_8() const {
 	return f->get_8();
 }
 
+// Reads fully inside the file go straight to the pack, with its endianness.
+
+uint16_t FileAccessPack::get_16() const {
+	if (pos + 2 > pf.size) {
+		return FileAccess::get_16();
+	}
+	pos += 2;
+	return f->get_16();
+}
+
+uint32_t FileAccessPack::get_32() const {
+	if (pos + 4 > pf.size) {
+		return FileAccess::get_32();
+	}
+	pos += 4;
+	return f->get_32();
+}
+
+uint64_t FileAccessPack::get_64() const {
+	if (pos + 8 > pf.size) {
+		return FileAccess::get_64();
+	}
+	pos += 8;
+	return f->get_64();
+}
+
 int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 	if (eof) {
 		return 0;
@@ -319,6 +881,18 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_buffer(int p_length) const {
+	if (eof || p_length < 0 || pos + p_length > pf.size) {
+		return nullptr;
+	}
+
+	const uint8_t *ptr = f->get_mapped_buffer(p_length);
+	if (ptr) {
+		pos += p_length;
+	}
+	return ptr;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
 	f->set_endian_swap(p_swap);
@@ -391,33 +965,88 @@ FileAccessPack::~FileAccessPack() {
 //////////////////////////////////////////////////////////////////////////////////
 
 Error DirAccessPack::list_dir_begin() {
-	list_dirs.clear();
-	list_files.clear();
+	list_dir_end();
+
+	PackedData *packed_data = PackedData::get_singleton();
+	int sources = 0;
 
-	for (Map<String, PackedData::PackedDir *>::Element *E = current->subdirs.front(); E; E = E->next()) {
-		list_dirs.push_back(E->key());
+	PackedData::PackedDir *pd = packed_data->_find_packed_dir(current);
+	if (pd) {
+		for (Map<String, PackedData::PackedDir *>::Element *E = pd->subdirs.front(); E; E = E->next()) {
+			list_dirs.push_back(E->key());
+		}
+
+		for (Set<String>::Element *E = pd->files.front(); E; E = E->next()) {
+			list_files.push_back(E->get());
+		}
+		sources++;
 	}
 
-	for (Set<String>::Element *E = current->files.front(); E; E = E->next()) {
-		list_files.push_back(E->get());
+	for (int i = 0; i < packed_data->indexes.size(); i++) {
+		int dir = packed_data->indexes[i]->find_dir(current);
+		if (dir >= 0) {
+			IndexedDir id;
+			id.index = packed_data->indexes[i];
+			id.dir = dir;
+			list_indexed.push_back(id);
+			sources++;
+		}
 	}
 
+	list_dedupe = sources > 1;
+
 	return OK;
 }
 
+bool DirAccessPack::_next_indexed(String &r_name) {
+	while (list_source < list_indexed.size()) {
+		const IndexedDir &id = list_indexed[list_source];
+		if (!list_indexed_files && list_item < id.index->get_dir_child_count(id.dir)) {
+			r_name = id.index->get_dir_child(id.dir, list_item++);
+			return true;
+		} else if (list_indexed_files && list_item < id.index->get_dir_file_count(id.dir)) {
+			r_name = id.index->get_dir_file(id.dir, list_item++);
+			return true;
+		}
+		list_source++;
+		list_item = 0;
+	}
+	return false;
+}
+
 String DirAccessPack::get_next() {
-	if (list_dirs.size()) {
-		cdir = true;
-		String d = list_dirs.front()->get();
-		list_dirs.pop_front();
-		return d;
-	} else if (list_files.size()) {
-		cdir = false;
-		String f = list_files.front()->get();
-		list_files.pop_front();
-		return f;
-	} else {
-		return String();
+	while (true) {
+		String name;
+		if (list_dirs.size()) {
+			cdir = true;
+			name = list_dirs.front()->get();
+			list_dirs.pop_front();
+		} else if (!list_indexed_files) {
+			if (!_next_indexed(name)) {
+				list_indexed_files = true;
+				list_source = 0;
+				list_item = 0;
+				continue;
+			}
+			cdir = true;
+		} else if (list_files.size()) {
+			cdir = false;
+			name = list_files.front()->get();
+			list_files.pop_front();
+		} else if (_next_indexed(name)) {
+			cdir = false;
+		} else {
+			return String();
+		}
+
+		if (!list_dedupe) {
+			return name;
+		}
+		String key = cdir ? name + "/" : name;
+		if (!listed.has(key)) {
+			listed.insert(key);
+			return name;
+		}
 	}
 }
 
@@ -432,6 +1061,12 @@ bool DirAccessPack::current_is_hidden() const {
 void DirAccessPack::list_dir_end() {
 	list_dirs.clear();
 	list_files.clear();
+	list_indexed.clear();
+	list_source = 0;
+	list_item = 0;
+	list_indexed_files = false;
+	list_dedupe = false;
+	listed.clear();
 }
 
 int DirAccessPack::get_drive_count() {
@@ -463,25 +1098,16 @@ Error DirAccessPack::change_dir(String p_dir) {
 
 	Vector<String> paths = nd.split("/");
 
-	PackedData::PackedDir *pd;
-
-	if (absolute) {
-		pd = PackedData::get_singleton()->root;
-	} else {
-		pd = current;
-	}
+	String pd = absolute ? String() : current;
 
 	for (int i = 0; i < paths.size(); i++) {
 		String p = paths[i];
 		if (p == ".") {
 			continue;
 		} else if (p == "..") {
-			if (pd->parent) {
-				pd = pd->parent;
-			}
-		} else if (pd->subdirs.has(p)) {
-			pd = pd->subdirs[p];
-
+			pd = pd.get_base_dir();
+		} else if (PackedData::get_singleton()->_has_dir(pd.plus_file(p))) {
+			pd = pd.plus_file(p);
 		} else {
 			return ERR_INVALID_PARAMETER;
 		}
@@ -493,27 +1119,41 @@ Error DirAccessPack::change_dir(String p_dir) {
 }
 
 String DirAccessPack::get_current_dir(bool p_include_drive) {
-	PackedData::PackedDir *pd = current;
-	String p = current->name;
-
-	while (pd->parent) {
-		pd = pd->parent;
-		p = pd->name.plus_file(p);
-	}
-
-	return "res://" + p;
+	return "res://" + current;
 }
 
 bool DirAccessPack::file_exists(String p_file) {
 	p_file = fix_path(p_file);
 
-	return current->files.has(p_file);
+	PackedData *packed_data = PackedData::get_singleton();
+	PackedData::PackedDir *pd = packed_data->_find_packed_dir(current);
+	if (pd && pd->files.has(p_file)) {
+		return true;
+	}
+	for (int i = 0; i < packed_data->indexes.size(); i++) {
+		int dir = packed_data->indexes[i]->find_dir(current);
+		if (dir >= 0 && packed_data->indexes[i]->has_dir_file(dir, p_file)) {
+			return true;
+		}
+	}
+	return false;
 }
 
 bool DirAccessPack::dir_exists(String p_dir) {
 	p_dir = fix_path(p_dir);
 
-	return current->subdirs.has(p_dir);
+	PackedData *packed_data = PackedData::get_singleton();
+	PackedData::PackedDir *pd = packed_data->_find_packed_dir(current);
+	if (pd && pd->subdirs.has(p_dir)) {
+		return true;
+	}
+	for (int i = 0; i < packed_data->indexes.size(); i++) {
+		int dir = packed_data->indexes[i]->find_dir(current);
+		if (dir >= 0 && packed_data->indexes[i]->has_dir_child(dir, p_dir)) {
+			return true;
+		}
+	}
+	return false;
 }
 
 Error DirAccessPack::make_dir(String p_dir) {
@@ -537,5 +1177,4 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
-	current = PackedData::get_singleton()->root;
 }
@@ -31,6 +31,7 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/io/marshalls.h"
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/dir_access.h"
@@ -43,7 +44,10 @@
 #define PACK_FORMAT_VERSION 2
 
 enum PackFlags {
-	PACK_DIR_ENCRYPTED = 1 << 0
+	PACK_DIR_ENCRYPTED = 1 << 0,
+	// The pack carries a sorted directory index after the file data, its
+	// offset is stored in the first two reserved header fields.
+	PACK_DIR_INDEX = 1 << 1
 };
 
 enum PackFileFlags {
@@ -65,6 +69,60 @@ public:
 		uint8_t md5[16];
 		PackSource *src;
 		bool encrypted;
+		uint32_t layer = 0;
+		bool replace = false;
+	};
+
+	struct IndexedFile {
+		CharString path;
+		uint64_t offset = 0; // Relative to the files base.
+		uint64_t size = 0;
+		uint8_t md5[16] = {};
+		uint32_t flags = 0;
+	};
+
+	// Directory index as stored in the pack, queried in place without
+	// building per file structures. Entries are sorted by path hash and
+	// directories by path, so both are found with a binary search.
+	struct PackIndex {
+		enum {
+			HEADER_SIZE = 24,
+			ENTRY_SIZE = 64,
+			DIR_SIZE = 24,
+		};
+
+		Vector<uint8_t> storage; // Only used if the pack could not be mapped.
+		const uint8_t *entries = nullptr;
+		const uint8_t *dirs = nullptr;
+		const uint8_t *children = nullptr;
+		const uint8_t *file_refs = nullptr;
+		const char *strings = nullptr;
+		uint32_t entry_count = 0;
+		uint32_t dir_count = 0;
+		uint32_t child_count = 0;
+		uint32_t file_ref_count = 0;
+		uint32_t string_size = 0;
+
+		String pack;
+		uint64_t base = 0;
+		PackSource *src = nullptr;
+		bool replace = false;
+		uint32_t layer = 0;
+
+		static uint64_t get_size(const uint8_t *p_header);
+		bool set_data(const uint8_t *p_header, const uint8_t *p_data);
+
+		int find_entry(uint64_t p_a, uint64_t p_b) const;
+		void get_entry(int p_entry, PackedFile &r_file) const;
+		String get_entry_name(int p_entry) const;
+
+		int find_dir(const String &p_dir) const;
+		_FORCE_INLINE_ uint32_t get_dir_child_count(int p_dir) const { return decode_uint32(dirs + p_dir * DIR_SIZE + 12); }
+		_FORCE_INLINE_ uint32_t get_dir_file_count(int p_dir) const { return decode_uint32(dirs + p_dir * DIR_SIZE + 20); }
+		String get_dir_child(int p_dir, uint32_t p_child) const;
+		String get_dir_file(int p_dir, uint32_t p_file) const;
+		bool has_dir_child(int p_dir, const String &p_name) const;
+		bool has_dir_file(int p_dir, const String &p_name) const;
 	};
 
 private:
@@ -93,14 +151,16 @@ private:
 		PathMD5() {}
 
 		PathMD5(const Vector<uint8_t> p_buf) {
-			a = *((uint64_t *)&p_buf[0]);
-			b = *((uint64_t *)&p_buf[8]);
+			a = decode_uint64(&p_buf[0]);
+			b = decode_uint64(&p_buf[8]);
 		}
 	};
 
 	Map<PathMD5, PackedFile> files;
 
 	Vector<PackSource *> sources;
+	Vector<PackIndex *> indexes;
+	uint32_t layer_count = 0;
 
 	PackedDir *root;
 
@@ -108,10 +168,19 @@ private:
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	PackedDir *_find_packed_dir(const String &p_dir) const;
+	bool _has_dir(const String &p_dir) const;
+
+	bool _find_file(const PathMD5 &p_md5, PackedFile &r_file) const;
+	FileAccess *_try_open_indexed_path(const String &p_path, const PathMD5 &p_md5);
+	bool _has_indexed_path(const PathMD5 &p_md5) const;
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_index(PackIndex *p_index, bool p_replace_files); // for PackSource, takes ownership
+
+	static void store_index(FileAccess *p_file, const Vector<IndexedFile> &p_files);
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -134,9 +203,16 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Kept open so memory mapped packs stay mapped between file reads.
+	Vector<FileAccess *> open_packs;
+
+	bool _load_index(const String &p_path, bool p_replace_files, uint64_t p_index_ofs, uint64_t p_file_base);
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, size_t p_offset);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -164,8 +240,12 @@ public:
 	virtual bool eof_reached() const;
 
 	virtual uint8_t get_8() const;
+	virtual uint16_t get_16() const;
+	virtual uint32_t get_32() const;
+	virtual uint64_t get_64() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_mapped_buffer(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -184,6 +264,9 @@ public:
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 	PathMD5 pmd5(p_path.md5_buffer());
+	if (indexes.size()) {
+		return _try_open_indexed_path(p_path, pmd5);
+	}
 	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
 	if (!E) {
 		return nullptr; //not found
@@ -196,16 +279,35 @@ FileAccess *PackedData::try_open_path(const String &p_path) {
 }
 
 bool PackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.md5_buffer()));
+	PathMD5 pmd5(p_path.md5_buffer());
+	if (files.has(pmd5)) {
+		return true;
+	}
+	return indexes.size() && _has_indexed_path(pmd5);
 }
 
 class DirAccessPack : public DirAccess {
-	PackedData::PackedDir *current;
+	String current; // Relative to "res://", empty for the root.
+
+	struct IndexedDir {
+		const PackedData::PackIndex *index;
+		int dir;
+	};
 
 	List<String> list_dirs;
 	List<String> list_files;
+	// Indexed directories are listed lazily straight from the index.
+	Vector<IndexedDir> list_indexed;
+	int list_source = 0;
+	uint32_t list_item = 0;
+	bool list_indexed_files = false;
+	// Only needed when more than one pack provides the current directory.
+	bool list_dedupe = false;
+	Set<String> listed;
 	bool cdir = false;
 
+	bool _next_indexed(String &r_name);
+
 public:
 	virtual Error list_dir_begin();
 	virtual String get_next();
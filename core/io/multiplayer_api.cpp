@@ -40,6 +40,12 @@
 #define NAME_ID_COMPRESSION_SHIFT 5
 #define BYTE_ONLY_OR_NO_ARGS_SHIFT 6
 
+// Batches stay below a common MTU, so unreliable ones don't get fragmented.
+#define BATCH_MAX_SIZE 1200
+// Snapshots kept per peer while waiting for acknowledgments, after that full snapshots are sent again.
+#define SNAPSHOT_HISTORY_MAX 64
+#define SNAPSHOT_MAX_PROPERTIES 32
+
 #ifdef DEBUG_ENABLED
 #include "core/os/os.h"
 #endif
@@ -98,11 +104,40 @@ _FORCE_INLINE_ bool _can_call_mode(Node *p_node, MultiplayerAPI::RPCMode mode, i
 	return false;
 }
 
+#ifdef DEBUG_ENABLED
+void _profile_node_data(const String &p_what, ObjectID p_id) {
+	if (EngineDebugger::is_profiling("multiplayer")) {
+		Array values;
+		values.push_back("node");
+		values.push_back(p_id);
+		values.push_back(p_what);
+		EngineDebugger::profiler_add_frame_data("multiplayer", values);
+	}
+}
+
+void _profile_bandwidth_data(const String &p_inout, int p_size) {
+	if (EngineDebugger::is_profiling("multiplayer")) {
+		Array values;
+		values.push_back("bandwidth");
+		values.push_back(p_inout);
+		values.push_back(OS::get_singleton()->get_ticks_msec());
+		values.push_back(p_size);
+		EngineDebugger::profiler_add_frame_data("multiplayer", values);
+	}
+}
+#endif
+
 void MultiplayerAPI::poll() {
 	if (!network_peer.is_valid() || network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_DISCONNECTED) {
 		return;
 	}
 
+	if (network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+		// Everything queued since the last poll leaves together.
+		_send_snapshots();
+		_flush_batches();
+	}
+
 	network_peer->poll();
 
 	if (!network_peer.is_valid()) { // It's possible that polling might have resulted in a disconnection, so check here.
@@ -120,6 +155,10 @@ void MultiplayerAPI::poll() {
 			break; // Something is wrong!
 		}
 
+#ifdef DEBUG_ENABLED
+		_profile_bandwidth_data("in", len);
+#endif
+
 		rpc_sender_id = sender;
 		_process_packet(sender, packet, len);
 		rpc_sender_id = 0;
@@ -135,6 +174,8 @@ void MultiplayerAPI::clear() {
 	path_get_cache.clear();
 	path_send_cache.clear();
 	packet_cache.clear();
+	batches.clear();
+	peer_snapshots.clear();
 	last_send_cache_id = 1;
 }
 
@@ -174,29 +215,6 @@ Ref<NetworkedMultiplayerPeer> MultiplayerAPI::get_network_peer() const {
 	return network_peer;
 }
 
-#ifdef DEBUG_ENABLED
-void _profile_node_data(const String &p_what, ObjectID p_id) {
-	if (EngineDebugger::is_profiling("multiplayer")) {
-		Array values;
-		values.push_back("node");
-		values.push_back(p_id);
-		values.push_back(p_what);
-		EngineDebugger::profiler_add_frame_data("multiplayer", values);
-	}
-}
-
-void _profile_bandwidth_data(const String &p_inout, int p_size) {
-	if (EngineDebugger::is_profiling("multiplayer")) {
-		Array values;
-		values.push_back("bandwidth");
-		values.push_back(p_inout);
-		values.push_back(OS::get_singleton()->get_ticks_msec());
-		values.push_back(p_size);
-		EngineDebugger::profiler_add_frame_data("multiplayer", values);
-	}
-}
-#endif
-
 // Returns the packet size stripping the node path added when the node is not yet cached.
 int get_packet_len(uint32_t p_node_target, int p_packet_len) {
 	if (p_node_target & 0x80000000) {
@@ -211,10 +229,6 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 	ERR_FAIL_COND_MSG(root_node == nullptr, "Multiplayer root node was not initialized. If you are using custom multiplayer, remember to set the root node via MultiplayerAPI.set_root_node before using it.");
 	ERR_FAIL_COND_MSG(p_packet_len < 1, "Invalid packet received. Size too small.");
 
-#ifdef DEBUG_ENABLED
-	_profile_bandwidth_data("in", p_packet_len);
-#endif
-
 	// Extract the `packet_type` from the LSB three bits:
 	uint8_t packet_type = p_packet[0] & 7;
 
@@ -310,6 +324,18 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 		case NETWORK_COMMAND_RAW: {
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_BATCH: {
+			_process_batch(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT: {
+			_process_snapshot(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_SNAPSHOT_ACK: {
+			_process_snapshot_ack(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -582,9 +608,8 @@ bool MultiplayerAPI::_send_confirm_path(Node *p_node, NodePath p_path, PathSentC
 		ofs += encode_cstring(path.get_data(), &packet.write[ofs]);
 
 		for (List<int>::Element *E = peers_to_add.front(); E; E = E->next()) {
-			network_peer->set_target_peer(E->get()); // To all of you.
-			network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
-			network_peer->put_packet(packet.ptr(), packet.size());
+			// Queued with the packets using it when batching.
+			_send_packet(E->get(), NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE, packet.ptr(), packet.size());
 
 			psc->confirmed_peers.insert(E->get(), false); // Insert into confirmed, but as false since it was not confirmed.
 		}
@@ -767,13 +792,7 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	ERR_FAIL_COND_MSG(from_path.is_empty(), "Unable to send RPC. Relative path is empty. THIS IS LIKELY A BUG IN THE ENGINE!");
 
 	// See if the path is cached.
-	PathSentCache *psc = path_send_cache.getptr(from_path);
-	if (!psc) {
-		// Path is not cached, create.
-		path_send_cache[from_path] = PathSentCache();
-		psc = path_send_cache.getptr(from_path);
-		psc->id = last_send_cache_id++;
-	}
+	PathSentCache *psc = _get_path_send_cache(from_path);
 
 	// See if all peers have cached path (if so, call can be fast).
 	const bool has_all_peers = _send_confirm_path(p_from, from_path, psc, p_to);
@@ -922,13 +941,11 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	_profile_bandwidth_data("out", ofs);
 #endif
 
-	// Take chance and set transfer mode, since all send methods will use it.
-	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	const NetworkedMultiplayerPeer::TransferMode transfer_mode = p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE;
 
 	if (has_all_peers) {
 		// They all have verified paths, so send fast.
-		network_peer->set_target_peer(p_to); // To all of you.
-		network_peer->put_packet(packet_cache.ptr(), ofs); // A message with love.
+		_send_packet(p_to, transfer_mode, packet_cache.ptr(), ofs); // A message with love.
 	} else {
 		// Unreachable because the node ID is never compressed if the peers doesn't know it.
 		CRASH_COND(node_id_compression != NETWORK_NODE_ID_COMPRESSION_32);
@@ -953,16 +970,14 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); // Should never happen.
 
-			network_peer->set_target_peer(E->get()); // To this one specifically.
-
 			if (F->get()) {
 				// This one confirmed path, so use id.
 				encode_uint32(psc->id, &(packet_cache.write[1]));
-				network_peer->put_packet(packet_cache.ptr(), ofs);
+				_send_packet(E->get(), transfer_mode, packet_cache.ptr(), ofs); // To this one specifically.
 			} else {
 				// This one did not confirm path yet, so use entire path (sorry!).
 				encode_uint32(0x80000000 | ofs, &(packet_cache.write[1])); // Offset to path and flag.
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
+				_send_packet(E->get(), transfer_mode, packet_cache.ptr(), ofs + path_len);
 			}
 		}
 	}
@@ -986,6 +1001,12 @@ void MultiplayerAPI::_del_peer(int p_id) {
 		PathSentCache *psc = path_send_cache.getptr(E->get());
 		psc->confirmed_peers.erase(p_id);
 	}
+	peer_snapshots.erase(p_id);
+	for (int i = batches.size() - 1; i >= 0; i--) {
+		if (batches[i].target == p_id) {
+			batches.remove(i);
+		}
+	}
 	emit_signal("network_peer_disconnected", p_id);
 }
 
@@ -1136,6 +1157,9 @@ Error MultiplayerAPI::send_bytes(Vector<uint8_t> p_data, int p_to, NetworkedMult
 	ERR_FAIL_COND_V_MSG(!network_peer.is_valid(), ERR_UNCONFIGURED, "Trying to send a raw packet while no network peer is active.");
 	ERR_FAIL_COND_V_MSG(network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED, ERR_UNCONFIGURED, "Trying to send a raw packet via a network peer which is not connected.");
 
+	// Raw packets are sent right away, after what was queued before them.
+	_flush_batches();
+
 	MAKE_ROOM(p_data.size() + 1);
 	const uint8_t *r = p_data.ptr();
 	packet_cache.write[0] = NETWORK_COMMAND_RAW;
@@ -1160,6 +1184,572 @@ void MultiplayerAPI::_process_raw(int p_from, const uint8_t *p_packet, int p_pac
 	emit_signal("network_peer_packet", p_from, out);
 }
 
+MultiplayerAPI::PathSentCache *MultiplayerAPI::_get_path_send_cache(const NodePath &p_path) {
+	PathSentCache *psc = path_send_cache.getptr(p_path);
+	if (!psc) {
+		// Path is not cached, create.
+		path_send_cache[p_path] = PathSentCache();
+		psc = path_send_cache.getptr(p_path);
+		psc->id = last_send_cache_id++;
+	}
+	return psc;
+}
+
+// Whether packets sent to both targets can reach a same peer. Negative targets
+// exclude a peer, 0 is a broadcast.
+static bool _targets_overlap(int p_a, int p_b) {
+	if (p_a == p_b || p_a == NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST || p_b == NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST) {
+		return true;
+	}
+	if (p_a < 0 && p_b < 0) {
+		return true; // Both reach every peer but one.
+	}
+	if (p_a < 0) {
+		return p_b != -p_a;
+	}
+	if (p_b < 0) {
+		return p_a != -p_b;
+	}
+	return false;
+}
+
+void MultiplayerAPI::_send_packet(int p_to, NetworkedMultiplayerPeer::TransferMode p_mode, const uint8_t *p_packet, int p_packet_len) {
+	if (!rpc_batching || p_packet_len + 3 > BATCH_MAX_SIZE) {
+		// Keep the order with what was batched before.
+		_flush_batches();
+
+		network_peer->set_transfer_mode(p_mode);
+		network_peer->set_target_peer(p_to);
+		network_peer->put_packet(p_packet, p_packet_len);
+		return;
+	}
+
+	int index = -1;
+	for (int i = batches.size() - 1; i >= 0; i--) {
+		if (batches[i].target == p_to && batches[i].mode == p_mode) {
+			index = i;
+			break;
+		}
+	}
+
+	// Unreliable packets can join any batch. Reliable ones can't skip ahead of
+	// a newer reliable batch reaching the same peer, or that peer would get them
+	// out of order. Batches for other peers don't matter.
+	bool reliable = p_mode != NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE;
+	if (index != -1 && reliable) {
+		for (int i = index + 1; i < batches.size(); i++) {
+			const Batch &newer = batches[i];
+			if (newer.packet_count > 0 && newer.mode != NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE && _targets_overlap(newer.target, p_to)) {
+				_flush_batches();
+				index = -1;
+				break;
+			}
+		}
+	}
+
+	if (index != -1 && batches[index].data.size() + 2 + p_packet_len > BATCH_MAX_SIZE) {
+		if (reliable) {
+			_flush_batches();
+			index = -1;
+		} else {
+			_flush_batch(batches.write[index]);
+		}
+	}
+
+	if (index == -1) {
+		Batch batch;
+		batch.target = p_to;
+		batch.mode = p_mode;
+		batches.push_back(batch);
+		index = batches.size() - 1;
+	}
+
+	Batch &batch = batches.write[index];
+	if (batch.data.empty()) {
+		batch.data.push_back(NETWORK_COMMAND_BATCH);
+	}
+
+	int ofs = batch.data.size();
+	batch.data.resize(ofs + 2 + p_packet_len);
+	encode_uint16(p_packet_len, &batch.data.write[ofs]);
+	memcpy(&batch.data.write[ofs + 2], p_packet, p_packet_len);
+	batch.packet_count++;
+}
+
+void MultiplayerAPI::_flush_batch(Batch &p_batch) {
+	if (p_batch.packet_count == 0) {
+		return;
+	}
+
+	network_peer->set_transfer_mode(p_batch.mode);
+	network_peer->set_target_peer(p_batch.target);
+	if (p_batch.packet_count == 1) {
+		// No need for the batch header.
+		network_peer->put_packet(p_batch.data.ptr() + 3, p_batch.data.size() - 3);
+	} else {
+		network_peer->put_packet(p_batch.data.ptr(), p_batch.data.size());
+	}
+
+	p_batch.data.clear();
+	p_batch.packet_count = 0;
+}
+
+void MultiplayerAPI::_flush_batches() {
+	if (batches.empty() || network_peer.is_null()) {
+		return;
+	}
+
+	for (int i = 0; i < batches.size(); i++) {
+		_flush_batch(batches.write[i]);
+	}
+	batches.clear();
+}
+
+void MultiplayerAPI::_process_batch(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	int ofs = 1;
+	while (ofs < p_packet_len) {
+		ERR_FAIL_COND_MSG(ofs + 2 > p_packet_len, "Invalid packet received. Size too small.");
+		int len = decode_uint16(&p_packet[ofs]);
+		ofs += 2;
+
+		ERR_FAIL_COND_MSG(len < 1 || ofs + len > p_packet_len, "Invalid packet received. Size smaller than declared.");
+		ERR_FAIL_COND_MSG((p_packet[ofs] & 7) == NETWORK_COMMAND_BATCH, "Invalid packet received. Batches can't be nested.");
+
+		_process_packet(p_from, &p_packet[ofs], len);
+		ofs += len;
+
+		if (!network_peer.is_valid()) {
+			return; // A packet may have caused a disconnection.
+		}
+	}
+}
+
+// Floating point values are replicated as integer multiples of the quantization
+// step, sent as the difference with the last acknowledged value.
+
+// Quantized values are kept within what a double holds exactly, so the deltas
+// between two of them can't overflow.
+#define QUANTIZED_MAX (int64_t(1) << 52)
+
+static bool _quantize_component(double p_value, real_t p_step, int64_t &r_component) {
+	double steps = Math::round(p_value / p_step);
+	if (!(Math::abs(steps) <= double(QUANTIZED_MAX))) {
+		return false; // Also NaN and INF, which are sent as they are.
+	}
+	r_component = (int64_t)steps;
+	return true;
+}
+
+static int _quantize_components(const Variant &p_value, real_t p_step, int64_t *r_components) {
+	if (p_step <= 0) {
+		return 0;
+	}
+
+	int64_t components[3];
+	int count = 0;
+	switch (p_value.get_type()) {
+		case Variant::FLOAT: {
+			if (_quantize_component(double(p_value), p_step, components[0])) {
+				count = 1;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			if (_quantize_component(v.x, p_step, components[0]) && _quantize_component(v.y, p_step, components[1])) {
+				count = 2;
+			}
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			if (_quantize_component(v.x, p_step, components[0]) && _quantize_component(v.y, p_step, components[1]) && _quantize_component(v.z, p_step, components[2])) {
+				count = 3;
+			}
+		} break;
+		default: {
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		r_components[i] = components[i];
+	}
+	return count;
+}
+
+static Variant _dequantize_components(Variant::Type p_type, const int64_t *p_components, real_t p_step) {
+	switch (p_type) {
+		case Variant::FLOAT: {
+			return double(p_components[0]) * p_step;
+		}
+		case Variant::VECTOR2: {
+			return Vector2(p_components[0] * p_step, p_components[1] * p_step);
+		}
+		case Variant::VECTOR3: {
+			return Vector3(p_components[0] * p_step, p_components[1] * p_step, p_components[2] * p_step);
+		}
+		default: {
+			return Variant();
+		}
+	}
+}
+
+static int _get_quantized_component_count(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return 1;
+		case Variant::VECTOR2:
+			return 2;
+		case Variant::VECTOR3:
+			return 3;
+		default:
+			return 0;
+	}
+}
+
+void MultiplayerAPI::_send_snapshots() {
+	if (replicated_nodes.empty() || connected_peers.empty()) {
+		return;
+	}
+
+	struct NodeValues {
+		Node *node = nullptr;
+		NodePath path;
+		PathSentCache *psc = nullptr;
+		const ReplicationConfig *config = nullptr;
+		Vector<Variant> values;
+	};
+
+	// Read and quantize the properties once, whatever the peer count.
+	Vector<NodeValues> nodes;
+	List<ObjectID> freed;
+	for (Map<ObjectID, ReplicationConfig>::Element *E = replicated_nodes.front(); E; E = E->next()) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->key()));
+		if (!node) {
+			freed.push_back(E->key());
+			continue;
+		}
+		if (!node->is_inside_tree() || !node->is_network_master()) {
+			continue;
+		}
+
+		NodeValues nv;
+		nv.node = node;
+		nv.path = (root_node->get_path()).rel_path_to(node->get_path());
+		nv.psc = _get_path_send_cache(nv.path);
+		nv.config = &E->get();
+		nv.values.resize(nv.config->properties.size());
+		for (int i = 0; i < nv.config->properties.size(); i++) {
+			Variant value = node->get(nv.config->properties[i]);
+			int64_t components[3];
+			if (_quantize_components(value, nv.config->quantization, components)) {
+				value = _dequantize_components(value.get_type(), components, nv.config->quantization);
+			}
+			nv.values.write[i] = value;
+		}
+		nodes.push_back(nv);
+	}
+
+	for (List<ObjectID>::Element *E = freed.front(); E; E = E->next()) {
+		replicated_nodes.erase(E->get());
+	}
+
+	if (nodes.empty()) {
+		return;
+	}
+
+	for (Set<int>::Element *P = connected_peers.front(); P; P = P->next()) {
+		const int peer = P->get();
+		PeerSnapshots &ps = peer_snapshots[peer];
+
+		const SnapshotState *base = nullptr;
+		if (ps.last_acked) {
+			Map<uint32_t, SnapshotState>::Element *B = ps.sent.find(ps.last_acked);
+			if (B) {
+				base = &B->get();
+			}
+		}
+
+		// Header: command, sequence and base sequence (0 when there is no base).
+		Vector<uint8_t> packet;
+		packet.resize(9);
+		packet.write[0] = NETWORK_COMMAND_SNAPSHOT;
+
+		SnapshotState state;
+		bool changed = false;
+
+		for (int n = 0; n < nodes.size(); n++) {
+			const NodeValues &nv = nodes[n];
+			if (!_send_confirm_path(nv.node, nv.path, nv.psc, peer)) {
+				continue; // Replicated once the peer knows the path.
+			}
+
+			state[nv.psc->id] = nv.values;
+
+			const Vector<Variant> *base_values = nullptr;
+			if (base) {
+				const Map<int, Vector<Variant>>::Element *B = base->find(nv.psc->id);
+				if (B && B->get().size() == nv.values.size()) {
+					base_values = &B->get();
+				}
+			}
+
+			// Node block: path cache id, changed properties mask, block size, then the changed values.
+			int block_ofs = packet.size();
+			packet.resize(block_ofs + 10);
+			uint32_t mask = 0;
+
+			for (int i = 0; i < nv.values.size(); i++) {
+				const Variant &value = nv.values[i];
+				if (base_values && (*base_values)[i] == value) {
+					continue;
+				}
+				mask |= 1u << i;
+
+				int64_t components[3];
+				int count = _quantize_components(value, nv.config->quantization, components);
+				if (count) {
+					int64_t base_components[3] = { 0, 0, 0 };
+					if (base_values && (*base_values)[i].get_type() == value.get_type()) {
+						_quantize_components((*base_values)[i], nv.config->quantization, base_components);
+					}
+
+					packet.push_back(value.get_type());
+					for (int j = 0; j < count; j++) {
+						Variant delta = components[j] - base_components[j];
+						int len;
+						_encode_and_compress_variant(delta, nullptr, len);
+						int ofs = packet.size();
+						packet.resize(ofs + len);
+						_encode_and_compress_variant(delta, &packet.write[ofs], len);
+					}
+				} else {
+					packet.push_back(0);
+					int len;
+					Error err = _encode_and_compress_variant(value, nullptr, len);
+					ERR_CONTINUE(err != OK);
+					int ofs = packet.size();
+					packet.resize(ofs + len);
+					_encode_and_compress_variant(value, &packet.write[ofs], len);
+				}
+			}
+
+			int block_len = packet.size() - block_ofs - 10;
+			if (mask == 0 || block_len > UINT16_MAX) {
+				ERR_CONTINUE_MSG(block_len > UINT16_MAX, "Replicated properties of node " + String(nv.path) + " are too big for a snapshot.");
+				packet.resize(block_ofs);
+				continue;
+			}
+
+			encode_uint32(nv.psc->id, &packet.write[block_ofs]);
+			encode_uint32(mask, &packet.write[block_ofs + 4]);
+			encode_uint16(block_len, &packet.write[block_ofs + 8]);
+			changed = true;
+		}
+
+		if (!changed && ps.last_sent == ps.last_acked) {
+			continue; // Nothing new and the peer is up to date.
+		}
+
+		uint32_t sequence = ++ps.last_sent;
+		encode_uint32(sequence, &packet.write[1]);
+		encode_uint32(base ? ps.last_acked : 0, &packet.write[5]);
+
+		ps.sent[sequence] = state;
+		while (ps.sent.size() > SNAPSHOT_HISTORY_MAX) {
+			// Acknowledgments are not coming back, start again from full snapshots.
+			if (ps.sent.front()->key() == ps.last_acked) {
+				ps.last_acked = 0;
+			}
+			ps.sent.erase(ps.sent.front());
+		}
+
+#ifdef DEBUG_ENABLED
+		_profile_bandwidth_data("out", packet.size());
+#endif
+
+		_send_packet(peer, NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE, packet.ptr(), packet.size());
+	}
+}
+
+void MultiplayerAPI::_process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 9, "Invalid packet received. Size too small.");
+
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+	const uint32_t base_sequence = decode_uint32(&p_packet[5]);
+
+	PeerSnapshots &ps = peer_snapshots[p_from];
+	if (sequence <= ps.last_received) {
+		return; // Late or duplicated.
+	}
+
+	const SnapshotState *base = nullptr;
+	if (base_sequence) {
+		Map<uint32_t, SnapshotState>::Element *B = ps.received.find(base_sequence);
+		if (!B) {
+			return; // Base is unknown, wait for a snapshot against one that was acknowledged.
+		}
+		base = &B->get();
+	}
+
+	const SnapshotState *applied = nullptr;
+	if (ps.last_received) {
+		Map<uint32_t, SnapshotState>::Element *A = ps.received.find(ps.last_received);
+		if (A) {
+			applied = &A->get();
+		}
+	}
+
+	Map<int, PathGetCache>::Element *G = path_get_cache.find(p_from);
+	ERR_FAIL_COND_MSG(!G, "Invalid packet received. Requests invalid peer cache.");
+
+	SnapshotState state;
+	if (base) {
+		state = *base;
+	}
+
+	int ofs = 9;
+	while (ofs < p_packet_len) {
+		ERR_FAIL_COND_MSG(ofs + 10 > p_packet_len, "Invalid packet received. Size too small.");
+		const int id = decode_uint32(&p_packet[ofs]);
+		const uint32_t mask = decode_uint32(&p_packet[ofs + 4]);
+		const int block_end = ofs + 10 + decode_uint16(&p_packet[ofs + 8]);
+		ERR_FAIL_COND_MSG(block_end > p_packet_len, "Invalid packet received. Size smaller than declared.");
+		ofs += 10;
+
+		Node *node = nullptr;
+		Map<int, PathGetCache::NodeInfo>::Element *F = G->get().nodes.find(id);
+		if (F) {
+			node = root_node->get_node(F->get().path);
+		}
+		const ReplicationConfig *config = nullptr;
+		if (node) {
+			Map<ObjectID, ReplicationConfig>::Element *C = replicated_nodes.find(node->get_instance_id());
+			if (C) {
+				config = &C->get();
+			}
+		}
+		// Bits past the last property must be clear. With 32 properties every bit is used,
+		// and shifting by the full width would be undefined.
+		const bool mask_valid = config && (config->properties.size() >= SNAPSHOT_MAX_PROPERTIES || (mask >> config->properties.size()) == 0);
+		if (!node || !config || !mask_valid) {
+			ERR_PRINT("Invalid snapshot received. Node is not replicated with the same properties on both ends.");
+			ofs = block_end;
+			continue;
+		}
+
+		Vector<Variant> values;
+		const Map<int, Vector<Variant>>::Element *B = state.find(id);
+		if (B && B->get().size() == config->properties.size()) {
+			values = B->get();
+		} else {
+			values.resize(config->properties.size());
+		}
+
+		for (int i = 0; i < config->properties.size(); i++) {
+			if (!(mask & (1u << i))) {
+				continue;
+			}
+			ERR_FAIL_COND_MSG(ofs >= block_end, "Invalid packet received. Size too small.");
+			const uint8_t kind = p_packet[ofs++];
+
+			if (kind == 0) {
+				int vlen;
+				Error err = _decode_and_decompress_variant(values.write[i], &p_packet[ofs], block_end - ofs, &vlen);
+				ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode snapshot value.");
+				ofs += vlen;
+				continue;
+			}
+
+			const int count = _get_quantized_component_count(Variant::Type(kind));
+			ERR_FAIL_COND_MSG(count == 0, "Invalid packet received. Unknown quantized value type.");
+
+			int64_t components[3] = { 0, 0, 0 };
+			if (values[i].get_type() == Variant::Type(kind)) {
+				_quantize_components(values[i], config->quantization, components);
+			}
+			for (int j = 0; j < count; j++) {
+				Variant delta;
+				int vlen;
+				ERR_FAIL_COND_MSG(ofs >= block_end, "Invalid packet received. Size too small.");
+				Error err = _decode_and_decompress_variant(delta, &p_packet[ofs], block_end - ofs, &vlen);
+				ERR_FAIL_COND_MSG(err != OK || delta.get_type() != Variant::INT, "Invalid packet received. Unable to decode snapshot value.");
+				ERR_FAIL_COND_MSG(int64_t(delta) > 2 * QUANTIZED_MAX || int64_t(delta) < -2 * QUANTIZED_MAX, "Invalid packet received. Snapshot value out of range.");
+				components[j] += int64_t(delta);
+				ofs += vlen;
+			}
+			values.write[i] = _dequantize_components(Variant::Type(kind), components, config->quantization);
+		}
+		ERR_FAIL_COND_MSG(ofs != block_end, "Invalid packet received. Size bigger than declared.");
+
+		state[id] = values;
+	}
+
+	// Apply whatever differs from the last applied snapshot, including values
+	// reverted to the base by the sender.
+	for (Map<int, Vector<Variant>>::Element *E = state.front(); E; E = E->next()) {
+		Map<int, PathGetCache::NodeInfo>::Element *F = G->get().nodes.find(E->key());
+		Node *node = F ? root_node->get_node(F->get().path) : nullptr;
+		if (!node) {
+			continue;
+		}
+		Map<ObjectID, ReplicationConfig>::Element *C = replicated_nodes.find(node->get_instance_id());
+		if (!C || C->get().properties.size() != E->get().size()) {
+			continue;
+		}
+		ERR_CONTINUE_MSG(p_from != node->get_network_master(), "Snapshot for node " + String(F->get().path) + " not sent by its network master: " + itos(p_from) + ".");
+
+		const Vector<Variant> *previous = nullptr;
+		if (applied) {
+			const Map<int, Vector<Variant>>::Element *A = applied->find(E->key());
+			if (A && A->get().size() == E->get().size()) {
+				previous = &A->get();
+			}
+		}
+
+		for (int i = 0; i < E->get().size(); i++) {
+			const Variant &value = E->get()[i];
+			if (value.get_type() == Variant::NIL || (previous && (*previous)[i] == value)) {
+				continue;
+			}
+			node->set(C->get().properties[i], value);
+		}
+	}
+
+	ps.last_received = sequence;
+	ps.received[sequence] = state;
+
+	// The sender only moves its base forward, so older snapshots are not needed anymore.
+	while (ps.received.front() && (ps.received.front()->key() < base_sequence || ps.received.size() > SNAPSHOT_HISTORY_MAX)) {
+		ps.received.erase(ps.received.front());
+	}
+
+	uint8_t ack[5];
+	ack[0] = NETWORK_COMMAND_SNAPSHOT_ACK;
+	encode_uint32(sequence, &ack[1]);
+	_send_packet(p_from, NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE, ack, 5);
+}
+
+void MultiplayerAPI::_process_snapshot_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 5, "Invalid packet received. Size too small.");
+
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+
+	Map<int, PeerSnapshots>::Element *E = peer_snapshots.find(p_from);
+	if (!E) {
+		return;
+	}
+
+	PeerSnapshots &ps = E->get();
+	if (sequence <= ps.last_acked || !ps.sent.has(sequence)) {
+		return;
+	}
+
+	ps.last_acked = sequence;
+	// Older snapshots will never be used as a base again.
+	while (ps.sent.front()->key() < sequence) {
+		ps.sent.erase(ps.sent.front());
+	}
+}
+
 int MultiplayerAPI::get_network_unique_id() const {
 	ERR_FAIL_COND_V_MSG(!network_peer.is_valid(), 0, "No network peer is assigned. Unable to get unique network ID.");
 	return network_peer->get_unique_id();
@@ -1200,6 +1790,35 @@ bool MultiplayerAPI::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+void MultiplayerAPI::set_rpc_batching(bool p_enable) {
+	if (!p_enable && network_peer.is_valid()) {
+		_flush_batches();
+	}
+	rpc_batching = p_enable;
+}
+
+bool MultiplayerAPI::is_rpc_batching() const {
+	return rpc_batching;
+}
+
+void MultiplayerAPI::replicate(Node *p_node, const Vector<String> &p_properties, real_t p_quantization) {
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND_MSG(p_properties.size() == 0 || p_properties.size() > SNAPSHOT_MAX_PROPERTIES, "A node can replicate between 1 and " + itos(SNAPSHOT_MAX_PROPERTIES) + " properties.");
+	ERR_FAIL_COND(p_quantization < 0);
+
+	ReplicationConfig config;
+	for (int i = 0; i < p_properties.size(); i++) {
+		config.properties.push_back(p_properties[i]);
+	}
+	config.quantization = p_quantization;
+	replicated_nodes[p_node->get_instance_id()] = config;
+}
+
+void MultiplayerAPI::stop_replicating(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	replicated_nodes.erase(p_node->get_instance_id());
+}
+
 void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_node", "node"), &MultiplayerAPI::set_root_node);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode"), &MultiplayerAPI::send_bytes, DEFVAL(NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE));
@@ -1217,9 +1836,14 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &MultiplayerAPI::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &MultiplayerAPI::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("set_rpc_batching", "enable"), &MultiplayerAPI::set_rpc_batching);
+	ClassDB::bind_method(D_METHOD("is_rpc_batching"), &MultiplayerAPI::is_rpc_batching);
+	ClassDB::bind_method(D_METHOD("replicate", "node", "properties", "quantization"), &MultiplayerAPI::replicate, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("stop_replicating", "node"), &MultiplayerAPI::stop_replicating);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "rpc_batching"), "set_rpc_batching", "is_rpc_batching");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
 	ADD_PROPERTY_DEFAULT("refuse_new_network_connections", false);
 
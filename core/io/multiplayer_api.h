@@ -64,6 +64,38 @@ private:
 	Node *root_node = nullptr;
 	bool allow_object_decoding = false;
 
+	// Outgoing packets coalesced per target and transfer mode until the next poll.
+	struct Batch {
+		int target = 0;
+		NetworkedMultiplayerPeer::TransferMode mode = NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE;
+		Vector<uint8_t> data;
+		int packet_count = 0;
+	};
+
+	bool rpc_batching = false;
+	Vector<Batch> batches;
+
+	struct ReplicationConfig {
+		Vector<StringName> properties;
+		real_t quantization = 0;
+	};
+
+	// Property values per path cache id, as last sent or received.
+	typedef Map<int, Vector<Variant>> SnapshotState;
+
+	struct PeerSnapshots {
+		// Sending side.
+		uint32_t last_sent = 0;
+		uint32_t last_acked = 0;
+		Map<uint32_t, SnapshotState> sent;
+		// Receiving side.
+		uint32_t last_received = 0;
+		Map<uint32_t, SnapshotState> received;
+	};
+
+	Map<ObjectID, ReplicationConfig> replicated_nodes;
+	Map<int, PeerSnapshots> peer_snapshots;
+
 protected:
 	static void _bind_methods();
 
@@ -74,6 +106,15 @@ protected:
 	void _process_rpc(Node *p_node, const uint16_t p_rpc_method_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_rset(Node *p_node, const uint16_t p_rpc_property_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_batch(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_snapshot(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_snapshot_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+	void _send_packet(int p_to, NetworkedMultiplayerPeer::TransferMode p_mode, const uint8_t *p_packet, int p_packet_len);
+	void _flush_batch(Batch &p_batch);
+	void _flush_batches();
+	void _send_snapshots();
+	PathSentCache *_get_path_send_cache(const NodePath &p_path);
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(Node *p_node, NodePath p_path, PathSentCache *psc, int p_target);
@@ -88,6 +129,9 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_BATCH,
+		NETWORK_COMMAND_SNAPSHOT,
+		NETWORK_COMMAND_SNAPSHOT_ACK,
 	};
 
 	enum NetworkNodeIdCompression {
@@ -141,6 +185,12 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void set_rpc_batching(bool p_enable);
+	bool is_rpc_batching() const;
+
+	void replicate(Node *p_node, const Vector<String> &p_properties, real_t p_quantization = 0);
+	void stop_replicating(Node *p_node);
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
@@ -101,6 +101,8 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	uint32_t pack_flags = 0;
 	if (enc_dir) {
 		pack_flags |= PACK_DIR_ENCRYPTED;
+	} else {
+		pack_flags |= PACK_DIR_INDEX;
 	}
 	file->store_32(pack_flags); // flags
 
@@ -267,6 +269,30 @@ Error PCKPacker::flush(bool p_verbose) {
 		printf("\n");
 	}
 
+	if (!enc_dir) {
+		// Directory index, the file table above is kept for older versions.
+		int index_pad = _get_pad(8, file->get_position());
+		for (int i = 0; i < index_pad; i++) {
+			file->store_8(0);
+		}
+
+		Vector<PackedData::IndexedFile> indexed;
+		indexed.resize(files.size());
+		for (int i = 0; i < files.size(); i++) {
+			PackedData::IndexedFile &idx = indexed.write[i];
+			idx.path = files[i].path.utf8();
+			idx.offset = files[i].ofs;
+			idx.size = files[i].size;
+			memcpy(idx.md5, files[i].md5.ptr(), 16);
+			idx.flags = files[i].encrypted ? PACK_FILE_ENCRYPTED : 0;
+		}
+
+		int64_t index_ofs = file->get_position();
+		PackedData::store_index(file, indexed);
+		file->seek(file_base_ofs + 8);
+		file->store_64(index_ofs); // first reserved fields
+	}
+
 	file->close();
 	memdelete_arr(buf);
 
@@ -112,8 +112,13 @@ StringName ResourceLoaderBinary::_get_string() {
 		if (len == 0) {
 			return StringName();
 		}
-		f->get_buffer((uint8_t *)&str_buf[0], len);
 		String s;
+		const uint8_t *mapped = f->get_mapped_buffer(len);
+		if (mapped) {
+			s.parse_utf8((const char *)mapped, len);
+			return s;
+		}
+		f->get_buffer((uint8_t *)&str_buf[0], len);
 		s.parse_utf8(&str_buf[0]);
 		return s;
 	}
@@ -315,7 +320,16 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					uint32_t index = f->get_32();
 					String path = res_path + "::" + itos(index);
 
-					if (use_nocache) {
+					if (lazy) {
+						RES res = _load_internal_resource(path);
+						if (error != OK) {
+							return error;
+						}
+						if (res.is_null()) {
+							WARN_PRINT(String("Couldn't load resource: " + path).utf8().get_data());
+						}
+						r_v = res;
+					} else if (use_nocache) {
 						if (!internal_index_cache.has(path)) {
 							WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						}
@@ -362,7 +376,19 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					} else {
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
-							if (use_sub_threads) {
+							if (lazy) {
+								// Lazy loads only bring in the dependencies actually referenced.
+								external_resources.write[erindex].cache = ResourceLoader::load(external_resources[erindex].path, external_resources[erindex].type);
+
+								if (external_resources[erindex].cache.is_null()) {
+									if (!ResourceLoader::get_abort_on_missing_resources()) {
+										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
+									} else {
+										error = ERR_FILE_MISSING_DEPENDENCIES;
+										ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[erindex].path + ".");
+									}
+								}
+							} else if (use_sub_threads) {
 								Error err;
 								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
 
@@ -613,13 +639,7 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
-Error ResourceLoaderBinary::load() {
-	if (error != OK) {
-		return error;
-	}
-
-	int stage = 0;
-
+Error ResourceLoaderBinary::_load_external_resources() {
 	for (int i = 0; i < external_resources.size(); i++) {
 		String path = external_resources[i].path;
 
@@ -634,7 +654,9 @@ Error ResourceLoaderBinary::load() {
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
 
-		if (!use_sub_threads) {
+		if (lazy) {
+			// Loaded when first referenced, see parse_variant().
+		} else if (!use_sub_threads) {
 			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
 
 			if (external_resources[i].cache.is_null()) {
@@ -657,8 +679,105 @@ Error ResourceLoaderBinary::load() {
 				}
 			}
 		}
+	}
+
+	return OK;
+}
+
+Error ResourceLoaderBinary::_parse_internal_resource(int p_index, const String &p_path, int p_subindex, bool p_main, RES &r_res) {
+	uint64_t offset = internal_resources[p_index].offset;
+
+	f->seek(offset);
+
+	String t = get_unicode_string();
+
+	Object *obj = ClassDB::instance(t);
+	if (!obj) {
+		error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+	}
+
+	Resource *r = Object::cast_to<Resource>(obj);
+	if (!r) {
+		String obj_class = obj->get_class();
+		error = ERR_FILE_CORRUPT;
+		memdelete(obj); //bye
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+	}
+
+	RES res = RES(r);
+
+	if (p_path != String()) {
+		r->set_path(p_path);
+	}
+	r->set_subindex(p_subindex);
+
+	if (!p_main) {
+		internal_index_cache[p_path] = res;
+	}
+
+	int pc = f->get_32();
+
+	//set properties
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+
+		Variant value;
+
+		error = parse_variant(value);
+		if (error) {
+			return error;
+		}
+
+		res->set(name, value);
+	}
+#ifdef TOOLS_ENABLED
+	res->set_edited(false);
+#endif
+
+	resource_cache.push_back(res);
+	r_res = res;
+
+	return OK;
+}
+
+RES ResourceLoaderBinary::_load_internal_resource(const String &p_path) {
+	if (internal_index_cache.has(p_path)) {
+		return internal_index_cache[p_path];
+	}
+	if (!use_nocache && ResourceCache::has(p_path)) {
+		return RES(ResourceCache::get(p_path));
+	}
+
+	const LazyResource *lr = lazy_resources.getptr(p_path);
+	if (!lr) {
+		return RES();
+	}
+
+	// Parsed in the middle of another resource, so resume where it was.
+	uint64_t pos = f->get_position();
+	RES res;
+	if (_parse_internal_resource(lr->index, p_path, lr->subindex, false, res) != OK) {
+		return RES();
+	}
+	f->seek(pos);
+
+	return res;
+}
+
+Error ResourceLoaderBinary::load() {
+	if (error != OK) {
+		return error;
+	}
 
-		stage++;
+	if (_load_external_resources() != OK) {
+		return error;
 	}
 
 	for (int i = 0; i < internal_resources.size(); i++) {
@@ -680,7 +799,6 @@ Error ResourceLoaderBinary::load() {
 			if (!use_nocache) {
 				if (ResourceCache::has(path)) {
 					//already loaded, don't do anything
-					stage++;
 					error = OK;
 					continue;
 				}
@@ -691,69 +809,15 @@ Error ResourceLoaderBinary::load() {
 			}
 		}
 
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
-
-		Object *obj = ClassDB::instance(t);
-		if (!obj) {
-			error = ERR_FILE_CORRUPT;
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-		}
-
-		Resource *r = Object::cast_to<Resource>(obj);
-		if (!r) {
-			String obj_class = obj->get_class();
-			error = ERR_FILE_CORRUPT;
-			memdelete(obj); //bye
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+		RES res;
+		if (_parse_internal_resource(i, path, subindex, main, res) != OK) {
+			return error;
 		}
 
-		RES res = RES(r);
-
-		if (path != String()) {
-			r->set_path(path);
-		}
-		r->set_subindex(subindex);
-
-		if (!main) {
-			internal_index_cache[path] = res;
-		}
-
-		int pc = f->get_32();
-
-		//set properties
-
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
-
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
-			Variant value;
-
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
-
-			res->set(name, value);
-		}
-#ifdef TOOLS_ENABLED
-		res->set_edited(false);
-#endif
-		stage++;
-
 		if (progress) {
 			*progress = (i + 1) / float(internal_resources.size());
 		}
 
-		resource_cache.push_back(res);
-
 		if (main) {
 			f->close();
 			resource = res;
@@ -766,6 +830,47 @@ Error ResourceLoaderBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+Error ResourceLoaderBinary::load_sub_resource(const String &p_path) {
+	if (error != OK) {
+		return error;
+	}
+
+	lazy = true;
+
+	// Only the offset table is known up front, resources are parsed when first referenced.
+	for (int i = 0; i < internal_resources.size() - 1; i++) {
+		String path = internal_resources[i].path;
+		if (!path.begins_with("local://")) {
+			continue;
+		}
+		path = path.replace_first("local://", "");
+
+		LazyResource lr;
+		lr.index = i;
+		lr.subindex = path.to_int();
+		lazy_resources[res_path + "::" + path] = lr;
+	}
+
+	if (_load_external_resources() != OK) {
+		return error;
+	}
+
+	RES res = _load_internal_resource(p_path);
+	if (error != OK) {
+		return error;
+	}
+	f->close();
+
+	ERR_FAIL_COND_V_MSG(res.is_null(), ERR_FILE_NOT_FOUND, "Sub-resource not found in file: " + p_path + ".");
+
+	resource = res;
+	if (progress) {
+		*progress = 1.0;
+	}
+
+	return OK;
+}
+
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -788,14 +893,19 @@ static String get_ustring(FileAccess *f) {
 
 String ResourceLoaderBinary::get_unicode_string() {
 	int len = f->get_32();
-	if (len > str_buf.size()) {
-		str_buf.resize(len);
-	}
 	if (len == 0) {
 		return String();
 	}
-	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
+	const uint8_t *mapped = f->get_mapped_buffer(len);
+	if (mapped) {
+		s.parse_utf8((const char *)mapped, len);
+		return s;
+	}
+	if (len > str_buf.size()) {
+		str_buf.resize(len);
+	}
+	f->get_buffer((uint8_t *)&str_buf[0], len);
 	s.parse_utf8(&str_buf[0]);
 	return s;
 }
@@ -968,22 +1078,38 @@ RES ResourceFormatLoaderBinary::load(const String &p_path, const String &p_origi
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	// "file.res::N" paths load a single sub-resource, parsing only what it references.
+	String file_path = p_path;
+	String subname;
+	int sub_sep = file_path.find("::");
+	if (sub_sep != -1) {
+		subname = file_path.substr(sub_sep + 2, file_path.length());
+		file_path = file_path.substr(0, sub_sep);
+	}
+
 	Error err;
-	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
+	FileAccess *f = FileAccess::open(file_path, FileAccess::READ, &err);
 
-	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + p_path + "'.");
+	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + file_path + "'.");
 
 	ResourceLoaderBinary loader;
 	loader.use_nocache = p_no_cache;
 	loader.use_sub_threads = p_use_sub_threads;
 	loader.progress = r_progress;
 	String path = p_original_path != "" ? p_original_path : p_path;
+	if (path.find("::") != -1) {
+		path = path.substr(0, path.find("::"));
+	}
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
 	loader.res_path = loader.local_path;
 	//loader.set_local_path( Globals::get_singleton()->localize_path(p_path) );
 	loader.open(f);
 
-	err = loader.load();
+	if (subname != String()) {
+		err = loader.load_sub_resource(loader.res_path + "::" + subname);
+	} else {
+		err = loader.load();
+	}
 
 	if (r_error) {
 		*r_error = err;
@@ -995,6 +1121,15 @@ RES ResourceFormatLoaderBinary::load(const String &p_path, const String &p_origi
 	return loader.resource;
 }
 
+bool ResourceFormatLoaderBinary::recognize_path(const String &p_path, const String &p_for_type) const {
+	int sub_sep = p_path.find("::");
+	if (sub_sep != -1) {
+		// Sub-resource of a binary file, the type hint applies to the sub-resource only.
+		return ResourceFormatLoader::recognize_path(p_path.substr(0, sub_sep));
+	}
+	return ResourceFormatLoader::recognize_path(p_path, p_for_type);
+}
+
 void ResourceFormatLoaderBinary::get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const {
 	if (p_type == "") {
 		get_recognized_extensions(p_extensions);
@@ -1666,6 +1801,9 @@ void ResourceFormatSaverBinaryInstance::_find_resources(const Variant &p_variant
 				return;
 			}
 
+			// Added before its properties so cyclic references don't recurse forever.
+			resource_set.insert(res);
+
 			List<PropertyInfo> property_list;
 
 			res->get_property_list(&property_list);
@@ -1689,7 +1827,6 @@ void ResourceFormatSaverBinaryInstance::_find_resources(const Variant &p_variant
 				}
 			}
 
-			resource_set.insert(res);
 			saved_resources.push_back(res);
 
 		} break;
@@ -31,6 +31,7 @@
 #ifndef RESOURCE_FORMAT_BINARY_H
 #define RESOURCE_FORMAT_BINARY_H
 
+#include "core/hash_map.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/os/file_access.h"
@@ -72,6 +73,15 @@ class ResourceLoaderBinary {
 	Vector<IntResource> internal_resources;
 	Map<String, RES> internal_index_cache;
 
+	struct LazyResource {
+		int index = 0;
+		int subindex = 0;
+	};
+
+	// Set when loading a single sub-resource, see load_sub_resource().
+	bool lazy = false;
+	HashMap<String, LazyResource> lazy_resources;
+
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
 
@@ -84,12 +94,17 @@ class ResourceLoaderBinary {
 
 	Error parse_variant(Variant &r_v);
 
+	Error _load_external_resources();
+	Error _parse_internal_resource(int p_index, const String &p_path, int p_subindex, bool p_main, RES &r_res);
+	RES _load_internal_resource(const String &p_path);
+
 	Map<String, RES> dependency_cache;
 
 public:
 	void set_local_path(const String &p_local_path);
 	Ref<Resource> get_resource();
 	Error load();
+	Error load_sub_resource(const String &p_path);
 	void set_translation_remapped(bool p_remapped);
 
 	void set_remaps(const Map<String, String> &p_remaps) { remaps = p_remaps; }
@@ -104,6 +119,7 @@ public:
 class ResourceFormatLoaderBinary : public ResourceFormatLoader {
 public:
 	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, bool p_no_cache = false);
+	virtual bool recognize_path(const String &p_path, const String &p_for_type = String()) const;
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
 	virtual bool handles_type(const String &p_type) const;
@@ -206,14 +206,39 @@ RES ResourceLoader::_load(const String &p_path, const String &p_original_path, c
 	ERR_FAIL_V_MSG(RES(), "No loader found for resource: " + p_path + ".");
 }
 
+void ResourceLoader::_thread_load_worker(void *p_userdata) {
+	thread_load_mutex->lock();
+	while (!thread_load_exit) {
+		if (thread_load_queue.empty()) {
+			// Whoever posts the semaphore takes this worker off the idle count.
+			thread_load_idle_count++;
+			thread_load_mutex->unlock();
+			thread_load_semaphore->wait();
+			thread_load_mutex->lock();
+			continue;
+		}
+
+		String path = thread_load_queue.front()->get();
+		thread_load_queue.pop_front();
+
+		// The task may have been loaded by a thread waiting on it in the meantime.
+		ThreadLoadTask *load_task = thread_load_tasks.getptr(path);
+		if (!load_task || load_task->started) {
+			continue;
+		}
+		load_task->started = true;
+
+		thread_load_mutex->unlock();
+		_thread_load_function(load_task);
+		thread_load_mutex->lock();
+	}
+	thread_load_mutex->unlock();
+}
+
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
 	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok fom semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
-	}
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, false, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
@@ -225,15 +250,7 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
-
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("END: " + load_task.local_path + " / queued: " + itos(thread_load_queue.size()) + " / workers: " + itos(thread_load_workers.size()) + " / idle: " + itos(thread_load_idle_count));
 
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
@@ -253,7 +270,8 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 
 		load_task.resource->set_edited(false);
 		if (timestamp_on_load) {
-			uint64_t mt = FileAccess::get_modified_time(load_task.remapped_path);
+			// Sub-resources ("file.res::N") take the time of their file.
+			uint64_t mt = FileAccess::get_modified_time(load_task.remapped_path.get_slice("::", 0));
 			//printf("mt %s: %lli\n",remapped_path.utf8().get_data(),mt);
 			load_task.resource->set_last_modified_time(mt);
 		}
@@ -357,17 +375,18 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	if (load_task.resource.is_null()) { //needs  to be loaded in thread
 
 		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
+		thread_load_queue.push_back(local_path);
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		// Wake an idle worker not already woken for another request, or grow the pool.
+		// When every worker is busy, the first one done picks the request from the queue.
+		if (thread_load_idle_count > 0) {
+			thread_load_idle_count--;
+			thread_load_semaphore->post();
+		} else if (thread_load_workers.size() < thread_load_max) {
+			thread_load_workers.push_back(Thread::create(_thread_load_worker, nullptr));
+		}
 
-		load_task.thread = Thread::create(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		print_lt("REQUEST: " + local_path + " / queued: " + itos(thread_load_queue.size()) + " / workers: " + itos(thread_load_workers.size()) + " / idle: " + itos(thread_load_idle_count));
 	}
 
 	thread_load_mutex->unlock();
@@ -444,36 +463,26 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	//semaphore still exists, meaning its still loading, request poll
 	Semaphore *semaphore = load_task.semaphore;
 	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "echange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
+		if (!load_task.started) {
+			// No worker picked it up yet, so load it here instead of blocking.
+			// Waiting only ever happens on tasks already running, so a pool
+			// full of waiting threads can't stall the loading.
+			load_task.started = true;
 
-			thread_suspended_count++;
+			print_lt("GET (loading in caller): " + local_path);
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+			thread_load_mutex->unlock();
+			_thread_load_function(&load_task);
+			thread_load_mutex->lock();
+		} else {
+			load_task.poll_requests++;
 
-		thread_load_mutex->unlock();
-		semaphore->wait();
-		thread_load_mutex->lock();
+			print_lt("GET (waiting): " + local_path);
 
-		thread_suspended_count--;
+			thread_load_mutex->unlock();
+			semaphore->wait();
+			thread_load_mutex->lock();
+		}
 
 		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
 			thread_load_mutex->unlock();
@@ -492,10 +501,6 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			Thread::wait_to_finish(load_task.thread);
-			memdelete(load_task.thread);
-		}
 		thread_load_tasks.erase(local_path);
 	}
 
@@ -605,7 +610,7 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 
 		res->set_edited(false);
 		if (timestamp_on_load) {
-			uint64_t mt = FileAccess::get_modified_time(path);
+			uint64_t mt = FileAccess::get_modified_time(path.get_slice("::", 0));
 			//printf("mt %s: %lli\n",remapped_path.utf8().get_data(),mt);
 			res->set_last_modified_time(mt);
 		}
@@ -1106,13 +1111,25 @@ void ResourceLoader::remove_custom_loaders() {
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
 	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
+	thread_load_idle_count = 0;
+	thread_load_exit = false;
 	thread_load_semaphore = memnew(Semaphore);
 }
 
 void ResourceLoader::finalize() {
+	thread_load_mutex->lock();
+	thread_load_exit = true;
+	thread_load_mutex->unlock();
+	for (int i = 0; i < thread_load_workers.size(); i++) {
+		thread_load_semaphore->post();
+	}
+	for (int i = 0; i < thread_load_workers.size(); i++) {
+		Thread::wait_to_finish(thread_load_workers[i]);
+		memdelete(thread_load_workers[i]);
+	}
+	thread_load_workers.clear();
+	thread_load_queue.clear();
+
 	memdelete(thread_load_mutex);
 	memdelete(thread_load_semaphore);
 }
@@ -1130,10 +1147,11 @@ Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
 Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
 
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
+List<String> ResourceLoader::thread_load_queue;
+Vector<Thread *> ResourceLoader::thread_load_workers;
+int ResourceLoader::thread_load_idle_count = 0;
 int ResourceLoader::thread_load_max = 0;
+bool ResourceLoader::thread_load_exit = false;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
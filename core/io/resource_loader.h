@@ -106,7 +106,6 @@ private:
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
 		Thread::ID loader_id = 0;
 		Semaphore *semaphore = nullptr;
 		String local_path;
@@ -118,20 +117,23 @@ private:
 		RES resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		bool started = false;
 		int requests = 0;
 		int poll_requests = 0;
 		Set<String> sub_tasks;
 	};
 
 	static void _thread_load_function(void *p_userdata);
+	static void _thread_load_worker(void *p_userdata);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
+	// Bounded pool of loading threads, spawned on demand up to thread_load_max.
 	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
+	static List<String> thread_load_queue;
+	static Vector<Thread *> thread_load_workers;
+	static int thread_load_idle_count; // Idle workers not woken yet.
 	static int thread_load_max;
+	static bool thread_load_exit;
 
 	static float _dependency_get_progress(const String &p_path);
 
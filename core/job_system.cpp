@@ -0,0 +1,444 @@
+/*************************************************************************/
+/*  job_system.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "job_system.h"
+
+#include "core/os/os.h"
+
+JobSystem *JobSystem::singleton = nullptr;
+
+static thread_local JobSystem *current_job_system = nullptr;
+static thread_local int current_worker = -1;
+
+/* TASK QUEUE */
+
+void JobSystem::TaskQueue::push(Job *p_job, uint32_t p_count) {
+	lock.lock();
+	for (uint32_t i = 0; i < p_count; i++) {
+		tasks.push_back(p_job);
+	}
+	lock.unlock();
+}
+
+bool JobSystem::TaskQueue::pop_back(Job *&r_job) {
+	lock.lock();
+	if (head == tasks.size()) {
+		lock.unlock();
+		return false;
+	}
+	r_job = tasks[tasks.size() - 1];
+	tasks.resize(tasks.size() - 1);
+	if (head == tasks.size()) {
+		tasks.clear();
+		head = 0;
+	}
+	lock.unlock();
+	return true;
+}
+
+bool JobSystem::TaskQueue::pop_front(Job *&r_job) {
+	lock.lock();
+	if (head == tasks.size()) {
+		lock.unlock();
+		return false;
+	}
+	r_job = tasks[head++];
+	if (head == tasks.size()) {
+		tasks.clear();
+		head = 0;
+	}
+	lock.unlock();
+	return true;
+}
+
+/* HANDLE */
+
+void JobSystem::Handle::_ref(JobSystem *p_job_system, Job *p_job) {
+	if (p_job) {
+		p_job->refcount.fetch_add(1, std::memory_order_relaxed);
+	}
+	job_system = p_job_system;
+	job = p_job;
+}
+
+void JobSystem::Handle::_unref() {
+	if (job) {
+		job_system->_unref_job(job);
+	}
+	job_system = nullptr;
+	job = nullptr;
+}
+
+bool JobSystem::Handle::is_completed() const {
+	ERR_FAIL_COND_V(!job, true);
+	return job->completed.load(std::memory_order_acquire);
+}
+
+uint32_t JobSystem::Handle::get_completed_elements() const {
+	ERR_FAIL_COND_V(!job, 0);
+	return job->completed_elements.load(std::memory_order_relaxed);
+}
+
+uint32_t JobSystem::Handle::get_element_count() const {
+	ERR_FAIL_COND_V(!job, 0);
+	return job->elements;
+}
+
+void JobSystem::Handle::wait() const {
+	ERR_FAIL_COND(!job);
+	job_system->_wait(job);
+}
+
+void JobSystem::Handle::operator=(const Handle &p_handle) {
+	if (job == p_handle.job) {
+		return;
+	}
+	_unref();
+	_ref(p_handle.job_system, p_handle.job);
+}
+
+JobSystem::Handle::Handle(const Handle &p_handle) {
+	_ref(p_handle.job_system, p_handle.job);
+}
+
+JobSystem::Handle::~Handle() {
+	_unref();
+}
+
+/* JOB SYSTEM */
+
+int JobSystem::_get_caller_queue() const {
+	return current_job_system == this ? current_worker : -1;
+}
+
+bool JobSystem::is_worker_thread() const {
+	return _get_caller_queue() >= 0;
+}
+
+JobSystem::Job *JobSystem::_alloc_job() {
+	free_lock.lock();
+	Job *job = free_jobs;
+	if (job) {
+		free_jobs = job->next_free;
+	} else {
+		job = memnew(Job);
+		all_jobs.push_back(job);
+	}
+	free_lock.unlock();
+
+	job->next_free = nullptr;
+	return job;
+}
+
+void JobSystem::_free_job(Job *p_job) {
+	free_lock.lock();
+	p_job->next_free = free_jobs;
+	free_jobs = p_job;
+	free_lock.unlock();
+}
+
+void JobSystem::_unref_job(Job *p_job) {
+	if (p_job->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		_free_job(p_job);
+	}
+}
+
+JobSystem::Handle JobSystem::_submit(Job *p_job, uint32_t p_elements, const Handle *p_dependencies, uint32_t p_dependency_count) {
+	p_job->elements = p_elements;
+	p_job->index.store(0, std::memory_order_relaxed);
+	p_job->completed_elements.store(0, std::memory_order_relaxed);
+	p_job->completed.store(false, std::memory_order_relaxed);
+	// One reference for the returned handle, one held until completion.
+	p_job->refcount.store(2, std::memory_order_relaxed);
+	// The extra dependency keeps the job from being dispatched while still registering.
+	p_job->pending_dependencies.store(p_dependency_count + 1, std::memory_order_release);
+
+	for (uint32_t i = 0; i < p_dependency_count; i++) {
+		Job *dependency = p_dependencies[i].job;
+		if (dependency) {
+			dependency->continuation_lock.lock();
+			if (!dependency->completed.load(std::memory_order_acquire)) {
+				dependency->continuations.push_back(p_job);
+				dependency->continuation_lock.unlock();
+				continue;
+			}
+			dependency->continuation_lock.unlock();
+		}
+		p_job->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	Handle handle;
+	handle.job_system = this;
+	handle.job = p_job;
+
+	if (p_job->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		_dispatch(p_job);
+	}
+
+	return handle;
+}
+
+JobSystem::Handle JobSystem::add_native_group_job(uint32_t p_elements, void (*p_function)(void *, uint32_t), void *p_userdata, const Handle *p_dependencies, uint32_t p_dependency_count) {
+	Job *job = _alloc_job();
+	NativeWork *w = _construct_work<NativeWork>(job);
+	w->function = p_function;
+	w->userdata = p_userdata;
+	return _submit(job, p_elements, p_dependencies, p_dependency_count);
+}
+
+void JobSystem::_dispatch(Job *p_job) {
+	if (p_job->elements == 0) {
+		_complete(p_job);
+		return;
+	}
+
+	if (thread_count == 0) {
+		// No workers, run right away on the submitting thread.
+		p_job->refcount.fetch_add(1, std::memory_order_relaxed);
+		_run_task(p_job);
+		return;
+	}
+
+	// No point in queuing more tasks than threads that can take them.
+	uint32_t tasks = MIN(p_job->elements, thread_count);
+	p_job->refcount.fetch_add(tasks, std::memory_order_relaxed);
+
+	queued_tasks.fetch_add(tasks);
+	_get_queue(_get_caller_queue()).push(p_job, tasks);
+
+	if (idle_threads.load() > 0 || waiting_threads.load() > 0) {
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		if (tasks > 1) {
+			sleep_cond.notify_all();
+		} else {
+			sleep_cond.notify_one();
+		}
+	}
+}
+
+void JobSystem::_run_task(Job *p_job) {
+	while (true) {
+		uint32_t index = p_job->index.fetch_add(1, std::memory_order_relaxed);
+		if (index >= p_job->elements) {
+			break;
+		}
+		p_job->work->work(index);
+		if (p_job->completed_elements.fetch_add(1, std::memory_order_acq_rel) + 1 == p_job->elements) {
+			_complete(p_job);
+		}
+	}
+	_unref_job(p_job);
+}
+
+void JobSystem::_complete(Job *p_job) {
+	p_job->work->~BaseWork();
+	p_job->work = nullptr;
+
+	// Sequentially consistent with the waiters incrementing waiting_threads and then
+	// checking completed: either they see it set, or it sees them and wakes them up.
+	p_job->continuation_lock.lock();
+	p_job->completed.store(true, std::memory_order_seq_cst);
+	p_job->continuation_lock.unlock();
+
+	// Nothing can be added to the continuations anymore, it's safe to walk them unlocked.
+	for (uint32_t i = 0; i < p_job->continuations.size(); i++) {
+		Job *continuation = p_job->continuations[i];
+		if (continuation->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			_dispatch(continuation);
+		}
+	}
+	p_job->continuations.clear();
+
+	if (waiting_threads.load() > 0) {
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		sleep_cond.notify_all();
+	}
+
+	_unref_job(p_job);
+}
+
+bool JobSystem::_try_run_one_task(int p_queue) {
+	Job *job = nullptr;
+	bool found = p_queue >= 0 && queues[p_queue].pop_back(job);
+
+	if (!found) {
+		found = injection_queue.pop_front(job);
+	}
+
+	for (uint32_t i = 0; !found && i < thread_count; i++) {
+		// Steal, starting from the next worker so thieves spread out.
+		uint32_t victim = (p_queue + 1 + i) % thread_count;
+		if (int(victim) != p_queue) {
+			found = queues[victim].pop_front(job);
+		}
+	}
+
+	if (!found) {
+		return false;
+	}
+
+	queued_tasks.fetch_sub(1);
+	_run_task(job);
+	return true;
+}
+
+void JobSystem::_wait(Job *p_job) {
+	int queue = _get_caller_queue();
+
+	while (!p_job->completed.load(std::memory_order_acquire)) {
+		if (p_job->pending_dependencies.load(std::memory_order_acquire) == 0 && p_job->index.load(std::memory_order_relaxed) < p_job->elements) {
+			// Help with the job itself first.
+			p_job->refcount.fetch_add(1, std::memory_order_relaxed);
+			_run_task(p_job);
+			continue;
+		}
+
+		// Workers keep running other tasks while they wait, other threads should
+		// not pick up unrelated (and possibly long) work.
+		if (queue >= 0 && _try_run_one_task(queue)) {
+			continue;
+		}
+
+		waiting_threads.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			while (!p_job->completed.load(std::memory_order_seq_cst) && (queue < 0 || queued_tasks.load() == 0)) {
+				if (queue < 0 && p_job->pending_dependencies.load(std::memory_order_acquire) == 0 && p_job->index.load(std::memory_order_relaxed) < p_job->elements) {
+					break; // Became runnable, go help.
+				}
+				sleep_cond.wait(lock);
+			}
+		}
+		waiting_threads.fetch_sub(1);
+	}
+}
+
+void JobSystem::wait(const Handle &p_handle) {
+	ERR_FAIL_COND(!p_handle.job);
+	_wait(p_handle.job);
+}
+
+void JobSystem::_thread_function(JobSystem *p_job_system, uint32_t p_index) {
+	current_job_system = p_job_system;
+	current_worker = p_index;
+
+	while (!p_job_system->exit.load()) {
+		if (p_job_system->_try_run_one_task(p_index)) {
+			continue;
+		}
+
+		p_job_system->idle_threads.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(p_job_system->sleep_mutex);
+			while (!p_job_system->exit.load() && p_job_system->queued_tasks.load() == 0) {
+				p_job_system->sleep_cond.wait(lock);
+			}
+		}
+		p_job_system->idle_threads.fetch_sub(1);
+	}
+
+	current_job_system = nullptr;
+	current_worker = -1;
+}
+
+void JobSystem::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0) {
+		// Leave a core for the main thread, which helps with what it waits for.
+		p_thread_count = MAX(1, OS::get_singleton()->get_processor_count() - 1);
+	}
+#endif
+
+	if (p_thread_count == 0) {
+		return;
+	}
+
+	exit.store(false);
+	queues = memnew_arr(TaskQueue, p_thread_count);
+	threads = memnew_arr(std::thread, p_thread_count);
+	thread_count = p_thread_count;
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i] = std::thread(JobSystem::_thread_function, this, i);
+	}
+}
+
+void JobSystem::finish() {
+	if (threads == nullptr) {
+		return;
+	}
+
+	// Run whatever is still queued, nobody may be waiting on it but it still owns references.
+	while (_try_run_one_task(-1)) {
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		exit.store(true);
+		sleep_cond.notify_all();
+	}
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].join();
+	}
+
+	memdelete_arr(threads);
+	threads = nullptr;
+	memdelete_arr(queues);
+	queues = nullptr;
+	thread_count = 0;
+}
+
+JobSystem::JobSystem() {
+	// Extra instances (e.g. in tests) don't replace the engine-wide one.
+	if (!singleton) {
+		singleton = this;
+	}
+	queued_tasks.store(0);
+	idle_threads.store(0);
+	waiting_threads.store(0);
+	exit.store(false);
+}
+
+JobSystem::~JobSystem() {
+	finish();
+
+	for (uint32_t i = 0; i < all_jobs.size(); i++) {
+		memdelete(all_jobs[i]);
+	}
+
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
@@ -0,0 +1,246 @@
+/*************************************************************************/
+/*  job_system.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "core/local_vector.h"
+#include "core/os/memory.h"
+#include "core/spin_lock.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+// Persistent engine-wide pool of worker threads. Every worker owns a deque
+// of pending tasks: it pushes and pops at the back, while idle workers steal
+// from the front of the others. Threads that are not workers (main thread,
+// render thread, loader threads) submit to a shared injection queue.
+//
+// A job is either a single call or a group call (parallel for) over a range
+// of elements, may depend on other jobs (it is only queued once all of them
+// completed) and can be waited on through a Handle. Waiting helps running
+// queued tasks instead of blocking, so nested parallel fors from inside jobs
+// are fine and never oversubscribe the machine.
+//
+// Without worker threads (NO_THREADS or a thread count of 0) jobs run right
+// away on the thread that submits them, once their dependencies completed.
+
+class JobSystem {
+	struct BaseWork {
+		virtual void work(uint32_t p_index) = 0;
+		virtual ~BaseWork() = default;
+	};
+
+	template <class C, class M, class U>
+	struct GroupWork : public BaseWork {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void work(uint32_t p_index) {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct SingleWork : public BaseWork {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void work(uint32_t p_index) {
+			(instance->*method)(userdata);
+		}
+	};
+
+	struct NativeWork : public BaseWork {
+		void (*function)(void *, uint32_t);
+		void *userdata;
+		virtual void work(uint32_t p_index) {
+			function(userdata, p_index);
+		}
+	};
+
+	enum {
+		WORK_STORAGE_SIZE = 64,
+	};
+
+	struct Job {
+		// Work objects are constructed in place, so dispatching never allocates.
+		alignas(16) uint8_t work_storage[WORK_STORAGE_SIZE];
+		BaseWork *work = nullptr;
+
+		uint32_t elements = 0;
+		std::atomic<uint32_t> index;
+		std::atomic<uint32_t> completed_elements;
+		std::atomic<uint32_t> pending_dependencies;
+		std::atomic<uint32_t> refcount;
+		std::atomic<bool> completed;
+
+		SpinLock continuation_lock;
+		LocalVector<Job *> continuations;
+
+		Job *next_free = nullptr;
+	};
+
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Job *> tasks;
+		uint32_t head = 0;
+
+		void push(Job *p_job, uint32_t p_count);
+		bool pop_back(Job *&r_job);
+		bool pop_front(Job *&r_job);
+	};
+
+public:
+	class Handle {
+		friend class JobSystem;
+
+		JobSystem *job_system = nullptr;
+		Job *job = nullptr;
+
+		void _ref(JobSystem *p_job_system, Job *p_job);
+		void _unref();
+
+	public:
+		_FORCE_INLINE_ bool is_valid() const { return job != nullptr; }
+		bool is_completed() const;
+		uint32_t get_completed_elements() const;
+		uint32_t get_element_count() const;
+		void wait() const;
+
+		void operator=(const Handle &p_handle);
+		Handle(const Handle &p_handle);
+		Handle() {}
+		~Handle();
+	};
+
+private:
+	static JobSystem *singleton;
+
+	TaskQueue *queues = nullptr; // One per worker.
+	TaskQueue injection_queue;
+
+	std::thread *threads = nullptr;
+	uint32_t thread_count = 0;
+
+	std::atomic<uint32_t> queued_tasks;
+	std::atomic<uint32_t> idle_threads;
+	std::atomic<uint32_t> waiting_threads;
+	std::atomic<bool> exit;
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_cond;
+
+	SpinLock free_lock;
+	Job *free_jobs = nullptr;
+	LocalVector<Job *> all_jobs;
+
+	static void _thread_function(JobSystem *p_job_system, uint32_t p_index);
+
+	_FORCE_INLINE_ TaskQueue &_get_queue(int p_index) { return p_index < 0 ? injection_queue : queues[p_index]; }
+	int _get_caller_queue() const;
+
+	Job *_alloc_job();
+	void _free_job(Job *p_job);
+	void _unref_job(Job *p_job);
+
+	Handle _submit(Job *p_job, uint32_t p_elements, const Handle *p_dependencies, uint32_t p_dependency_count);
+	void _dispatch(Job *p_job);
+	void _run_task(Job *p_job);
+	void _complete(Job *p_job);
+	bool _try_run_one_task(int p_queue);
+	void _wait(Job *p_job);
+
+	template <class W>
+	_FORCE_INLINE_ W *_construct_work(Job *p_job) {
+		static_assert(sizeof(W) <= WORK_STORAGE_SIZE, "Job userdata too big, pass it by pointer.");
+		W *w = new (p_job->work_storage) W;
+		p_job->work = w;
+		return w;
+	}
+
+public:
+	static JobSystem *get_singleton() { return singleton; }
+
+	// Calls (p_instance->*p_method)(p_userdata) once.
+	template <class C, class M, class U>
+	Handle add_job(C *p_instance, M p_method, U p_userdata, const Handle *p_dependencies = nullptr, uint32_t p_dependency_count = 0) {
+		Job *job = _alloc_job();
+		SingleWork<C, M, U> *w = _construct_work<SingleWork<C, M, U>>(job);
+		w->instance = p_instance;
+		w->method = p_method;
+		w->userdata = p_userdata;
+		return _submit(job, 1, p_dependencies, p_dependency_count);
+	}
+
+	// Calls (p_instance->*p_method)(index, p_userdata) for every index in [0, p_elements).
+	template <class C, class M, class U>
+	Handle add_group_job(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, const Handle *p_dependencies = nullptr, uint32_t p_dependency_count = 0) {
+		Job *job = _alloc_job();
+		GroupWork<C, M, U> *w = _construct_work<GroupWork<C, M, U>>(job);
+		w->instance = p_instance;
+		w->method = p_method;
+		w->userdata = p_userdata;
+		return _submit(job, p_elements, p_dependencies, p_dependency_count);
+	}
+
+	Handle add_native_group_job(uint32_t p_elements, void (*p_function)(void *, uint32_t), void *p_userdata, const Handle *p_dependencies = nullptr, uint32_t p_dependency_count = 0);
+
+	// Blocking group job, the calling thread takes part in the work.
+	template <class C, class M, class U>
+	void parallel_for(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+		if (p_elements == 0) {
+			return;
+		}
+		if (p_elements == 1 || thread_count == 0) {
+			for (uint32_t i = 0; i < p_elements; i++) {
+				(p_instance->*p_method)(i, p_userdata);
+			}
+			return;
+		}
+		Handle handle = add_group_job(p_elements, p_instance, p_method, p_userdata);
+		_wait(handle.job);
+	}
+
+	void wait(const Handle &p_handle);
+
+	uint32_t get_thread_count() const { return thread_count; }
+	bool is_worker_thread() const;
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	JobSystem();
+	~JobSystem();
+};
+
+#endif // JOB_SYSTEM_H
@@ -329,15 +329,13 @@ bool CameraMatrix::get_endpoints(const Transform &p_transform, Vector3 *p_8point
 	return true;
 }
 
-Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform) const {
+void CameraMatrix::get_projection_planes(const Transform &p_transform, Plane *p_6planes) const {
 	/** Fast Plane Extraction from combined modelview/projection matrices.
 	 * References:
 	 * https://web.archive.org/web/20011221205252/http://www.markmorley.com/opengl/frustumculling.html
 	 * https://web.archive.org/web/20061020020112/http://www2.ravensoft.com/users/ggribb/plane%20extraction.pdf
 	 */
 
-	Vector<Plane> planes;
-
 	const real_t *matrix = (const real_t *)this->matrix;
 
 	Plane new_plane;
@@ -351,7 +349,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[0] = p_transform.xform(new_plane);
 
 	///////--- Far Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[2],
@@ -362,7 +360,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[1] = p_transform.xform(new_plane);
 
 	///////--- Left Plane ---///////
 	new_plane = Plane(matrix[3] + matrix[0],
@@ -373,7 +371,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[2] = p_transform.xform(new_plane);
 
 	///////--- Top Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[1],
@@ -384,7 +382,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[3] = p_transform.xform(new_plane);
 
 	///////--- Right Plane ---///////
 	new_plane = Plane(matrix[3] - matrix[0],
@@ -395,7 +393,7 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[4] = p_transform.xform(new_plane);
 
 	///////--- Bottom Plane ---///////
 	new_plane = Plane(matrix[3] + matrix[1],
@@ -406,8 +404,13 @@ Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform)
 	new_plane.normal = -new_plane.normal;
 	new_plane.normalize();
 
-	planes.push_back(p_transform.xform(new_plane));
+	p_6planes[5] = p_transform.xform(new_plane);
+}
 
+Vector<Plane> CameraMatrix::get_projection_planes(const Transform &p_transform) const {
+	Vector<Plane> planes;
+	planes.resize(6);
+	get_projection_planes(p_transform, planes.ptrw());
 	return planes;
 }
 
@@ -71,6 +71,7 @@ struct CameraMatrix {
 	bool is_orthogonal() const;
 
 	Vector<Plane> get_projection_planes(const Transform &p_transform) const;
+	void get_projection_planes(const Transform &p_transform, Plane *p_6planes) const; // Near, far, left, top, right, bottom.
 
 	bool get_endpoints(const Transform &p_transform, Vector3 *p_8points) const;
 	Vector2 get_viewport_half_extents() const;
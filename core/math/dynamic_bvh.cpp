@@ -0,0 +1,301 @@
+/*************************************************************************/
+/*  dynamic_bvh.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "dynamic_bvh.h"
+
+uint32_t DynamicBVH::_alloc_node() {
+	uint32_t id;
+	if (free_list != INVALID_ID) {
+		id = free_list;
+		free_list = nodes[id].parent;
+	} else {
+		id = nodes.size();
+		nodes.resize(id + 1);
+	}
+
+	Node &node = nodes[id];
+	node.parent = INVALID_ID;
+	node.children[0] = INVALID_ID;
+	node.children[1] = INVALID_ID;
+	node.userdata = 0;
+	node.height = 0;
+	return id;
+}
+
+void DynamicBVH::_free_node(uint32_t p_node) {
+	nodes[p_node].height = -1;
+	nodes[p_node].parent = free_list;
+	free_list = p_node;
+}
+
+void DynamicBVH::_refit_upwards(uint32_t p_node) {
+	uint32_t index = p_node;
+	while (index != INVALID_ID) {
+		index = _balance(index);
+
+		Node &node = nodes[index];
+		const Node &child_a = nodes[node.children[0]];
+		const Node &child_b = nodes[node.children[1]];
+		node.height = 1 + MAX(child_a.height, child_b.height);
+		node.aabb = child_a.aabb.merge(child_b.aabb);
+
+		index = node.parent;
+	}
+}
+
+void DynamicBVH::_insert_leaf(uint32_t p_leaf) {
+	if (root == INVALID_ID) {
+		root = p_leaf;
+		nodes[root].parent = INVALID_ID;
+		return;
+	}
+
+	// Walk down picking the cheapest sibling (surface area heuristic).
+	const AABB leaf_aabb = nodes[p_leaf].aabb;
+	uint32_t index = root;
+	while (!nodes[index].is_leaf()) {
+		const Node &node = nodes[index];
+
+		real_t cost = _get_cost(node.aabb);
+		real_t combined_cost = _get_cost(node.aabb.merge(leaf_aabb));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		real_t new_parent_cost = 2.0 * combined_cost;
+		// Minimum cost of pushing the leaf further down the tree.
+		real_t inheritance_cost = 2.0 * (combined_cost - cost);
+
+		real_t child_costs[2];
+		for (int i = 0; i < 2; i++) {
+			const Node &child = nodes[node.children[i]];
+			real_t merged_cost = _get_cost(child.aabb.merge(leaf_aabb));
+			if (child.is_leaf()) {
+				child_costs[i] = merged_cost + inheritance_cost;
+			} else {
+				child_costs[i] = (merged_cost - _get_cost(child.aabb)) + inheritance_cost;
+			}
+		}
+
+		if (new_parent_cost < child_costs[0] && new_parent_cost < child_costs[1]) {
+			break;
+		}
+
+		index = child_costs[0] < child_costs[1] ? node.children[0] : node.children[1];
+	}
+
+	uint32_t sibling = index;
+	uint32_t old_parent = nodes[sibling].parent;
+	uint32_t new_parent = _alloc_node(); // May reallocate, don't hold references across.
+
+	Node &parent = nodes[new_parent];
+	parent.parent = old_parent;
+	parent.aabb = leaf_aabb.merge(nodes[sibling].aabb);
+	parent.height = nodes[sibling].height + 1;
+	parent.children[0] = sibling;
+	parent.children[1] = p_leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[p_leaf].parent = new_parent;
+
+	if (old_parent != INVALID_ID) {
+		Node &op = nodes[old_parent];
+		op.children[op.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+		root = new_parent;
+	}
+
+	_refit_upwards(nodes[p_leaf].parent);
+}
+
+void DynamicBVH::_remove_leaf(uint32_t p_leaf) {
+	if (p_leaf == root) {
+		root = INVALID_ID;
+		return;
+	}
+
+	uint32_t parent = nodes[p_leaf].parent;
+	uint32_t grand_parent = nodes[parent].parent;
+	uint32_t sibling = nodes[parent].children[0] == p_leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	if (grand_parent != INVALID_ID) {
+		Node &gp = nodes[grand_parent];
+		gp.children[gp.children[0] == parent ? 0 : 1] = sibling;
+		nodes[sibling].parent = grand_parent;
+		_free_node(parent);
+		_refit_upwards(grand_parent);
+	} else {
+		root = sibling;
+		nodes[sibling].parent = INVALID_ID;
+		_free_node(parent);
+	}
+}
+
+// Rotates the taller grandchild up if the subtree at p_node is imbalanced.
+// Returns the index of the new subtree root.
+uint32_t DynamicBVH::_balance(uint32_t p_node) {
+	uint32_t ia = p_node;
+	Node &a = nodes[ia];
+	if (a.is_leaf() || a.height < 2) {
+		return ia;
+	}
+
+	uint32_t ib = a.children[0];
+	uint32_t ic = a.children[1];
+	Node &b = nodes[ib];
+	Node &c = nodes[ic];
+
+	int32_t balance = c.height - b.height;
+
+	if (balance > 1) {
+		// Rotate C up.
+		uint32_t i_f = c.children[0];
+		uint32_t i_g = c.children[1];
+		Node &f = nodes[i_f];
+		Node &g = nodes[i_g];
+
+		c.children[0] = ia;
+		c.parent = a.parent;
+		a.parent = ic;
+
+		if (c.parent != INVALID_ID) {
+			Node &cp = nodes[c.parent];
+			cp.children[cp.children[0] == ia ? 0 : 1] = ic;
+		} else {
+			root = ic;
+		}
+
+		if (f.height > g.height) {
+			c.children[1] = i_f;
+			a.children[1] = i_g;
+			g.parent = ia;
+			a.aabb = b.aabb.merge(g.aabb);
+			c.aabb = a.aabb.merge(f.aabb);
+			a.height = 1 + MAX(b.height, g.height);
+			c.height = 1 + MAX(a.height, f.height);
+		} else {
+			c.children[1] = i_g;
+			a.children[1] = i_f;
+			f.parent = ia;
+			a.aabb = b.aabb.merge(f.aabb);
+			c.aabb = a.aabb.merge(g.aabb);
+			a.height = 1 + MAX(b.height, f.height);
+			c.height = 1 + MAX(a.height, g.height);
+		}
+
+		return ic;
+	}
+
+	if (balance < -1) {
+		// Rotate B up.
+		uint32_t i_d = b.children[0];
+		uint32_t i_e = b.children[1];
+		Node &d = nodes[i_d];
+		Node &e = nodes[i_e];
+
+		b.children[0] = ia;
+		b.parent = a.parent;
+		a.parent = ib;
+
+		if (b.parent != INVALID_ID) {
+			Node &bp = nodes[b.parent];
+			bp.children[bp.children[0] == ia ? 0 : 1] = ib;
+		} else {
+			root = ib;
+		}
+
+		if (d.height > e.height) {
+			b.children[1] = i_d;
+			a.children[0] = i_e;
+			e.parent = ia;
+			a.aabb = c.aabb.merge(e.aabb);
+			b.aabb = a.aabb.merge(d.aabb);
+			a.height = 1 + MAX(c.height, e.height);
+			b.height = 1 + MAX(a.height, d.height);
+		} else {
+			b.children[1] = i_e;
+			a.children[0] = i_d;
+			d.parent = ia;
+			a.aabb = c.aabb.merge(d.aabb);
+			b.aabb = a.aabb.merge(e.aabb);
+			a.height = 1 + MAX(c.height, d.height);
+			b.height = 1 + MAX(a.height, e.height);
+		}
+
+		return ib;
+	}
+
+	return ia;
+}
+
+DynamicBVH::ID DynamicBVH::insert(const AABB &p_aabb, uint32_t p_userdata) {
+	uint32_t leaf = _alloc_node();
+	nodes[leaf].aabb = p_aabb.grow(margin);
+	nodes[leaf].userdata = p_userdata;
+	_insert_leaf(leaf);
+	leaf_count++;
+	return leaf;
+}
+
+bool DynamicBVH::update(ID p_id, const AABB &p_aabb) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_id, nodes.size(), false);
+	ERR_FAIL_COND_V(!nodes[p_id].is_leaf() || nodes[p_id].height < 0, false);
+
+	const AABB &fat = nodes[p_id].aabb;
+	if (fat.encloses(p_aabb)) {
+		// Still inside, unless the box shrank so much the fat one is now wasteful.
+		AABB huge = p_aabb.grow(margin * 4.0);
+		if (huge.encloses(fat)) {
+			return false;
+		}
+	}
+
+	_remove_leaf(p_id);
+	nodes[p_id].aabb = p_aabb.grow(margin);
+	_insert_leaf(p_id);
+	return true;
+}
+
+void DynamicBVH::remove(ID p_id) {
+	ERR_FAIL_UNSIGNED_INDEX(p_id, nodes.size());
+	ERR_FAIL_COND(!nodes[p_id].is_leaf() || nodes[p_id].height < 0);
+
+	_remove_leaf(p_id);
+	_free_node(p_id);
+	leaf_count--;
+}
+
+void DynamicBVH::clear() {
+	nodes.reset();
+	root = INVALID_ID;
+	free_list = INVALID_ID;
+	leaf_count = 0;
+}
+
+int DynamicBVH::get_height() const {
+	return root == INVALID_ID ? 0 : nodes[root].height;
+}
@@ -0,0 +1,219 @@
+/*************************************************************************/
+/*  dynamic_bvh.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
+#include "core/math/plane.h"
+
+/*
+ * Dynamic AABB tree (in the spirit of Box2D's b2DynamicTree).
+ *
+ * Nodes live in a flat array and are recycled through a free list, so
+ * inserting, moving and removing leaves never allocates once the array
+ * has grown. Leaves store a fattened AABB: small movements that stay inside
+ * it don't touch the tree at all. Insertion picks the sibling with the
+ * lowest surface area cost and the tree is kept balanced with AVL-like
+ * rotations while refitting back up to the root.
+ *
+ * Queries are iterative and take a functor with the signature
+ * `bool operator()(uint32_t p_userdata)`; returning true stops the query.
+ * Since leaves are fattened, the functor must do its own exact test.
+ */
+
+class DynamicBVH {
+public:
+	enum {
+		INVALID_ID = 0xFFFFFFFF,
+	};
+
+	typedef uint32_t ID;
+
+private:
+	enum {
+		MAX_STACK = 128
+	};
+
+	struct Node {
+		AABB aabb;
+		uint32_t parent = INVALID_ID; // Next free node when in the free list.
+		uint32_t children[2] = { INVALID_ID, INVALID_ID };
+		uint32_t userdata = 0;
+		int32_t height = -1; // -1 for free nodes, 0 for leaves.
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == INVALID_ID; }
+	};
+
+	LocalVector<Node> nodes;
+	uint32_t root = INVALID_ID;
+	uint32_t free_list = INVALID_ID;
+	uint32_t leaf_count = 0;
+	real_t margin = 0.1;
+
+	uint32_t _alloc_node();
+	void _free_node(uint32_t p_node);
+	void _insert_leaf(uint32_t p_leaf);
+	void _remove_leaf(uint32_t p_leaf);
+	uint32_t _balance(uint32_t p_node);
+	void _refit_upwards(uint32_t p_node);
+
+	static _FORCE_INLINE_ real_t _get_cost(const AABB &p_aabb) {
+		// Half the surface area; it keeps flat and thin boxes comparable.
+		const Vector3 &s = p_aabb.size;
+		return s.x * s.y + s.y * s.z + s.z * s.x;
+	}
+
+	static _FORCE_INLINE_ bool _outside_planes(const AABB &p_aabb, const Plane *p_planes, int p_plane_count) {
+		const Vector3 half_extents = p_aabb.size * 0.5;
+		const Vector3 center = p_aabb.position + half_extents;
+		for (int i = 0; i < p_plane_count; i++) {
+			const Plane &p = p_planes[i];
+			real_t radius = Math::abs(p.normal.x * half_extents.x) + Math::abs(p.normal.y * half_extents.y) + Math::abs(p.normal.z * half_extents.z);
+			if (p.distance_to(center) > radius) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	// Returns the leaf ID, used to move and remove it later.
+	ID insert(const AABB &p_aabb, uint32_t p_userdata);
+	// Returns true if the leaf had to be reinserted (the new box left its fattened box).
+	bool update(ID p_id, const AABB &p_aabb);
+	void remove(ID p_id);
+	void clear();
+
+	_FORCE_INLINE_ uint32_t get_userdata(ID p_id) const { return nodes[p_id].userdata; }
+	_FORCE_INLINE_ const AABB &get_fat_aabb(ID p_id) const { return nodes[p_id].aabb; }
+	_FORCE_INLINE_ uint32_t get_leaf_count() const { return leaf_count; }
+	_FORCE_INLINE_ bool is_empty() const { return root == INVALID_ID; }
+	int get_height() const;
+
+	// Only affects leaves inserted or reinserted afterwards.
+	void set_margin(real_t p_margin) { margin = p_margin; }
+	real_t get_margin() const { return margin; }
+
+	template <class QueryResult>
+	void aabb_query(const AABB &p_aabb, QueryResult &r_result) const;
+	// Planes point outwards, as in a CameraMatrix frustum.
+	template <class QueryResult>
+	void convex_query(const Plane *p_planes, int p_plane_count, QueryResult &r_result) const;
+	template <class QueryResult>
+	void segment_query(const Vector3 &p_from, const Vector3 &p_to, QueryResult &r_result) const;
+
+	DynamicBVH() {}
+	~DynamicBVH() {}
+};
+
+template <class QueryResult>
+void DynamicBVH::aabb_query(const AABB &p_aabb, QueryResult &r_result) const {
+	if (root == INVALID_ID) {
+		return;
+	}
+
+	uint32_t stack[MAX_STACK];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (!node.aabb.intersects_inclusive(p_aabb)) {
+			continue;
+		}
+		if (node.is_leaf()) {
+			if (r_result(node.userdata)) {
+				return;
+			}
+		} else {
+			ERR_FAIL_COND(stack_size + 2 > MAX_STACK);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+}
+
+template <class QueryResult>
+void DynamicBVH::convex_query(const Plane *p_planes, int p_plane_count, QueryResult &r_result) const {
+	if (root == INVALID_ID) {
+		return;
+	}
+
+	uint32_t stack[MAX_STACK];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (_outside_planes(node.aabb, p_planes, p_plane_count)) {
+			continue;
+		}
+		if (node.is_leaf()) {
+			if (r_result(node.userdata)) {
+				return;
+			}
+		} else {
+			ERR_FAIL_COND(stack_size + 2 > MAX_STACK);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+}
+
+template <class QueryResult>
+void DynamicBVH::segment_query(const Vector3 &p_from, const Vector3 &p_to, QueryResult &r_result) const {
+	if (root == INVALID_ID) {
+		return;
+	}
+
+	uint32_t stack[MAX_STACK];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (!node.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+		if (node.is_leaf()) {
+			if (r_result(node.userdata)) {
+				return;
+			}
+		} else {
+			ERR_FAIL_COND(stack_size + 2 > MAX_STACK);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+}
+
+#endif // DYNAMIC_BVH_H
@@ -334,6 +334,7 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	int cull_convex(const Plane *p_convex, int p_convex_count, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1197,11 +1198,16 @@ void Octree<T, use_pairs, AL>::_cull_point(Octant *p_octant, const Vector3 &p_po
 
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) {
-	if (!root || p_convex.size() == 0) {
+	return cull_convex(p_convex.ptr(), p_convex.size(), p_result_array, p_result_max, p_mask);
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex(const Plane *p_convex, int p_convex_count, T **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (!root || p_convex_count == 0) {
 		return 0;
 	}
 
-	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(&p_convex[0], p_convex.size());
+	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(p_convex, p_convex_count);
 	if (convex_points.size() == 0) {
 		return 0;
 	}
@@ -1209,8 +1215,8 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	int result_count = 0;
 	pass++;
 	_CullConvexData cdata;
-	cdata.planes = &p_convex[0];
-	cdata.plane_count = p_convex.size();
+	cdata.planes = p_convex;
+	cdata.plane_count = p_convex_count;
 	cdata.points = &convex_points[0];
 	cdata.point_count = convex_points.size();
 	cdata.result_array = p_result_array;
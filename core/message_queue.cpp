@@ -36,10 +36,136 @@
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+static std::atomic<uint64_t> message_queue_instance_counter = { 0 };
+
+struct MessageQueueThreadOwner {
+	uint64_t instance_id = 0;
+	void *queue = nullptr;
+
+	~MessageQueueThreadOwner() {
+		// The queue is only released if it belongs to the current message queue, older ones already freed theirs.
+		MessageQueue *message_queue = MessageQueue::get_singleton();
+		if (queue && message_queue && message_queue->instance_id == instance_id) {
+			message_queue->_thread_exited((MessageQueue::ThreadQueue *)queue);
+		}
+	}
+};
+
+static thread_local MessageQueueThreadOwner message_queue_thread_owner;
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::ThreadQueue *MessageQueue::_get_thread_queue() {
+	if (likely(message_queue_thread_owner.instance_id == instance_id)) {
+		return (ThreadQueue *)message_queue_thread_owner.queue;
+	}
+
+	// First message pushed from this thread.
+	ThreadQueue *queue = memnew(ThreadQueue);
+	thread_queues_lock.lock();
+	thread_queues.push_back(queue);
+	thread_queues_lock.unlock();
+
+	message_queue_thread_owner.instance_id = instance_id;
+	message_queue_thread_owner.queue = queue;
+	return queue;
+}
+
+void MessageQueue::_thread_exited(ThreadQueue *p_queue) {
+	thread_queues_lock.lock();
+	p_queue->lock.lock();
+	bool empty = p_queue->first == nullptr;
+	p_queue->thread_exited = true;
+	p_queue->lock.unlock();
+
+	if (empty) {
+		thread_queues.erase(p_queue);
+		memdelete(p_queue);
+	}
+	thread_queues_lock.unlock();
+}
+
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_size) {
+	Page *page = nullptr;
+	if (p_size <= PAGE_SIZE) {
+		free_pages_lock.lock();
+		page = free_pages;
+		if (page) {
+			free_pages = page->next;
+		}
+		free_pages_lock.unlock();
+		p_size = PAGE_SIZE;
+	}
+
+	if (!page) {
+		page = (Page *)Memory::alloc_static(sizeof(Page) + p_size);
+		page->size = p_size;
+	}
+
+	page->next = nullptr;
+	page->used = 0;
+	return page;
+}
+
+void MessageQueue::_free_pages(Page *p_page) {
+	while (p_page) {
+		Page *next = p_page->next;
+		if (p_page->size == PAGE_SIZE) {
+			// Kept for reuse, so a steady message load does not allocate.
+			free_pages_lock.lock();
+			p_page->next = free_pages;
+			free_pages = p_page;
+			free_pages_lock.unlock();
+		} else {
+			Memory::free_static(p_page);
+		}
+		p_page = next;
+	}
+}
+
+MessageQueue::Message *MessageQueue::_alloc_message(ThreadQueue *p_queue, uint32_t p_size) {
+	Page *page = p_queue->last;
+	if (!page || page->used + p_size > page->size) {
+		page = _alloc_page(p_size);
+		if (p_queue->last) {
+			p_queue->last->next = page;
+		} else {
+			p_queue->first = page;
+		}
+		p_queue->last = page;
+	}
+
+	Message *msg = memnew_placement(page->get_data() + page->used, Message);
+	msg->order = message_order.fetch_add(1, std::memory_order_relaxed);
+	page->used += p_size;
+	p_queue->used += p_size;
+
+	if (unlikely(p_queue->used > buffer_warn_size)) {
+		WARN_PRINT_ONCE("Message queue is larger than 'memory/limits/message_queue/max_size_kb', messages are being pushed faster than they are flushed.");
+	}
+
+	return msg;
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+		return sizeof(Message);
+	}
+	return sizeof(Message) + sizeof(Variant) * p_message->args;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -60,59 +186,44 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	ThreadQueue *queue = _get_thread_queue();
+	queue->lock.lock();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(queue, sizeof(Message) + sizeof(Variant));
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	memnew_placement(msg + 1, Variant(p_value));
 
+	queue->lock.unlock();
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	ThreadQueue *queue = _get_thread_queue();
+	queue->lock.lock();
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+	// The same notification is already waiting for this object, sending it twice in a row is redundant.
+	NotificationKey key;
+	key.id = p_id;
+	key.notification = p_notification;
+	if (queue->notifications.has(key)) {
+		queue->lock.unlock();
+		return OK;
 	}
+	queue->notifications.insert(key, true);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-
+	Message *msg = _alloc_message(queue, sizeof(Message));
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
-	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
-
+	queue->lock.unlock();
 	return OK;
 }
-
 Error MessageQueue::push_call(Object *p_object, const StringName &p_method, VARIANT_ARG_DECLARE) {
 	return push_call(p_object->get_instance_id(), p_method, VARIANT_ARG_PASS);
 }
@@ -126,17 +237,10 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
-
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	ThreadQueue *queue = _get_thread_queue();
+	queue->lock.lock();
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _alloc_message(queue, sizeof(Message) + sizeof(Variant) * p_argcount);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -144,14 +248,12 @@ Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	queue->lock.unlock();
 	return OK;
 }
 
@@ -176,55 +278,66 @@ void MessageQueue::statistics() {
 	Map<Callable, int> call_count;
 	int null_count = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	uint32_t total_bytes = 0;
 
-		Object *target = message->callable.get_object();
+	thread_queues_lock.lock();
+	for (uint32_t i = 0; i < thread_queues.size(); i++) {
+		ThreadQueue *queue = thread_queues[i];
+		queue->lock.lock();
+		total_bytes += queue->used;
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+		for (Page *page = queue->first; page; page = page->next) {
+			uint32_t read_pos = 0;
+			while (read_pos < page->used) {
+				Message *message = (Message *)(page->get_data() + read_pos);
 
-					call_count[message->callable]++;
+				Object *target = message->callable.get_object();
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-					notify_count[message->notification]++;
+							call_count[message->callable]++;
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-					set_count[t]++;
+							notify_count[message->notification]++;
 
-				} break;
-			}
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+							set_count[t]++;
 
-			null_count++;
-		}
+						} break;
+					}
+
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+					null_count++;
+				}
+
+				read_pos += _get_message_size(message);
+			}
 		}
+
+		queue->lock.unlock();
 	}
+	thread_queues_lock.unlock();
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -244,6 +357,13 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_thread_queue_count() {
+	thread_queues_lock.lock();
+	int count = thread_queues.size();
+	thread_queues_lock.unlock();
+	return count;
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -262,113 +382,159 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+	if (flushing.exchange(true, std::memory_order_acquire)) {
+		ERR_FAIL_MSG("Already flushing, you did something odd.");
 	}
 
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
-	}
-	flushing = true;
+	while (true) {
+		// Take everything pushed so far. Messages pushed by the calls below
+		// are collected by the next round.
+		flush_cursors.clear();
+		uint32_t used = 0;
+
+		thread_queues_lock.lock();
+		for (uint32_t i = 0; i < thread_queues.size(); i++) {
+			ThreadQueue *queue = thread_queues[i];
+			queue->lock.lock();
+			if (queue->first) {
+				Cursor cursor;
+				cursor.page = queue->first;
+				flush_cursors.push_back(cursor);
+				used += queue->used;
+
+				queue->first = nullptr;
+				queue->last = nullptr;
+				queue->used = 0;
+				if (!queue->notifications.empty()) {
+					queue->notifications.clear();
+				}
+			}
+			queue->lock.unlock();
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+			if (queue->thread_exited) {
+				// Nothing can be pushed to it anymore.
+				thread_queues.remove(i);
+				memdelete(queue);
+				i--;
+			}
+		}
+		thread_queues_lock.unlock();
 
-		Message *message = (Message *)&buffer[read_pos];
+		if (flush_cursors.size() == 0) {
+			break;
+		}
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+		if (used > buffer_max_used) {
+			buffer_max_used = used;
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		while (true) {
+			// Oldest message first, so the order between threads is kept.
+			Cursor *cursor = nullptr;
+			Message *message = nullptr;
+			for (uint32_t i = 0; i < flush_cursors.size(); i++) {
+				Cursor &c = flush_cursors[i];
+				if (!c.page) {
+					continue;
+				}
+				Message *m = (Message *)(c.page->get_data() + c.pos);
+				if (!message || m->order < message->order) {
+					message = m;
+					cursor = &c;
+				}
+			}
 
-		_THREAD_SAFE_UNLOCK_
+			if (!message) {
+				break;
+			}
 
-		Object *target = message->callable.get_object();
+			Page *page = cursor->page;
+			cursor->pos += _get_message_size(message);
+			if (cursor->pos == page->used) {
+				cursor->page = page->next;
+				cursor->pos = 0;
+			} else {
+				page = nullptr;
+			}
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+			Object *target = message->callable.get_object();
 
-					// messages don't expect a return value
+			if (target != nullptr) {
+				switch (message->type & FLAG_MASK) {
+					case TYPE_CALL: {
+						Variant *args = (Variant *)(message + 1);
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+						// messages don't expect a return value
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+						_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->callable.get_method(), *arg);
+					} break;
+					case TYPE_NOTIFICATION: {
+						// messages don't expect a return value
+						target->notification(message->notification);
 
-				} break;
-			}
-		}
+					} break;
+					case TYPE_SET: {
+						Variant *arg = (Variant *)(message + 1);
+						// messages don't expect a return value
+						target->set(message->callable.get_method(), *arg);
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+					} break;
+				}
 			}
-		}
 
-		message->~Message();
+			_destroy_message(message);
 
-		_THREAD_SAFE_LOCK_
+			if (page) {
+				// Last message of the page.
+				page->next = nullptr;
+				_free_pages(page);
+			}
+		}
 	}
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	flushing.store(false, std::memory_order_release);
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.load(std::memory_order_relaxed);
 }
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	instance_id = message_queue_instance_counter.fetch_add(1) + 1;
+
+	// The queue grows as needed, past this size a warning is printed as messages are likely piling up.
+	buffer_warn_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	buffer_warn_size *= 1024;
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
+	for (uint32_t i = 0; i < thread_queues.size(); i++) {
+		ThreadQueue *queue = thread_queues[i];
+		Page *page = queue->first;
+		while (page) {
+			uint32_t read_pos = 0;
+			while (read_pos < page->used) {
+				Message *message = (Message *)(page->get_data() + read_pos);
+				read_pos += _get_message_size(message);
+				_destroy_message(message);
 			}
+			Page *next = page->next;
+			Memory::free_static(page);
+			page = next;
 		}
-		message->~Message();
+		memdelete(queue);
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	while (free_pages) {
+		Page *next = free_pages->next;
+		Memory::free_static(free_pages);
+		free_pages = next;
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
@@ -31,14 +31,20 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include "core/local_vector.h"
+#include "core/oa_hash_map.h"
 #include "core/object.h"
-#include "core/os/thread_safe.h"
+#include "core/spin_lock.h"
 
-class MessageQueue {
-	_THREAD_SAFE_CLASS_
+#include <atomic>
 
+// Every thread pushes into its own queue, so pushing never waits on other
+// threads. Messages are stamped with a global order and flush() merges the
+// queues back into that order.
+class MessageQueue {
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE = 16384
 	};
 
 	enum {
@@ -52,6 +58,7 @@ class MessageQueue {
 
 	struct Message {
 		Callable callable;
+		uint64_t order;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -59,16 +66,66 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
+	// Messages are stored in a chain of pages, a message followed by its arguments.
+	struct Page {
+		Page *next;
+		uint32_t size;
+		uint32_t used;
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)(this + 1); }
+	};
+
+	struct NotificationKey {
+		ObjectID id;
+		int notification;
+		bool operator==(const NotificationKey &p_key) const { return id == p_key.id && notification == p_key.notification; }
+	};
+
+	struct NotificationKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const NotificationKey &p_key) { return hash_djb2_one_32(p_key.notification, hash_one_uint64(p_key.id)); }
+	};
+
+	struct ThreadQueue {
+		SpinLock lock; // Only contended while flush() takes the pages.
+		Page *first = nullptr;
+		Page *last = nullptr;
+		uint32_t used = 0;
+		OAHashMap<NotificationKey, bool, NotificationKeyHasher> notifications; // Pending, to coalesce duplicates.
+		bool thread_exited = false; // Freed once its remaining messages are flushed.
+	};
+
+	struct Cursor {
+		Page *page = nullptr;
+		uint32_t pos = 0;
+	};
+
+	uint64_t instance_id;
+	std::atomic<uint64_t> message_order = { 0 };
+
+	SpinLock thread_queues_lock;
+	LocalVector<ThreadQueue *> thread_queues;
+
+	SpinLock free_pages_lock;
+	Page *free_pages = nullptr;
+
+	LocalVector<Cursor> flush_cursors;
+
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+	uint32_t buffer_warn_size;
+
+	ThreadQueue *_get_thread_queue();
+	void _thread_exited(ThreadQueue *p_queue);
+	friend struct MessageQueueThreadOwner;
+	Page *_alloc_page(uint32_t p_size);
+	void _free_pages(Page *p_page);
+	Message *_alloc_message(ThreadQueue *p_queue, uint32_t p_size);
+	static uint32_t _get_message_size(const Message *p_message);
+	static void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing = false;
+	std::atomic<bool> flushing = { false };
 
 public:
 	static MessageQueue *get_singleton();
@@ -90,6 +147,7 @@ public:
 	bool is_flushing() const;
 
 	int get_max_buffer_usage() const;
+	int get_thread_queue_count();
 
 	MessageQueue();
 	~MessageQueue();
@@ -840,6 +840,10 @@ void Object::cancel_delete() {
 	_predelete_ok = true;
 }
 
+void Object::cancel_free() {
+	_predelete_ok = false;
+}
+
 void Object::set_script_and_instance(const Variant &p_script, ScriptInstance *p_instance) {
 	//this function is not meant to be used in any of these ways
 	ERR_FAIL_COND(p_script.is_null());
@@ -977,11 +981,6 @@ bool Object::_has_user_signal(const StringName &p_name) const {
 	return signal_map[p_name].user.name.length() > 0;
 }
 
-struct _ObjectSignalDisconnectData {
-	StringName signal;
-	Callable callable;
-};
-
 Variant Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
 
@@ -1025,25 +1024,39 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
-	List<_ObjectSignalDisconnectData> disconnect_data;
+	bool profiling = signal_profiling;
+	uint64_t profile_from = profiling ? OS::get_singleton()->get_ticks_usec() : 0;
 
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
+	// Slots connected from now on get an epoch that isn't older, so they are
+	// not called until the next emission.
+	uint64_t epoch = ++s->epoch;
+	s->emitting++;
 
-	int ssize = slot_map.size();
+	SignalEmission emission;
+	emission.prev = _emissions;
+	_emissions = &emission;
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
+	// Binds are appended to the arguments in stack memory, grown when a slot has more.
+	const Variant **bind_mem = nullptr;
+	int bind_mem_size = 0;
 
 	Error err = OK;
 
-	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+	for (int i = 0; i < s->slot_map.size(); i++) {
+		const SignalData::Slot &slot = s->slot_map.getv(i);
+		if (slot.removed || slot.epoch >= epoch) {
+			continue;
+		}
+
+		// Copied, connecting from the callback may move the slot.
+		Callable callable = slot.conn.callable;
+		Vector<Variant> binds = slot.conn.binds;
+		uint32_t flags = slot.conn.flags;
+		int slot_count = s->slot_map.size();
 
-		Object *target = c.callable.get_object();
+		Object *target = callable.get_object();
 		if (!target) {
 			// Target might have been deleted during signal callback, this is expected and OK.
 			continue;
@@ -1052,70 +1065,142 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		const Variant **args = p_args;
 		int argc = p_argcount;
 
-		if (c.binds.size()) {
+		if (binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
+			argc = p_argcount + binds.size();
+			if (argc > bind_mem_size) {
+				bind_mem = (const Variant **)alloca(sizeof(Variant *) * argc);
+				bind_mem_size = argc;
+			}
 
 			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
+				bind_mem[j] = p_args[j];
 			}
-			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+			for (int j = 0; j < binds.size(); j++) {
+				bind_mem[p_argcount + j] = &binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_mem;
 		}
 
-		if (c.flags & CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_callable(c.callable, args, argc, true);
+		if (flags & CONNECT_DEFERRED) {
+			MessageQueue::get_singleton()->push_callable(callable, args, argc, true);
 		} else {
 			Callable::CallError ce;
-			_emitting = true;
 			Variant ret;
-			c.callable.call(args, argc, ret, ce);
-			_emitting = false;
+			callable.call(args, argc, ret, ce);
+
+			if (emission.object_freed) {
+				// Nothing left to emit from, the error was reported when freeing.
+				if (profiling) {
+					_signal_profiling_add(p_name, OS::get_singleton()->get_ticks_usec() - profile_from);
+				}
+				return err;
+			}
+
+			if (s->slot_map.size() != slot_count) {
+				// Slots were connected before this one, find where it went.
+				i = s->slot_map.find(*callable.get_base_comparator());
+			}
 
 			if (ce.error != Callable::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
-				if (c.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
+				if (flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
 					continue;
 				}
 #endif
 				if (ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD && !ClassDB::class_exists(target->get_class_name())) {
 					//most likely object is not initialized yet, do not throw error.
 				} else {
-					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
+					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(callable, args, argc, ce) + ".");
 					err = ERR_METHOD_NOT_FOUND;
 				}
 			}
 		}
 
-		bool disconnect = c.flags & CONNECT_ONESHOT;
+		bool disconnect = flags & CONNECT_ONESHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (c.flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+		if (disconnect && (flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
 			//this signal was connected from the editor, and is being edited. just don't disconnect for now
 			disconnect = false;
 		}
 #endif
-		if (disconnect) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal = p_name;
-			dd.callable = c.callable;
-			disconnect_data.push_back(dd);
+		if (disconnect && !s->slot_map.getv(i).removed) {
+			_disconnect(p_name, callable);
 		}
 	}
 
-	while (!disconnect_data.empty()) {
-		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
+	_emissions = emission.prev;
+	s->emitting--;
+	if (s->emitting == 0 && s->has_removed) {
+		_sweep_removed_slots(p_name, s);
+	}
 
-		_disconnect(dd.signal, dd.callable);
-		disconnect_data.pop_front();
+	if (profiling) {
+		_signal_profiling_add(p_name, OS::get_singleton()->get_ticks_usec() - profile_from);
 	}
 
 	return err;
 }
 
+bool Object::signal_profiling = false;
+static SpinLock signal_profiling_lock;
+static HashMap<StringName, Object::SignalProfilingInfo> signal_profiling_data;
+
+void Object::_signal_profiling_add(const StringName &p_signal, uint64_t p_time) {
+	signal_profiling_lock.lock();
+	SignalProfilingInfo *info = signal_profiling_data.getptr(p_signal);
+	if (!info) {
+		info = &signal_profiling_data[p_signal];
+		info->signal = p_signal;
+	}
+	info->emit_count++;
+	info->total_time += p_time;
+	signal_profiling_lock.unlock();
+}
+
+void Object::signal_profiling_start() {
+	signal_profiling_lock.lock();
+	signal_profiling_data.clear();
+	signal_profiling = true;
+	signal_profiling_lock.unlock();
+}
+
+void Object::signal_profiling_stop() {
+	signal_profiling_lock.lock();
+	signal_profiling = false;
+	signal_profiling_data.clear();
+	signal_profiling_lock.unlock();
+}
+
+void Object::signal_profiling_get_frame_data(List<SignalProfilingInfo> *r_info) {
+	signal_profiling_lock.lock();
+	const StringName *K = nullptr;
+	while ((K = signal_profiling_data.next(K))) {
+		SignalProfilingInfo &info = signal_profiling_data[*K];
+		if (info.emit_count) {
+			r_info->push_back(info);
+			info.emit_count = 0;
+			info.total_time = 0;
+		}
+	}
+	signal_profiling_lock.unlock();
+}
+
+void Object::_sweep_removed_slots(const StringName &p_signal, SignalData *p_signal_data) {
+	for (int i = p_signal_data->slot_map.size() - 1; i >= 0; i--) {
+		if (p_signal_data->slot_map.getv(i).removed) {
+			p_signal_data->slot_map.erase(p_signal_data->slot_map.getk(i));
+		}
+	}
+	p_signal_data->has_removed = false;
+
+	if (p_signal_data->slot_map.empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
+		//not user signal, delete
+		signal_map.erase(p_signal);
+	}
+}
+
 Error Object::emit_signal(const StringName &p_name, VARIANT_ARG_DECLARE) {
 	VARIANT_ARGPTRS;
 
@@ -1240,7 +1325,9 @@ void Object::get_all_signal_connections(List<Connection> *p_connections) const {
 		const SignalData *s = &signal_map[*S];
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
-			p_connections->push_back(s->slot_map.getv(i).conn);
+			if (!s->slot_map.getv(i).removed) {
+				p_connections->push_back(s->slot_map.getv(i).conn);
+			}
 		}
 	}
 }
@@ -1252,7 +1339,9 @@ void Object::get_signal_connection_list(const StringName &p_signal, List<Connect
 	}
 
 	for (int i = 0; i < s->slot_map.size(); i++) {
-		p_connections->push_back(s->slot_map.getv(i).conn);
+		if (!s->slot_map.getv(i).removed) {
+			p_connections->push_back(s->slot_map.getv(i).conn);
+		}
 	}
 }
 
@@ -1264,7 +1353,7 @@ int Object::get_persistent_signal_connection_count() const {
 		const SignalData *s = &signal_map[*S];
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
-			if (s->slot_map.getv(i).conn.flags & CONNECT_PERSIST) {
+			if (!s->slot_map.getv(i).removed && s->slot_map.getv(i).conn.flags & CONNECT_PERSIST) {
 				count += 1;
 			}
 		}
@@ -1316,9 +1405,10 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 	Callable target = p_callable;
 
 	//compare with the base callable, so binds can be ignored
-	if (s->slot_map.has(*target.get_base_comparator())) {
+	int slot_index = s->slot_map.find(*target.get_base_comparator());
+	if (slot_index >= 0 && !s->slot_map.getv(slot_index).removed) {
 		if (p_flags & CONNECT_REFERENCE_COUNTED) {
-			s->slot_map[*target.get_base_comparator()].reference_count++;
+			s->slot_map.getv(slot_index).reference_count++;
 			return OK;
 		} else {
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Signal '" + p_signal + "' is already connected to given callable '" + p_callable + "' in that object.");
@@ -1337,8 +1427,10 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 	if (p_flags & CONNECT_REFERENCE_COUNTED) {
 		slot.reference_count = 1;
 	}
+	slot.epoch = s->epoch;
 
 	//use callable version as key, so binds can be ignored
+	//a slot removed during the current emission is replaced in place
 	s->slot_map[*target.get_base_comparator()] = slot;
 
 	return OK;
@@ -1366,7 +1458,8 @@ bool Object::is_connected(const StringName &p_signal, const Callable &p_callable
 
 	Callable target = p_callable;
 
-	return s->slot_map.has(*target.get_base_comparator());
+	int slot_index = s->slot_map.find(*target.get_base_comparator());
+	return slot_index >= 0 && !s->slot_map.getv(slot_index).removed;
 	//const Map<Signal::Target,Signal::Slot>::Element *E = s->slot_map.find(target);
 	//return (E!=nullptr );
 }
@@ -1388,9 +1481,10 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	SignalData *s = signal_map.getptr(p_signal);
 	ERR_FAIL_COND_MSG(!s, vformat("Nonexistent signal '%s' in %s.", p_signal, to_string()));
 
-	ERR_FAIL_COND_MSG(!s->slot_map.has(*p_callable.get_base_comparator()), "Disconnecting nonexistent signal '" + p_signal + "', callable: " + p_callable + ".");
+	int slot_index = s->slot_map.find(*p_callable.get_base_comparator());
+	ERR_FAIL_COND_MSG(slot_index < 0 || s->slot_map.getv(slot_index).removed, "Disconnecting nonexistent signal '" + p_signal + "', callable: " + p_callable + ".");
 
-	SignalData::Slot *slot = &s->slot_map[p_callable];
+	SignalData::Slot *slot = &s->slot_map.getv(slot_index);
 
 	if (!p_force) {
 		slot->reference_count--; // by default is zero, if it was not referenced it will go below it
@@ -1400,6 +1494,15 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	target_object->connections.erase(slot->cE);
+
+	if (s->emitting) {
+		// Erased when the emission ends.
+		slot->removed = true;
+		slot->cE = nullptr;
+		s->has_removed = true;
+		return;
+	}
+
 	s->slot_map.erase(*p_callable.get_base_comparator());
 
 	if (s->slot_map.empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
@@ -1805,9 +1908,12 @@ Object::~Object() {
 
 	const StringName *S = nullptr;
 
-	if (_emitting) {
+	if (_emissions) {
 		//@todo this may need to actually reach the debugger prioritarily somehow because it may crash before
 		ERR_PRINT("Object " + to_string() + " was freed or unreferenced while a signal is being emitted from it. Try connecting to the signal using 'CONNECT_DEFERRED' flag, or use queue_free() to free the object (if this object is a Node) to avoid this error and potential crashes.");
+		for (SignalEmission *E = _emissions; E; E = E->prev) {
+			E->object_freed = true;
+		}
 	}
 
 	while ((S = signal_map.next(nullptr))) {
@@ -1818,7 +1924,9 @@ Object::~Object() {
 		const VMap<Callable, SignalData::Slot>::Pair *slot_list = s->slot_map.get_array();
 
 		for (int i = 0; i < slot_count; i++) {
-			slot_list[i].value.conn.callable.get_object()->connections.erase(slot_list[i].value.cE);
+			if (!slot_list[i].value.removed) {
+				slot_list[i].value.conn.callable.get_object()->connections.erase(slot_list[i].value.cE);
+			}
 		}
 
 		signal_map.erase(*S);
@@ -1990,4 +2098,7 @@ void ObjectDB::cleanup() {
 	if (object_slots) {
 		memfree(object_slots);
 	}
+
+	// Don't keep names past StringName cleanup if the profiler was left running.
+	Object::signal_profiling_stop();
 }
@@ -438,15 +438,30 @@ private:
 	friend bool predelete_handler(Object *);
 	friend void postinitialize_handler(Object *);
 
+	// Emission goes through slot_map in place. While a signal is being emitted,
+	// disconnected slots are only flagged as removed and erased once the
+	// outermost emission ends, and slots connected meanwhile are skipped by
+	// the emissions already running (their epoch is not older).
 	struct SignalData {
 		struct Slot {
 			int reference_count = 0;
 			Connection conn;
 			List<Connection>::Element *cE = nullptr;
+			uint64_t epoch = 0;
+			bool removed = false;
 		};
 
 		MethodInfo user;
 		VMap<Callable, Slot> slot_map;
+		uint64_t epoch = 0;
+		int emitting = 0;
+		bool has_removed = false;
+	};
+
+	// Emissions running on this object, innermost first, so freeing it can tell them to stop.
+	struct SignalEmission {
+		SignalEmission *prev = nullptr;
+		bool object_freed = false;
 	};
 
 	HashMap<StringName, SignalData> signal_map;
@@ -461,7 +476,7 @@ private:
 	bool _predelete();
 	void _postinitialize();
 	bool _can_translate = true;
-	bool _emitting = false;
+	SignalEmission *_emissions = nullptr;
 #ifdef TOOLS_ENABLED
 	bool _edited = false;
 	uint32_t _edited_version = 0;
@@ -473,6 +488,10 @@ private:
 	mutable StringName _class_name;
 	mutable const StringName *_class_ptr = nullptr;
 
+	static bool signal_profiling;
+	static void _signal_profiling_add(const StringName &p_signal, uint64_t p_time);
+	void _sweep_removed_slots(const StringName &p_signal, SignalData *p_signal_data);
+
 	void _add_user_signal(const String &p_name, const Array &p_args = Array());
 	bool _has_user_signal(const StringName &p_name) const;
 	Variant _emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
@@ -528,6 +547,7 @@ protected:
 	static void _get_valid_parents_static(List<String> *p_parents);
 
 	void cancel_delete();
+	void cancel_free(); // Called from NOTIFICATION_PREDELETE to keep the object alive.
 
 	virtual void _changed_callback(Object *p_changed, const char *p_prop);
 
@@ -690,6 +710,8 @@ public:
 	void set_script_and_instance(const Variant &p_script, ScriptInstance *p_instance); //some script languages can't control instance creation, so this function eases the process
 
 	void add_user_signal(const MethodInfo &p_signal);
+	// Slots disconnected during the emission are skipped, slots connected
+	// during it wait for the next one. Freeing the object from a slot stops it.
 	Error emit_signal(const StringName &p_name, VARIANT_ARG_LIST);
 	Error emit_signal(const StringName &p_name, const Variant **p_args, int p_argcount);
 	bool has_signal(const StringName &p_name) const;
@@ -699,6 +721,16 @@ public:
 	int get_persistent_signal_connection_count() const;
 	void get_signals_connected_to_this(List<Connection> *p_connections) const;
 
+	// Emission count and dispatch time per signal name, collected while profiling.
+	struct SignalProfilingInfo {
+		StringName signal;
+		uint64_t emit_count = 0;
+		uint64_t total_time = 0; // In microseconds.
+	};
+	static void signal_profiling_start();
+	static void signal_profiling_stop();
+	static void signal_profiling_get_frame_data(List<SignalProfilingInfo> *r_info); // Resets the counters.
+
 	Error connect_compat(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method, const Vector<Variant> &p_binds = Vector<Variant>(), uint32_t p_flags = 0);
 	void disconnect_compat(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method);
 	bool is_connected_compat(const StringName &p_signal, Object *p_to_object, const StringName &p_to_method) const;
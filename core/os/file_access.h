@@ -111,6 +111,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_mapped_buffer(int p_length) const { return nullptr; } ///< get a pointer to the next bytes without copying them, if the file is memory mapped (else nullptr); valid until the file is closed
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -37,6 +37,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
 }
@@ -192,6 +194,172 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+/* FrameAllocator */
+
+namespace {
+
+struct FrameArena {
+	struct Block {
+		Block *next = nullptr;
+		uint32_t size = 0;
+		uint32_t used = 0;
+	};
+
+	// Every allocation is prefixed with the arena it came from, nullptr for
+	// allocations that went to the regular allocator.
+	struct Header {
+		FrameArena *arena;
+		uint64_t padding;
+	};
+
+	Block *first = nullptr;
+	Block *current = nullptr;
+	uint32_t blocks_used = 1; // Blocks reached during the current frame.
+	uint64_t frame = 0; // Frame of the last allocation.
+	// Live allocations, plus one held by the owning thread until it exits.
+	std::atomic<uint32_t> refcount = { 1 };
+
+	static uint8_t *get_block_data(Block *p_block) {
+		return (uint8_t *)p_block + ((sizeof(Block) + 15) & ~15);
+	}
+
+	Block *create_block() {
+		Block *block = (Block *)Memory::alloc_static(((sizeof(Block) + 15) & ~15) + FrameAllocator::BLOCK_SIZE);
+		block->next = nullptr;
+		block->size = FrameAllocator::BLOCK_SIZE;
+		block->used = 0;
+		return block;
+	}
+
+	void free_blocks_after(Block *p_block) {
+		Block *block = p_block->next;
+		p_block->next = nullptr;
+		while (block) {
+			Block *next = block->next;
+			Memory::free_static(block);
+			block = next;
+		}
+	}
+
+	void *alloc(size_t p_size, uint64_t p_frame) {
+		if (refcount.load(std::memory_order_acquire) == 1) {
+			// Everything was freed, start over from the first block.
+			if (frame != p_frame) {
+				// Only keep the blocks the previous frame needed.
+				Block *last_used = first;
+				for (uint32_t i = 1; i < blocks_used && last_used->next; i++) {
+					last_used = last_used->next;
+				}
+				free_blocks_after(last_used);
+				blocks_used = 1;
+				frame = p_frame;
+			}
+			current = first;
+			current->used = 0;
+		}
+
+		uint32_t size = (p_size + 15) & ~15;
+		if (current->used + size > current->size) {
+			if (!current->next) {
+				current->next = create_block();
+			}
+			current = current->next;
+			current->used = 0;
+
+			uint32_t index = 1;
+			for (Block *block = first; block != current; block = block->next) {
+				index++;
+			}
+			blocks_used = MAX(blocks_used, index);
+		}
+
+		uint8_t *ptr = get_block_data(current) + current->used;
+		current->used += size;
+		frame = p_frame;
+		refcount.fetch_add(1, std::memory_order_relaxed);
+		return ptr;
+	}
+
+	FrameArena() {
+		first = create_block();
+		current = first;
+	}
+
+	~FrameArena() {
+		free_blocks_after(first);
+		Memory::free_static(first);
+	}
+};
+
+struct FrameArenaOwner {
+	FrameArena *arena = nullptr;
+
+	// Gives up the arena, allocations still alive keep it until they are freed.
+	void release() {
+		if (arena && arena->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			memdelete(arena);
+		}
+		arena = nullptr;
+	}
+
+	~FrameArenaOwner() {
+		release();
+	}
+};
+
+std::atomic<uint64_t> frame_allocator_frame = { 0 };
+thread_local FrameArenaOwner frame_arena_owner;
+
+} // namespace
+
+void *FrameAllocator::alloc(size_t p_memory) {
+	FrameArena::Header *header;
+	if (p_memory > MAX_ARENA_ALLOCATION) {
+		header = (FrameArena::Header *)Memory::alloc_static(p_memory + sizeof(FrameArena::Header));
+		ERR_FAIL_COND_V(!header, nullptr);
+		header->arena = nullptr;
+	} else {
+		uint64_t frame = frame_allocator_frame.load(std::memory_order_relaxed);
+		FrameArena *arena = frame_arena_owner.arena;
+		if (unlikely(arena && arena->frame != frame && arena->refcount.load(std::memory_order_acquire) > 1)) {
+			// Memory from a past frame is still in use, so the arena can't be
+			// rewound and would keep growing. Leave it to those allocations.
+			WARN_PRINT_ONCE("FrameAllocator memory outlived the frame it was allocated in.");
+			frame_arena_owner.release();
+			arena = nullptr;
+		}
+		if (unlikely(!arena)) {
+			arena = memnew(FrameArena);
+			frame_arena_owner.arena = arena;
+		}
+		header = (FrameArena::Header *)arena->alloc(p_memory + sizeof(FrameArena::Header), frame);
+		header->arena = arena;
+	}
+	return header + 1;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	FrameArena::Header *header = (FrameArena::Header *)p_ptr - 1;
+	FrameArena *arena = header->arena;
+	if (!arena) {
+		Memory::free_static(header);
+		return;
+	}
+	// Memory is only reclaimed when the arena is rewound. If the owning
+	// thread already exited, the last allocation freed deletes the arena.
+	if (arena->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		memdelete(arena);
+	}
+}
+
+void FrameAllocator::begin_frame() {
+	frame_allocator_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t FrameAllocator::get_frame() {
+	return frame_allocator_frame.load(std::memory_order_relaxed);
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -65,6 +65,27 @@ public:
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
+// Drop-in replacement for DefaultAllocator (e.g. `List<T, FrameAllocator>`) for
+// scratch data that does not outlive the frame. Each thread bumps through its own
+// arena, which is rewound once everything allocated from it has been freed, and
+// gives back blocks it did not need during the last frame. If memory is kept
+// past its frame, the thread moves on to a new arena. Memory can be freed from
+// any thread. Large allocations fall back to the regular allocator.
+class FrameAllocator {
+public:
+	enum {
+		BLOCK_SIZE = 64 * 1024,
+		MAX_ARENA_ALLOCATION = BLOCK_SIZE / 4,
+	};
+
+	static void *alloc(size_t p_memory);
+	static void free(void *p_ptr);
+
+	// Called by the main loop at the start of each frame.
+	static void begin_frame();
+	static uint64_t get_frame();
+};
+
 void *operator new(size_t p_size, const char *p_description); ///< operator new that takes a description and uses MemoryStaticPool
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
 
@@ -59,6 +59,7 @@
 #include "core/io/translation_loader_po.h"
 #include "core/io/udp_server.h"
 #include "core/io/xml_parser.h"
+#include "core/job_system.h"
 #include "core/math/a_star.h"
 #include "core/math/expression.h"
 #include "core/math/geometry_2d.h"
@@ -90,6 +91,8 @@ static _EngineDebugger *_engine_debugger = nullptr;
 
 static IP *ip = nullptr;
 
+static JobSystem *job_system = nullptr;
+
 static _Geometry2D *_geometry_2d = nullptr;
 static _Geometry3D *_geometry_3d = nullptr;
 
@@ -110,6 +113,9 @@ void register_core_types() {
 	StringName::setup();
 	ResourceLoader::initialize();
 
+	// Threads are started by Main once project settings are loaded, until then jobs run inline.
+	job_system = memnew(JobSystem);
+
 	register_global_constants();
 	register_variant_methods();
 
@@ -316,6 +322,8 @@ void unregister_core_types() {
 
 	ResourceLoader::finalize();
 
+	memdelete(job_system);
+
 	ClassDB::cleanup_defaults();
 	ObjectDB::cleanup();
 
@@ -30,39 +30,117 @@
 
 #include "string_name.h"
 
+#include "core/local_vector.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
 
+#include <atomic>
+
 StaticCString StaticCString::create(const char *p_ptr) {
 	StaticCString scs;
 	scs.ptr = p_ptr;
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+struct StringName::_Table {
+	uint32_t mask = 0;
+	std::atomic<_Data *> *slots = nullptr;
+
+	static _Table *create(uint32_t p_capacity) {
+		_Table *table = memnew(_Table);
+		table->mask = p_capacity - 1;
+		table->slots = (std::atomic<_Data *> *)memalloc(sizeof(std::atomic<_Data *>) * p_capacity);
+		for (uint32_t i = 0; i < p_capacity; i++) {
+			memnew_placement(&table->slots[i], std::atomic<_Data *>(nullptr));
+		}
+		return table;
+	}
+
+	static void destroy(_Table *p_table) {
+		memfree(p_table->slots);
+		memdelete(p_table);
+	}
+
+	// Marks the slot of a removed name, so probing goes on past it.
+	static _Data *tombstone() { return (_Data *)uintptr_t(1); }
+
+	// Compare without building a String out of static names.
+	static _FORCE_INLINE_ bool name_equals(const _Data *p_data, const char *p_name) {
+		return p_data->cname ? strcmp(p_data->cname, p_name) == 0 : p_data->name == p_name;
+	}
+
+	static _FORCE_INLINE_ bool name_equals(const _Data *p_data, const char32_t *p_name) {
+		if (!p_data->cname) {
+			return p_data->name == p_name;
+		}
+		const char *c = p_data->cname;
+		while (*c && char32_t(uint8_t(*c)) == *p_name) {
+			c++;
+			p_name++;
+		}
+		return *c == 0 && *p_name == 0;
+	}
+
+	static _FORCE_INLINE_ bool name_equals(const _Data *p_data, const String &p_name) {
+		return p_data->cname ? p_name == p_data->cname : p_data->name == p_name;
+	}
+};
+
+// Each shard has its own cache line, threads working on different names don't contend.
+struct alignas(64) StringName::_Shard {
+	std::atomic<_Table *> table = { nullptr };
+	// Lookups in flight. Removed names and replaced tables are only freed once
+	// no lookup could still be reading them.
+	std::atomic<uint32_t> readers = { 0 };
+	Mutex mutex;
+	uint32_t names = 0;
+	uint32_t tombstones = 0;
+	uint64_t collisions = 0;
+	LocalVector<_Data *> retired_names;
+	LocalVector<_Table *> retired_tables;
+};
+
+StringName::_Shard StringName::_shards[SHARD_COUNT];
+
+static _FORCE_INLINE_ uint32_t _mix_hash(uint32_t p_hash) {
+	// String hashes are weak in the low bits, which linear probing is sensitive to.
+	p_hash ^= p_hash >> 16;
+	p_hash *= 0x85ebca6b;
+	p_hash ^= p_hash >> 13;
+	p_hash *= 0xc2b2ae35;
+	p_hash ^= p_hash >> 16;
+	return p_hash;
+}
 
 StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		_shards[i].table.store(_Table::create(SHARD_INITIAL_CAPACITY));
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	TableStats stats = get_table_stats();
+	print_verbose("StringName: " + itos(stats.names) + " names in " + itos(stats.capacity) + " slots, " + itos(stats.collisions) + " collisions since startup.");
 
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		_Shard &shard = _shards[i];
+		MutexLock lock(shard.mutex);
+
+		_Table *table = shard.table.load();
+		for (uint32_t j = 0; j <= table->mask; j++) {
+			_Data *d = table->slots[j].load();
+			if (!d || d == _Table::tombstone()) {
+				continue;
+			}
 			lost_strings++;
 			if (OS::get_singleton()->is_stdout_verbose()) {
 				if (d->cname) {
@@ -71,35 +149,185 @@ void StringName::cleanup() {
 					print_line("Orphan StringName: " + String(d->name));
 				}
 			}
-
-			_table[i] = _table[i]->next;
 			memdelete(d);
 		}
+		_Table::destroy(table);
+		shard.table.store(nullptr);
+		shard.names = 0;
+		shard.tombstones = 0;
+
+		_reclaim(shard);
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
 }
 
+template <class T>
+StringName::_Data *StringName::_find(_Shard &p_shard, uint32_t p_hash, uint32_t p_table_hash, const T &p_name) {
+	_Data *found = nullptr;
+
+	p_shard.readers.fetch_add(1);
+	_Table *table = p_shard.table.load();
+	for (uint32_t i = p_table_hash & table->mask;; i = (i + 1) & table->mask) {
+		_Data *d = table->slots[i].load();
+		if (!d) {
+			break;
+		}
+		// A name whose last reference is being released can't be referenced
+		// anymore, keep looking in case it was already interned again.
+		if (d != _Table::tombstone() && d->hash == p_hash && _Table::name_equals(d, p_name) && d->refcount.ref()) {
+			found = d;
+			break;
+		}
+	}
+	p_shard.readers.fetch_sub(1, std::memory_order_release);
+
+	return found;
+}
+
+template <class T>
+StringName::_Data *StringName::_intern(const T &p_name, uint32_t p_hash, const char *p_static_cname) {
+	uint32_t table_hash = _mix_hash(p_hash);
+	_Shard &shard = _shards[_get_shard_index(table_hash)];
+
+	_Data *data = _find(shard, p_hash, table_hash, p_name);
+	if (data) {
+		return data;
+	}
+
+	MutexLock lock(shard.mutex);
+
+	// Look again, it may have been added since.
+	_Table *table = shard.table.load(std::memory_order_relaxed);
+	uint32_t home = table_hash & table->mask;
+	uint32_t insert_at = UINT32_MAX;
+	for (uint32_t i = home;; i = (i + 1) & table->mask) {
+		_Data *d = table->slots[i].load(std::memory_order_relaxed);
+		if (!d) {
+			if (insert_at == UINT32_MAX) {
+				insert_at = i;
+			}
+			break;
+		}
+		if (d == _Table::tombstone()) {
+			if (insert_at == UINT32_MAX) {
+				insert_at = i;
+			}
+			continue;
+		}
+		if (d->hash == p_hash && _Table::name_equals(d, p_name) && d->refcount.ref()) {
+			return d;
+		}
+	}
+
+	data = memnew(_Data);
+	if (p_static_cname) {
+		data->cname = p_static_cname;
+	} else {
+		data->name = p_name;
+	}
+	data->refcount.init();
+	data->hash = p_hash;
+	data->table_hash = table_hash;
+
+	if (table->slots[insert_at].load(std::memory_order_relaxed) == _Table::tombstone()) {
+		shard.tombstones--;
+	}
+	// Publishes the fully constructed name to lookups.
+	table->slots[insert_at].store(data);
+	shard.names++;
+	if (insert_at != home) {
+		shard.collisions++;
+	}
+
+	if ((shard.names + shard.tombstones) * 4 > (table->mask + 1) * 3) {
+		_rehash(shard);
+	}
+
+	return data;
+}
+
+void StringName::_rehash(_Shard &p_shard) {
+	// Must be called with the shard locked. Names don't move, only the slot array
+	// is rebuilt, so lookups still going through the old one stay valid.
+	_Table *old_table = p_shard.table.load(std::memory_order_relaxed);
+	uint32_t capacity = old_table->mask + 1;
+	if (p_shard.names * 2 > capacity) {
+		capacity *= 2;
+	}
+
+	_Table *table = _Table::create(capacity);
+	for (uint32_t i = 0; i <= old_table->mask; i++) {
+		_Data *d = old_table->slots[i].load(std::memory_order_relaxed);
+		if (!d || d == _Table::tombstone()) {
+			continue;
+		}
+		uint32_t j = d->table_hash & table->mask;
+		while (table->slots[j].load(std::memory_order_relaxed)) {
+			j = (j + 1) & table->mask;
+		}
+		table->slots[j].store(d, std::memory_order_relaxed);
+	}
+
+	p_shard.table.store(table);
+	p_shard.tombstones = 0;
+	p_shard.retired_tables.push_back(old_table);
+	_reclaim(p_shard);
+}
+
+void StringName::_reclaim(_Shard &p_shard) {
+	// Must be called with the shard locked, after unpublishing what was retired.
+	if (p_shard.readers.load() != 0) {
+		return; // Try again on the next removal.
+	}
+	for (uint32_t i = 0; i < p_shard.retired_names.size(); i++) {
+		memdelete(p_shard.retired_names[i]);
+	}
+	for (uint32_t i = 0; i < p_shard.retired_tables.size(); i++) {
+		_Table::destroy(p_shard.retired_tables[i]);
+	}
+	p_shard.retired_names.clear();
+	p_shard.retired_tables.clear();
+}
+
+StringName::TableStats StringName::get_table_stats() {
+	TableStats stats;
+	for (int i = 0; i < SHARD_COUNT; i++) {
+		_Shard &shard = _shards[i];
+		MutexLock lock(shard.mutex);
+		_Table *table = shard.table.load(std::memory_order_relaxed);
+		stats.names += shard.names;
+		stats.capacity += table ? table->mask + 1 : 0;
+		stats.tombstones += shard.tombstones;
+		stats.collisions += shard.collisions;
+	}
+	return stats;
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		_Shard &shard = _shards[_get_shard_index(_data->table_hash)];
+		MutexLock lock(shard.mutex);
 
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			if (_table[_data->idx] != _data) {
+		_Table *table = shard.table.load(std::memory_order_relaxed);
+		uint32_t i = _data->table_hash & table->mask;
+		while (table->slots[i].load(std::memory_order_relaxed) != _data) {
+			if (!table->slots[i].load(std::memory_order_relaxed)) {
 				ERR_PRINT("BUG!");
+				_data = nullptr;
+				return;
 			}
-			_table[_data->idx] = _data->next;
+			i = (i + 1) & table->mask;
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
-		}
-		memdelete(_data);
+		table->slots[i].store(_Table::tombstone());
+		shard.names--;
+		shard.tombstones++;
+		shard.retired_names.push_back(_data);
+		_reclaim(shard);
 	}
 
 	_data = nullptr;
@@ -162,41 +390,7 @@ StringName::StringName(const char *p_name) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name, String::hash(p_name), nullptr);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -206,41 +400,7 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_static_string.ptr, String::hash(p_static_string.ptr), p_static_string.ptr);
 }
 
 StringName::StringName(const String &p_name) {
@@ -252,39 +412,7 @@ StringName::StringName(const String &p_name) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _intern(p_name, p_name.hash(), nullptr);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -295,23 +423,11 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	uint32_t table_hash = _mix_hash(hash);
+	_Data *data = _find(_shards[_get_shard_index(table_hash)], hash, table_hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -325,24 +441,11 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	uint32_t table_hash = _mix_hash(hash);
+	_Data *data = _find(_shards[_get_shard_index(table_hash)], hash, table_hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -351,24 +454,11 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	uint32_t table_hash = _mix_hash(hash);
+	_Data *data = _find(_shards[_get_shard_index(table_hash)], hash, table_hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -43,11 +43,13 @@ struct StaticCString {
 };
 
 class StringName {
+	// Names are interned in a table split in shards by hash. Each shard is an
+	// open addressing table that grows on its own; lookups don't lock, inserting
+	// and removing lock only the shard involved.
 	enum {
-
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		SHARD_BITS = 6,
+		SHARD_COUNT = 1 << SHARD_BITS,
+		SHARD_INITIAL_CAPACITY = 64,
 	};
 
 	struct _Data {
@@ -56,14 +58,22 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		uint32_t table_hash = 0; // Mixed hash, picks the shard and the slot.
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct _Table;
+	struct _Shard;
+	static _Shard _shards[SHARD_COUNT];
+
+	template <class T>
+	static _Data *_find(_Shard &p_shard, uint32_t p_hash, uint32_t p_table_hash, const T &p_name);
+	template <class T>
+	static _Data *_intern(const T &p_name, uint32_t p_hash, const char *p_static_cname);
+	static void _rehash(_Shard &p_shard);
+	static void _reclaim(_Shard &p_shard);
+	static _FORCE_INLINE_ uint32_t _get_shard_index(uint32_t p_table_hash) { return p_table_hash >> (32 - SHARD_BITS); }
 
 	_Data *_data = nullptr;
 
@@ -76,7 +86,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -125,6 +134,14 @@ public:
 	static StringName search(const char32_t *p_name);
 	static StringName search(const String &p_name);
 
+	struct TableStats {
+		uint32_t names = 0;
+		uint32_t capacity = 0; // Slots over all shards, load is names / capacity.
+		uint32_t tombstones = 0; // Slots of removed names, reclaimed on rehash.
+		uint64_t collisions = 0; // Names inserted away from their home slot, since startup.
+	};
+	static TableStats get_table_stats();
+
 	struct AlphCompare {
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
 			const char *l_cname = l._data ? l._data->cname : "";
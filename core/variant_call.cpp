@@ -1471,7 +1471,7 @@ Variant::InternalMethod *Variant::get_internal_method(Type p_type, const StringN
 	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, nullptr);
 
 	Variant::InternalMethod **m = _VariantCall::type_internal_methods[p_type].lookup_ptr(p_method_name);
-	if (*m) {
+	if (m) {
 		return *m;
 	}
 	return nullptr;
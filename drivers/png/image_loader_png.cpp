@@ -38,6 +38,13 @@
 
 Error ImageLoaderPNG::load_image(Ref<Image> p_image, FileAccess *f, bool p_force_linear, float p_scale) {
 	const size_t buffer_size = f->get_len();
+	const uint8_t *mapped = f->get_mapped_buffer(buffer_size);
+	if (mapped) {
+		// Decode straight from the file mapping, which is only valid while the file is open.
+		Error err = PNGDriverCommon::png_to_image(mapped, buffer_size, p_force_linear, p_image);
+		f->close();
+		return err;
+	}
 	Vector<uint8_t> file_buffer;
 	Error err = file_buffer.resize(buffer_size);
 	if (err) {
@@ -32,8 +32,10 @@
 
 #if defined(UNIX_ENABLED) || defined(LIBC_FILEIO_ENABLED)
 
+#include "core/io/marshalls.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
+#include "core/project_settings.h"
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -41,6 +43,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -62,6 +65,61 @@
 #include <sys/ioctl.h>
 #endif
 
+// Smaller files are cheaper to read through stdio than to map.
+#define MMAP_MIN_SIZE (64 * 1024)
+
+Mutex FileAccessUnix::mapping_mutex;
+HashMap<String, FileAccessUnix::Mapping *> FileAccessUnix::mappings;
+bool FileAccessUnix::use_mmap = true;
+
+bool FileAccessUnix::_is_mappable(const String &p_path_src, const String &p_path) {
+	// Reading a mapped file that another process truncated raises SIGBUS, so only
+	// packs and imported resources are mapped. Nothing else is expected to rewrite them in place.
+	return p_path_src.begins_with(ProjectSettings::IMPORTED_FILES_PATH) || p_path.get_extension().to_lower() == "pck";
+}
+
+FileAccessUnix::Mapping *FileAccessUnix::_acquire_mapping(const String &p_key, int p_fd, size_t p_len) {
+#if defined(UNIX_ENABLED)
+	MutexLock lock(mapping_mutex);
+
+	Mapping **existing = mappings.getptr(p_key);
+	if (existing) {
+		(*existing)->refcount++;
+		return *existing;
+	}
+
+	void *data = mmap(nullptr, p_len, PROT_READ, MAP_PRIVATE, p_fd, 0);
+	if (data == MAP_FAILED) {
+		return nullptr; // Read through stdio instead.
+	}
+
+	Mapping *mapping = memnew(Mapping);
+	mapping->key = p_key;
+	mapping->data = (uint8_t *)data;
+	mapping->len = p_len;
+	mapping->refcount = 1;
+	mappings[p_key] = mapping;
+	return mapping;
+#else
+	return nullptr;
+#endif
+}
+
+void FileAccessUnix::_release_mapping(Mapping *p_mapping) {
+#if defined(UNIX_ENABLED)
+	MutexLock lock(mapping_mutex);
+
+	p_mapping->refcount--;
+	if (p_mapping->refcount > 0) {
+		return;
+	}
+
+	mappings.erase(p_mapping->key);
+	munmap(p_mapping->data, p_mapping->len);
+	memdelete(p_mapping);
+#endif
+}
+
 void FileAccessUnix::check_errors() const {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
@@ -76,6 +134,11 @@ Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 	}
 	f = nullptr;
 
+	if (mapping) {
+		_release_mapping(mapping);
+		mapping = nullptr;
+	}
+
 	path_src = p_path;
 	path = fix_path(p_path);
 	//printf("opening %s, %i\n", path.utf8().get_data(), Memory::get_static_mem_usage());
@@ -143,6 +206,15 @@ Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 #endif
 	}
 
+	// Check the opened file rather than the path, which may have been replaced in the meantime.
+	struct stat fst;
+	if (use_mmap && p_mode_flags == READ && fd != -1 && _is_mappable(path_src, path) && fstat(fd, &fst) == 0 && S_ISREG(fst.st_mode) && fst.st_size >= MMAP_MIN_SIZE) {
+		// The key changes along with the file, so a rewritten file is never read through an old mapping.
+		String key = path + ":" + itos(fst.st_ino) + ":" + itos(fst.st_size) + ":" + itos(fst.st_mtime);
+		mapping = _acquire_mapping(key, fd, fst.st_size);
+		mapping_pos = 0;
+	}
+
 	last_error = OK;
 	flags = p_mode_flags;
 	return OK;
@@ -156,6 +228,11 @@ void FileAccessUnix::close() {
 	fclose(f);
 	f = nullptr;
 
+	if (mapping) {
+		_release_mapping(mapping);
+		mapping = nullptr;
+	}
+
 	if (close_notification_func) {
 		close_notification_func(path, flags);
 	}
@@ -188,6 +265,10 @@ void FileAccessUnix::seek(size_t p_position) {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
 	last_error = OK;
+	if (mapping) {
+		mapping_pos = p_position;
+		return;
+	}
 	if (fseek(f, p_position, SEEK_SET)) {
 		check_errors();
 	}
@@ -196,6 +277,12 @@ void FileAccessUnix::seek(size_t p_position) {
 void FileAccessUnix::seek_end(int64_t p_position) {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
+	if (mapping) {
+		ERR_FAIL_COND(int64_t(mapping->len) + p_position < 0);
+		mapping_pos = mapping->len + p_position;
+		return;
+	}
+
 	if (fseek(f, p_position, SEEK_END)) {
 		check_errors();
 	}
@@ -204,6 +291,10 @@ void FileAccessUnix::seek_end(int64_t p_position) {
 size_t FileAccessUnix::get_position() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 
+	if (mapping) {
+		return mapping_pos;
+	}
+
 	long pos = ftell(f);
 	if (pos < 0) {
 		check_errors();
@@ -215,6 +306,10 @@ size_t FileAccessUnix::get_position() const {
 size_t FileAccessUnix::get_len() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
 
+	if (mapping) {
+		return mapping->len;
+	}
+
 	long pos = ftell(f);
 	ERR_FAIL_COND_V(pos < 0, 0);
 	ERR_FAIL_COND_V(fseek(f, 0, SEEK_END), 0);
@@ -231,6 +326,13 @@ bool FileAccessUnix::eof_reached() const {
 
 uint8_t FileAccessUnix::get_8() const {
 	ERR_FAIL_COND_V_MSG(!f, 0, "File must be opened before use.");
+	if (mapping) {
+		if (mapping_pos >= mapping->len) {
+			last_error = ERR_FILE_EOF;
+			return 0;
+		}
+		return mapping->data[mapping_pos++];
+	}
 	uint8_t b;
 	if (fread(&b, 1, 1, f) == 0) {
 		check_errors();
@@ -239,13 +341,59 @@ uint8_t FileAccessUnix::get_8() const {
 	return b;
 }
 
+uint16_t FileAccessUnix::get_16() const {
+	const uint8_t *ptr = get_mapped_buffer(2);
+	if (!ptr) {
+		return FileAccess::get_16();
+	}
+	uint16_t v = decode_uint16(ptr);
+	return endian_swap ? BSWAP16(v) : v;
+}
+
+uint32_t FileAccessUnix::get_32() const {
+	const uint8_t *ptr = get_mapped_buffer(4);
+	if (!ptr) {
+		return FileAccess::get_32();
+	}
+	uint32_t v = decode_uint32(ptr);
+	return endian_swap ? BSWAP32(v) : v;
+}
+
+uint64_t FileAccessUnix::get_64() const {
+	const uint8_t *ptr = get_mapped_buffer(8);
+	if (!ptr) {
+		return FileAccess::get_64();
+	}
+	uint64_t v = decode_uint64(ptr);
+	return endian_swap ? BSWAP64(v) : v;
+}
+
 int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 	ERR_FAIL_COND_V_MSG(!f, -1, "File must be opened before use.");
+	if (mapping) {
+		size_t available = mapping_pos < mapping->len ? mapping->len - mapping_pos : 0;
+		int read = MIN((size_t)p_length, available);
+		memcpy(p_dst, mapping->data + mapping_pos, read);
+		mapping_pos += read;
+		if (read < p_length) {
+			last_error = ERR_FILE_EOF;
+		}
+		return read;
+	}
 	int read = fread(p_dst, 1, p_length, f);
 	check_errors();
 	return read;
 };
 
+const uint8_t *FileAccessUnix::get_mapped_buffer(int p_length) const {
+	if (!mapping || p_length < 0 || mapping_pos + p_length > mapping->len) {
+		return nullptr;
+	}
+	const uint8_t *ptr = mapping->data + mapping_pos;
+	mapping_pos += p_length;
+	return ptr;
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
@@ -31,8 +31,10 @@
 #ifndef FILE_ACCESS_UNIX_H
 #define FILE_ACCESS_UNIX_H
 
+#include "core/hash_map.h"
 #include "core/os/file_access.h"
 #include "core/os/memory.h"
+#include "core/os/mutex.h"
 
 #include <stdio.h>
 
@@ -41,8 +43,26 @@
 typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 
 class FileAccessUnix : public FileAccess {
+	// Read only packs and imported resources are mapped, mappings of the same file are shared.
+	struct Mapping {
+		String key;
+		uint8_t *data = nullptr;
+		size_t len = 0;
+		int refcount = 0;
+	};
+
+	static Mutex mapping_mutex;
+	static HashMap<String, Mapping *> mappings;
+	static bool use_mmap;
+
+	static Mapping *_acquire_mapping(const String &p_key, int p_fd, size_t p_len);
+	static void _release_mapping(Mapping *p_mapping);
+	static bool _is_mappable(const String &p_path_src, const String &p_path);
+
 	FILE *f = nullptr;
 	int flags = 0;
+	Mapping *mapping = nullptr;
+	mutable size_t mapping_pos = 0;
 	void check_errors() const;
 	mutable Error last_error = OK;
 	String save_path;
@@ -69,7 +89,11 @@ public:
 	virtual bool eof_reached() const; ///< reading passed EOF
 
 	virtual uint8_t get_8() const; ///< get a byte
+	virtual uint16_t get_16() const;
+	virtual uint32_t get_32() const;
+	virtual uint64_t get_64() const;
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_mapped_buffer(int p_length) const;
 
 	virtual Error get_error() const; ///< get last error
 
@@ -83,6 +107,9 @@ public:
 	virtual uint32_t _get_unix_permissions(const String &p_file);
 	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
 
+	static void set_use_mmap(bool p_enable) { use_mmap = p_enable; }
+	static bool is_using_mmap() { return use_mmap; }
+
 	FileAccessUnix() {}
 	virtual ~FileAccessUnix();
 };
@@ -619,7 +619,7 @@ void ScriptEditorDebugger::_parse_message(const String &p_msg, const Array &p_da
 			c.signature = "categ::" + name;
 			for (int j = 0; j < srv.functions.size(); j++) {
 				EditorProfiler::Metric::Category::Item item;
-				item.calls = 1;
+				item.calls = srv.functions[j].calls;
 				item.line = 0;
 				item.name = srv.functions[j].name;
 				item.self = srv.functions[j].time;
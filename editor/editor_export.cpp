@@ -1085,6 +1085,8 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	bool enc_directory = p_preset->get_enc_directory();
 	if (enc_pck && enc_directory) {
 		pack_flags |= PACK_DIR_ENCRYPTED;
+	} else {
+		pack_flags |= PACK_DIR_INDEX;
 	}
 	f->store_32(pack_flags); // flags
 
@@ -1196,6 +1198,31 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	memdelete(ftmp);
 
+	if (!(pack_flags & PACK_DIR_ENCRYPTED)) {
+		// Directory index, the file table above is kept for older versions.
+		int index_pad = _get_pad(8, f->get_position());
+		for (int i = 0; i < index_pad; i++) {
+			f->store_8(0);
+		}
+
+		Vector<PackedData::IndexedFile> indexed;
+		indexed.resize(pd.file_ofs.size());
+		for (int i = 0; i < pd.file_ofs.size(); i++) {
+			PackedData::IndexedFile &idx = indexed.write[i];
+			idx.path = pd.file_ofs[i].path_utf8;
+			idx.offset = pd.file_ofs[i].ofs;
+			idx.size = pd.file_ofs[i].size;
+			memcpy(idx.md5, pd.file_ofs[i].md5.ptr(), 16);
+			idx.flags = pd.file_ofs[i].encrypted ? PACK_FILE_ENCRYPTED : 0;
+		}
+
+		uint64_t index_ofs = f->get_position();
+		PackedData::store_index(f, indexed);
+		f->seek(file_base_ofs + 8);
+		f->store_64(index_ofs); // first reserved fields
+		f->seek_end();
+	}
+
 	if (p_embed) {
 		// Ensure embedded data ends at a 64-bit multiple
 		int64_t embed_end = f->get_position() - embed_pos + 12;
@@ -41,6 +41,7 @@
 #include "core/io/image_loader.h"
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
+#include "core/job_system.h"
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
 #include "core/os/os.h"
@@ -75,6 +76,7 @@
 #include "servers/xr_server.h"
 
 #ifdef TESTS_ENABLED
+#include "tests/benchmark_main.h"
 #include "tests/test_main.h"
 #endif
 
@@ -364,6 +366,11 @@ void Main::print_help(const char *p_binary) {
 #endif
 #ifdef TESTS_ENABLED
 	OS::get_singleton()->print("  --test [--help]                  Run unit tests. Use --test --help for more information.\n");
+	OS::get_singleton()->print("  --benchmark                      Run micro-benchmarks and print the results as JSON.\n");
+	OS::get_singleton()->print("    --benchmark-filter <text>      Only run benchmarks whose name contains <text>.\n");
+	OS::get_singleton()->print("    --benchmark-output <file>      Write the JSON results to <file> and print a summary instead.\n");
+	OS::get_singleton()->print("    --benchmark-runs <n>           Timed runs per benchmark (default: 5).\n");
+	OS::get_singleton()->print("    --benchmark-min-time <ms>      Minimum duration of each timed run (default: 50).\n");
 #endif
 	OS::get_singleton()->print("\n");
 #endif
@@ -387,6 +394,8 @@ Error Main::test_setup() {
 	GLOBAL_DEF("debug/settings/crash_handler/message",
 			String("Please include this when reporting the bug on https://github.com/godotengine/godot/issues"));
 
+	JobSystem::get_singleton()->init();
+
 	// From `Main::setup2()`.
 	preregister_module_types();
 	preregister_server_types();
@@ -459,6 +468,13 @@ int Main::test_entrypoint(int argc, char *argv[], bool &tests_need_run) {
 			test_cleanup();
 			return status;
 		}
+		if ((strncmp(argv[x], "--benchmark", 11) == 0) && (strlen(argv[x]) == 11)) {
+			tests_need_run = true;
+			test_setup();
+			int status = benchmark_main(argc, argv);
+			test_cleanup();
+			return status;
+		}
 	}
 #endif
 	tests_need_run = false;
@@ -1049,6 +1065,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 					"memory/limits/multithreaded_server/rid_pool_prealloc",
 					PROPERTY_HINT_RANGE,
 					"0,500,1")); // No negative and limit to 500 due to crashes
+	GLOBAL_DEF("memory/limits/multithreaded_server/lock_free_command_queue", true);
 	GLOBAL_DEF("network/limits/debugger/max_chars_per_second", 32768);
 	ProjectSettings::get_singleton()->set_custom_property_info("network/limits/debugger/max_chars_per_second",
 			PropertyInfo(Variant::INT,
@@ -1373,6 +1390,14 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	Engine::get_singleton()->set_frame_delay(frame_delay);
 
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads",
+			PropertyInfo(Variant::INT,
+					"threading/worker_pool/max_threads",
+					PROPERTY_HINT_RANGE,
+					"-1,256,1,or_greater")); // -1 means one thread per core, minus the main thread.
+	JobSystem::get_singleton()->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	message_queue = memnew(MessageQueue);
 
 	if (p_second_phase) {
@@ -2352,6 +2377,8 @@ bool Main::iteration() {
 
 	iterating++;
 
+	FrameAllocator::begin_frame();
+
 	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -77,6 +77,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(AUDIO_VOICE_COUNT);
+	BIND_ENUM_CONSTANT(AUDIO_VOICE_MIX_TIME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -121,6 +123,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"audio/voices",
+		"audio/voice_mix_time",
 
 	};
 
@@ -183,6 +187,10 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case AUDIO_VOICE_COUNT:
+			return AudioServer::get_singleton()->get_active_voice_count();
+		case AUDIO_VOICE_MIX_TIME:
+			return AudioServer::get_singleton()->get_voice_mix_time();
 
 		default: {
 		}
@@ -223,6 +231,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
@@ -92,6 +92,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		AUDIO_VOICE_COUNT,
+		AUDIO_VOICE_MIX_TIME,
 		MONITOR_MAX
 	};
 
@@ -30,7 +30,9 @@
 
 #include "nav_map.h"
 
-#include "core/os/threaded_array_processor.h"
+#include "core/job_system.h"
+#include "core/oa_hash_map.h"
+#include "core/sort_array.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -42,6 +44,20 @@
 
 #define USE_ENTRY_POINT
 
+// Working data of path queries, kept to reuse its memory in the next query.
+// Queries may run on any thread, so each thread has its own.
+struct PathQueryData {
+	std::vector<gd::NavigationPoly> navigation_polys;
+	// The `navigation_polys` index of each visited map polygon.
+	OAHashMap<uint32_t, uint32_t> visited_polys;
+	gd::NavigationPolyHeap open_list;
+
+	PathQueryData() :
+			open_list(navigation_polys) {}
+};
+
+static thread_local PathQueryData path_query_data;
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -71,43 +87,23 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 }
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize) const {
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
 	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 spoint = f.get_closest_point_to(p_origin);
-			float dpoint = spoint.distance_to(p_origin);
-			if (dpoint < begin_d) {
-				begin_d = dpoint;
-				begin_poly = &p;
-				begin_point = spoint;
-			}
+	ClosestPoint begin;
+	ClosestPoint end;
+	_get_closest_point(p_origin, begin);
+	_get_closest_point(p_destination, end);
 
-			spoint = f.get_closest_point_to(p_destination);
-			dpoint = spoint.distance_to(p_destination);
-			if (dpoint < end_d) {
-				end_d = dpoint;
-				end_poly = &p;
-				end_point = spoint;
-			}
-		}
-	}
-
-	if (!begin_poly || !end_poly) {
+	if (begin.polygon == -1 || end.polygon == -1) {
 		// No path
 		return Vector<Vector3>();
 	}
 
+	const gd::Polygon *begin_poly = &polygons[begin.polygon];
+	const gd::Polygon *end_poly = &polygons[end.polygon];
+	Vector3 begin_point = begin.point;
+	Vector3 end_point = end.point;
+	float end_d = end.distance;
+
 	if (begin_poly == end_poly) {
 		Vector<Vector3> path;
 		path.resize(2);
@@ -116,12 +112,15 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	std::vector<gd::NavigationPoly> &navigation_polys = path_query_data.navigation_polys;
+	OAHashMap<uint32_t, uint32_t> &visited_polys = path_query_data.visited_polys;
+	gd::NavigationPolyHeap &open_list = path_query_data.open_list;
+	open_list.clear();
+	navigation_polys.clear();
+	visited_polys.clear();
 
 	// The elements indices in the `navigation_polys`.
 	int least_cost_id(-1);
-	List<uint32_t> open_list;
 	bool found_route = false;
 
 	navigation_polys.push_back(gd::NavigationPoly(begin_poly));
@@ -131,8 +130,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		least_cost_poly->self_id = least_cost_id;
 		least_cost_poly->entry = begin_point;
 	}
-
-	open_list.push_back(0);
+	visited_polys.insert(begin.polygon, 0);
 
 	const gd::Polygon *reachable_end = nullptr;
 	float reachable_d = 1e30;
@@ -161,20 +159,25 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const float new_distance = least_cost_poly->poly->center.distance_to(edge.other_polygon->center) + least_cost_poly->traveled_distance;
 #endif
 
-				auto it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(edge.other_polygon));
+				const uint32_t other_polygon = edge.other_polygon - polygons.data();
+				uint32_t *visited_id = visited_polys.lookup_ptr(other_polygon);
 
-				if (it != navigation_polys.end()) {
+				if (visited_id) {
 					// Oh this was visited already, can we win the cost?
-					if (it->traveled_distance > new_distance) {
-						it->prev_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = edge.other_edge;
-						it->traveled_distance = new_distance;
+					gd::NavigationPoly *np = &navigation_polys[*visited_id];
+					if (np->traveled_distance > new_distance) {
+						np->prev_navigation_poly_id = least_cost_id;
+						np->back_navigation_edge = edge.other_edge;
+						np->traveled_distance = new_distance;
 #ifdef USE_ENTRY_POINT
-						it->entry = new_entry;
+						np->entry = new_entry;
+						np->cost = new_distance + np->entry.distance_to(end_point);
+#else
+						np->cost = new_distance + np->poly->center.distance_to(end_point);
 #endif
+						if (np->heap_index != -1) {
+							open_list.cost_decreased(*visited_id);
+						}
 					}
 				} else {
 					// Add to open neighbours
@@ -188,16 +191,17 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					np->traveled_distance = new_distance;
 #ifdef USE_ENTRY_POINT
 					np->entry = new_entry;
+					np->cost = new_distance + np->entry.distance_to(end_point);
+#else
+					np->cost = new_distance + np->poly->center.distance_to(end_point);
 #endif
-					open_list.push_back(navigation_polys.size() - 1);
+					visited_polys.insert(other_polygon, np->self_id);
+					open_list.push(np->self_id);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the open list so we can advance.
-		open_list.erase(least_cost_id);
-
-		if (open_list.size() == 0) {
+		if (open_list.is_empty()) {
 			// When the open list is empty at this point the End Polygon is not reachable
 			// so use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
@@ -224,8 +228,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			gd::NavigationPoly np = navigation_polys[0];
 			navigation_polys.clear();
 			navigation_polys.push_back(np);
-			open_list.clear();
-			open_list.push_back(0);
+			visited_polys.clear();
+			visited_polys.insert(begin.polygon, 0);
+			least_cost_id = 0;
 
 			reachable_end = nullptr;
 
@@ -233,22 +238,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 
 		// Now take the new least_cost_poly from the open list.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-
-		for (auto element = open_list.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-#ifdef USE_ENTRY_POINT
-			cost += np->entry.distance_to(end_point);
-#else
-			cost += np->poly->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		least_cost_id = open_list.pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -259,8 +249,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			// Yep, done!!
@@ -383,33 +371,135 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	return Vector<Vector3>();
 }
 
+static _FORCE_INLINE_ real_t _get_aabb_distance_to_point(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	const Vector3 closest(
+			CLAMP(p_point.x, p_aabb.position.x, end.x),
+			CLAMP(p_point.y, p_aabb.position.y, end.y),
+			CLAMP(p_point.z, p_aabb.position.z, end.z));
+	return closest.distance_to(p_point);
+}
+
+static _FORCE_INLINE_ real_t _get_aabb_distance_to_aabb(const AABB &p_a, const AABB &p_b) {
+	const Vector3 a_end = p_a.position + p_a.size;
+	const Vector3 b_end = p_b.position + p_b.size;
+	Vector3 gap;
+	for (int i = 0; i < 3; i++) {
+		gap[i] = MAX(0, MAX(p_a.position[i] - b_end[i], p_b.position[i] - a_end[i]));
+	}
+	return gap.length();
+}
+
+void NavMap::_get_closest_point(const Vector3 &p_point, ClosestPoint &r_closest) const {
+	if (polygons_bvh.empty()) {
+		return;
+	}
+
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const PolygonBVH &node = polygons_bvh[stack[--stack_size]];
+
+		if (_get_aabb_distance_to_point(node.bounds, p_point) > r_closest.distance + CMP_EPSILON) {
+			continue; // Already found something closer than anything in here.
+		}
+
+		if (node.children[0] & PolygonBVH::LEAF_BIT) {
+			const int polygon_id = node.children[0] & PolygonBVH::LEAF_MASK;
+			const gd::Polygon &p = polygons[polygon_id];
+
+			// For each point cast a face and check the distance to the point.
+			// On ties the first polygon of the map wins, as a linear scan would do.
+			for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 inters = f.get_closest_point_to(p_point);
+				const real_t d = inters.distance_to(p_point);
+				if (d < r_closest.distance || (d == r_closest.distance && polygon_id < r_closest.polygon)) {
+					r_closest.point = inters;
+					r_closest.normal = f.get_plane().normal;
+					r_closest.distance = d;
+					r_closest.polygon = polygon_id;
+				}
+			}
+			continue;
+		}
+
+		// Push the farthest child first, so the closest one is visited first.
+		const real_t d0 = _get_aabb_distance_to_point(polygons_bvh[node.children[0]].bounds, p_point);
+		const real_t d1 = _get_aabb_distance_to_point(polygons_bvh[node.children[1]].bounds, p_point);
+		if (d0 < d1) {
+			stack[stack_size++] = node.children[1];
+			stack[stack_size++] = node.children[0];
+		} else {
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+}
+
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	bool use_collision = p_use_collision;
+	if (polygons_bvh.empty()) {
+		return Vector3();
+	}
+
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+
+	// First look for the closest intersection with the map faces.
+	bool collided = false;
 	Vector3 closest_point;
 	real_t closest_point_d = 1e20;
 
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const PolygonBVH &node = polygons_bvh[stack[--stack_size]];
+		if (!node.bounds.intersects_segment(p_from, p_to)) {
+			continue;
+		}
 
-		// For each point cast a face and check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+		if (node.children[0] & PolygonBVH::LEAF_BIT) {
+			const gd::Polygon &p = polygons[node.children[0] & PolygonBVH::LEAF_MASK];
+
+			// For each point cast a face and check the distance to the segment
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters)) {
+					const real_t d = p_from.distance_to(inters);
+					if (d < closest_point_d) {
+						closest_point = inters;
+						closest_point_d = d;
+						collided = true;
+					}
 				}
 			}
+			continue;
+		}
+
+		stack[stack_size++] = node.children[0];
+		stack[stack_size++] = node.children[1];
+	}
+
+	if (collided || p_use_collision) {
+		return closest_point;
+	}
+
+	// No collision, take the point of the polygon edges closest to the segment.
+	AABB segment_aabb(p_from, Vector3());
+	segment_aabb.expand_to(p_to);
+
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const PolygonBVH &node = polygons_bvh[stack[--stack_size]];
+		if (_get_aabb_distance_to_aabb(node.bounds, segment_aabb) > closest_point_d + CMP_EPSILON) {
+			continue;
 		}
 
-		if (use_collision == false) {
+		if (node.children[0] & PolygonBVH::LEAF_BIT) {
+			const gd::Polygon &p = polygons[node.children[0] & PolygonBVH::LEAF_MASK];
+
 			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
 				Vector3 a, b;
 
@@ -427,89 +517,35 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 					closest_point = b;
 				}
 			}
+			continue;
 		}
+
+		stack[stack_size++] = node.children[0];
+		stack[stack_size++] = node.children[1];
 	}
 
 	return closest_point;
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_d = d;
-			}
-		}
-	}
-
-	return closest_point;
+	ClosestPoint closest;
+	_get_closest_point(p_point, closest);
+	return closest.point;
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	Vector3 closest_point_normal;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_normal = f.get_plane().normal;
-				closest_point_d = d;
-			}
-		}
-	}
-
-	return closest_point_normal;
+	ClosestPoint closest;
+	_get_closest_point(p_point, closest);
+	return closest.normal;
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	RID closest_point_owner;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_owner = p.owner->get_self();
-				closest_point_d = d;
-			}
-		}
+	ClosestPoint closest;
+	_get_closest_point(p_point, closest);
+	if (closest.polygon == -1) {
+		return RID();
 	}
-
-	return closest_point_owner;
+	return polygons[closest.polygon].owner->get_self();
 }
 
 void NavMap::add_region(NavRegion *p_region) {
@@ -593,6 +629,8 @@ void NavMap::sync() {
 			count += regions[r]->get_polygons().size();
 		}
 
+		_build_polygons_bvh();
+
 		// Connects the `Edges` of all the `Polygons` of all `Regions` each other.
 		Map<gd::EdgeKey, gd::Connection> connections;
 
@@ -724,6 +762,79 @@ void NavMap::sync() {
 	agents_dirty = false;
 }
 
+struct PolygonBVHSort {
+	const AABB *aabbs;
+	int axis;
+
+	bool operator()(const uint32_t &p_left, const uint32_t &p_right) const {
+		const AABB &left = aabbs[p_left];
+		const AABB &right = aabbs[p_right];
+		return (left.position[axis] + left.size[axis] * 0.5) < (right.position[axis] + right.size[axis] * 0.5);
+	}
+};
+
+uint32_t NavMap::_build_polygons_bvh(uint32_t *p_polygons, uint32_t p_polygon_count, const AABB *p_aabbs) {
+	uint32_t index = polygons_bvh.size();
+	{
+		PolygonBVH bvh;
+		bvh.bounds = p_aabbs[p_polygons[0]];
+		for (uint32_t i = 1; i < p_polygon_count; i++) {
+			bvh.bounds.merge_with(p_aabbs[p_polygons[i]]);
+		}
+		bvh.children[0] = PolygonBVH::LEAF_BIT | p_polygons[0];
+		bvh.children[1] = 0;
+		polygons_bvh.push_back(bvh);
+	}
+
+	if (p_polygon_count == 1) {
+		return index;
+	}
+
+	uint32_t middle = p_polygon_count / 2;
+
+	SortArray<uint32_t, PolygonBVHSort> s;
+	s.compare.aabbs = p_aabbs;
+	s.compare.axis = polygons_bvh[index].bounds.get_longest_axis_index();
+	s.nth_element(0, p_polygon_count, middle, p_polygons);
+
+	uint32_t left = _build_polygons_bvh(p_polygons, middle, p_aabbs);
+	uint32_t right = _build_polygons_bvh(p_polygons + middle, p_polygon_count - middle, p_aabbs);
+
+	polygons_bvh[index].children[0] = left;
+	polygons_bvh[index].children[1] = right;
+
+	return index;
+}
+
+void NavMap::_build_polygons_bvh() {
+	polygons_bvh.clear();
+	if (polygons.empty()) {
+		return;
+	}
+
+	LocalVector<AABB> aabbs;
+	LocalVector<uint32_t> ids;
+	aabbs.resize(polygons.size());
+	ids.resize(polygons.size());
+
+	for (size_t i(0); i < polygons.size(); i++) {
+		const gd::Polygon &p = polygons[i];
+		AABB aabb;
+		if (p.points.size()) {
+			aabb.position = p.points[0].pos;
+			for (size_t point_id = 1; point_id < p.points.size(); point_id++) {
+				aabb.expand_to(p.points[point_id].pos);
+			}
+		}
+		// Navigation polygons are usually flat, make sure the bounds have volume.
+		aabbs[i] = aabb.grow(CMP_EPSILON);
+		ids[i] = i;
+	}
+
+	polygons_bvh.reserve(polygons.size() * 2);
+	_build_polygons_bvh(ids.ptr(), ids.size(), aabbs.ptr());
+}
+
 void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 	(*(agent + index))->get_agent()->computeNeighbors(&rvo);
 	(*(agent + index))->get_agent()->computeNewVelocity(deltatime);
@@ -732,7 +843,7 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		thread_process_array(
+		JobSystem::get_singleton()->parallel_for(
 				controlled_agents.size(),
 				this,
 				&NavMap::compute_single_step,
@@ -33,6 +33,8 @@
 
 #include "nav_rid.h"
 
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
 #include "core/math/math_defs.h"
 #include "nav_utils.h"
 #include <KdTree.h>
@@ -64,6 +66,26 @@ class NavMap : public NavRid {
 	/// Map polygons
 	std::vector<gd::Polygon> polygons;
 
+	/// Bounding volume hierarchy of the map polygons, rebuilt on sync.
+	/// Used to find the polygons closest to a point or a segment.
+	struct PolygonBVH {
+		enum {
+			LEAF_BIT = 1 << 30,
+			LEAF_MASK = LEAF_BIT - 1,
+		};
+		AABB bounds;
+		uint32_t children[2];
+	};
+
+	LocalVector<PolygonBVH> polygons_bvh;
+
+	struct ClosestPoint {
+		Vector3 point;
+		Vector3 normal;
+		real_t distance = 1e20;
+		int polygon = -1;
+	};
+
 	/// Rvo world
 	RVO::KdTree rvo;
 
@@ -133,6 +155,10 @@ public:
 	void dispatch_callbacks();
 
 private:
+	uint32_t _build_polygons_bvh(uint32_t *p_polygons, uint32_t p_polygon_count, const AABB *p_aabbs);
+	void _build_polygons_bvh();
+	void _get_closest_point(const Vector3 &p_point, ClosestPoint &r_closest) const;
+
 	void compute_single_step(uint32_t index, RvoAgent **agent);
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
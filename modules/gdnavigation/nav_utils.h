@@ -127,6 +127,10 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// The traveled distance plus the estimated distance to the end point.
+	float cost = 0.0;
+	/// The position of this poly in the open list heap, -1 when not in it.
+	int heap_index = -1;
 
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
@@ -140,6 +144,94 @@ struct NavigationPoly {
 	}
 };
 
+/// Open list of the path finding: an indexed binary min heap of
+/// `NavigationPoly` ids ordered by `cost`. Each poly keeps its heap position
+/// so its cost can be decreased in place.
+class NavigationPolyHeap {
+	std::vector<NavigationPoly> &polys;
+	std::vector<uint32_t> heap;
+
+	bool less(uint32_t p_a, uint32_t p_b) const {
+		const NavigationPoly &a = polys[p_a];
+		const NavigationPoly &b = polys[p_b];
+		// On ties the oldest poly wins, like a plain list scan would do.
+		return a.cost < b.cost || (a.cost == b.cost && p_a < p_b);
+	}
+
+	void place(uint32_t p_pos, uint32_t p_id) {
+		heap[p_pos] = p_id;
+		polys[p_id].heap_index = p_pos;
+	}
+
+	void sift_up(uint32_t p_pos) {
+		uint32_t id = heap[p_pos];
+		while (p_pos > 0) {
+			uint32_t parent = (p_pos - 1) / 2;
+			if (!less(id, heap[parent])) {
+				break;
+			}
+			place(p_pos, heap[parent]);
+			p_pos = parent;
+		}
+		place(p_pos, id);
+	}
+
+	void sift_down(uint32_t p_pos) {
+		uint32_t id = heap[p_pos];
+		const uint32_t size = heap.size();
+		while (true) {
+			uint32_t child = p_pos * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && less(heap[child + 1], heap[child])) {
+				child++;
+			}
+			if (!less(heap[child], id)) {
+				break;
+			}
+			place(p_pos, heap[child]);
+			p_pos = child;
+		}
+		place(p_pos, id);
+	}
+
+public:
+	bool is_empty() const { return heap.empty(); }
+
+	void push(uint32_t p_id) {
+		heap.push_back(p_id);
+		sift_up(heap.size() - 1);
+	}
+
+	uint32_t pop() {
+		uint32_t id = heap[0];
+		polys[id].heap_index = -1;
+		uint32_t last = heap.back();
+		heap.pop_back();
+		if (!heap.empty()) {
+			place(0, last);
+			sift_down(0);
+		}
+		return id;
+	}
+
+	/// Must be called after the cost of a poly in the heap decreased.
+	void cost_decreased(uint32_t p_id) {
+		sift_up(polys[p_id].heap_index);
+	}
+
+	void clear() {
+		for (size_t i = 0; i < heap.size(); i++) {
+			polys[heap[i]].heap_index = -1;
+		}
+		heap.clear();
+	}
+
+	NavigationPolyHeap(std::vector<NavigationPoly> &p_polys) :
+			polys(p_polys) {}
+};
+
 struct FreeEdge {
 	bool is_free;
 	Polygon *poly;
@@ -0,0 +1,172 @@
+/*************************************************************************/
+/*  test_nav_map.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_MAP_H
+#define TEST_NAV_MAP_H
+
+#include "modules/gdnavigation/nav_map.h"
+#include "modules/gdnavigation/nav_region.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMap {
+
+const int GRID_SIZE = 10;
+
+// Unit quads covering [0, GRID_SIZE] on the XZ plane. With a wall, the cells
+// of column 5 are left out except for the last row, the only way across.
+Ref<NavigationMesh> create_grid(bool p_wall) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= GRID_SIZE; z++) {
+		for (int x = 0; x <= GRID_SIZE; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> mesh;
+	mesh.instance();
+	mesh->set_vertices(vertices);
+	for (int z = 0; z < GRID_SIZE; z++) {
+		for (int x = 0; x < GRID_SIZE; x++) {
+			if (p_wall && x == 5 && z < GRID_SIZE - 1) {
+				continue;
+			}
+			Vector<int> polygon;
+			polygon.push_back(z * (GRID_SIZE + 1) + x);
+			polygon.push_back((z + 1) * (GRID_SIZE + 1) + x);
+			polygon.push_back((z + 1) * (GRID_SIZE + 1) + x + 1);
+			polygon.push_back(z * (GRID_SIZE + 1) + x + 1);
+			mesh->add_polygon(polygon);
+		}
+	}
+	return mesh;
+}
+
+real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[NavMap] Closest point queries match the map geometry") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(create_grid(false));
+	map.add_region(&region);
+	map.sync();
+
+	// Sample points inside, above, below and around the grid; the closest
+	// point is always the point clamped to the grid bounds.
+	int wrong = 0;
+	for (int x = -4; x <= GRID_SIZE * 2 + 4; x++) {
+		for (int z = -4; z <= GRID_SIZE * 2 + 4; z++) {
+			for (int y = -2; y <= 2; y += 2) {
+				const Vector3 point(x * 0.5 + 0.1, y, z * 0.5 + 0.2);
+				const Vector3 expected(CLAMP(point.x, 0, GRID_SIZE), 0, CLAMP(point.z, 0, GRID_SIZE));
+				if (!map.get_closest_point(point).is_equal_approx(expected)) {
+					wrong++;
+				}
+			}
+		}
+	}
+	CHECK_MESSAGE(wrong == 0, "The closest point should be on the map, right below or next to the queried point.");
+
+	CHECK_MESSAGE(
+			Math::is_equal_approx(Math::abs(map.get_closest_point_normal(Vector3(3.5, 1, 7.5)).y), 1),
+			"The normal of a flat map should be vertical.");
+}
+
+TEST_CASE("[NavMap] Closest point to segment") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(create_grid(false));
+	map.add_region(&region);
+	map.sync();
+
+	CHECK_MESSAGE(
+			map.get_closest_point_to_segment(Vector3(2.5, 5, 3.5), Vector3(2.5, -5, 3.5), true).is_equal_approx(Vector3(2.5, 0, 3.5)),
+			"A segment crossing the map should return the intersection.");
+	CHECK_MESSAGE(
+			map.get_closest_point_to_segment(Vector3(2.5, 5, 3.5), Vector3(4.5, -5, 3.5), true).is_equal_approx(Vector3(3.5, 0, 3.5)),
+			"A slanted segment crossing the map should return the intersection.");
+
+	const Vector3 above = map.get_closest_point_to_segment(Vector3(1, 1, 1), Vector3(4, 1, 1), false);
+	CHECK_MESSAGE(Math::is_zero_approx(above.y), "The closest point to a segment above the map should be on the map.");
+	CHECK_MESSAGE(Math::is_equal_approx(above.z, 1), "The closest point to a segment above the map should be right below it.");
+	CHECK_MESSAGE((above.x >= 1 - CMP_EPSILON && above.x <= 4 + CMP_EPSILON), "The closest point to a segment above the map should be right below it.");
+}
+
+TEST_CASE("[NavMap] Path queries") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(create_grid(true));
+	map.add_region(&region);
+	map.sync();
+
+	const Vector3 from(2.5, 0, 2.5);
+	const Vector3 to(8.5, 0, 2.5);
+
+	for (int optimize = 0; optimize < 2; optimize++) {
+		Vector<Vector3> path = map.get_path(from, to, optimize);
+		REQUIRE_MESSAGE(path.size() >= 2, "A path should be found around the wall.");
+		CHECK_MESSAGE(path[0].is_equal_approx(from), "The path should start at the origin.");
+		CHECK_MESSAGE(path[path.size() - 1].is_equal_approx(to), "The path should end at the destination.");
+
+		// The only way across the wall is through the last row.
+		real_t max_z = 0;
+		for (int i = 0; i < path.size(); i++) {
+			max_z = MAX(max_z, path[i].z);
+		}
+		CHECK_MESSAGE(max_z >= GRID_SIZE - 1 - CMP_EPSILON, "The path should go through the gap in the wall.");
+		CHECK_MESSAGE(get_path_length(path) > from.distance_to(to) + 6, "The path should go around the wall.");
+	}
+
+	// Without the wall, the optimized path is a straight line.
+	region.set_mesh(create_grid(false));
+	map.sync();
+	Vector<Vector3> path = map.get_path(from, to, true);
+	REQUIRE(path.size() >= 2);
+	CHECK_MESSAGE(Math::is_equal_approx(get_path_length(path), from.distance_to(to)), "The optimized path should be a straight line.");
+
+	// Same across the whole map.
+	path = map.get_path(Vector3(0.5, 0, 0.5), Vector3(9.5, 0, 9.5), true);
+	REQUIRE(path.size() >= 2);
+	CHECK_MESSAGE(Math::is_equal_approx(get_path_length(path), Vector3(0.5, 0, 0.5).distance_to(Vector3(9.5, 0, 9.5))), "The optimized diagonal path should be a straight line.");
+}
+
+} // namespace TestNavMap
+
+#endif // TEST_NAV_MAP_H
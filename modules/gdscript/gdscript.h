@@ -320,6 +320,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	int _debug_parse_err_line;
 	String _debug_parse_err_file;
 	String _debug_error;
+	// The debug call stack only follows the main thread. Scripts run elsewhere, like nodes
+	// in sub-thread process groups, are skipped by enter_function() and exit_function().
 	int _debug_call_stack_pos;
 	int _debug_max_call_stack;
 	CallLevel *_call_stack;
@@ -140,6 +140,30 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_global_names_count = 0;
 	}
 
+	if (method_bind_map.size()) {
+		function->methods.resize(method_bind_map.size());
+		function->_methods_ptr = function->methods.ptr();
+		for (Map<MethodBind *, int>::Element *E = method_bind_map.front(); E; E = E->next()) {
+			function->methods.write[E->get()] = E->key();
+		}
+		function->_methods_count = function->methods.size();
+	} else {
+		function->_methods_ptr = nullptr;
+		function->_methods_count = 0;
+	}
+
+	if (builtin_method_map.size()) {
+		function->builtin_methods.resize(builtin_method_map.size());
+		function->_builtin_methods_ptr = function->builtin_methods.ptr();
+		for (Map<Variant::InternalMethod *, int>::Element *E = builtin_method_map.front(); E; E = E->next()) {
+			function->builtin_methods.write[E->get()] = E->key();
+		}
+		function->_builtin_methods_count = function->builtin_methods.size();
+	} else {
+		function->_builtin_methods_ptr = nullptr;
+		function->_builtin_methods_count = 0;
+	}
+
 	if (opcodes.size()) {
 		function->code = opcodes;
 		function->_code_ptr = &function->code[0];
@@ -178,8 +202,49 @@ void GDScriptByteCodeGenerator::set_initial_line(int p_line) {
 	function->_initial_line = p_line;
 }
 
+static bool _is_typed_builtin(const GDScriptCodeGenerator::Address &p_address, Variant::Type p_type) {
+	return p_address.type.has_type && p_address.type.kind == GDScriptDataType::BUILTIN && p_address.type.builtin_type == p_type;
+}
+
 void GDScriptByteCodeGenerator::write_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
-	append(GDScriptFunction::OPCODE_OPERATOR);
+	GDScriptFunction::Opcode opcode = GDScriptFunction::OPCODE_OPERATOR;
+
+	// Operators the VM can evaluate without going through Variant::evaluate() when both operands are known numbers.
+	bool left_int = _is_typed_builtin(p_left_operand, Variant::INT);
+	bool right_int = _is_typed_builtin(p_right_operand, Variant::INT);
+	bool left_float = _is_typed_builtin(p_left_operand, Variant::FLOAT);
+	bool right_float = _is_typed_builtin(p_right_operand, Variant::FLOAT);
+
+	switch (p_operator) {
+		case Variant::OP_ADD:
+		case Variant::OP_SUBTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE:
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL: {
+			if (left_int && right_int) {
+				opcode = GDScriptFunction::OPCODE_OPERATOR_INT;
+			} else if ((left_int || left_float) && (right_int || right_float)) {
+				opcode = GDScriptFunction::OPCODE_OPERATOR_FLOAT;
+			}
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR: {
+			if (left_int && right_int) {
+				opcode = GDScriptFunction::OPCODE_OPERATOR_INT;
+			}
+		} break;
+		default: {
+		}
+	}
+
+	append(opcode);
 	append(p_operator);
 	append(p_left_operand);
 	append(p_right_operand);
@@ -474,10 +539,10 @@ void GDScriptByteCodeGenerator::write_call_builtin(const Address &p_target, GDSc
 }
 
 void GDScriptByteCodeGenerator::write_call_method_bind(const Address &p_target, const Address &p_base, const MethodBind *p_method, const Vector<Address> &p_arguments) {
-	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN);
+	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL_METHOD_BIND : GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET);
 	append(p_arguments.size());
 	append(p_base);
-	append(p_method->get_name());
+	append(get_method_bind_pos(p_method));
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
 	}
@@ -486,10 +551,31 @@ void GDScriptByteCodeGenerator::write_call_method_bind(const Address &p_target,
 }
 
 void GDScriptByteCodeGenerator::write_call_ptrcall(const Address &p_target, const Address &p_base, const MethodBind *p_method, const Vector<Address> &p_arguments) {
-	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN);
+	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL_PTRCALL : GDScriptFunction::OPCODE_CALL_PTRCALL_RET);
+	append(p_arguments.size());
+	append(p_base);
+	append(get_method_bind_pos(p_method));
+	for (int i = 0; i < p_arguments.size(); i++) {
+		append(p_arguments[i]);
+	}
+	append(p_target);
+	alloc_call(p_arguments.size());
+}
+
+void GDScriptByteCodeGenerator::write_call_builtin_type(const Address &p_target, const Address &p_base, Variant::Type p_type, const StringName &p_method, const Vector<Address> &p_arguments) {
+	Variant::InternalMethod *method = Variant::get_internal_method(p_type, p_method);
+	if (!method) {
+		// Shouldn't get here, the compiler only asks for methods that exist.
+		write_call(p_target, p_base, p_method, p_arguments);
+		return;
+	}
+
+	append(GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED);
 	append(p_arguments.size());
+	append(p_type);
 	append(p_base);
-	append(p_method->get_name());
+	append(p_method);
+	append(get_builtin_method_pos(method));
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
 	}
@@ -584,6 +670,27 @@ void GDScriptByteCodeGenerator::write_for(const Address &p_variable, const Addre
 	int container_pos = increase_stack() | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
 
 	current_breaks_to_patch.push_back(List<int>());
+	for_temporaries.push_back(2);
+
+	// Packed arrays have a typed iterator, others go through Variant's iteration API.
+	bool packed_array = false;
+	if (p_list.type.has_type && p_list.type.kind == GDScriptDataType::BUILTIN) {
+		switch (p_list.type.builtin_type) {
+			case Variant::PACKED_BYTE_ARRAY:
+			case Variant::PACKED_INT32_ARRAY:
+			case Variant::PACKED_INT64_ARRAY:
+			case Variant::PACKED_FLOAT32_ARRAY:
+			case Variant::PACKED_FLOAT64_ARRAY:
+			case Variant::PACKED_STRING_ARRAY:
+			case Variant::PACKED_VECTOR2_ARRAY:
+			case Variant::PACKED_VECTOR3_ARRAY:
+			case Variant::PACKED_COLOR_ARRAY: {
+				packed_array = true;
+			} break;
+			default: {
+			}
+		}
+	}
 
 	// Assign container.
 	append(GDScriptFunction::OPCODE_ASSIGN);
@@ -591,7 +698,7 @@ void GDScriptByteCodeGenerator::write_for(const Address &p_variable, const Addre
 	append(p_list);
 
 	// Begin loop.
-	append(GDScriptFunction::OPCODE_ITERATE_BEGIN);
+	append(packed_array ? GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_ARRAY : GDScriptFunction::OPCODE_ITERATE_BEGIN);
 	append(counter_pos);
 	append(container_pos);
 	for_jmp_addrs.push_back(opcodes.size());
@@ -603,7 +710,7 @@ void GDScriptByteCodeGenerator::write_for(const Address &p_variable, const Addre
 	// Next iteration.
 	int continue_addr = opcodes.size();
 	continue_addrs.push_back(continue_addr);
-	append(GDScriptFunction::OPCODE_ITERATE);
+	append(packed_array ? GDScriptFunction::OPCODE_ITERATE_PACKED_ARRAY : GDScriptFunction::OPCODE_ITERATE);
 	append(counter_pos);
 	append(container_pos);
 	for_jmp_addrs.push_back(opcodes.size());
@@ -611,6 +718,40 @@ void GDScriptByteCodeGenerator::write_for(const Address &p_variable, const Addre
 	append(p_variable);
 }
 
+void GDScriptByteCodeGenerator::write_for_range(const Address &p_variable, const Address &p_from, const Address &p_to, const Address &p_step) {
+	int counter_pos = increase_stack() | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+	int to_pos = increase_stack() | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+	int step_pos = increase_stack() | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+
+	current_breaks_to_patch.push_back(List<int>());
+	for_temporaries.push_back(3);
+
+	// Begin loop. The bounds are copied, so the loop doesn't need to build an array.
+	append(GDScriptFunction::OPCODE_ITERATE_BEGIN_RANGE);
+	append(counter_pos);
+	append(to_pos);
+	append(step_pos);
+	append(p_from);
+	append(p_to);
+	append(p_step);
+	for_jmp_addrs.push_back(opcodes.size());
+	append(0); // End of loop address, will be patched.
+	append(p_variable);
+	append(GDScriptFunction::OPCODE_JUMP);
+	append(opcodes.size() + 7); // Skip over 'continue' code.
+
+	// Next iteration.
+	int continue_addr = opcodes.size();
+	continue_addrs.push_back(continue_addr);
+	append(GDScriptFunction::OPCODE_ITERATE_RANGE);
+	append(counter_pos);
+	append(to_pos);
+	append(step_pos);
+	for_jmp_addrs.push_back(opcodes.size());
+	append(0); // Jump destination, will be patched.
+	append(p_variable);
+}
+
 void GDScriptByteCodeGenerator::write_endfor() {
 	// Jump back to loop check.
 	append(GDScriptFunction::OPCODE_JUMP);
@@ -629,7 +770,8 @@ void GDScriptByteCodeGenerator::write_endfor() {
 	}
 	current_breaks_to_patch.pop_back();
 
-	current_stack_size -= 2; // Remove loop temporaries.
+	current_stack_size -= for_temporaries.back()->get(); // Remove loop temporaries.
+	for_temporaries.pop_back();
 }
 
 void GDScriptByteCodeGenerator::start_while_condition() {
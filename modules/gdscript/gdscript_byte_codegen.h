@@ -52,6 +52,8 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	HashMap<Variant, int, VariantHasher, VariantComparator> constant_map;
 	Map<StringName, int> name_map;
+	Map<MethodBind *, int> method_bind_map;
+	Map<Variant::InternalMethod *, int> builtin_method_map;
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
@@ -61,6 +63,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	List<int> if_jmp_addrs; // List since this can be nested.
 	List<int> for_jmp_addrs;
+	List<int> for_temporaries; // Stack slots used by each nested loop.
 	List<int> while_jmp_addrs;
 	List<int> continue_addrs;
 
@@ -126,6 +129,27 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		return ret;
 	}
 
+	int get_method_bind_pos(const MethodBind *p_method) {
+		MethodBind *method = const_cast<MethodBind *>(p_method);
+		Map<MethodBind *, int>::Element *E = method_bind_map.find(method);
+		if (E) {
+			return E->get();
+		}
+		int pos = method_bind_map.size();
+		method_bind_map[method] = pos;
+		return pos;
+	}
+
+	int get_builtin_method_pos(Variant::InternalMethod *p_method) {
+		Map<Variant::InternalMethod *, int>::Element *E = builtin_method_map.find(p_method);
+		if (E) {
+			return E->get();
+		}
+		int pos = builtin_method_map.size();
+		builtin_method_map[p_method] = pos;
+		return pos;
+	}
+
 	int get_constant_pos(const Variant &p_constant) {
 		if (constant_map.has(p_constant))
 			return constant_map[p_constant];
@@ -246,6 +270,7 @@ public:
 	virtual void write_call_builtin(const Address &p_target, GDScriptFunctions::Function p_function, const Vector<Address> &p_arguments) override;
 	virtual void write_call_method_bind(const Address &p_target, const Address &p_base, const MethodBind *p_method, const Vector<Address> &p_arguments) override;
 	virtual void write_call_ptrcall(const Address &p_target, const Address &p_base, const MethodBind *p_method, const Vector<Address> &p_arguments) override;
+	virtual void write_call_builtin_type(const Address &p_target, const Address &p_base, Variant::Type p_type, const StringName &p_method, const Vector<Address> &p_arguments) override;
 	virtual void write_call_self(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) override;
@@ -256,6 +281,7 @@ public:
 	virtual void write_else() override;
 	virtual void write_endif() override;
 	virtual void write_for(const Address &p_variable, const Address &p_list) override;
+	virtual void write_for_range(const Address &p_variable, const Address &p_from, const Address &p_to, const Address &p_step) override;
 	virtual void write_endfor() override;
 	virtual void start_while_condition() override;
 	virtual void write_while(const Address &p_condition) override;
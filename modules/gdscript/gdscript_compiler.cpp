@@ -158,6 +158,88 @@ GDScriptDataType GDScriptCompiler::_gdtype_from_datatype(const GDScriptParser::D
 	return result;
 }
 
+static bool _is_exact_type(Variant::Type p_type, const GDScriptCodeGenerator::Address &p_address) {
+	if (p_type == Variant::NIL) {
+		return true; // Variant argument, anything goes.
+	}
+	return p_address.type.has_type && p_address.type.kind == GDScriptDataType::BUILTIN && p_address.type.builtin_type == p_type;
+}
+
+bool GDScriptCompiler::_have_exact_arguments(const MethodBind *p_method, const Vector<GDScriptCodeGenerator::Address> &p_arguments) {
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+	// Ptrcalls don't convert arguments nor fill default ones, and objects need extra handling.
+	if (p_method->is_vararg() || p_method->get_argument_count() != p_arguments.size()) {
+		return false;
+	}
+	if (p_method->get_argument_type(-1) == Variant::OBJECT) {
+		return false;
+	}
+	for (int i = 0; i < p_arguments.size(); i++) {
+		Variant::Type arg_type = p_method->get_argument_type(i);
+		if (arg_type == Variant::OBJECT || !_is_exact_type(arg_type, p_arguments[i])) {
+			return false;
+		}
+	}
+	return true;
+#else
+	// Argument types are not available to check against.
+	return false;
+#endif
+}
+
+bool GDScriptCompiler::_can_use_validated_call(Variant::Type p_type, const StringName &p_method, const Vector<GDScriptCodeGenerator::Address> &p_arguments) {
+#ifdef DEBUG_METHODS_ENABLED
+	if (p_type == Variant::NIL || p_type == Variant::OBJECT) {
+		return false;
+	}
+
+	Variant::InternalMethod *method = Variant::get_internal_method(p_type, p_method);
+	if (!method) {
+		return false;
+	}
+	if (method->get_flags() & (Variant::InternalMethod::FLAG_VARARGS | Variant::InternalMethod::FLAG_NO_PTRCALL)) {
+		return false;
+	}
+	if (method->get_argument_count() != p_arguments.size() || method->get_return_type() == Variant::OBJECT) {
+		return false;
+	}
+	for (int i = 0; i < p_arguments.size(); i++) {
+		Variant::Type arg_type = method->get_argument_type(i);
+		if (arg_type == Variant::OBJECT || !_is_exact_type(arg_type, p_arguments[i])) {
+			return false;
+		}
+	}
+	return true;
+#else
+	// Argument types are not available to check against.
+	return false;
+#endif
+}
+
+bool GDScriptCompiler::_is_int_range(const GDScriptParser::ExpressionNode *p_list) {
+	// Matches `range(...)` with int arguments, which can be iterated without building an array.
+	if (p_list->type != GDScriptParser::Node::CALL) {
+		return false;
+	}
+	const GDScriptParser::CallNode *call = static_cast<const GDScriptParser::CallNode *>(p_list);
+	if (call->is_super || call->callee == nullptr || call->callee->type != GDScriptParser::Node::IDENTIFIER) {
+		return false;
+	}
+	if (GDScriptParser::get_builtin_function(static_cast<const GDScriptParser::IdentifierNode *>(call->callee)->name) != GDScriptFunctions::GEN_RANGE) {
+		return false;
+	}
+	if (call->arguments.size() < 1 || call->arguments.size() > 3) {
+		return false;
+	}
+	for (int i = 0; i < call->arguments.size(); i++) {
+		GDScriptDataType type = _gdtype_from_datatype(call->arguments[i]->get_datatype());
+		if (!type.has_type || type.kind != GDScriptDataType::BUILTIN || type.builtin_type != Variant::INT) {
+			return false;
+		}
+	}
+	return true;
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root, bool p_initializer, const GDScriptCodeGenerator::Address &p_index_addr) {
 	if (p_expression->is_constant) {
 		return codegen.add_constant(p_expression->reduced_value);
@@ -447,6 +529,16 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 							}
 							if (within_await) {
 								gen->write_call_async(result, base, call->function_name, arguments);
+							} else if (base.type.has_type && base.type.kind == GDScriptDataType::NATIVE && ClassDB::get_method(base.type.native_type, call->function_name) != nullptr) {
+								// Native method on a statically typed object, no need to look it up by name.
+								MethodBind *method = ClassDB::get_method(base.type.native_type, call->function_name);
+								if (_have_exact_arguments(method, arguments)) {
+									gen->write_call_ptrcall(result, base, method, arguments);
+								} else {
+									gen->write_call_method_bind(result, base, method, arguments);
+								}
+							} else if (base.type.has_type && base.type.kind == GDScriptDataType::BUILTIN && _can_use_validated_call(base.type.builtin_type, call->function_name, arguments)) {
+								gen->write_call_builtin_type(result, base, base.type.builtin_type, call->function_name, arguments);
 							} else {
 								gen->write_call(result, base, call->function_name, arguments);
 							}
@@ -668,6 +760,14 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					GDScriptCodeGenerator::Address left_operand = _parse_expression(codegen, r_error, binary->left_operand);
 					GDScriptCodeGenerator::Address right_operand = _parse_expression(codegen, r_error, binary->right_operand);
 
+					if (left_operand.type.has_type && right_operand.type.has_type) {
+						// With both operands statically typed, so is the result. This lets nested operations use typed opcodes.
+						GDScriptDataType result_type = _gdtype_from_datatype(binary->get_datatype());
+						if (result_type.kind == GDScriptDataType::BUILTIN) {
+							result.type = result_type;
+						}
+					}
+
 					gen->write_operator(result, binary->variant_op, left_operand, right_operand);
 
 					if (right_operand.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
@@ -1500,12 +1600,36 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				codegen.start_block();
 				GDScriptCodeGenerator::Address iterator = codegen.add_local(for_n->variable->name, _gdtype_from_datatype(for_n->variable->get_datatype()));
 
-				GDScriptCodeGenerator::Address list = _parse_expression(codegen, error, for_n->list);
-				if (error) {
-					return error;
-				}
+				Vector<GDScriptCodeGenerator::Address> range_args;
+				GDScriptCodeGenerator::Address list;
 
-				gen->write_for(iterator, list);
+				if (_is_int_range(for_n->list)) {
+					// Iterate the range directly instead of building an array with all the values.
+					const GDScriptParser::CallNode *range_call = static_cast<const GDScriptParser::CallNode *>(for_n->list);
+					for (int i = 0; i < range_call->arguments.size(); i++) {
+						range_args.push_back(_parse_expression(codegen, error, range_call->arguments[i]));
+						if (error) {
+							return error;
+						}
+					}
+
+					GDScriptCodeGenerator::Address from = range_args.size() > 1 ? range_args[0] : codegen.add_constant(0);
+					GDScriptCodeGenerator::Address to = range_args.size() > 1 ? range_args[1] : range_args[0];
+					GDScriptCodeGenerator::Address step = range_args.size() > 2 ? range_args[2] : codegen.add_constant(1);
+					gen->write_for_range(iterator, from, to, step);
+				} else {
+					list = _parse_expression(codegen, error, for_n->list);
+					if (error) {
+						return error;
+					}
+
+					if (_is_exact_type(Variant::INT, list)) {
+						// Iterating an int counts from zero to it.
+						gen->write_for_range(iterator, codegen.add_constant(0), list, codegen.add_constant(1));
+					} else {
+						gen->write_for(iterator, list);
+					}
+				}
 
 				error = _parse_block(codegen, for_n->loop);
 				if (error) {
@@ -1517,6 +1641,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				if (list.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
 					codegen.generator->pop_temporary();
 				}
+				for (int i = range_args.size() - 1; i >= 0; i--) {
+					if (range_args[i].mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+						codegen.generator->pop_temporary();
+					}
+				}
 
 				codegen.end_block();
 			} break;
@@ -31,6 +31,7 @@
 #include "gdscript_function.h"
 
 #include "core/os/os.h"
+#include "core/variant_internal.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
 
@@ -188,10 +189,161 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+// Helpers for the typed opcodes. They write into the destination in place when it already holds a value of the right type.
+
+static _FORCE_INLINE_ void _set_int(Variant *p_dst, int64_t p_value) {
+	if (likely(p_dst->get_type() == Variant::INT)) {
+		*VariantInternal::get_int(p_dst) = p_value;
+	} else {
+		*p_dst = p_value;
+	}
+}
+
+static _FORCE_INLINE_ void _set_float(Variant *p_dst, double p_value) {
+	if (likely(p_dst->get_type() == Variant::FLOAT)) {
+		*VariantInternal::get_float(p_dst) = p_value;
+	} else {
+		*p_dst = p_value;
+	}
+}
+
+static _FORCE_INLINE_ void _set_bool(Variant *p_dst, bool p_value) {
+	if (likely(p_dst->get_type() == Variant::BOOL)) {
+		*VariantInternal::get_bool(p_dst) = p_value;
+	} else {
+		*p_dst = p_value;
+	}
+}
+
+// Makes sure p_dst holds a value of the given type, so validated calls and ptrcalls can write into it.
+static _FORCE_INLINE_ void _prepare_return(Variant *p_dst, Variant::Type p_type) {
+	if (p_dst->get_type() != p_type) {
+		Callable::CallError ce;
+		*p_dst = Variant::construct(p_type, nullptr, 0, ce);
+	}
+}
+
+template <class T>
+static _FORCE_INLINE_ int _get_packed_array_element(const Vector<T> *p_array, int64_t p_index, Variant *r_iterator) {
+	if (p_index >= p_array->size()) {
+		return 0;
+	}
+	*r_iterator = (*p_array)[p_index];
+	return 1;
+}
+
+// Returns 1 and sets r_iterator if p_index is within the array, 0 past the end,
+// and -1 if p_container is not a packed array and must use the generic iterator.
+static _FORCE_INLINE_ int _iterate_packed_array(const Variant *p_container, int64_t p_index, Variant *r_iterator) {
+	switch (p_container->get_type()) {
+		case Variant::PACKED_BYTE_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_byte_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_INT32_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_int32_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_INT64_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_int64_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_float32_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_float64_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_STRING_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_string_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_vector2_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_vector3_array(p_container), p_index, r_iterator);
+		case Variant::PACKED_COLOR_ARRAY:
+			return _get_packed_array_element(VariantInternal::get_color_array(p_container), p_index, r_iterator);
+		default:
+			return -1;
+	}
+}
+
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+// Returns the pointer a ptrcall expects for a value of the given type. NIL stands for a Variant argument or return.
+static void *_get_ptrcall_data(Variant *p_value, Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::NIL:
+			return p_value;
+		case Variant::BOOL:
+			return VariantInternal::get_bool(p_value);
+		case Variant::INT:
+			return VariantInternal::get_int(p_value);
+		case Variant::FLOAT:
+			return VariantInternal::get_float(p_value);
+		case Variant::STRING:
+			return VariantInternal::get_string(p_value);
+		case Variant::VECTOR2:
+			return VariantInternal::get_vector2(p_value);
+		case Variant::VECTOR2I:
+			return VariantInternal::get_vector2i(p_value);
+		case Variant::RECT2:
+			return VariantInternal::get_rect2(p_value);
+		case Variant::RECT2I:
+			return VariantInternal::get_rect2i(p_value);
+		case Variant::VECTOR3:
+			return VariantInternal::get_vector3(p_value);
+		case Variant::VECTOR3I:
+			return VariantInternal::get_vector3i(p_value);
+		case Variant::TRANSFORM2D:
+			return VariantInternal::get_transform2d(p_value);
+		case Variant::PLANE:
+			return VariantInternal::get_plane(p_value);
+		case Variant::QUAT:
+			return VariantInternal::get_quat(p_value);
+		case Variant::AABB:
+			return VariantInternal::get_aabb(p_value);
+		case Variant::BASIS:
+			return VariantInternal::get_basis(p_value);
+		case Variant::TRANSFORM:
+			return VariantInternal::get_transform(p_value);
+		case Variant::COLOR:
+			return VariantInternal::get_color(p_value);
+		case Variant::STRING_NAME:
+			return VariantInternal::get_string_name(p_value);
+		case Variant::NODE_PATH:
+			return VariantInternal::get_node_path(p_value);
+		case Variant::_RID:
+			return VariantInternal::get_rid(p_value);
+		case Variant::CALLABLE:
+			return VariantInternal::get_callable(p_value);
+		case Variant::SIGNAL:
+			return VariantInternal::get_signal(p_value);
+		case Variant::DICTIONARY:
+			return VariantInternal::get_dictionary(p_value);
+		case Variant::ARRAY:
+			return VariantInternal::get_array(p_value);
+		case Variant::PACKED_BYTE_ARRAY:
+			return VariantInternal::get_byte_array(p_value);
+		case Variant::PACKED_INT32_ARRAY:
+			return VariantInternal::get_int32_array(p_value);
+		case Variant::PACKED_INT64_ARRAY:
+			return VariantInternal::get_int64_array(p_value);
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return VariantInternal::get_float32_array(p_value);
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return VariantInternal::get_float64_array(p_value);
+		case Variant::PACKED_STRING_ARRAY:
+			return VariantInternal::get_string_array(p_value);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return VariantInternal::get_vector2_array(p_value);
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return VariantInternal::get_vector3_array(p_value);
+		case Variant::PACKED_COLOR_ARRAY:
+			return VariantInternal::get_color_array(p_value);
+		default:
+			// Objects are never passed through ptrcalls by the compiler.
+			return nullptr;
+	}
+}
+#endif
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_FLOAT,              \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
@@ -217,6 +369,11 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_CALL_ASYNC,                  \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF_BASE,              \
+		&&OPCODE_CALL_METHOD_BIND,            \
+		&&OPCODE_CALL_METHOD_BIND_RET,        \
+		&&OPCODE_CALL_PTRCALL,                \
+		&&OPCODE_CALL_PTRCALL_RET,            \
+		&&OPCODE_CALL_BUILTIN_TYPE_VALIDATED, \
 		&&OPCODE_AWAIT,                       \
 		&&OPCODE_AWAIT_RESUME,                \
 		&&OPCODE_JUMP,                        \
@@ -226,6 +383,10 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_RETURN,                      \
 		&&OPCODE_ITERATE_BEGIN,               \
 		&&OPCODE_ITERATE,                     \
+		&&OPCODE_ITERATE_BEGIN_RANGE,         \
+		&&OPCODE_ITERATE_RANGE,               \
+		&&OPCODE_ITERATE_BEGIN_PACKED_ARRAY,  \
+		&&OPCODE_ITERATE_PACKED_ARRAY,        \
 		&&OPCODE_ASSERT,                      \
 		&&OPCODE_BREAKPOINT,                  \
 		&&OPCODE_LINE,                        \
@@ -426,6 +587,150 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
+			OPCODE(OPCODE_OPERATOR_INT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				// The analyzer proved both operands are ints, this only guards against bad values sneaking in.
+				if (likely(a->get_type() == Variant::INT && b->get_type() == Variant::INT)) {
+					int64_t left = *VariantInternal::get_int(a);
+					int64_t right = *VariantInternal::get_int(b);
+					GET_VARIANT_PTR(dst, 4);
+
+					bool handled = true;
+					switch ((Variant::Operator)_code_ptr[ip + 1]) {
+						case Variant::OP_ADD: {
+							_set_int(dst, left + right);
+						} break;
+						case Variant::OP_SUBTRACT: {
+							_set_int(dst, left - right);
+						} break;
+						case Variant::OP_MULTIPLY: {
+							_set_int(dst, left * right);
+						} break;
+						case Variant::OP_DIVIDE: {
+							// Division by zero is reported by the generic operator.
+							handled = right != 0;
+							if (handled) {
+								_set_int(dst, left / right);
+							}
+						} break;
+						case Variant::OP_MODULE: {
+							handled = right != 0;
+							if (handled) {
+								_set_int(dst, left % right);
+							}
+						} break;
+						case Variant::OP_EQUAL: {
+							_set_bool(dst, left == right);
+						} break;
+						case Variant::OP_NOT_EQUAL: {
+							_set_bool(dst, left != right);
+						} break;
+						case Variant::OP_LESS: {
+							_set_bool(dst, left < right);
+						} break;
+						case Variant::OP_LESS_EQUAL: {
+							_set_bool(dst, left <= right);
+						} break;
+						case Variant::OP_GREATER: {
+							_set_bool(dst, left > right);
+						} break;
+						case Variant::OP_GREATER_EQUAL: {
+							_set_bool(dst, left >= right);
+						} break;
+						case Variant::OP_BIT_AND: {
+							_set_int(dst, left & right);
+						} break;
+						case Variant::OP_BIT_OR: {
+							_set_int(dst, left | right);
+						} break;
+						case Variant::OP_BIT_XOR: {
+							_set_int(dst, left ^ right);
+						} break;
+						default: {
+							handled = false;
+						}
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+			// Not handled, fall through to the next opcode (mixed int and float are valid float operations).
+
+			OPCODE(OPCODE_OPERATOR_FLOAT) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				Variant::Type type_a = a->get_type();
+				Variant::Type type_b = b->get_type();
+
+				// At least one operand must be a float, otherwise the result would be an int.
+				if (likely((type_a == Variant::FLOAT && (type_b == Variant::FLOAT || type_b == Variant::INT)) || (type_a == Variant::INT && type_b == Variant::FLOAT))) {
+					double left = type_a == Variant::FLOAT ? *VariantInternal::get_float(a) : (double)*VariantInternal::get_int(a);
+					double right = type_b == Variant::FLOAT ? *VariantInternal::get_float(b) : (double)*VariantInternal::get_int(b);
+					GET_VARIANT_PTR(dst, 4);
+
+					bool handled = true;
+					switch ((Variant::Operator)_code_ptr[ip + 1]) {
+						case Variant::OP_ADD: {
+							_set_float(dst, left + right);
+						} break;
+						case Variant::OP_SUBTRACT: {
+							_set_float(dst, left - right);
+						} break;
+						case Variant::OP_MULTIPLY: {
+							_set_float(dst, left * right);
+						} break;
+						case Variant::OP_DIVIDE: {
+#ifdef DEBUG_ENABLED
+							// Division by zero is reported by the generic operator.
+							handled = right != 0;
+							if (handled) {
+								_set_float(dst, left / right);
+							}
+#else
+							_set_float(dst, left / right);
+#endif
+						} break;
+						case Variant::OP_EQUAL: {
+							_set_bool(dst, left == right);
+						} break;
+						case Variant::OP_NOT_EQUAL: {
+							_set_bool(dst, left != right);
+						} break;
+						case Variant::OP_LESS: {
+							_set_bool(dst, left < right);
+						} break;
+						case Variant::OP_LESS_EQUAL: {
+							_set_bool(dst, left <= right);
+						} break;
+						case Variant::OP_GREATER: {
+							_set_bool(dst, left > right);
+						} break;
+						case Variant::OP_GREATER_EQUAL: {
+							_set_bool(dst, left >= right);
+						} break;
+						default: {
+							handled = false;
+						}
+					}
+
+					if (likely(handled)) {
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+			// Not handled, fall through to the generic operator.
+
 			OPCODE(OPCODE_OPERATOR) {
 				CHECK_SPACE(5);
 
@@ -1212,6 +1517,162 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_METHOD_BIND)
+			OPCODE(OPCODE_CALL_METHOD_BIND_RET)
+			OPCODE(OPCODE_CALL_PTRCALL)
+			OPCODE(OPCODE_CALL_PTRCALL_RET) {
+				CHECK_SPACE(4);
+				int opcode = _code_ptr[ip];
+				bool call_ret = opcode == OPCODE_CALL_METHOD_BIND_RET || opcode == OPCODE_CALL_PTRCALL_RET;
+
+				int argc = _code_ptr[ip + 1];
+				GET_VARIANT_PTR(base, 2);
+				int methodg = _code_ptr[ip + 3];
+
+				GD_ERR_BREAK(methodg < 0 || methodg >= _methods_count);
+				MethodBind *method = _methods_ptr[methodg];
+
+				GD_ERR_BREAK(argc < 0);
+				ip += 4;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+				}
+
+				Variant *ret = nullptr;
+				if (call_ret) {
+					GET_VARIANT_PTR(dst, argc);
+					ret = dst;
+				}
+
+#ifdef DEBUG_ENABLED
+				uint64_t call_time = 0;
+
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					call_time = OS::get_singleton()->get_ticks_usec();
+				}
+#endif
+				Callable::CallError err;
+
+				// The base is statically typed to the method's class, but may still be null or freed.
+				// Objects with a script go through the generic call, which runs script overrides first.
+				Object *obj = base->get_type() == Variant::OBJECT ? base->get_validated_object() : nullptr;
+				if (likely(obj) && likely(!obj->get_script_instance())) {
+					bool use_ptrcall = false;
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+					if (opcode == OPCODE_CALL_PTRCALL || opcode == OPCODE_CALL_PTRCALL_RET) {
+						use_ptrcall = true;
+						for (int i = 0; i < argc && use_ptrcall; i++) {
+							Variant::Type arg_type = method->get_argument_type(i);
+							use_ptrcall = arg_type == Variant::NIL || argptrs[i]->get_type() == arg_type;
+						}
+					}
+
+					if (use_ptrcall) {
+						// Reuse the argument array to hold the raw pointers.
+						const void **ptr_args = (const void **)argptrs;
+						for (int i = 0; i < argc; i++) {
+							ptr_args[i] = _get_ptrcall_data(argptrs[i], method->get_argument_type(i));
+						}
+
+						Variant discarded;
+						void *ptr_ret = nullptr;
+						if (method->has_return()) {
+							Variant *r = ret ? ret : &discarded;
+							Variant::Type ret_type = method->get_argument_type(-1);
+							if (ret_type != Variant::NIL) {
+								_prepare_return(r, ret_type);
+							}
+							ptr_ret = _get_ptrcall_data(r, ret_type);
+						} else if (ret) {
+							*ret = Variant();
+						}
+
+						method->ptrcall(obj, ptr_args, ptr_ret);
+					}
+#endif
+					if (!use_ptrcall) {
+						Variant r = method->call(obj, (const Variant **)argptrs, argc, err);
+						if (ret) {
+							*ret = r;
+						}
+					}
+				} else {
+					// Let the generic call report the error or run the override.
+					base->call_ptr(method->get_name(), (const Variant **)argptrs, argc, ret, err);
+				}
+
+#ifdef DEBUG_ENABLED
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					function_call_time += OS::get_singleton()->get_ticks_usec() - call_time;
+				}
+
+				if (err.error != Callable::CallError::CALL_OK) {
+					err_text = _get_call_error(err, "function '" + String(method->get_name()) + "' in base '" + _get_var_type(base) + "'", (const Variant **)argptrs);
+					OPCODE_BREAK;
+				}
+#endif
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+				CHECK_SPACE(6);
+
+				int argc = _code_ptr[ip + 1];
+				Variant::Type base_type = (Variant::Type)_code_ptr[ip + 2];
+				GET_VARIANT_PTR(base, 3);
+				int nameg = _code_ptr[ip + 4];
+				int methodg = _code_ptr[ip + 5];
+
+				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
+				GD_ERR_BREAK(methodg < 0 || methodg >= _builtin_methods_count);
+				Variant::InternalMethod *method = _builtin_methods_ptr[methodg];
+
+				GD_ERR_BREAK(argc < 0);
+				ip += 6;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				// Validated calls skip all conversions, so types must match exactly.
+				bool validated = base->get_type() == base_type;
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+					if (validated) {
+						Variant::Type arg_type = method->get_argument_type(i);
+						validated = arg_type == Variant::NIL || v->get_type() == arg_type;
+					}
+				}
+
+				GET_VARIANT_PTR(dst, argc);
+
+				Callable::CallError err;
+				if (likely(validated)) {
+					Variant::Type ret_type = method->get_return_type();
+					if (ret_type != Variant::NIL) {
+						_prepare_return(dst, ret_type);
+					} else if (!(method->get_flags() & Variant::InternalMethod::FLAG_RETURNS_VARIANT)) {
+						*dst = Variant();
+					}
+					method->validated_call(base, (const Variant **)argptrs, dst);
+				} else {
+					base->call_ptr(_global_names_ptr[nameg], (const Variant **)argptrs, argc, dst, err);
+				}
+
+#ifdef DEBUG_ENABLED
+				if (err.error != Callable::CallError::CALL_OK) {
+					err_text = _get_call_error(err, "function '" + String(_global_names_ptr[nameg]) + "' in base '" + _get_var_type(base) + "'", (const Variant **)argptrs);
+					OPCODE_BREAK;
+				}
+#endif
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_AWAIT) {
 				CHECK_SPACE(2);
 
@@ -1373,6 +1834,97 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				OPCODE_BREAK;
 			}
 
+			OPCODE(OPCODE_ITERATE_BEGIN_RANGE) {
+				CHECK_SPACE(12); // Space for this and the range iterate.
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(to, 2);
+				GET_VARIANT_PTR(step, 3);
+				GET_VARIANT_PTR(from_arg, 4);
+				GET_VARIANT_PTR(to_arg, 5);
+				GET_VARIANT_PTR(step_arg, 6);
+
+				int jumpto = _code_ptr[ip + 7];
+				GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+
+				// Same conversions as the range() built-in function.
+				int64_t from_value = *from_arg;
+				int64_t to_value = *to_arg;
+				int64_t step_value = *step_arg;
+
+				if (unlikely(step_value == 0)) {
+#ifdef DEBUG_ENABLED
+					err_text = "Error calling built-in function 'range': Step argument is zero!";
+					OPCODE_BREAK;
+#else
+					// Script errors are not reported in release builds, but this one would loop forever.
+					ERR_PRINT("Error calling built-in function 'range': Step argument is zero!");
+					ip = jumpto;
+					DISPATCH_OPCODE;
+#endif
+				}
+
+				*counter = from_value;
+				*to = to_value;
+				*step = step_value;
+
+				if (step_value > 0 ? from_value >= to_value : from_value <= to_value) {
+					ip = jumpto;
+				} else {
+					GET_VARIANT_PTR(iterator, 8);
+					_set_int(iterator, from_value);
+					ip += 9; // Skip the range iterate, which is always next.
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_ITERATE_RANGE) {
+				CHECK_SPACE(6);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(to, 2);
+				GET_VARIANT_PTR(step, 3);
+
+				// The counter, limit and step are loop temporaries, always ints.
+				int64_t *count = VariantInternal::get_int(counter);
+				int64_t step_value = *VariantInternal::get_int(step);
+				int64_t to_value = *VariantInternal::get_int(to);
+				*count += step_value;
+
+				if (step_value > 0 ? *count >= to_value : *count <= to_value) {
+					int jumpto = _code_ptr[ip + 4];
+					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+				} else {
+					GET_VARIANT_PTR(iterator, 5);
+					_set_int(iterator, *count);
+					ip += 6; // Loop again.
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_ITERATE_BEGIN_PACKED_ARRAY) {
+				CHECK_SPACE(8);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(container, 2);
+				GET_VARIANT_PTR(iterator, 4);
+
+				int result = _iterate_packed_array(container, 0, iterator);
+				if (likely(result >= 0)) {
+					if (result == 0) {
+						int jumpto = _code_ptr[ip + 3];
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					} else {
+						_set_int(counter, 0);
+						ip += 5; // Skip the regular iterate, which is always next.
+					}
+					DISPATCH_OPCODE;
+				}
+			}
+			// Not a packed array, fall through to the generic iterator.
+
 			OPCODE(OPCODE_ITERATE_BEGIN) {
 				CHECK_SPACE(8); //space for this a regular iterate
 
@@ -1405,6 +1957,31 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_ITERATE_PACKED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(container, 2);
+				GET_VARIANT_PTR(iterator, 4);
+
+				if (likely(counter->get_type() == Variant::INT)) {
+					int64_t *index = VariantInternal::get_int(counter);
+					int result = _iterate_packed_array(container, *index + 1, iterator);
+					if (likely(result >= 0)) {
+						if (result == 0) {
+							int jumpto = _code_ptr[ip + 3];
+							GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+							ip = jumpto;
+						} else {
+							(*index)++;
+							ip += 5; // Loop again.
+						}
+						DISPATCH_OPCODE;
+					}
+				}
+			}
+			// Not a packed array, fall through to the generic iterator.
+
 			OPCODE(OPCODE_ITERATE) {
 				CHECK_SPACE(4);
 
@@ -1968,10 +2545,18 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 		Opcode code = Opcode(_code_ptr[ip]);
 
 		switch (code) {
-			case OPCODE_OPERATOR: {
+			case OPCODE_OPERATOR:
+			case OPCODE_OPERATOR_INT:
+			case OPCODE_OPERATOR_FLOAT: {
 				int operation = _code_ptr[ip + 1];
 
-				text += "operator ";
+				if (code == OPCODE_OPERATOR_INT) {
+					text += "operator-int ";
+				} else if (code == OPCODE_OPERATOR_FLOAT) {
+					text += "operator-float ";
+				} else {
+					text += "operator ";
+				}
 
 				text += DADDR(4);
 				text += " = ";
@@ -2275,6 +2860,55 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 4 + argc;
 			} break;
+			case OPCODE_CALL_METHOD_BIND:
+			case OPCODE_CALL_METHOD_BIND_RET:
+			case OPCODE_CALL_PTRCALL:
+			case OPCODE_CALL_PTRCALL_RET: {
+				bool ret = code == OPCODE_CALL_METHOD_BIND_RET || code == OPCODE_CALL_PTRCALL_RET;
+
+				if (code == OPCODE_CALL_PTRCALL || code == OPCODE_CALL_PTRCALL_RET) {
+					text += ret ? "call-ptrcall-ret " : "call-ptrcall ";
+				} else {
+					text += ret ? "call-method-bind-ret " : "call-method-bind ";
+				}
+
+				int argc = _code_ptr[ip + 1];
+				if (ret) {
+					text += DADDR(4 + argc) + " = ";
+				}
+
+				text += DADDR(2) + ".";
+				text += String(_methods_ptr[_code_ptr[ip + 3]]->get_name());
+				text += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0)
+						text += ", ";
+					text += DADDR(4 + i);
+				}
+				text += ")";
+
+				incr = 5 + argc;
+			} break;
+			case OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+				text += "call-builtin-validated ";
+
+				int argc = _code_ptr[ip + 1];
+				text += DADDR(6 + argc) + " = ";
+
+				text += DADDR(3) + ".";
+				text += String(_global_names_ptr[_code_ptr[ip + 4]]);
+				text += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0)
+						text += ", ";
+					text += DADDR(6 + i);
+				}
+				text += ")";
+
+				incr = 7 + argc;
+			} break;
 			case OPCODE_AWAIT: {
 				text += "await ";
 				text += DADDR(1);
@@ -2320,8 +2954,39 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 2;
 			} break;
+			case OPCODE_ITERATE_BEGIN_RANGE: {
+				text += "for-init-range ";
+				text += DADDR(8);
+				text += " in range(";
+				text += DADDR(4);
+				text += ", ";
+				text += DADDR(5);
+				text += ", ";
+				text += DADDR(6);
+				text += ") counter ";
+				text += DADDR(1);
+				text += " end ";
+				text += itos(_code_ptr[ip + 7]);
+
+				incr += 9;
+			} break;
+			case OPCODE_ITERATE_RANGE: {
+				text += "for-loop-range ";
+				text += DADDR(5);
+				text += " counter ";
+				text += DADDR(1);
+				text += " to ";
+				text += DADDR(2);
+				text += " step ";
+				text += DADDR(3);
+				text += " end ";
+				text += itos(_code_ptr[ip + 4]);
+
+				incr += 6;
+			} break;
+			case OPCODE_ITERATE_BEGIN_PACKED_ARRAY:
 			case OPCODE_ITERATE_BEGIN: {
-				text += "for-init ";
+				text += code == OPCODE_ITERATE_BEGIN_PACKED_ARRAY ? "for-init-packed " : "for-init ";
 				text += DADDR(4);
 				text += " in ";
 				text += DADDR(2);
@@ -2332,8 +2997,9 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_ITERATE_PACKED_ARRAY:
 			case OPCODE_ITERATE: {
-				text += "for-loop ";
+				text += code == OPCODE_ITERATE_PACKED_ARRAY ? "for-loop-packed " : "for-loop ";
 				text += DADDR(4);
 				text += " in ";
 				text += DADDR(2);
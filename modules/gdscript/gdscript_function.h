@@ -159,6 +159,8 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT,
+		OPCODE_OPERATOR_FLOAT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
@@ -184,6 +186,11 @@ public:
 		OPCODE_CALL_ASYNC,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF_BASE,
+		OPCODE_CALL_METHOD_BIND,
+		OPCODE_CALL_METHOD_BIND_RET,
+		OPCODE_CALL_PTRCALL,
+		OPCODE_CALL_PTRCALL_RET,
+		OPCODE_CALL_BUILTIN_TYPE_VALIDATED,
 		OPCODE_AWAIT,
 		OPCODE_AWAIT_RESUME,
 		OPCODE_JUMP,
@@ -193,6 +200,10 @@ public:
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
 		OPCODE_ITERATE,
+		OPCODE_ITERATE_BEGIN_RANGE,
+		OPCODE_ITERATE_RANGE,
+		OPCODE_ITERATE_BEGIN_PACKED_ARRAY,
+		OPCODE_ITERATE_PACKED_ARRAY,
 		OPCODE_ASSERT,
 		OPCODE_BREAKPOINT,
 		OPCODE_LINE,
@@ -233,6 +244,10 @@ private:
 	int _constant_count;
 	const StringName *_global_names_ptr;
 	int _global_names_count;
+	MethodBind *const *_methods_ptr;
+	int _methods_count;
+	Variant::InternalMethod *const *_builtin_methods_ptr;
+	int _builtin_methods_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
 	const int *_code_ptr;
@@ -249,6 +264,8 @@ private:
 	StringName name;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
+	Vector<MethodBind *> methods;
+	Vector<Variant::InternalMethod *> builtin_methods;
 	Vector<int> default_arguments;
 	Vector<int> code;
 	Vector<GDScriptDataType> argument_types;
@@ -0,0 +1,182 @@
+/*************************************************************************/
+/*  test_gdscript_typed_code.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GDSCRIPT_TYPED_CODE_H
+#define TEST_GDSCRIPT_TYPED_CODE_H
+
+#include "modules/gdscript/gdscript.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGDScriptTypedCode {
+
+// Each typed function has an untyped twin going through the generic opcodes,
+// so both paths can be checked against each other.
+const char *SCRIPT_SOURCE = R"(@tool
+extends Reference
+
+func get_class():
+	return "Overridden"
+
+func class_of(p_object: Reference):
+	return p_object.get_class()
+
+func typed_math(a: int, b: int, x: float) -> float:
+	var c: int = a * b + a / b - a % b
+	return c * x + x / 2.0 - (1.0 if a < b else 0.0)
+
+func untyped_math(a, b, x):
+	var c = a * b + a / b - a % b
+	return c * x + x / 2.0 - (1.0 if a < b else 0.0)
+
+func typed_range(from: int, to: int, step: int) -> int:
+	var total: int = 0
+	for i in range(from, to, step):
+		total = total * 3 + i
+	return total
+
+func untyped_range(from, to, step):
+	var total = 0
+	for i in range(from, to, step):
+		total = total * 3 + i
+	return total
+
+func typed_count(n: int) -> int:
+	var total: int = 0
+	for i in n:
+		total += i
+	return total
+
+func packed_sum(p_array: PackedInt32Array) -> int:
+	var total: int = 0
+	for i in p_array:
+		total += i
+	return total
+
+func rng_seed(p_seed: int) -> int:
+	var rng: RandomNumberGenerator = RandomNumberGenerator.new()
+	rng.set_seed(p_seed)
+	return rng.get_seed()
+
+func vector_length(v: Vector2) -> float:
+	return v.length()
+)";
+
+Ref<Reference> create_instance() {
+	// Globals such as native class names are normally registered on startup.
+	GDScriptLanguage::get_singleton()->init();
+
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(SCRIPT_SOURCE);
+	Error err = script->reload();
+	CHECK_MESSAGE(err == OK, "The test script should compile.");
+
+	Ref<Reference> instance;
+	instance.instance();
+	instance->set_script(script);
+	CHECK_MESSAGE(instance->get_script_instance() != nullptr, "The test script should be instanced.");
+	return instance;
+}
+
+TEST_CASE("[GDScript] Typed operators match the generic ones") {
+	Ref<Reference> instance = create_instance();
+
+	const int values[] = { -7, -3, -1, 1, 2, 5, 13 };
+	for (int a : values) {
+		for (int b : values) {
+			float x = a * 0.25 + b;
+			Variant typed = instance->call("typed_math", a, b, x);
+			Variant untyped = instance->call("untyped_math", a, b, x);
+			CHECK(typed.get_type() == Variant::FLOAT);
+			CHECK(typed == untyped);
+		}
+	}
+}
+
+TEST_CASE("[GDScript] Typed range loops match range()") {
+	Ref<Reference> instance = create_instance();
+
+	const int ranges[][3] = {
+		{ 0, 10, 1 },
+		{ 3, 20, 4 },
+		{ 10, 0, -1 },
+		{ 10, -11, -3 },
+		{ 5, 5, 1 },
+		{ 5, 0, 1 },
+		{ 0, 5, -1 },
+	};
+	for (int i = 0; i < 7; i++) {
+		int from = ranges[i][0];
+		int to = ranges[i][1];
+		int step = ranges[i][2];
+		CHECK(instance->call("typed_range", from, to, step) == instance->call("untyped_range", from, to, step));
+	}
+
+	CHECK(int(instance->call("typed_count", 10)) == 45);
+	CHECK(int(instance->call("typed_count", 0)) == 0);
+	CHECK(int(instance->call("typed_count", -5)) == 0);
+
+	// A zero step is an error, which must stop the function instead of looping forever.
+	ERR_PRINT_OFF;
+	instance->call("typed_range", 0, 10, 0);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[GDScript] Typed iteration of packed arrays") {
+	Ref<Reference> instance = create_instance();
+
+	PackedInt32Array array;
+	int expected = 0;
+	for (int i = 0; i < 100; i++) {
+		array.push_back(i * 7 - 50);
+		expected += i * 7 - 50;
+	}
+	CHECK(int(instance->call("packed_sum", array)) == expected);
+	CHECK(int(instance->call("packed_sum", PackedInt32Array())) == 0);
+}
+
+TEST_CASE("[GDScript] Typed native and builtin calls") {
+	Ref<Reference> instance = create_instance();
+
+	CHECK(int64_t(instance->call("rng_seed", 12345)) == 12345);
+	CHECK(float(instance->call("vector_length", Vector2(3, 4))) == doctest::Approx(5.0));
+
+	// The native method must not hide a script override on the object it is called on.
+	CHECK(String(instance->call("class_of", instance)) == "Overridden");
+
+	Ref<Reference> plain;
+	plain.instance();
+	CHECK(String(instance->call("class_of", plain)) == "Reference");
+}
+
+} // namespace TestGDScriptTypedCode
+
+#endif // TEST_GDSCRIPT_TYPED_CODE_H
@@ -137,12 +137,16 @@ void AudioStreamPlayer3D::_calc_output_vol(const Vector3 &source_dir, real_t tig
 	}
 }
 
-void AudioStreamPlayer3D::_mix_audio() {
+void AudioStreamPlayer3D::_mix_voice(int p_frames, LocalVector<AudioServer::VoiceSend> &r_sends) {
 	if (!stream_playback.is_valid() || !active ||
 			(stream_paused && !stream_paused_fade_out)) {
 		return;
 	}
 
+	if (mix_buffer.size() < p_frames) {
+		return; //mix buffer size changed, will be updated on set_stream
+	}
+
 	bool started = false;
 	if (setseek >= 0.0) {
 		stream_playback->start(setseek);
@@ -152,11 +156,12 @@ void AudioStreamPlayer3D::_mix_audio() {
 
 	//get data
 	AudioFrame *buffer = mix_buffer.ptrw();
-	int buffer_size = mix_buffer.size();
+	int buffer_size = p_frames;
+	int mix_size = buffer_size;
 
 	if (stream_paused_fade_out) {
-		// Short fadeout ramp
-		buffer_size = MIN(buffer_size, 128);
+		// Short fadeout ramp, the rest of the buffer is silent
+		mix_size = MIN(buffer_size, 128);
 	}
 
 	// Mix if we're not paused or we're fading out
@@ -172,9 +177,15 @@ void AudioStreamPlayer3D::_mix_audio() {
 			output_pitch_scale = 1.0;
 		}
 
-		stream_playback->mix(buffer, pitch_scale * output_pitch_scale, buffer_size);
+		stream_playback->mix(buffer, pitch_scale * output_pitch_scale, mix_size);
+	}
+
+	for (int j = mix_size; j < buffer_size; j++) {
+		buffer[j] = AudioFrame(0, 0);
 	}
 
+	int buffers = AudioServer::get_singleton()->get_channel_count();
+
 	//write all outputs
 	for (int i = 0; i < output_count; i++) {
 		Output current = outputs[i];
@@ -203,82 +214,78 @@ void AudioStreamPlayer3D::_mix_audio() {
 			interpolate_filter = false;
 		}
 
-		//mix!
+		if (filter_buffer.size() < (i + 1) * buffer_size) {
+			continue; //output was just added, buffer will be allocated on process
+		}
+
+		// The attenuation filter is linear, so it's applied once to the frames
+		// of this output and the speaker volumes are applied by the AudioServer.
+		AudioFrame *filtered = filter_buffer.ptrw() + i * buffer_size;
+
+		current.filter.set_mode(AudioFilterSW::HIGHSHELF);
+		current.filter.set_sampling_rate(AudioServer::get_singleton()->get_mix_rate());
+		current.filter.set_cutoff(attenuation_filter_cutoff_hz);
+		current.filter.set_resonance(1);
+		current.filter.set_stages(1);
+		current.filter.set_gain(current.filter_gain);
+
+		if (interpolate_filter) {
+			current.filter_process[0] = prev_outputs[i].filter_process[0];
+			current.filter_process[1] = prev_outputs[i].filter_process[1];
+
+			current.filter_process[0].set_filter(&current.filter, false);
+			current.filter_process[1].set_filter(&current.filter, false);
+
+			current.filter_process[0].update_coeffs(mix_size);
+			current.filter_process[1].update_coeffs(mix_size);
+			for (int j = 0; j < mix_size; j++) {
+				AudioFrame f = buffer[j];
+				current.filter_process[0].process_one_interp(f.l);
+				current.filter_process[1].process_one_interp(f.r);
+				filtered[j] = f;
+			}
+		} else {
+			current.filter_process[0].set_filter(&current.filter);
+			current.filter_process[1].set_filter(&current.filter);
+
+			current.filter_process[0].update_coeffs();
+			current.filter_process[1].update_coeffs();
+			for (int j = 0; j < mix_size; j++) {
+				AudioFrame f = buffer[j];
+				current.filter_process[0].process_one(f.l);
+				current.filter_process[1].process_one(f.r);
+				filtered[j] = f;
+			}
+		}
 
-		int buffers = AudioServer::get_singleton()->get_channel_count();
+		for (int j = mix_size; j < buffer_size; j++) {
+			filtered[j] = AudioFrame(0, 0);
+		}
 
 		for (int k = 0; k < buffers; k++) {
 			AudioFrame target_volume = stream_paused_fade_out ? AudioFrame(0.f, 0.f) : current.vol[k];
 			AudioFrame vol_prev = stream_paused_fade_in ? AudioFrame(0.f, 0.f) : prev_outputs[i].vol[k];
-			AudioFrame vol_inc = (target_volume - vol_prev) / float(buffer_size);
-			AudioFrame vol = vol_prev;
-
-			if (!AudioServer::get_singleton()->thread_has_channel_mix_buffer(current.bus_index, k)) {
-				continue; //may have been deleted, will be updated on process
-			}
 
-			AudioFrame *target = AudioServer::get_singleton()->thread_get_channel_mix_buffer(current.bus_index, k);
-			current.filter.set_mode(AudioFilterSW::HIGHSHELF);
-			current.filter.set_sampling_rate(AudioServer::get_singleton()->get_mix_rate());
-			current.filter.set_cutoff(attenuation_filter_cutoff_hz);
-			current.filter.set_resonance(1);
-			current.filter.set_stages(1);
-			current.filter.set_gain(current.filter_gain);
-
-			if (interpolate_filter) {
-				current.filter_process[k * 2 + 0] = prev_outputs[i].filter_process[k * 2 + 0];
-				current.filter_process[k * 2 + 1] = prev_outputs[i].filter_process[k * 2 + 1];
-
-				current.filter_process[k * 2 + 0].set_filter(&current.filter, false);
-				current.filter_process[k * 2 + 1].set_filter(&current.filter, false);
-
-				current.filter_process[k * 2 + 0].update_coeffs(buffer_size);
-				current.filter_process[k * 2 + 1].update_coeffs(buffer_size);
-				for (int j = 0; j < buffer_size; j++) {
-					AudioFrame f = buffer[j] * vol;
-					current.filter_process[k * 2 + 0].process_one_interp(f.l);
-					current.filter_process[k * 2 + 1].process_one_interp(f.r);
-
-					target[j] += f;
-					vol += vol_inc;
-				}
-			} else {
-				current.filter_process[k * 2 + 0].set_filter(&current.filter);
-				current.filter_process[k * 2 + 1].set_filter(&current.filter);
-
-				current.filter_process[k * 2 + 0].update_coeffs();
-				current.filter_process[k * 2 + 1].update_coeffs();
-				for (int j = 0; j < buffer_size; j++) {
-					AudioFrame f = buffer[j] * vol;
-					current.filter_process[k * 2 + 0].process_one(f.l);
-					current.filter_process[k * 2 + 1].process_one(f.r);
-
-					target[j] += f;
-					vol += vol_inc;
-				}
-			}
+			AudioServer::VoiceSend send;
+			send.frames = filtered;
+			send.bus_index = current.bus_index;
+			send.channel = k;
+			send.volume = vol_prev;
+			send.volume_inc = (target_volume - vol_prev) / float(mix_size);
+			r_sends.push_back(send);
 
 			if (current.reverb_bus_index >= 0) {
-				if (!AudioServer::get_singleton()->thread_has_channel_mix_buffer(current.reverb_bus_index, k)) {
-					continue; //may have been deleted, will be updated on process
-				}
-
-				AudioFrame *rtarget = AudioServer::get_singleton()->thread_get_channel_mix_buffer(current.reverb_bus_index, k);
+				send.frames = buffer;
+				send.bus_index = current.reverb_bus_index;
 
 				if (current.reverb_bus_index == prev_outputs[i].reverb_bus_index) {
-					AudioFrame rvol_inc = (current.reverb_vol[k] - prev_outputs[i].reverb_vol[k]) / float(buffer_size);
-					AudioFrame rvol = prev_outputs[i].reverb_vol[k];
-
-					for (int j = 0; j < buffer_size; j++) {
-						rtarget[j] += buffer[j] * rvol;
-						rvol += rvol_inc;
-					}
+					send.volume = prev_outputs[i].reverb_vol[k];
+					send.volume_inc = (current.reverb_vol[k] - prev_outputs[i].reverb_vol[k]) / float(mix_size);
 				} else {
-					AudioFrame rvol = current.reverb_vol[k];
-					for (int j = 0; j < buffer_size; j++) {
-						rtarget[j] += buffer[j] * rvol;
-					}
+					send.volume = current.reverb_vol[k];
+					send.volume_inc = AudioFrame(0, 0);
 				}
+				r_sends.push_back(send);
 			}
 		}
 
@@ -327,20 +334,68 @@ float AudioStreamPlayer3D::_get_attenuation_db(float p_distance) const {
 	return att;
 }
 
+// Distance a player can move before the areas around it are queried again.
+#define AREA_CACHE_DISTANCE 0.1
+
+Area3D *AudioStreamPlayer3D::_find_audio_area(PhysicsDirectSpaceState3D *p_space_state, const Vector3 &p_global_pos) {
+	// Areas rarely change under a sound, so the query is only repeated when
+	// the player moved or the result got old.
+	uint64_t frame = Engine::get_singleton()->get_physics_frames();
+
+	if (area_cache_valid && frame - area_cache_frame < AREA_CACHE_FRAMES && p_global_pos.distance_squared_to(area_cache_position) < AREA_CACHE_DISTANCE * AREA_CACHE_DISTANCE) {
+		return area_cache.is_valid() ? Object::cast_to<Area3D>(ObjectDB::get_instance(area_cache)) : nullptr;
+	}
+
+	if (!area_cache_valid) {
+		// Spread the refreshes of players started on the same frame.
+		area_cache_frame = frame - uint64_t(get_instance_id()) % AREA_CACHE_FRAMES;
+	} else {
+		area_cache_frame = frame;
+	}
+	area_cache_valid = true;
+	area_cache_position = p_global_pos;
+	area_cache = ObjectID();
+
+	PhysicsDirectSpaceState3D::ShapeResult sr[MAX_INTERSECT_AREAS];
+
+	int areas = p_space_state->intersect_point(p_global_pos, sr, MAX_INTERSECT_AREAS, Set<RID>(), area_mask, false, true);
+
+	for (int i = 0; i < areas; i++) {
+		if (!sr[i].collider) {
+			continue;
+		}
+
+		Area3D *tarea = Object::cast_to<Area3D>(sr[i].collider);
+		if (!tarea) {
+			continue;
+		}
+
+		if (!tarea->is_overriding_audio_bus() && !tarea->is_using_reverb_bus()) {
+			continue;
+		}
+
+		area_cache = tarea->get_instance_id();
+		return tarea;
+	}
+
+	return nullptr;
+}
+
 void _update_sound() {
 }
 
 void AudioStreamPlayer3D::_notification(int p_what) {
 	if (p_what == NOTIFICATION_ENTER_TREE) {
 		velocity_tracker->reset(get_global_transform().origin);
-		AudioServer::get_singleton()->add_callback(_mix_audios, this);
+		AudioServer::get_singleton()->add_voice(_mix_voices, this);
 		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
 			play();
 		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
-		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
+		AudioServer::get_singleton()->remove_voice(_mix_voices, this);
+		area_cache_valid = false;
 	}
 
 	if (p_what == NOTIFICATION_PAUSED) {
@@ -384,28 +439,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 
 			PhysicsDirectSpaceState3D *space_state = PhysicsServer3D::get_singleton()->space_get_direct_state(world_3d->get_space());
 
-			PhysicsDirectSpaceState3D::ShapeResult sr[MAX_INTERSECT_AREAS];
-
-			int areas = space_state->intersect_point(global_pos, sr, MAX_INTERSECT_AREAS, Set<RID>(), area_mask, false, true);
-			Area3D *area = nullptr;
-
-			for (int i = 0; i < areas; i++) {
-				if (!sr[i].collider) {
-					continue;
-				}
-
-				Area3D *tarea = Object::cast_to<Area3D>(sr[i].collider);
-				if (!tarea) {
-					continue;
-				}
-
-				if (!tarea->is_overriding_audio_bus() && !tarea->is_using_reverb_bus()) {
-					continue;
-				}
-
-				area = tarea;
-				break;
-			}
+			Area3D *area = _find_audio_area(space_state, global_pos);
 
 			List<Camera3D *> cameras;
 			world_3d->get_camera_list(&cameras);
@@ -599,6 +633,13 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 				}
 			}
 
+			int filter_buffer_size = new_output_count * AudioServer::get_singleton()->thread_get_mix_buffer_size();
+			if (filter_buffer.size() < filter_buffer_size) {
+				AudioServer::get_singleton()->lock();
+				filter_buffer.resize(filter_buffer_size);
+				AudioServer::get_singleton()->unlock();
+			}
+
 			output_count = new_output_count;
 			output_ready = true;
 		}
@@ -793,6 +834,7 @@ float AudioStreamPlayer3D::get_max_distance() const {
 
 void AudioStreamPlayer3D::set_area_mask(uint32_t p_mask) {
 	area_mask = p_mask;
+	area_cache_valid = false;
 }
 
 uint32_t AudioStreamPlayer3D::get_area_mask() const {
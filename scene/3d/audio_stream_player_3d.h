@@ -37,7 +37,9 @@
 #include "servers/audio/audio_stream.h"
 #include "servers/audio_server.h"
 
+class Area3D;
 class Camera3D;
+class PhysicsDirectSpaceState3D;
 class AudioStreamPlayer3D : public Node3D {
 	GDCLASS(AudioStreamPlayer3D, Node3D);
 
@@ -63,13 +65,14 @@ public:
 private:
 	enum {
 		MAX_OUTPUTS = 8,
-		MAX_INTERSECT_AREAS = 32
+		MAX_INTERSECT_AREAS = 32,
+		AREA_CACHE_FRAMES = 8
 
 	};
 
 	struct Output {
 		AudioFilterSW filter;
-		AudioFilterSW::Processor filter_process[8];
+		AudioFilterSW::Processor filter_process[2];
 		AudioFrame vol[4];
 		float filter_gain;
 		float pitch_scale;
@@ -97,6 +100,7 @@ private:
 	Ref<AudioStreamPlayback> stream_playback;
 	Ref<AudioStream> stream;
 	Vector<AudioFrame> mix_buffer;
+	Vector<AudioFrame> filter_buffer; // Filtered frames of each output, sent to the buses by the AudioServer.
 
 	volatile float setseek;
 	volatile bool active;
@@ -114,8 +118,8 @@ private:
 	StringName bus;
 
 	static void _calc_output_vol(const Vector3 &source_dir, real_t tightness, Output &output);
-	void _mix_audio();
-	static void _mix_audios(void *self) { reinterpret_cast<AudioStreamPlayer3D *>(self)->_mix_audio(); }
+	void _mix_voice(int p_frames, LocalVector<AudioServer::VoiceSend> &r_sends);
+	static void _mix_voices(void *self, int p_frames, LocalVector<AudioServer::VoiceSend> &r_sends) { reinterpret_cast<AudioStreamPlayer3D *>(self)->_mix_voice(p_frames, r_sends); }
 
 	void _set_playing(bool p_enable);
 	bool _is_active() const;
@@ -124,6 +128,13 @@ private:
 
 	uint32_t area_mask;
 
+	ObjectID area_cache;
+	Vector3 area_cache_position;
+	uint64_t area_cache_frame = 0;
+	bool area_cache_valid = false;
+
+	Area3D *_find_audio_area(PhysicsDirectSpaceState3D *p_space_state, const Vector3 &p_global_pos);
+
 	bool emission_angle_enabled;
 	float emission_angle;
 	float emission_angle_filter_attenuation_db;
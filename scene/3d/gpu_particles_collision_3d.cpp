@@ -30,7 +30,7 @@
 
 #include "gpu_particles_collision_3d.h"
 
-#include "core/thread_work_pool.h"
+#include "core/job_system.h"
 #include "mesh_instance_3d.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/main/viewport.h"
@@ -343,15 +343,13 @@ void GPUParticlesCollisionSDF::_compute_sdf_z(uint32_t p_z, ComputeSDFParams *pa
 }
 
 void GPUParticlesCollisionSDF::_compute_sdf(ComputeSDFParams *params) {
-	ThreadWorkPool work_pool;
-	work_pool.init();
-	work_pool.begin_work(params->size.z, this, &GPUParticlesCollisionSDF::_compute_sdf_z, params);
-	while (work_pool.get_work_index() < (uint32_t)params->size.z) {
+	JobSystem::Handle job = JobSystem::get_singleton()->add_group_job(params->size.z, this, &GPUParticlesCollisionSDF::_compute_sdf_z, params);
+	while (!job.is_completed()) {
 		OS::get_singleton()->delay_usec(10000);
-		bake_step_function(work_pool.get_work_index() * 100 / params->size.z, "Baking SDF");
+		if (bake_step_function) {
+			bake_step_function(job.get_completed_elements() * 100 / params->size.z, "Baking SDF");
+		}
 	}
-	work_pool.end_work();
-	work_pool.finish();
 }
 
 Vector3i GPUParticlesCollisionSDF::get_estimated_cell_size() const {
@@ -31,6 +31,7 @@
 #include "node_3d.h"
 
 #include "core/engine.h"
+#include "core/local_vector.h"
 #include "core/message_queue.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/window.h"
@@ -80,7 +81,10 @@ void Node3D::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		SceneTree *tree = get_tree();
+		tree->_xform_lock();
+		tree->xform_change_list.add(&xform_change);
+		tree->_xform_unlock();
 	}
 }
 
@@ -90,34 +94,117 @@ void Node3D::_update_local_transform() const {
 	data.dirty &= ~DIRTY_LOCAL;
 }
 
-void Node3D::_propagate_transform_changed(Node3D *p_origin) {
+// Scratch space for _update_transform_subtree(), nodes can be moved from several threads.
+static thread_local LocalVector<Node3D *> transform_subtree;
+
+void Node3D::_transform_changed() {
 	if (!is_inside_tree()) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
+	data.dirty |= DIRTY_GLOBAL;
+	_notify_dirty();
 
-	data.children_lock++;
+	if (data.children.empty() || xform_pending.in_list()) {
+		return;
+	}
 
-	for (List<Node3D *>::Element *E = data.children.front(); E; E = E->next()) {
-		if (E->get()->data.top_level_active) {
-			continue; //don't propagate to a top_level
+	// Children are updated in one pass when transform notifications are
+	// flushed, or before that if one of them needs its global transform.
+	SceneTree *tree = get_tree();
+	tree->_xform_lock();
+	tree->xform_pending_list.add(&xform_pending);
+	tree->xform_pending_version++;
+	tree->_xform_unlock();
+}
+
+void Node3D::_check_pending_parents() const {
+	SceneTree *tree = get_tree();
+	data.pending_check = tree->xform_pending_version;
+
+	Node3D *pending = nullptr;
+	const Node3D *n = this;
+	while (n->data.parent && !n->data.top_level_active) {
+		n = n->data.parent;
+		if (n->xform_pending.in_list()) {
+			pending = const_cast<Node3D *>(n);
 		}
-		E->get()->_propagate_transform_changed(p_origin);
 	}
-#ifdef TOOLS_ENABLED
-	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
-#else
-	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
-#endif
-		get_tree()->xform_change_list.add(&xform_change);
+
+	if (pending) {
+		pending->_update_transform_subtree();
 	}
-	data.dirty |= DIRTY_GLOBAL;
+}
 
-	data.children_lock--;
+void Node3D::_propagate_transform_changed() {
+	// Start from the highest pending parent, so nodes are only updated once.
+	Node3D *root = this;
+	const Node3D *n = this;
+	while (n->data.parent && !n->data.top_level_active) {
+		n = n->data.parent;
+		if (n->xform_pending.in_list()) {
+			root = const_cast<Node3D *>(n);
+		}
+	}
+
+	root->_update_transform_subtree();
+}
+
+void Node3D::_update_transform_subtree() {
+	SceneTree *tree = get_tree();
+	tree->_xform_lock();
+	tree->xform_pending_list.remove(&xform_pending);
+
+	// Computed before filling the scratch array, as it may update pending parents.
+	get_global_transform();
+
+	// Flatten the subtree breadth first, so parents always come before their children.
+	LocalVector<Node3D *> &nodes = transform_subtree;
+	nodes.clear();
+	nodes.push_back(this);
+
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		const List<Node3D *> &children = nodes[i]->data.children;
+		for (const List<Node3D *>::Element *E = children.front(); E; E = E->next()) {
+			Node3D *child = E->get();
+			if (child->data.top_level_active) {
+				continue; //don't propagate to a top_level
+			}
+			if (child->xform_pending.in_list()) {
+				tree->xform_pending_list.remove(&child->xform_pending);
+			}
+			nodes.push_back(child);
+		}
+	}
+
+	Node3D **nodes_ptr = nodes.ptr();
+	uint32_t node_count = nodes.size();
+
+	for (uint32_t i = 1; i < node_count; i++) {
+		Node3D *n = nodes_ptr[i];
+		if (n->data.dirty & DIRTY_LOCAL) {
+			n->_update_local_transform();
+		}
+
+		n->data.global_transform = n->data.parent->data.global_transform * n->data.local_transform;
+
+		if (n->data.disable_scale) {
+			n->data.global_transform.basis.orthonormalize();
+		}
+
+		n->data.dirty &= ~DIRTY_GLOBAL;
+		n->_notify_dirty();
+	}
+
+	tree->_xform_unlock();
+}
+
+void Node3D::_flush_pending_transforms(SceneTree *p_tree) {
+	SelfList<Node> *n = p_tree->xform_pending_list.first();
+	while (n) {
+		static_cast<Node3D *>(n->self())->_propagate_transform_changed();
+		n = p_tree->xform_pending_list.first();
+	}
 }
 
 void Node3D::_notification(int p_what) {
@@ -145,6 +232,7 @@ void Node3D::_notification(int p_what) {
 			}
 
 			data.dirty |= DIRTY_GLOBAL; //global is always dirty upon entering a scene
+			data.pending_check = 0;
 			_notify_dirty();
 
 			notification(NOTIFICATION_ENTER_WORLD);
@@ -155,6 +243,9 @@ void Node3D::_notification(int p_what) {
 			if (xform_change.in_list()) {
 				get_tree()->xform_change_list.remove(&xform_change);
 			}
+			if (xform_pending.in_list()) {
+				get_tree()->xform_pending_list.remove(&xform_pending);
+			}
 			if (data.C) {
 				data.parent->data.children.erase(data.C);
 			}
@@ -230,7 +321,7 @@ void Node3D::set_transform(const Transform &p_transform) {
 	_change_notify("rotation");
 	_change_notify("rotation_degrees");
 	_change_notify("scale");
-	_propagate_transform_changed(this);
+	_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -256,6 +347,14 @@ Transform Node3D::get_transform() const {
 Transform Node3D::get_global_transform() const {
 	ERR_FAIL_COND_V(!is_inside_tree(), Transform());
 
+	const SceneTree *tree = get_tree();
+	tree->_xform_lock();
+	if (tree->xform_pending_list.first() && data.pending_check != tree->xform_pending_version) {
+		// A parent moved since the last check and its children may not know yet.
+		_check_pending_parents();
+	}
+	tree->_xform_unlock();
+
 	if (data.dirty & DIRTY_GLOBAL) {
 		if (data.dirty & DIRTY_LOCAL) {
 			_update_local_transform();
@@ -308,7 +407,7 @@ Transform Node3D::get_relative_transform(const Node *p_parent) const {
 void Node3D::set_translation(const Vector3 &p_translation) {
 	data.local_transform.origin = p_translation;
 	_change_notify("transform");
-	_propagate_transform_changed(this);
+	_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -323,7 +422,7 @@ void Node3D::set_rotation(const Vector3 &p_euler_rad) {
 	data.rotation = p_euler_rad;
 	data.dirty |= DIRTY_LOCAL;
 	_change_notify("transform");
-	_propagate_transform_changed(this);
+	_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -342,7 +441,7 @@ void Node3D::set_scale(const Vector3 &p_scale) {
 	data.scale = p_scale;
 	data.dirty |= DIRTY_LOCAL;
 	_change_notify("transform");
-	_propagate_transform_changed(this);
+	_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -695,7 +794,10 @@ void Node3D::force_update_transform() {
 	if (!xform_change.in_list()) {
 		return; //nothing to update
 	}
-	get_tree()->xform_change_list.remove(&xform_change);
+	SceneTree *tree = get_tree();
+	tree->_xform_lock();
+	tree->xform_change_list.remove(&xform_change);
+	tree->_xform_unlock();
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
@@ -784,8 +886,10 @@ void Node3D::_bind_methods() {
 }
 
 Node3D::Node3D() :
-		xform_change(this) {
+		xform_change(this),
+		xform_pending(this) {
 	data.dirty = DIRTY_NONE;
+	data.pending_check = 0;
 	data.children_lock = 0;
 
 	data.ignore_notification = false;
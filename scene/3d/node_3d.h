@@ -60,6 +60,7 @@ class Node3D : public Node {
 	};
 
 	mutable SelfList<Node> xform_change;
+	mutable SelfList<Node> xform_pending; // Children not updated yet, see _propagate_transform_changed().
 
 	struct Data {
 		mutable Transform global_transform;
@@ -68,6 +69,7 @@ class Node3D : public Node {
 		mutable Vector3 scale;
 
 		mutable int dirty;
+		mutable uint64_t pending_check;
 
 		Viewport *viewport;
 
@@ -97,7 +99,12 @@ class Node3D : public Node {
 
 	void _update_gizmo();
 	void _notify_dirty();
-	void _propagate_transform_changed(Node3D *p_origin);
+	void _transform_changed();
+	void _check_pending_parents() const;
+	void _propagate_transform_changed();
+	void _update_transform_subtree();
+	static void _flush_pending_transforms(SceneTree *p_tree);
+	friend class SceneTree;
 
 	void _propagate_visibility_changed();
 
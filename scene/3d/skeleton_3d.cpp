@@ -31,6 +31,7 @@
 #include "skeleton_3d.h"
 
 #include "core/engine.h"
+#include "core/job_system.h"
 #include "core/message_queue.h"
 #include "core/project_settings.h"
 #include "core/type_info.h"
@@ -223,142 +224,260 @@ void Skeleton3D::_update_process_order() {
 	process_order_dirty = false;
 }
 
-void Skeleton3D::_notification(int p_what) {
-	switch (p_what) {
-		case NOTIFICATION_UPDATE_SKELETON: {
-			RenderingServer *rs = RenderingServer::get_singleton();
-			Bone *bonesptr = bones.ptrw();
-			int len = bones.size();
+SpinLock Skeleton3D::dirty_skeletons_lock;
+LocalVector<Skeleton3D *> Skeleton3D::dirty_skeletons;
 
-			_update_process_order();
+void Skeleton3D::_update_bone_poses() {
+	// Only touches this skeleton, so different skeletons can be updated from worker threads.
+	_update_process_order();
 
-			const int *order = process_order.ptr();
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
+	Transform *global_poses = bone_global_poses.ptr();
+	uint8_t *bones_dirty = bone_dirty.ptr();
 
-			for (int i = 0; i < len; i++) {
-				Bone &b = bonesptr[order[i]];
+	if (all_bones_dirty) {
+		for (int i = 0; i < len; i++) {
+			bones_dirty[i] |= BONE_DIRTY;
+		}
+		all_bones_dirty = false;
+	}
 
-				if (b.global_pose_override_amount >= 0.999) {
-					b.pose_global = b.global_pose_override;
-				} else {
-					if (b.disable_rest) {
-						if (b.enabled) {
-							Transform pose = b.pose;
-							if (b.custom_pose_enable) {
-								pose = b.custom_pose * pose;
-							}
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * pose;
-							} else {
-								b.pose_global = pose;
-							}
-						} else {
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global;
-							} else {
-								b.pose_global = Transform();
-							}
-						}
+	if (finish_pending) {
+		// Updated again before the previous poses were applied, the bones changed
+		// since then are computed now too instead of keeping a stale pose.
+		for (int i = 0; i < len; i++) {
+			if (bones_dirty[i] & BONE_DIRTY_NEXT) {
+				bones_dirty[i] = (bones_dirty[i] & ~BONE_DIRTY_NEXT) | BONE_DIRTY;
+			}
+		}
+	}
+
+	const int *order = process_order.ptr();
+
+	for (int i = 0; i < len; i++) {
+		int bone = order[i];
+		Bone &b = bonesptr[bone];
+
+		// Parents come first in process order, so a changed bone marks its whole subtree.
+		if (!(bones_dirty[bone] & BONE_DIRTY)) {
+			if (b.parent < 0 || !(bones_dirty[b.parent] & BONE_DIRTY)) {
+				continue;
+			}
+			bones_dirty[bone] |= BONE_DIRTY;
+		}
 
+		if (b.global_pose_override_amount >= 0.999) {
+			global_poses[bone] = b.global_pose_override;
+		} else {
+			Transform pose_global;
+
+			if (b.disable_rest) {
+				if (b.enabled) {
+					Transform pose = b.pose;
+					if (b.custom_pose_enable) {
+						pose = b.custom_pose * pose;
+					}
+					if (b.parent >= 0) {
+						pose_global = global_poses[b.parent] * pose;
 					} else {
-						if (b.enabled) {
-							Transform pose = b.pose;
-							if (b.custom_pose_enable) {
-								pose = b.custom_pose * pose;
-							}
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-							} else {
-								b.pose_global = b.rest * pose;
-							}
-						} else {
-							if (b.parent >= 0) {
-								b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-							} else {
-								b.pose_global = b.rest;
-							}
-						}
+						pose_global = pose;
 					}
-
-					if (b.global_pose_override_amount >= CMP_EPSILON) {
-						b.pose_global = b.pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
+				} else {
+					if (b.parent >= 0) {
+						pose_global = global_poses[b.parent];
+					} else {
+						pose_global = Transform();
 					}
 				}
 
-				if (b.global_pose_override_reset) {
-					b.global_pose_override_amount = 0.0;
+			} else {
+				if (b.enabled) {
+					Transform pose = b.pose;
+					if (b.custom_pose_enable) {
+						pose = b.custom_pose * pose;
+					}
+					if (b.parent >= 0) {
+						pose_global = global_poses[b.parent] * (b.rest * pose);
+					} else {
+						pose_global = b.rest * pose;
+					}
+				} else {
+					if (b.parent >= 0) {
+						pose_global = global_poses[b.parent] * b.rest;
+					} else {
+						pose_global = b.rest;
+					}
 				}
+			}
 
-				for (List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Node3D *node_3d = Object::cast_to<Node3D>(obj);
-					ERR_CONTINUE(!node_3d);
-					node_3d->set_transform(b.pose_global);
-				}
+			if (b.global_pose_override_amount >= CMP_EPSILON) {
+				pose_global = pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
 			}
 
-			//update skins
-			for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
-				const Skin *skin = E->get()->skin.operator->();
-				RID skeleton = E->get()->skeleton;
-				uint32_t bind_count = skin->get_bind_count();
-
-				if (E->get()->bind_count != bind_count) {
-					RS::get_singleton()->skeleton_allocate(skeleton, bind_count);
-					E->get()->bind_count = bind_count;
-					E->get()->skin_bone_indices.resize(bind_count);
-					E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
-				}
+			global_poses[bone] = pose_global;
+		}
 
-				if (E->get()->skeleton_version != version) {
-					for (uint32_t i = 0; i < bind_count; i++) {
-						StringName bind_name = skin->get_bind_name(i);
-
-						if (bind_name != StringName()) {
-							//bind name used, use this
-							bool found = false;
-							for (int j = 0; j < len; j++) {
-								if (bonesptr[j].name == bind_name) {
-									E->get()->skin_bone_indices_ptrs[i] = j;
-									found = true;
-									break;
-								}
-							}
-
-							if (!found) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							}
-						} else if (skin->get_bind_bone(i) >= 0) {
-							int bind_index = skin->get_bind_bone(i);
-							if (bind_index >= len) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							} else {
-								E->get()->skin_bone_indices_ptrs[i] = bind_index;
-							}
-						} else {
-							ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
-							E->get()->skin_bone_indices_ptrs[i] = 0;
+		if (b.global_pose_override_reset && b.global_pose_override_amount != 0.0) {
+			b.global_pose_override_amount = 0.0;
+			bones_dirty[bone] |= BONE_DIRTY_NEXT;
+		}
+	}
+}
+
+void Skeleton3D::_update_finish() {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const Bone *bonesptr = bones.ptr();
+	int len = bones.size();
+	const Transform *global_poses = bone_global_poses.ptr();
+	uint8_t *bones_dirty = bone_dirty.ptr();
+
+	// BONE_DIRTY_NEXT becomes BONE_DIRTY before any user code runs, so bones
+	// changed from here on are recomputed by the next update.
+	for (int i = 0; i < len; i++) {
+		uint8_t flags = bones_dirty[i];
+		bones_dirty[i] = (flags & BONE_APPLY) | ((flags & BONE_DIRTY) ? BONE_APPLY : 0) | ((flags & BONE_DIRTY_NEXT) ? BONE_DIRTY : 0);
+	}
+	finish_pending = false;
+	finish_depth++;
+
+	for (int i = 0; i < len; i++) {
+		if (!(bones_dirty[i] & BONE_APPLY)) {
+			continue;
+		}
+
+		for (const List<ObjectID>::Element *E = bonesptr[i].nodes_bound.front(); E; E = E->next()) {
+			Object *obj = ObjectDB::get_instance(E->get());
+			ERR_CONTINUE(!obj);
+			Node3D *node_3d = Object::cast_to<Node3D>(obj);
+			ERR_CONTINUE(!node_3d);
+			node_3d->set_transform(global_poses[i]);
+		}
+	}
+
+	//update skins
+	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
+		const Skin *skin = E->get()->skin.operator->();
+		RID skeleton = E->get()->skeleton;
+		uint32_t bind_count = skin->get_bind_count();
+		bool update_all = false;
+
+		if (E->get()->bind_count != bind_count) {
+			RS::get_singleton()->skeleton_allocate(skeleton, bind_count);
+			E->get()->bind_count = bind_count;
+			E->get()->skin_bone_indices.resize(bind_count);
+			E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
+			update_all = true;
+		}
+
+		if (E->get()->skeleton_version != version) {
+			for (uint32_t i = 0; i < bind_count; i++) {
+				StringName bind_name = skin->get_bind_name(i);
+
+				if (bind_name != StringName()) {
+					//bind name used, use this
+					bool found = false;
+					for (int j = 0; j < len; j++) {
+						if (bonesptr[j].name == bind_name) {
+							E->get()->skin_bone_indices_ptrs[i] = j;
+							found = true;
+							break;
 						}
 					}
 
-					E->get()->skeleton_version = version;
+					if (!found) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					}
+				} else if (skin->get_bind_bone(i) >= 0) {
+					int bind_index = skin->get_bind_bone(i);
+					if (bind_index >= len) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					} else {
+						E->get()->skin_bone_indices_ptrs[i] = bind_index;
+					}
+				} else {
+					ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
+					E->get()->skin_bone_indices_ptrs[i] = 0;
 				}
+			}
 
-				for (uint32_t i = 0; i < bind_count; i++) {
-					uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
-					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].pose_global * skin->get_bind_pose(i));
-				}
+			E->get()->skeleton_version = version;
+			update_all = true;
+		}
+
+		// Bones that were not recomputed still have their transform in the RenderingServer.
+		for (uint32_t i = 0; i < bind_count; i++) {
+			uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
+			ERR_CONTINUE(bone_index >= (uint32_t)len);
+			if (update_all || (bones_dirty[bone_index] & BONE_APPLY)) {
+				rs->skeleton_bone_set_transform(skeleton, i, global_poses[bone_index] * skin->get_bind_pose(i));
 			}
+		}
+	}
 
-			dirty = false;
+	// A nested update applies the remaining bones of this one as well.
+	finish_depth--;
+	if (finish_depth == 0) {
+		for (int i = 0; i < len; i++) {
+			bones_dirty[i] &= ~BONE_APPLY;
+		}
+	}
 
 #ifdef TOOLS_ENABLED
-			emit_signal(SceneStringNames::get_singleton()->pose_updated);
+	emit_signal(SceneStringNames::get_singleton()->pose_updated);
 #endif // TOOLS_ENABLED
+}
+
+void Skeleton3D::_update_bone_poses_job(void *p_skeletons, uint32_t p_index) {
+	((Skeleton3D **)p_skeletons)[p_index]->_update_bone_poses();
+}
+
+void Skeleton3D::_update_dirty_skeletons() {
+	LocalVector<Skeleton3D *> skeletons;
+
+	dirty_skeletons_lock.lock();
+	SWAP(skeletons, dirty_skeletons);
+	dirty_skeletons_lock.unlock();
+
+	if (skeletons.size() == 0) {
+		return;
+	}
+
+	// Poses of different skeletons are independent, the rest (bound nodes,
+	// RenderingServer, signals) stays on this thread.
+	JobSystem *job_system = JobSystem::get_singleton();
+	if (job_system && job_system->get_thread_count() > 0 && skeletons.size() > 1) {
+		job_system->wait(job_system->add_native_group_job(skeletons.size(), &Skeleton3D::_update_bone_poses_job, skeletons.ptr()));
+	} else {
+		for (uint32_t i = 0; i < skeletons.size(); i++) {
+			skeletons[i]->_update_bone_poses();
+		}
+	}
+
+	// Applying poses runs user code, which may change any skeleton again. Those
+	// are queued anew instead of being lost when their flags are cleared.
+	for (uint32_t i = 0; i < skeletons.size(); i++) {
+		skeletons[i]->dirty = false;
+		skeletons[i]->finish_pending = true;
+	}
+
+	for (uint32_t i = 0; i < skeletons.size(); i++) {
+		if (skeletons[i]->finish_pending) { // Otherwise already applied by a nested update.
+			skeletons[i]->_update_finish();
+		}
+	}
+}
 
+void Skeleton3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_UPDATE_SKELETON: {
+			if (!dirty) {
+				break; // Already updated along with other skeletons.
+			}
+
+			_update_dirty_skeletons();
 		} break;
 
 #ifndef _3D_DISABLED
@@ -388,6 +507,7 @@ void Skeleton3D::clear_bones_global_pose_override() {
 	for (int i = 0; i < bones.size(); i += 1) {
 		bones.write[i].global_pose_override_amount = 0;
 	}
+	all_bones_dirty = true;
 	_make_dirty();
 }
 
@@ -396,6 +516,7 @@ void Skeleton3D::set_bone_global_pose_override(int p_bone, const Transform &p_po
 	bones.write[p_bone].global_pose_override_amount = p_amount;
 	bones.write[p_bone].global_pose_override = p_pose;
 	bones.write[p_bone].global_pose_override_reset = !p_persistent;
+	_make_bone_dirty(p_bone);
 	_make_dirty();
 }
 
@@ -404,7 +525,7 @@ Transform Skeleton3D::get_bone_global_pose(int p_bone) const {
 	if (dirty) {
 		const_cast<Skeleton3D *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
 	}
-	return bones[p_bone].pose_global;
+	return bone_global_poses[p_bone];
 }
 
 // skeleton creation api
@@ -418,6 +539,9 @@ void Skeleton3D::add_bone(const String &p_name) {
 	Bone b;
 	b.name = p_name;
 	bones.push_back(b);
+	bone_global_poses.push_back(Transform());
+	bone_dirty.push_back(0);
+	all_bones_dirty = true;
 	process_order_dirty = true;
 	version++;
 	_make_dirty();
@@ -464,6 +588,7 @@ void Skeleton3D::set_bone_parent(int p_bone, int p_parent) {
 
 	bones.write[p_bone].parent = p_parent;
 	process_order_dirty = true;
+	all_bones_dirty = true;
 	_make_dirty();
 }
 
@@ -480,6 +605,7 @@ void Skeleton3D::unparent_bone_and_rest(int p_bone) {
 
 	bones.write[p_bone].parent = -1;
 	process_order_dirty = true;
+	all_bones_dirty = true;
 
 	_make_dirty();
 }
@@ -487,6 +613,7 @@ void Skeleton3D::unparent_bone_and_rest(int p_bone) {
 void Skeleton3D::set_bone_disable_rest(int p_bone, bool p_disable) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 	bones.write[p_bone].disable_rest = p_disable;
+	_make_bone_dirty(p_bone);
 }
 
 bool Skeleton3D::is_bone_rest_disabled(int p_bone) const {
@@ -504,6 +631,7 @@ void Skeleton3D::set_bone_rest(int p_bone, const Transform &p_rest) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].rest = p_rest;
+	_make_bone_dirty(p_bone);
 	_make_dirty();
 }
 
@@ -517,6 +645,7 @@ void Skeleton3D::set_bone_enabled(int p_bone, bool p_enabled) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].enabled = p_enabled;
+	_make_bone_dirty(p_bone);
 	_make_dirty();
 }
 
@@ -538,6 +667,7 @@ void Skeleton3D::bind_child_node_to_bone(int p_bone, Node *p_node) {
 	}
 
 	bones.write[p_bone].nodes_bound.push_back(id);
+	_make_bone_dirty(p_bone);
 }
 
 void Skeleton3D::unbind_child_node_from_bone(int p_bone, Node *p_node) {
@@ -560,6 +690,9 @@ void Skeleton3D::get_bound_child_nodes_to_bone(int p_bone, List<Node *> *p_bound
 
 void Skeleton3D::clear_bones() {
 	bones.clear();
+	bone_global_poses.clear();
+	bone_dirty.clear();
+	all_bones_dirty = true;
 	process_order_dirty = true;
 	version++;
 	_make_dirty();
@@ -571,11 +704,27 @@ void Skeleton3D::set_bone_pose(int p_bone, const Transform &p_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].pose = p_pose;
+	_make_bone_dirty(p_bone);
 	if (is_inside_tree()) {
 		_make_dirty();
 	}
 }
 
+void Skeleton3D::set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count) {
+	Bone *bonesptr = bones.ptrw();
+	int bone_count = bones.size();
+
+	for (int i = 0; i < p_count; i++) {
+		ERR_CONTINUE(p_bones[i] < 0 || p_bones[i] >= bone_count);
+		bonesptr[p_bones[i]].pose = p_poses[i];
+		bone_dirty[p_bones[i]] |= finish_pending ? BONE_DIRTY_NEXT : BONE_DIRTY;
+	}
+
+	if (p_count && is_inside_tree()) {
+		_make_dirty();
+	}
+}
+
 Transform Skeleton3D::get_bone_pose(int p_bone) const {
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 	return bones[p_bone].pose;
@@ -588,6 +737,7 @@ void Skeleton3D::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose
 	bones.write[p_bone].custom_pose_enable = (p_custom_pose != Transform());
 	bones.write[p_bone].custom_pose = p_custom_pose;
 
+	_make_bone_dirty(p_bone);
 	_make_dirty();
 }
 
@@ -601,10 +751,18 @@ void Skeleton3D::_make_dirty() {
 		return;
 	}
 
+	dirty_skeletons_lock.lock();
+	dirty_skeletons.push_back(this);
+	dirty_skeletons_lock.unlock();
+
 	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
 	dirty = true;
 }
 
+void Skeleton3D::_make_bone_dirty(int p_bone) {
+	bone_dirty[p_bone] |= finish_pending ? BONE_DIRTY_NEXT : BONE_DIRTY;
+}
+
 int Skeleton3D::get_process_order(int p_idx) {
 	ERR_FAIL_INDEX_V(p_idx, bones.size(), -1);
 	_update_process_order();
@@ -934,6 +1092,12 @@ Skeleton3D::Skeleton3D() {
 }
 
 Skeleton3D::~Skeleton3D() {
+	if (dirty) {
+		dirty_skeletons_lock.lock();
+		dirty_skeletons.erase(this);
+		dirty_skeletons_lock.unlock();
+	}
+
 	//some skins may remain bound
 	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
 		E->get()->skeleton_node = nullptr;
@@ -31,7 +31,9 @@
 #ifndef SKELETON_3D_H
 #define SKELETON_3D_H
 
+#include "core/local_vector.h"
 #include "core/rid.h"
+#include "core/spin_lock.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/skin.h"
 
@@ -82,7 +84,6 @@ private:
 		Transform rest;
 
 		Transform pose;
-		Transform pose_global;
 
 		bool custom_pose_enable;
 		Transform custom_pose;
@@ -121,8 +122,34 @@ private:
 	Vector<int> process_order;
 	bool process_order_dirty;
 
+	enum {
+		BONE_DIRTY = 1, // Recomputed on the next update, along with its subtree.
+		BONE_DIRTY_NEXT = 2, // Recomputed on the update after that (reset global pose overrides).
+		BONE_APPLY = 4, // Recomputed, applied to bound nodes and skins.
+	};
+
+	// Per bone data used on every update, kept in contiguous arrays indexed by bone.
+	LocalVector<Transform> bone_global_poses;
+	LocalVector<uint8_t> bone_dirty;
+	bool all_bones_dirty = true;
+
 	void _make_dirty();
+	void _make_bone_dirty(int p_bone);
 	bool dirty;
+	// Poses are computed but not applied yet. Bones changed meanwhile are
+	// marked BONE_DIRTY_NEXT, the dirty flags are shifted when applying.
+	bool finish_pending = false;
+	// Applying runs user code, which may read poses and update this skeleton again.
+	int finish_depth = 0;
+
+	// Skeletons waiting for an update, evaluated together on the first queued notification.
+	static SpinLock dirty_skeletons_lock;
+	static LocalVector<Skeleton3D *> dirty_skeletons;
+
+	void _update_bone_poses();
+	static void _update_bone_poses_job(void *p_skeletons, uint32_t p_index);
+	void _update_finish();
+	static void _update_dirty_skeletons();
 
 	uint64_t version;
 
@@ -189,6 +216,7 @@ public:
 	// posing api
 
 	void set_bone_pose(int p_bone, const Transform &p_pose);
+	void set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count); // Sets many poses, updating the skeleton once.
 	Transform get_bone_pose(int p_bone) const;
 
 	void set_bone_custom_pose(int p_bone, const Transform &p_custom_pose);
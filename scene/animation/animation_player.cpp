@@ -226,9 +226,11 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 	Animation *a = p_anim->animation.operator->();
 
 	p_anim->node_cache.resize(a->get_track_count());
+	p_anim->key_cursors.resize(a->get_track_count());
 
 	for (int i = 0; i < a->get_track_count(); i++) {
 		p_anim->node_cache.write[i] = nullptr;
+		p_anim->key_cursors.write[i] = -1;
 		RES resource;
 		Vector<StringName> leftover_path;
 		Node *child = parent->get_node_and_resource(a->track_get_path(i), resource, leftover_path);
@@ -359,7 +361,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				Quat rot;
 				Vector3 scale;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale, &p_anim->key_cursors.write[i]);
 				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 				if (err != OK) {
@@ -440,7 +442,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE || (p_delta == 0 && update_mode == Animation::UPDATE_DISCRETE)) { //delta == 0 means seek
 
-					Variant value = a->value_track_interpolate(i, p_time);
+					Variant value = a->value_track_interpolate(i, p_time, &p_anim->key_cursors.write[i]);
 
 					if (value == Variant()) {
 						continue;
@@ -569,7 +571,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				TrackNodeCache::BezierAnim *ba = &E->get();
 
-				float bezier = a->bezier_track_interpolate(i, p_time);
+				float bezier = a->bezier_track_interpolate(i, p_time, &p_anim->key_cursors.write[i]);
 				if (ba->accum_pass != accum_pass) {
 					ERR_CONTINUE(cache_update_bezier_size >= NODE_CACHE_UPDATE_MAX);
 					cache_update_bezier[cache_update_bezier_size++] = ba;
@@ -166,6 +166,7 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		Vector<int> key_cursors; // Last key found per track, speeds up finding the next one.
 		Ref<Animation> animation;
 	};
 
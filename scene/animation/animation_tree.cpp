@@ -691,16 +691,45 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 	}
 
 	state.track_map.clear();
+	track_cache_list.clear();
+	transform_slots.clear();
+	bezier_slots.clear();
+	animation_bindings.clear();
 
 	K = nullptr;
 	int idx = 0;
 	while ((K = track_cache.next(K))) {
+		TrackCache *tc = track_cache[*K];
+		tc->root_motion = root_motion_track == *K;
+
+		if (tc->type == Animation::TYPE_TRANSFORM) {
+			TrackCacheTransform *t = static_cast<TrackCacheTransform *>(tc);
+			t->blend_slot = -1;
+			if (!tc->root_motion) {
+				transform_slots.push_back(t);
+			}
+		} else if (tc->type == Animation::TYPE_BEZIER) {
+			TrackCacheBezier *t = static_cast<TrackCacheBezier *>(tc);
+			t->blend_slot = bezier_slots.size();
+			bezier_slots.push_back(t);
+		}
+
 		state.track_map[*K] = idx;
+		track_cache_list.push_back(tc);
 		idx++;
 	}
 
 	state.track_count = idx;
 
+	// Keep the bones of each skeleton together, so their poses are set in one batch.
+	transform_slots.sort_custom<TransformSlotSort>();
+	for (uint32_t i = 0; i < transform_slots.size(); i++) {
+		transform_slots[i]->blend_slot = i;
+	}
+
+	transform_blend.resize(transform_slots.size());
+	bezier_blend.resize(bezier_slots.size());
+
 	cache_valid = true;
 
 	return true;
@@ -714,9 +743,154 @@ void AnimationTree::_clear_caches() {
 	playing_caches.clear();
 
 	track_cache.clear();
+	track_cache_list.clear();
+	transform_slots.clear();
+	bezier_slots.clear();
+	animation_bindings.clear();
 	cache_valid = false;
 }
 
+AnimationTree::AnimationBinding *AnimationTree::_get_animation_binding(Animation *p_animation) {
+	AnimationBinding *binding = animation_bindings.getptr(p_animation->get_instance_id());
+	int track_count = p_animation->get_track_count();
+
+	if (binding && (int)binding->track_index.size() == track_count) {
+		return binding;
+	}
+
+	if (!binding) {
+		binding = &animation_bindings.set(p_animation->get_instance_id(), AnimationBinding())->value();
+	}
+
+	binding->track_index.resize(track_count);
+	binding->key_cursors.resize(track_count);
+
+	for (int i = 0; i < track_count; i++) {
+		binding->key_cursors[i] = -1;
+		binding->track_index[i] = -1;
+
+		NodePath path = p_animation->track_get_path(i);
+		const int *idx = state.track_map.getptr(path);
+		ERR_CONTINUE(!idx);
+		ERR_CONTINUE(*idx < 0 || *idx >= state.track_count);
+
+		if (track_cache_list[*idx]->type != p_animation->track_get_type(i)) {
+			continue; //may happen should not
+		}
+
+		binding->track_index[i] = *idx;
+	}
+
+	return binding;
+}
+
+void AnimationTree::TransformBlend::resize(uint32_t p_size) {
+	for (int i = 0; i < 3; i++) {
+		loc[i].resize(p_size);
+		scale[i].resize(p_size);
+		sample_loc[i].resize(p_size);
+		sample_scale[i].resize(p_size);
+	}
+	for (int i = 0; i < 4; i++) {
+		rot[i].resize(p_size);
+		sample_rot[i].resize(p_size);
+	}
+	rot_blend_accum.resize(p_size);
+	weight.resize(p_size);
+	used.resize(p_size);
+
+	// Slots without a sample are blended with a weight of zero, which only
+	// works if all values are finite.
+	for (int i = 0; i < 3; i++) {
+		memset(loc[i].ptr(), 0, p_size * sizeof(float));
+		memset(scale[i].ptr(), 0, p_size * sizeof(float));
+		memset(sample_loc[i].ptr(), 0, p_size * sizeof(float));
+		memset(sample_scale[i].ptr(), 0, p_size * sizeof(float));
+	}
+	for (int i = 0; i < 4; i++) {
+		memset(rot[i].ptr(), 0, p_size * sizeof(float));
+		memset(sample_rot[i].ptr(), 0, p_size * sizeof(float));
+	}
+	memset(rot_blend_accum.ptr(), 0, p_size * sizeof(float));
+	memset(weight.ptr(), 0, p_size * sizeof(float));
+	memset(used.ptr(), 0, p_size * sizeof(uint8_t));
+}
+
+void AnimationTree::TransformBlend::blend() {
+	uint32_t count = weight.size();
+	const float *w = weight.ptr();
+	uint8_t *u = used.ptr();
+
+	// The first sample of a slot in a pass is taken as is, later ones are
+	// blended in by their weight. Slots don't depend on each other, GCC
+	// vectorizes the location and scale loop at -O3.
+	for (int c = 0; c < 3; c++) {
+		float *dst_loc = loc[c].ptr();
+		float *dst_scale = scale[c].ptr();
+		const float *src_loc = sample_loc[c].ptr();
+		const float *src_scale = sample_scale[c].ptr();
+
+		for (uint32_t i = 0; i < count; i++) {
+			// Not short-circuited, the conditional load of used[] kept the loop scalar.
+			float f = ((w[i] > 0) & !u[i]) ? 1.0f : w[i];
+			dst_loc[i] += (src_loc[i] - dst_loc[i]) * f;
+			dst_scale[i] += (src_scale[i] - dst_scale[i]) * f;
+		}
+	}
+
+	float *rx = rot[0].ptr();
+	float *ry = rot[1].ptr();
+	float *rz = rot[2].ptr();
+	float *rw = rot[3].ptr();
+	float *accum = rot_blend_accum.ptr();
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (w[i] <= 0) {
+			continue;
+		}
+
+		Quat q(sample_rot[0][i], sample_rot[1][i], sample_rot[2][i], sample_rot[3][i]);
+		if (!u[i] || accum[i] == 0) {
+			accum[i] = w[i];
+		} else {
+			float rot_total = accum[i] + w[i];
+			q = q.slerp(Quat(rx[i], ry[i], rz[i], rw[i]), accum[i] / rot_total).normalized();
+			accum[i] = rot_total;
+		}
+		rx[i] = q.x;
+		ry[i] = q.y;
+		rz[i] = q.z;
+		rw[i] = q.w;
+		u[i] = 1;
+	}
+}
+
+void AnimationTree::BezierBlend::resize(uint32_t p_size) {
+	value.resize(p_size);
+	sample.resize(p_size);
+	weight.resize(p_size);
+	used.resize(p_size);
+
+	memset(value.ptr(), 0, p_size * sizeof(float));
+	memset(sample.ptr(), 0, p_size * sizeof(float));
+	memset(weight.ptr(), 0, p_size * sizeof(float));
+	memset(used.ptr(), 0, p_size * sizeof(uint8_t));
+}
+
+void AnimationTree::BezierBlend::blend() {
+	uint32_t count = weight.size();
+	const float *w = weight.ptr();
+	const float *src = sample.ptr();
+	float *dst = value.ptr();
+	uint8_t *u = used.ptr();
+
+	for (uint32_t i = 0; i < count; i++) {
+		float f = (w[i] > 0 && !u[i]) ? 1.0f : w[i];
+		dst[i] += (src[i] - dst[i]) * f;
+		u[i] |= w[i] > 0;
+	}
+}
+
 void AnimationTree::_process_graph(float p_delta) {
 	_update_properties(); //if properties need updating, update them
 
@@ -793,6 +967,9 @@ void AnimationTree::_process_graph(float p_delta) {
 		for (int i = 0; i < state.track_count; i++) {
 			src_blendsw[i] = 1.0; //by default all go to 1 for the root input
 		}
+
+		memset(transform_blend.used.ptr(), 0, transform_blend.used.size() * sizeof(uint8_t));
+		memset(bezier_blend.used.ptr(), 0, bezier_blend.used.size() * sizeof(uint8_t));
 	}
 
 	//process
@@ -823,34 +1000,70 @@ void AnimationTree::_process_graph(float p_delta) {
 			float delta = as.delta;
 			bool seeked = as.seeked;
 
-			for (int i = 0; i < a->get_track_count(); i++) {
-				NodePath path = a->track_get_path(i);
+			AnimationBinding *binding = _get_animation_binding(a.ptr());
+			ERR_CONTINUE(as.track_blends->size() != state.track_count);
+			const float *track_blends = as.track_blends->ptr();
 
-				ERR_CONTINUE(!track_cache.has(path));
+			bool transforms_sampled = false;
+			bool beziers_sampled = false;
 
-				TrackCache *track = track_cache[path];
-				if (track->type != a->track_get_type(i)) {
-					continue; //may happen should not
+			for (int i = 0; i < a->get_track_count(); i++) {
+				int blend_idx = binding->track_index[i];
+				if (blend_idx < 0) {
+					continue;
 				}
 
-				track->root_motion = root_motion_track == path;
-
-				ERR_CONTINUE(!state.track_map.has(path));
-				int blend_idx = state.track_map[path];
-
-				ERR_CONTINUE(blend_idx < 0 || blend_idx >= state.track_count);
-
-				float blend = (*as.track_blends)[blend_idx];
+				float blend = track_blends[blend_idx];
 
 				if (blend < CMP_EPSILON) {
 					continue; //nothing to blend
 				}
 
+				TrackCache *track = track_cache_list[blend_idx];
+				int *cursor = &binding->key_cursors[i];
+
 				switch (track->type) {
 					case Animation::TYPE_TRANSFORM: {
 						TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
 
-						if (track->root_motion) {
+						if (t->blend_slot >= 0) {
+							TransformBlend &tb = transform_blend;
+							int slot = t->blend_slot;
+
+							Vector3 loc;
+							Quat rot;
+							Vector3 scale;
+
+							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale, cursor);
+							if (err != OK) {
+								if (!tb.used[slot]) {
+									// Keep the slot initialized like any other processed track.
+									for (int c = 0; c < 3; c++) {
+										tb.loc[c][slot] = loc[c];
+										tb.scale[c][slot] = scale[c];
+									}
+									tb.rot[0][slot] = rot.x;
+									tb.rot[1][slot] = rot.y;
+									tb.rot[2][slot] = rot.z;
+									tb.rot[3][slot] = rot.w;
+									tb.rot_blend_accum[slot] = 0;
+									tb.used[slot] = 1;
+								}
+								continue;
+							}
+
+							for (int c = 0; c < 3; c++) {
+								tb.sample_loc[c][slot] = loc[c];
+								tb.sample_scale[c][slot] = scale[c];
+							}
+							tb.sample_rot[0][slot] = rot.x;
+							tb.sample_rot[1][slot] = rot.y;
+							tb.sample_rot[2][slot] = rot.z;
+							tb.sample_rot[3][slot] = rot.w;
+							tb.weight[slot] = blend;
+							transforms_sampled = true;
+
+						} else if (track->root_motion) {
 							if (t->process_pass != process_pass) {
 								t->process_pass = process_pass;
 								t->loc = Vector3();
@@ -902,36 +1115,6 @@ void AnimationTree::_process_graph(float p_delta) {
 
 							prev_time = 0;
 
-						} else {
-							Vector3 loc;
-							Quat rot;
-							Vector3 scale;
-
-							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
-							//ERR_CONTINUE(err!=OK); //used for testing, should be removed
-
-							if (t->process_pass != process_pass) {
-								t->process_pass = process_pass;
-								t->loc = loc;
-								t->rot = rot;
-								t->rot_blend_accum = 0;
-								t->scale = scale;
-							}
-
-							if (err != OK) {
-								continue;
-							}
-
-							t->loc = t->loc.lerp(loc, blend);
-							if (t->rot_blend_accum == 0) {
-								t->rot = rot;
-								t->rot_blend_accum = blend;
-							} else {
-								float rot_total = t->rot_blend_accum + blend;
-								t->rot = rot.slerp(t->rot, t->rot_blend_accum / rot_total).normalized();
-								t->rot_blend_accum = rot_total;
-							}
-							t->scale = t->scale.lerp(scale, blend);
 						}
 
 					} break;
@@ -942,7 +1125,7 @@ void AnimationTree::_process_graph(float p_delta) {
 
 						if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE) { //delta == 0 means seek
 
-							Variant value = a->value_track_interpolate(i, time);
+							Variant value = a->value_track_interpolate(i, time, cursor);
 
 							if (value == Variant()) {
 								continue;
@@ -998,14 +1181,9 @@ void AnimationTree::_process_graph(float p_delta) {
 					case Animation::TYPE_BEZIER: {
 						TrackCacheBezier *t = static_cast<TrackCacheBezier *>(track);
 
-						float bezier = a->bezier_track_interpolate(i, time);
-
-						if (t->process_pass != process_pass) {
-							t->value = bezier;
-							t->process_pass = process_pass;
-						}
-
-						t->value = Math::lerp(t->value, bezier, blend);
+						bezier_blend.sample[t->blend_slot] = a->bezier_track_interpolate(i, time, cursor);
+						bezier_blend.weight[t->blend_slot] = blend;
+						beziers_sampled = true;
 
 					} break;
 					case Animation::TYPE_AUDIO: {
@@ -1178,14 +1356,69 @@ void AnimationTree::_process_graph(float p_delta) {
 					} break;
 				}
 			}
+
+			if (transforms_sampled) {
+				transform_blend.blend();
+				memset(transform_blend.weight.ptr(), 0, transform_blend.weight.size() * sizeof(float));
+			}
+			if (beziers_sampled) {
+				bezier_blend.blend();
+				memset(bezier_blend.weight.ptr(), 0, bezier_blend.weight.size() * sizeof(float));
+			}
 		}
 	}
 
 	{
 		// finally, set the tracks
-		const NodePath *K = nullptr;
-		while ((K = track_cache.next(K))) {
-			TrackCache *track = track_cache[*K];
+		const TransformBlend &tb = transform_blend;
+		Skeleton3D *batch_skeleton = nullptr;
+		bone_batch.clear();
+		pose_batch.clear();
+
+		for (uint32_t i = 0; i < transform_slots.size(); i++) {
+			if (!tb.used[i]) {
+				continue; //not processed, ignore
+			}
+
+			TrackCacheTransform *t = transform_slots[i];
+
+			Transform xform;
+			xform.origin = Vector3(tb.loc[0][i], tb.loc[1][i], tb.loc[2][i]);
+			xform.basis.set_quat_scale(Quat(tb.rot[0][i], tb.rot[1][i], tb.rot[2][i], tb.rot[3][i]), Vector3(tb.scale[0][i], tb.scale[1][i], tb.scale[2][i]));
+
+			if (t->skeleton && t->bone_idx >= 0) {
+				// Slots are sorted by skeleton, so each one gets its poses in one call.
+				if (t->skeleton != batch_skeleton) {
+					if (batch_skeleton) {
+						batch_skeleton->set_bone_poses(bone_batch.ptr(), pose_batch.ptr(), bone_batch.size());
+						bone_batch.clear();
+						pose_batch.clear();
+					}
+					batch_skeleton = t->skeleton;
+				}
+				bone_batch.push_back(t->bone_idx);
+				pose_batch.push_back(xform);
+			} else {
+				t->spatial->set_transform(xform);
+			}
+		}
+
+		if (batch_skeleton) {
+			batch_skeleton->set_bone_poses(bone_batch.ptr(), pose_batch.ptr(), bone_batch.size());
+		}
+
+		for (uint32_t i = 0; i < bezier_slots.size(); i++) {
+			if (!bezier_blend.used[i]) {
+				continue; //not processed, ignore
+			}
+
+			TrackCacheBezier *t = bezier_slots[i];
+			t->value = bezier_blend.value[i];
+			t->object->set_indexed(t->subpath, t->value);
+		}
+
+		for (uint32_t i = 0; i < track_cache_list.size(); i++) {
+			TrackCache *track = track_cache_list[i];
 			if (track->process_pass != process_pass) {
 				continue; //not processed, ignore
 			}
@@ -1193,23 +1426,19 @@ void AnimationTree::_process_graph(float p_delta) {
 			switch (track->type) {
 				case Animation::TYPE_TRANSFORM: {
 					TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
+					if (!t->root_motion) {
+						continue; // Set from the blend buffers above.
+					}
 
 					Transform xform;
 					xform.origin = t->loc;
 
 					xform.basis.set_quat_scale(t->rot, t->scale);
 
-					if (t->root_motion) {
-						root_motion_transform = xform;
+					root_motion_transform = xform;
 
-						if (t->skeleton && t->bone_idx >= 0) {
-							root_motion_transform = (t->skeleton->get_bone_rest(t->bone_idx) * root_motion_transform) * t->skeleton->get_bone_rest(t->bone_idx).affine_inverse();
-						}
-					} else if (t->skeleton && t->bone_idx >= 0) {
-						t->skeleton->set_bone_pose(t->bone_idx, xform);
-
-					} else {
-						t->spatial->set_transform(xform);
+					if (t->skeleton && t->bone_idx >= 0) {
+						root_motion_transform = (t->skeleton->get_bone_rest(t->bone_idx) * root_motion_transform) * t->skeleton->get_bone_rest(t->bone_idx).affine_inverse();
 					}
 
 				} break;
@@ -1218,12 +1447,6 @@ void AnimationTree::_process_graph(float p_delta) {
 
 					t->object->set_indexed(t->subpath, t->value);
 
-				} break;
-				case Animation::TYPE_BEZIER: {
-					TrackCacheBezier *t = static_cast<TrackCacheBezier *>(track);
-
-					t->object->set_indexed(t->subpath, t->value);
-
 				} break;
 				default: {
 				} //the rest don't matter
@@ -1320,6 +1543,7 @@ String AnimationTree::get_configuration_warning() const {
 
 void AnimationTree::set_root_motion_track(const NodePath &p_track) {
 	root_motion_track = p_track;
+	cache_valid = false; // Root motion tracks are not blended with the others.
 }
 
 NodePath AnimationTree::get_root_motion_track() const {
@@ -32,6 +32,7 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/local_vector.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/resources/animation.h"
@@ -195,12 +196,14 @@ private:
 		Quat rot;
 		float rot_blend_accum;
 		Vector3 scale;
+		int blend_slot; // Index in transform_blend, -1 for root motion.
 
 		TrackCacheTransform() {
 			type = Animation::TYPE_TRANSFORM;
 			spatial = nullptr;
 			bone_idx = -1;
 			skeleton = nullptr;
+			blend_slot = -1;
 		}
 	};
 
@@ -217,9 +220,11 @@ private:
 	struct TrackCacheBezier : public TrackCache {
 		float value;
 		Vector<StringName> subpath;
+		int blend_slot; // Index in bezier_blend.
 		TrackCacheBezier() {
 			type = Animation::TYPE_BEZIER;
 			value = 0;
+			blend_slot = -1;
 		}
 	};
 
@@ -248,6 +253,62 @@ private:
 	HashMap<NodePath, TrackCache *> track_cache;
 	Set<TrackCache *> playing_caches;
 
+	// Track caches by their index in the blend arrays (see State::track_map).
+	LocalVector<TrackCache *> track_cache_list;
+
+	// Animation tracks resolved to track_cache_list indices, so processing
+	// does not need to look paths up. Built the first time an animation is
+	// blended after the caches were updated.
+	struct AnimationBinding {
+		LocalVector<int> track_index; // -1 if the track has no cache.
+		LocalVector<int> key_cursors;
+	};
+
+	HashMap<ObjectID, AnimationBinding> animation_bindings;
+	AnimationBinding *_get_animation_binding(Animation *p_animation);
+
+	// Transform (except root motion) and bezier tracks are blended in
+	// structure of arrays form, one slot per track. Each animation writes its
+	// samples and weights first, then all slots are blended in one pass over
+	// contiguous arrays. Other tracks go through their TrackCache.
+	struct TransformBlend {
+		LocalVector<float> loc[3];
+		LocalVector<float> rot[4];
+		LocalVector<float> rot_blend_accum;
+		LocalVector<float> scale[3];
+
+		LocalVector<float> sample_loc[3];
+		LocalVector<float> sample_rot[4];
+		LocalVector<float> sample_scale[3];
+		LocalVector<float> weight;
+		LocalVector<uint8_t> used; // Written this pass.
+
+		void resize(uint32_t p_size);
+		void blend();
+	};
+
+	struct BezierBlend {
+		LocalVector<float> value;
+		LocalVector<float> sample;
+		LocalVector<float> weight;
+		LocalVector<uint8_t> used;
+
+		void resize(uint32_t p_size);
+		void blend();
+	};
+
+	struct TransformSlotSort {
+		_FORCE_INLINE_ bool operator()(const TrackCacheTransform *p_a, const TrackCacheTransform *p_b) const { return p_a->skeleton < p_b->skeleton; }
+	};
+
+	TransformBlend transform_blend;
+	LocalVector<TrackCacheTransform *> transform_slots; // Sorted by skeleton.
+	BezierBlend bezier_blend;
+	LocalVector<TrackCacheBezier *> bezier_slots;
+
+	LocalVector<int> bone_batch;
+	LocalVector<Transform> pose_batch;
+
 	Ref<AnimationNode> root;
 
 	AnimationProcessMode process_mode;
@@ -47,6 +47,7 @@
 #include <stdint.h>
 
 VARIANT_ENUM_CAST(Node::PauseMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
 
 int Node::orphan_node_count = 0;
 
@@ -79,6 +80,16 @@ void Node::_notification(int p_notification) {
 				data.pause_owner = this;
 			}
 
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+				if (data.parent) {
+					data.process_thread_group_owner = data.parent->data.process_thread_group_owner;
+				} else {
+					data.process_thread_group_owner = nullptr;
+				}
+			} else {
+				data.process_thread_group_owner = this;
+			}
+
 			if (data.input) {
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			}
@@ -111,6 +122,7 @@ void Node::_notification(int p_notification) {
 			}
 
 			data.pause_owner = nullptr;
+			data.process_thread_group_owner = nullptr;
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = nullptr;
@@ -152,6 +164,13 @@ void Node::_notification(int p_notification) {
 			data.in_constructor = false;
 		} break;
 		case NOTIFICATION_PREDELETE: {
+			if (data.tree && data.tree->is_processing_thread_groups()) {
+				// The node can't leave the tree while sub-thread groups run, keep it alive instead of leaving a dangling child.
+				ERR_PRINT("Scene tree is processing thread groups, can't free a node inside the tree. Consider using queue_free() instead.");
+				cancel_free();
+				return;
+			}
+
 			set_owner(nullptr);
 
 			while (data.owned.size()) {
@@ -295,6 +314,7 @@ void Node::move_child(Node *p_child, int p_pos) {
 	ERR_FAIL_INDEX_MSG(p_pos, data.children.size() + 1, "Invalid new child position: " + itos(p_pos) + ".");
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Scene tree is processing thread groups, move_child() failed. Consider using call_deferred(\"move_child\") instead.");
 
 	// Specifying one place beyond the end
 	// means the same as moving to the last position
@@ -355,6 +375,45 @@ void Node::move_child_notify(Node *p_child) {
 	// to be used when not wanted
 }
 
+void Node::_update_process_group(const StringName &p_group, bool p_enabled) {
+	if (data.tree && data.tree->is_processing_thread_groups()) {
+		// The tree's groups can't change while sub-thread groups run, they are synced once the message queue is flushed.
+		MessageQueue::get_singleton()->push_callable(callable_mp(this, &Node::_sync_process_groups));
+		return;
+	}
+
+	if (p_enabled) {
+		add_to_group(p_group, false);
+	} else {
+		remove_from_group(p_group);
+	}
+}
+
+void Node::_sync_process_groups() {
+	const StringName groups[4] = { "idle_process", "idle_process_internal", "physics_process", "physics_process_internal" };
+	const bool enabled[4] = { data.idle_process, data.idle_process_internal, data.physics_process, data.physics_process_internal };
+
+	for (int i = 0; i < 4; i++) {
+		if (enabled[i] != data.grouped.has(groups[i])) {
+			_update_process_group(groups[i], enabled[i]);
+		}
+	}
+
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	String viewport_id = itos(get_viewport()->get_instance_id());
+	const StringName input_groups[3] = { "_vp_input" + viewport_id, "_vp_unhandled_input" + viewport_id, "_vp_unhandled_key_input" + viewport_id };
+	const bool input_enabled[3] = { data.input, data.unhandled_input, data.unhandled_key_input };
+
+	for (int i = 0; i < 3; i++) {
+		if (input_enabled[i] != data.grouped.has(input_groups[i])) {
+			_update_process_group(input_groups[i], input_enabled[i]);
+		}
+	}
+}
+
 void Node::set_physics_process(bool p_process) {
 	if (data.physics_process == p_process) {
 		return;
@@ -362,11 +421,7 @@ void Node::set_physics_process(bool p_process) {
 
 	data.physics_process = p_process;
 
-	if (data.physics_process) {
-		add_to_group("physics_process", false);
-	} else {
-		remove_from_group("physics_process");
-	}
+	_update_process_group("physics_process", data.physics_process);
 
 	_change_notify("physics_process");
 }
@@ -382,11 +437,7 @@ void Node::set_physics_process_internal(bool p_process_internal) {
 
 	data.physics_process_internal = p_process_internal;
 
-	if (data.physics_process_internal) {
-		add_to_group("physics_process_internal", false);
-	} else {
-		remove_from_group("physics_process_internal");
-	}
+	_update_process_group("physics_process_internal", data.physics_process_internal);
 
 	_change_notify("physics_process_internal");
 }
@@ -436,6 +487,56 @@ void Node::_propagate_pause_owner(Node *p_owner) {
 	}
 }
 
+void Node::set_process_thread_group(ProcessThreadGroup p_mode) {
+	if (data.process_thread_group == p_mode) {
+		return;
+	}
+
+	bool prev_inherits = data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT;
+	data.process_thread_group = p_mode;
+	if (!is_inside_tree()) {
+		return;
+	}
+	if ((data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) == prev_inherits) {
+		return;
+	}
+
+	Node *owner = nullptr;
+
+	if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+		if (data.parent) {
+			owner = data.parent->data.process_thread_group_owner;
+		}
+	} else {
+		owner = this;
+	}
+
+	_propagate_process_thread_group_owner(owner);
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
+Node *Node::get_process_thread_group_owner() const {
+	// Only sub-thread groups are processed separately, everything else belongs to the main thread.
+	Node *owner = data.process_thread_group_owner;
+	if (owner && owner->data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+		return owner;
+	}
+	return nullptr;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	if (this != p_owner && data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
+		return;
+	}
+	data.process_thread_group_owner = p_owner;
+	for (int i = 0; i < data.children.size(); i++) {
+		data.children[i]->_propagate_process_thread_group_owner(p_owner);
+	}
+}
+
 void Node::set_network_master(int p_peer_id, bool p_recursive) {
 	data.network_master = p_peer_id;
 
@@ -858,11 +959,7 @@ void Node::set_process(bool p_idle_process) {
 
 	data.idle_process = p_idle_process;
 
-	if (data.idle_process) {
-		add_to_group("idle_process", false);
-	} else {
-		remove_from_group("idle_process");
-	}
+	_update_process_group("idle_process", data.idle_process);
 
 	_change_notify("idle_process");
 }
@@ -878,11 +975,7 @@ void Node::set_process_internal(bool p_idle_process_internal) {
 
 	data.idle_process_internal = p_idle_process_internal;
 
-	if (data.idle_process_internal) {
-		add_to_group("idle_process_internal", false);
-	} else {
-		remove_from_group("idle_process_internal");
-	}
+	_update_process_group("idle_process_internal", data.idle_process_internal);
 
 	_change_notify("idle_process_internal");
 }
@@ -930,11 +1023,7 @@ void Node::set_process_input(bool p_enable) {
 		return;
 	}
 
-	if (p_enable) {
-		add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
-	} else {
-		remove_from_group("_vp_input" + itos(get_viewport()->get_instance_id()));
-	}
+	_update_process_group("_vp_input" + itos(get_viewport()->get_instance_id()), p_enable);
 }
 
 bool Node::is_processing_input() const {
@@ -950,11 +1039,7 @@ void Node::set_process_unhandled_input(bool p_enable) {
 		return;
 	}
 
-	if (p_enable) {
-		add_to_group("_vp_unhandled_input" + itos(get_viewport()->get_instance_id()));
-	} else {
-		remove_from_group("_vp_unhandled_input" + itos(get_viewport()->get_instance_id()));
-	}
+	_update_process_group("_vp_unhandled_input" + itos(get_viewport()->get_instance_id()), p_enable);
 }
 
 bool Node::is_processing_unhandled_input() const {
@@ -970,11 +1055,7 @@ void Node::set_process_unhandled_key_input(bool p_enable) {
 		return;
 	}
 
-	if (p_enable) {
-		add_to_group("_vp_unhandled_key_input" + itos(get_viewport()->get_instance_id()));
-	} else {
-		remove_from_group("_vp_unhandled_key_input" + itos(get_viewport()->get_instance_id()));
-	}
+	_update_process_group("_vp_unhandled_key_input" + itos(get_viewport()->get_instance_id()), p_enable);
 }
 
 bool Node::is_processing_unhandled_key_input() const {
@@ -1225,6 +1306,7 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	ERR_FAIL_COND_MSG(p_child == this, "Can't add child '" + p_child->get_name() + "' to itself."); // adding to itself!
 	ERR_FAIL_COND_MSG(p_child->data.parent, "Can't add child '" + p_child->get_name() + "' to '" + get_name() + "', already has a parent '" + p_child->data.parent->get_name() + "'."); //Fail if node has a parent
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Scene tree is processing thread groups, add_child() failed. Consider using call_deferred(\"add_child\", child) instead.");
 
 	/* Validate name */
 	_validate_child_name(p_child, p_legible_unique_name);
@@ -1269,6 +1351,7 @@ void Node::_propagate_validate_owner() {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Scene tree is processing thread groups, remove_child() failed. Consider using call_deferred(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -1698,6 +1781,7 @@ bool Node::is_in_group(const StringName &p_identifier) const {
 
 void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 	ERR_FAIL_COND(!p_identifier.operator String().length());
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Scene tree is processing thread groups, add_to_group() failed. Consider using call_deferred(\"add_to_group\", group) instead.");
 
 	if (data.grouped.has(p_identifier)) {
 		return;
@@ -1718,6 +1802,7 @@ void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 
 void Node::remove_from_group(const StringName &p_identifier) {
 	ERR_FAIL_COND(!data.grouped.has(p_identifier));
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Scene tree is processing thread groups, remove_from_group() failed. Consider using call_deferred(\"remove_from_group\", group) instead.");
 
 	Map<StringName, GroupData>::Element *E = data.grouped.find(p_identifier);
 
@@ -2769,6 +2854,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_processing_unhandled_key_input"), &Node::is_processing_unhandled_key_input);
 	ClassDB::bind_method(D_METHOD("set_pause_mode", "mode"), &Node::set_pause_mode);
 	ClassDB::bind_method(D_METHOD("get_pause_mode"), &Node::get_pause_mode);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "mode"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("can_process"), &Node::can_process);
 	ClassDB::bind_method(D_METHOD("print_stray_nodes"), &Node::_print_stray_nodes);
 
@@ -2878,6 +2965,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PAUSE_MODE_STOP);
 	BIND_ENUM_CONSTANT(PAUSE_MODE_PROCESS);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2891,6 +2982,7 @@ void Node::_bind_methods() {
 
 	ADD_GROUP("Pause", "pause_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "pause_mode", PROPERTY_HINT_ENUM, "Inherit,Stop,Process"), "set_pause_mode", "get_pause_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "name", PROPERTY_HINT_NONE, "", 0), "set_name", "get_name");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "filename", PROPERTY_HINT_NONE, "", 0), "set_filename", "get_filename");
@@ -2945,6 +3037,9 @@ Node::Node() {
 	data.unhandled_key_input = false;
 	data.pause_mode = PAUSE_MODE_INHERIT;
 	data.pause_owner = nullptr;
+	data.process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+	data.process_thread_group_owner = nullptr;
+	data.process_thread_group_index = -1;
 	data.network_master = 1; //server by default
 	data.path_cache = nullptr;
 	data.parent_owned = false;
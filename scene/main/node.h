@@ -54,6 +54,13 @@ public:
 		PAUSE_MODE_PROCESS
 	};
 
+	enum ProcessThreadGroup {
+
+		PROCESS_THREAD_GROUP_INHERIT,
+		PROCESS_THREAD_GROUP_MAIN_THREAD,
+		PROCESS_THREAD_GROUP_SUB_THREAD
+	};
+
 	enum DuplicateFlags {
 
 		DUPLICATE_SIGNALS = 1,
@@ -118,6 +125,10 @@ private:
 		PauseMode pause_mode;
 		Node *pause_owner;
 
+		ProcessThreadGroup process_thread_group;
+		Node *process_thread_group_owner;
+		int process_thread_group_index; // Used by SceneTree while dispatching.
+
 		int network_master;
 		Vector<NetData> rpc_methods;
 		Vector<NetData> rpc_properties;
@@ -172,6 +183,9 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_pause_owner(Node *p_owner);
+	void _propagate_process_thread_group_owner(Node *p_owner);
+	void _update_process_group(const StringName &p_group, bool p_enabled);
+	void _sync_process_groups();
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -389,6 +403,10 @@ public:
 	void set_pause_mode(PauseMode p_mode);
 	PauseMode get_pause_mode() const;
 	bool can_process() const;
+
+	void set_process_thread_group(ProcessThreadGroup p_mode);
+	ProcessThreadGroup get_process_thread_group() const;
+	Node *get_process_thread_group_owner() const;
 	bool can_process_notification(int p_what) const;
 
 	void request_ready();
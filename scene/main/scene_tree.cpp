@@ -34,6 +34,7 @@
 #include "core/input/input.h"
 #include "core/io/marshalls.h"
 #include "core/io/resource_loader.h"
+#include "core/job_system.h"
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
 #include "core/os/keyboard.h"
@@ -41,6 +42,7 @@
 #include "core/print_string.h"
 #include "core/project_settings.h"
 #include "node.h"
+#include "scene/3d/node_3d.h"
 #include "scene/debugger/scene_debugger.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
@@ -149,6 +151,8 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 }
 
 void SceneTree::flush_transform_notifications() {
+	Node3D::_flush_pending_transforms(this);
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -795,10 +799,14 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 
 	//copy, so copy on write happens in case something is removed from process while being called
 	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+	//only read through the copy, as ptrw() would force the duplication every frame.
+	const Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
+
+	JobSystem *job_system = JobSystem::get_singleton();
+	bool use_thread_groups = job_system && job_system->get_thread_count() > 0;
 
 	call_lock++;
 
@@ -815,16 +823,63 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 			continue;
 		}
 
+		if (use_thread_groups) {
+			Node *owner = n->get_process_thread_group_owner();
+			if (owner) {
+				// Processed after the main thread nodes, keeping the order inside each group.
+				int index = owner->data.process_thread_group_index;
+				if (index < 0) {
+					index = process_thread_group_count++;
+					if (index == (int)process_thread_groups.size()) {
+						process_thread_groups.push_back(ProcessThreadGroup());
+					}
+					process_thread_groups[index].owner = owner;
+					owner->data.process_thread_group_index = index;
+				}
+				process_thread_groups[index].nodes.push_back(n);
+				continue;
+			}
+		}
+
 		n->notification(p_notification);
 		//ERR_FAIL_COND(node_count != g.nodes.size());
 	}
 
+	if (process_thread_group_count > 0) {
+		for (uint32_t i = 0; i < process_thread_group_count; i++) {
+			process_thread_groups[i].owner->data.process_thread_group_index = -1;
+		}
+
+		// Scene changes from the groups are refused until this returns, they
+		// have to be deferred and are flushed with the message queue.
+		processing_thread_groups = true;
+		job_system->parallel_for(process_thread_group_count, this, &SceneTree::_process_thread_group, p_notification);
+		processing_thread_groups = false;
+
+		for (uint32_t i = 0; i < process_thread_group_count; i++) {
+			process_thread_groups[i].owner = nullptr;
+			process_thread_groups[i].nodes.clear();
+		}
+		process_thread_group_count = 0;
+	}
+
 	call_lock--;
 	if (call_lock == 0) {
 		call_skip.clear();
 	}
 }
 
+void SceneTree::_process_thread_group(uint32_t p_index, int p_notification) {
+	const ProcessThreadGroup &group = process_thread_groups[p_index];
+	for (uint32_t i = 0; i < group.nodes.size(); i++) {
+		Node *n = group.nodes[i];
+		if (call_skip.has(n)) {
+			continue; // Removed by a main thread node this frame.
+		}
+		n->notification(p_notification);
+	}
+}
+
 /*
 void SceneMainLoop::_update_listener_2d() {
 
@@ -1364,6 +1419,9 @@ SceneTree::SceneTree() {
 	ugc_locked = false;
 	call_lock = 0;
 	root_lock = 0;
+	process_thread_group_count = 0;
+	processing_thread_groups = false;
+	xform_pending_version = 1;
 	node_count = 0;
 
 	//create with mainloop
@@ -32,6 +32,7 @@
 #define SCENE_TREE_H
 
 #include "core/io/multiplayer_api.h"
+#include "core/local_vector.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
 #include "core/self_list.h"
@@ -122,6 +123,17 @@ private:
 		bool operator<(const UGCall &p_with) const { return group == p_with.group ? call < p_with.call : group < p_with.group; }
 	};
 
+	// Nodes of each sub-thread process group, rebuilt on every dispatch.
+	struct ProcessThreadGroup {
+		Node *owner = nullptr;
+		LocalVector<Node *> nodes;
+	};
+
+	LocalVector<ProcessThreadGroup> process_thread_groups;
+	uint32_t process_thread_group_count;
+	bool processing_thread_groups;
+	void _process_thread_group(uint32_t p_index, int p_notification);
+
 	//safety for when a node is deleted while a group is being called
 	int call_lock;
 	Set<Node *> call_skip; //skip erased nodes
@@ -175,6 +187,7 @@ private:
 	void node_renamed(Node *p_node);
 
 	Group *add_to_group(const StringName &p_group, Node *p_node);
+	_FORCE_INLINE_ bool is_processing_thread_groups() const { return processing_thread_groups; }
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
@@ -189,6 +202,21 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	SelfList<Node>::List xform_pending_list;
+	uint64_t xform_pending_version;
+
+	// Transforms can also change from sub-thread process groups, the lists above are locked while they run.
+	Mutex xform_mutex;
+	_FORCE_INLINE_ void _xform_lock() const {
+		if (processing_thread_groups) {
+			xform_mutex.lock();
+		}
+	}
+	_FORCE_INLINE_ void _xform_unlock() const {
+		if (processing_thread_groups) {
+			xform_mutex.unlock();
+		}
+	}
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -77,8 +77,60 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (what == "enabled") {
 			track_set_enabled(track, p_value);
 		} else if (what == "keys" || what == "key_values") {
-			if (track_get_type(track) == TYPE_TRANSFORM) {
+			if (track_get_type(track) == TYPE_TRANSFORM && p_value.get_type() == Variant::DICTIONARY) {
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+				Dictionary d = p_value;
+				ERR_FAIL_COND_V(!d.has("times"), false);
+				ERR_FAIL_COND_V(!d.has("transitions"), false);
+				ERR_FAIL_COND_V(!d.has("pages"), false);
+				ERR_FAIL_COND_V(!d.has("data"), false);
+
+				Vector<float> times = d["times"];
+				Vector<float> transitions = d["transitions"];
+				Vector<float> pages = d["pages"];
+				Vector<uint8_t> data = d["data"];
+				int key_count = times.size();
+				int page_count = (key_count + CompressedTransforms::PAGE_SIZE - 1) / CompressedTransforms::PAGE_SIZE;
+				ERR_FAIL_COND_V(transitions.size() != key_count, false);
+				ERR_FAIL_COND_V(pages.size() != page_count * 12, false);
+				ERR_FAIL_COND_V(data.size() != key_count * CompressedTransforms::KEY_COMPONENTS * (int)sizeof(uint16_t), false);
+
+				CompressedTransforms &ct = tt->compressed_transforms;
+				ct.keys.resize(key_count);
+				for (int i = 0; i < key_count; i++) {
+					ct.keys.write[i].time = times[i];
+					ct.keys.write[i].transition = transitions[i];
+				}
+
+				ct.pages.resize(page_count);
+				const float *rp = pages.ptr();
+				for (int i = 0; i < page_count; i++) {
+					CompressedTransforms::Page &page = ct.pages.write[i];
+					Vector3 *bounds[4] = { &page.loc_min, &page.loc_size, &page.scale_min, &page.scale_size };
+					for (int j = 0; j < 4; j++) {
+						bounds[j]->x = *rp++;
+						bounds[j]->y = *rp++;
+						bounds[j]->z = *rp++;
+					}
+				}
+
+				ct.data.resize(key_count * CompressedTransforms::KEY_COMPONENTS);
+				if (data.size()) {
+					memcpy(ct.data.ptrw(), data.ptr(), data.size());
+				}
+
+				Vector3 error = d.has("error") ? Vector3(d["error"]) : Vector3();
+				ct.loc_error = error.x;
+				ct.rot_error = error.y;
+				ct.scale_error = error.z;
+
+				tt->transforms.clear();
+				tt->compressed = true;
+
+			} else if (track_get_type(track) == TYPE_TRANSFORM) {
+				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+				tt->compressed = false;
+				tt->compressed_transforms = CompressedTransforms();
 				Vector<float> values = p_value;
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % 12, false); // should be multiple of 11
@@ -353,7 +405,51 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "enabled") {
 			r_ret = track_is_enabled(track);
 		} else if (what == "keys") {
-			if (track_get_type(track) == TYPE_TRANSFORM) {
+			if (track_get_type(track) == TYPE_TRANSFORM && transform_track_is_compressed(track)) {
+				const CompressedTransforms &ct = static_cast<const TransformTrack *>(tracks[track])->compressed_transforms;
+
+				Dictionary d;
+
+				Vector<float> key_times;
+				Vector<float> key_transitions;
+				key_times.resize(ct.keys.size());
+				key_transitions.resize(ct.keys.size());
+				float *wti = key_times.ptrw();
+				float *wtr = key_transitions.ptrw();
+				for (int i = 0; i < ct.keys.size(); i++) {
+					wti[i] = ct.keys[i].time;
+					wtr[i] = ct.keys[i].transition;
+				}
+
+				Vector<float> pages;
+				pages.resize(ct.pages.size() * 12);
+				float *wp = pages.ptrw();
+				for (int i = 0; i < ct.pages.size(); i++) {
+					const CompressedTransforms::Page &page = ct.pages[i];
+					const Vector3 *bounds[4] = { &page.loc_min, &page.loc_size, &page.scale_min, &page.scale_size };
+					for (int j = 0; j < 4; j++) {
+						*wp++ = bounds[j]->x;
+						*wp++ = bounds[j]->y;
+						*wp++ = bounds[j]->z;
+					}
+				}
+
+				Vector<uint8_t> data;
+				data.resize(ct.data.size() * sizeof(uint16_t));
+				if (data.size()) {
+					memcpy(data.ptrw(), ct.data.ptr(), data.size());
+				}
+
+				d["times"] = key_times;
+				d["transitions"] = key_transitions;
+				d["pages"] = pages;
+				d["data"] = data;
+				d["error"] = Vector3(ct.loc_error, ct.rot_error, ct.scale_error);
+
+				r_ret = d;
+				return true;
+
+			} else if (track_get_type(track) == TYPE_TRANSFORM) {
 				Vector<float> keys;
 				int kk = track_get_key_count(track);
 				keys.resize(kk * 12);
@@ -629,6 +725,7 @@ void Animation::remove_track(int p_track) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			_clear(tt->transforms);
+			tt->compressed_transforms = CompressedTransforms();
 
 		} break;
 		case TYPE_VALUE: {
@@ -780,6 +877,22 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
+
+	if (tt->compressed) {
+		ERR_FAIL_INDEX_V(p_key, tt->compressed_transforms.keys.size(), ERR_INVALID_PARAMETER);
+		TransformKey tk = tt->compressed_transforms.get_value(p_key);
+		if (r_loc) {
+			*r_loc = tk.loc;
+		}
+		if (r_rot) {
+			*r_rot = tk.rot;
+		}
+		if (r_scale) {
+			*r_scale = tk.scale;
+		}
+		return OK;
+	}
+
 	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
 
 	if (r_loc) {
@@ -801,6 +914,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	_transform_track_decompress(tt);
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -826,6 +940,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -872,6 +987,17 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				const Vector<Key> &keys = tt->compressed_transforms.keys;
+				int k = _find(keys, p_time);
+				if (k < 0 || k >= keys.size()) {
+					return -1;
+				}
+				if (keys[k].time != p_time && p_exact) {
+					return -1;
+				}
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size()) {
 				return -1;
@@ -1056,7 +1182,7 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return tt->compressed ? tt->compressed_transforms.keys.size() : tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1091,6 +1217,17 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.keys.size(), Variant());
+				TransformKey tk = tt->compressed_transforms.get_value(p_key_idx);
+
+				Dictionary d;
+				d["location"] = tk.loc;
+				d["rotation"] = tk.rot;
+				d["scale"] = tk.scale;
+
+				return d;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
 
 			Dictionary d;
@@ -1159,6 +1296,10 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.keys.size(), -1);
+				return tt->compressed_transforms.keys[p_key_idx].time;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1204,6 +1345,7 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, float p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
@@ -1268,6 +1410,10 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.keys.size(), -1);
+				return tt->compressed_transforms.keys[p_key_idx].transition;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1304,6 +1450,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1387,6 +1534,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1413,12 +1561,30 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 }
 
 template <class K>
-int Animation::_find(const Vector<K> &p_keys, float p_time) const {
+int Animation::_find(const Vector<K> &p_keys, float p_time, int *r_cursor) const {
 	int len = p_keys.size();
 	if (len == 0) {
 		return -2;
 	}
 
+	if (r_cursor) {
+		// Playing forward, the key is usually the one found last time or the next.
+		const K *keys = p_keys.ptr();
+		for (int i = *r_cursor; i <= *r_cursor + 1; i++) {
+			if (i < -1 || i >= len) {
+				continue;
+			}
+			bool after_key = i == -1 || p_time > keys[i].time || Math::is_equal_approx(p_time, keys[i].time);
+			bool before_next = i == len - 1 || (p_time < keys[i + 1].time && !Math::is_equal_approx(p_time, keys[i + 1].time));
+			if (after_key && before_next) {
+				*r_cursor = i;
+				return i;
+			}
+		}
+		*r_cursor = _find(p_keys, p_time);
+		return *r_cursor;
+	}
+
 	int low = 0;
 	int high = len - 1;
 	int middle = 0;
@@ -1584,9 +1750,40 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
+// Key times and transitions are read from keys, values through get_value(),
+// so compressed tracks interpolate like the others.
+template <class T>
+struct Animation::KeyValues {
+	typedef TKey<T> KeyType;
+	const Vector<TKey<T>> &keys;
+
+	_FORCE_INLINE_ const T &get_value(int p_key) const { return keys[p_key].value; }
+};
+
+struct Animation::CompressedKeyValues {
+	typedef Key KeyType;
+	const Vector<Key> &keys;
+	const CompressedTransforms &compressed;
+
+	_FORCE_INLINE_ TransformKey get_value(int p_key) const { return compressed.get_value(p_key); }
+};
+
 template <class T>
-T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor) const {
+	KeyValues<T> values = { p_keys };
+	return _interpolate<T>(values, p_time, p_interp, p_loop_wrap, p_ok, r_cursor);
+}
+
+template <class T, class V>
+T Animation::_interpolate(const V &p_values, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor) const {
+	const Vector<typename V::KeyType> &keys = p_values.keys;
+
+	int len;
+	if (keys.size() && (keys[keys.size() - 1].time < length || Math::is_equal_approx(keys[keys.size() - 1].time, length))) {
+		len = keys.size(); // no keys past the end, skip searching for the last one
+	} else {
+		len = _find(keys, length) + 1; // try to find last key (there may be more past the end)
+	}
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
@@ -1600,10 +1797,10 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 		if (p_ok) {
 			*p_ok = true;
 		}
-		return p_keys[0].value;
+		return p_values.get_value(0);
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx = _find(keys, p_time, r_cursor);
 
 	ERR_FAIL_COND_V(idx == -2, T());
 
@@ -1617,8 +1814,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 		if (idx >= 0) {
 			if ((idx + 1) < len) {
 				next = idx + 1;
-				float delta = p_keys[next].time - p_keys[idx].time;
-				float from = p_time - p_keys[idx].time;
+				float delta = keys[next].time - keys[idx].time;
+				float from = p_time - keys[idx].time;
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1628,8 +1825,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 
 			} else {
 				next = 0;
-				float delta = (length - p_keys[idx].time) + p_keys[next].time;
-				float from = p_time - p_keys[idx].time;
+				float delta = (length - keys[idx].time) + keys[next].time;
+				float from = p_time - keys[idx].time;
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1642,11 +1839,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 			// on loop, behind first key
 			idx = len - 1;
 			next = 0;
-			float endtime = (length - p_keys[idx].time);
+			float endtime = (length - keys[idx].time);
 			if (endtime < 0) { // may be keys past the end
 				endtime = 0;
 			}
-			float delta = endtime + p_keys[next].time;
+			float delta = endtime + keys[next].time;
 			float from = endtime + p_time;
 
 			if (Math::is_zero_approx(delta)) {
@@ -1661,8 +1858,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 		if (idx >= 0) {
 			if ((idx + 1) < len) {
 				next = idx + 1;
-				float delta = p_keys[next].time - p_keys[idx].time;
-				float from = p_time - p_keys[idx].time;
+				float delta = keys[next].time - keys[idx].time;
+				float from = p_time - keys[idx].time;
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1691,11 +1888,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 		return T();
 	}
 
-	float tr = p_keys[idx].transition;
+	float tr = keys[idx].transition;
 
 	if (tr == 0 || idx == next) {
 		// don't interpolate if not needed
-		return p_keys[idx].value;
+		return p_values.get_value(idx);
 	}
 
 	if (tr != 1.0) {
@@ -1704,10 +1901,10 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 
 	switch (p_interp) {
 		case INTERPOLATION_NEAREST: {
-			return p_keys[idx].value;
+			return p_values.get_value(idx);
 		} break;
 		case INTERPOLATION_LINEAR: {
-			return _interpolate(p_keys[idx].value, p_keys[next].value, c);
+			return _interpolate(p_values.get_value(idx), p_values.get_value(next), c);
 		} break;
 		case INTERPOLATION_CUBIC: {
 			int pre = idx - 1;
@@ -1719,17 +1916,17 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, float p_time, Interpola
 				post = next;
 			}
 
-			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, c);
+			return _cubic_interpolate(p_values.get_value(pre), p_values.get_value(idx), p_values.get_value(next), p_values.get_value(post), c);
 
 		} break;
 		default:
-			return p_keys[idx].value;
+			return p_values.get_value(idx);
 	}
 
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
@@ -1738,7 +1935,13 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed) {
+		CompressedKeyValues values = { tt->compressed_transforms.keys, tt->compressed_transforms };
+		tk = _interpolate<TransformKey>(values, p_time, tt->interpolation, tt->loop_wrap, &ok, r_cursor);
+	} else {
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok, r_cursor);
+	}
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1759,7 +1962,7 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	return OK;
 }
 
-Variant Animation::value_track_interpolate(int p_track, float p_time) const {
+Variant Animation::value_track_interpolate(int p_track, float p_time, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_VALUE, Variant());
@@ -1767,7 +1970,7 @@ Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok, r_cursor);
 
 	if (ok) {
 		return res;
@@ -1935,8 +2138,13 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 			switch (t->type) {
 				case TYPE_TRANSFORM: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(tt->compressed_transforms.keys, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed_transforms.keys, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -1991,7 +2199,11 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 	switch (t->type) {
 		case TYPE_TRANSFORM: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed) {
+				_track_get_key_indices_in_range(tt->compressed_transforms.keys, from_time, to_time, p_indices);
+			} else {
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			}
 
 		} break;
 		case TYPE_VALUE: {
@@ -2247,7 +2459,7 @@ static _FORCE_INLINE_ Vector2 _bezier_interp(real_t t, const Vector2 &start, con
 	return start * omt3 + control_1 * omt2 * t * 3.0 + control_2 * omt * t2 * 3.0 + end * t3;
 }
 
-float Animation::bezier_track_interpolate(int p_track, float p_time) const {
+float Animation::bezier_track_interpolate(int p_track, float p_time, int *r_cursor) const {
 	//this uses a different interpolation scheme
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *track = tracks[p_track];
@@ -2264,7 +2476,7 @@ float Animation::bezier_track_interpolate(int p_track, float p_time) const {
 		return bt->values[0].value.value;
 	}
 
-	int idx = _find(bt->values, p_time);
+	int idx = _find(bt->values, p_time, r_cursor);
 
 	ERR_FAIL_COND_V(idx == -2, 0);
 
@@ -2583,6 +2795,15 @@ void Animation::copy_track(int p_track, Ref<Animation> p_to_animation) {
 		p_to_animation->value_track_set_update_mode(dst_track, value_track_get_update_mode(p_track));
 	}
 
+	if (track_get_type(p_track) == TYPE_TRANSFORM && transform_track_is_compressed(p_track)) {
+		// Copy the compressed keys as they are, instead of decompressing them.
+		TransformTrack *dst = static_cast<TransformTrack *>(p_to_animation->tracks[dst_track]);
+		dst->compressed_transforms = static_cast<const TransformTrack *>(tracks[p_track])->compressed_transforms;
+		dst->compressed = true;
+		p_to_animation->emit_changed();
+		return;
+	}
+
 	for (int i = 0; i < track_get_key_count(p_track); i++) {
 		p_to_animation->track_insert_key(dst_track, track_get_key_time(p_track, i), track_get_key_value(p_track, i), track_get_key_transition(p_track, i));
 	}
@@ -2629,11 +2850,14 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_get_interpolation_loop_wrap", "track_idx"), &Animation::track_get_interpolation_loop_wrap);
 
 	ClassDB::bind_method(D_METHOD("transform_track_interpolate", "track_idx", "time_sec"), &Animation::_transform_track_interpolate);
+	ClassDB::bind_method(D_METHOD("transform_track_set_compressed", "track_idx", "compressed"), &Animation::transform_track_set_compressed);
+	ClassDB::bind_method(D_METHOD("transform_track_is_compressed", "track_idx"), &Animation::transform_track_is_compressed);
+	ClassDB::bind_method(D_METHOD("transform_track_get_compression_error", "track_idx"), &Animation::transform_track_get_compression_error);
 	ClassDB::bind_method(D_METHOD("value_track_set_update_mode", "track_idx", "mode"), &Animation::value_track_set_update_mode);
 	ClassDB::bind_method(D_METHOD("value_track_get_update_mode", "track_idx"), &Animation::value_track_get_update_mode);
 
 	ClassDB::bind_method(D_METHOD("value_track_get_key_indices", "track_idx", "time_sec", "delta"), &Animation::_value_track_get_key_indices);
-	ClassDB::bind_method(D_METHOD("value_track_interpolate", "track_idx", "time_sec"), &Animation::value_track_interpolate);
+	ClassDB::bind_method(D_METHOD("value_track_interpolate", "track_idx", "time_sec"), &Animation::_value_track_interpolate);
 
 	ClassDB::bind_method(D_METHOD("method_track_get_key_indices", "track_idx", "time_sec", "delta"), &Animation::_method_track_get_key_indices);
 	ClassDB::bind_method(D_METHOD("method_track_get_name", "track_idx", "key_idx"), &Animation::method_track_get_name);
@@ -2649,7 +2873,7 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bezier_track_get_key_in_handle", "track_idx", "key_idx"), &Animation::bezier_track_get_key_in_handle);
 	ClassDB::bind_method(D_METHOD("bezier_track_get_key_out_handle", "track_idx", "key_idx"), &Animation::bezier_track_get_key_out_handle);
 
-	ClassDB::bind_method(D_METHOD("bezier_track_interpolate", "track_idx", "time"), &Animation::bezier_track_interpolate);
+	ClassDB::bind_method(D_METHOD("bezier_track_interpolate", "track_idx", "time"), &Animation::_bezier_track_interpolate);
 
 	ClassDB::bind_method(D_METHOD("audio_track_insert_key", "track_idx", "time", "stream", "start_offset", "end_offset"), &Animation::audio_track_insert_key, DEFVAL(0), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("audio_track_set_key_stream", "track_idx", "key_idx", "stream"), &Animation::audio_track_set_key_stream);
@@ -2674,6 +2898,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress"), &Animation::compress);
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2880,6 +3105,9 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	if (tt->compressed) {
+		return; // Already lossy, optimize before compressing.
+	}
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2924,6 +3152,179 @@ void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err
 	}
 }
 
+static _FORCE_INLINE_ uint16_t _quantize_component(float p_value, float p_min, float p_size) {
+	if (p_size <= 0) {
+		return 0;
+	}
+	return CLAMP((int)Math::round((p_value - p_min) / p_size * 65535.0f), 0, 65535);
+}
+
+static _FORCE_INLINE_ float _dequantize_component(uint16_t p_value, float p_min, float p_size) {
+	return p_min + p_size * (p_value / 65535.0f);
+}
+
+Animation::TransformKey Animation::CompressedTransforms::get_value(int p_key) const {
+	const Page &page = pages[p_key / PAGE_SIZE];
+	const uint16_t *src = data.ptr() + p_key * KEY_COMPONENTS;
+
+	TransformKey tk;
+	for (int i = 0; i < 3; i++) {
+		tk.loc[i] = _dequantize_component(src[i], page.loc_min[i], page.loc_size[i]);
+		tk.scale[i] = _dequantize_component(src[6 + i], page.scale_min[i], page.scale_size[i]);
+	}
+
+	// The index of the dropped (largest) component is kept in the spare top bits.
+	int largest = (src[3] >> 15) | ((src[4] >> 15) << 1);
+	real_t q[4];
+	real_t sum = 0;
+	for (int i = 0, j = 3; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		q[i] = ((src[j++] & 0x7FFF) / 32767.0f * 2.0f - 1.0f) * Math_SQRT12;
+		sum += q[i] * q[i];
+	}
+	q[largest] = Math::sqrt(MAX(0, 1 - sum));
+	tk.rot = Quat(q[0], q[1], q[2], q[3]);
+
+	return tk;
+}
+
+void Animation::_transform_track_compress(TransformTrack *p_track) {
+	if (p_track->compressed) {
+		return;
+	}
+
+	const Vector<TKey<TransformKey>> &transforms = p_track->transforms;
+	CompressedTransforms &ct = p_track->compressed_transforms;
+	int key_count = transforms.size();
+	int page_count = (key_count + CompressedTransforms::PAGE_SIZE - 1) / CompressedTransforms::PAGE_SIZE;
+
+	ct.keys.resize(key_count);
+	ct.pages.resize(page_count);
+	ct.data.resize(key_count * CompressedTransforms::KEY_COMPONENTS);
+	ct.loc_error = 0;
+	ct.rot_error = 0;
+	ct.scale_error = 0;
+
+	for (int i = 0; i < page_count; i++) {
+		int from = i * CompressedTransforms::PAGE_SIZE;
+		int to = MIN(from + CompressedTransforms::PAGE_SIZE, key_count);
+
+		AABB loc_bounds(transforms[from].value.loc, Vector3());
+		AABB scale_bounds(transforms[from].value.scale, Vector3());
+		for (int j = from + 1; j < to; j++) {
+			loc_bounds.expand_to(transforms[j].value.loc);
+			scale_bounds.expand_to(transforms[j].value.scale);
+		}
+
+		CompressedTransforms::Page &page = ct.pages.write[i];
+		page.loc_min = loc_bounds.position;
+		page.loc_size = loc_bounds.size;
+		page.scale_min = scale_bounds.position;
+		page.scale_size = scale_bounds.size;
+	}
+
+	uint16_t *dst = ct.data.ptrw();
+	for (int i = 0; i < key_count; i++) {
+		const TKey<TransformKey> &key = transforms[i];
+		const CompressedTransforms::Page &page = ct.pages[i / CompressedTransforms::PAGE_SIZE];
+		uint16_t *key_dst = dst + i * CompressedTransforms::KEY_COMPONENTS;
+
+		ct.keys.write[i].time = key.time;
+		ct.keys.write[i].transition = key.transition;
+
+		for (int j = 0; j < 3; j++) {
+			key_dst[j] = _quantize_component(key.value.loc[j], page.loc_min[j], page.loc_size[j]);
+			key_dst[6 + j] = _quantize_component(key.value.scale[j], page.scale_min[j], page.scale_size[j]);
+		}
+
+		Quat rot = key.value.rot.normalized();
+		real_t q[4] = { rot.x, rot.y, rot.z, rot.w };
+		int largest = 0;
+		for (int j = 1; j < 4; j++) {
+			if (Math::abs(q[j]) > Math::abs(q[largest])) {
+				largest = j;
+			}
+		}
+		// q and -q are the same rotation, keep the dropped component positive.
+		real_t sign = q[largest] < 0 ? -1 : 1;
+		for (int j = 0, k = 3; j < 4; j++) {
+			if (j == largest) {
+				continue;
+			}
+			float v = (q[j] * sign / Math_SQRT12 + 1.0f) * 0.5f;
+			key_dst[k++] = CLAMP((int)Math::round(v * 32767.0f), 0, 32767);
+		}
+		key_dst[3] |= (largest & 1) << 15;
+		key_dst[4] |= (largest >> 1) << 15;
+
+		TransformKey decoded = ct.get_value(i);
+		ct.loc_error = MAX(ct.loc_error, decoded.loc.distance_to(key.value.loc));
+		ct.rot_error = MAX(ct.rot_error, 2.0f * Math::acos(MIN(1.0f, (float)Math::abs(decoded.rot.dot(rot)))));
+		ct.scale_error = MAX(ct.scale_error, decoded.scale.distance_to(key.value.scale));
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed = true;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *p_track) {
+	if (!p_track->compressed) {
+		return;
+	}
+
+	const CompressedTransforms &ct = p_track->compressed_transforms;
+	p_track->transforms.resize(ct.keys.size());
+	for (int i = 0; i < ct.keys.size(); i++) {
+		TKey<TransformKey> &key = p_track->transforms.write[i];
+		key.time = ct.keys[i].time;
+		key.transition = ct.keys[i].transition;
+		key.value = ct.get_value(i);
+	}
+
+	p_track->compressed_transforms = CompressedTransforms();
+	p_track->compressed = false;
+}
+
+void Animation::transform_track_set_compressed(int p_track, bool p_compressed) {
+	ERR_FAIL_INDEX(p_track, tracks.size());
+	Track *t = tracks[p_track];
+	ERR_FAIL_COND(t->type != TYPE_TRANSFORM);
+	TransformTrack *tt = static_cast<TransformTrack *>(t);
+
+	if (p_compressed) {
+		_transform_track_compress(tt);
+	} else {
+		_transform_track_decompress(tt);
+	}
+	emit_changed();
+}
+
+bool Animation::transform_track_is_compressed(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	const Track *t = tracks[p_track];
+	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, false);
+	return static_cast<const TransformTrack *>(t)->compressed;
+}
+
+Vector3 Animation::transform_track_get_compression_error(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), Vector3());
+	const Track *t = tracks[p_track];
+	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, Vector3());
+	const CompressedTransforms &ct = static_cast<const TransformTrack *>(t)->compressed_transforms;
+	return Vector3(ct.loc_error, ct.rot_error, ct.scale_error);
+}
+
+void Animation::compress() {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type == TYPE_TRANSFORM) {
+			_transform_track_compress(static_cast<TransformTrack *>(tracks[i]));
+		}
+	}
+	emit_changed();
+}
+
 Animation::Animation() {
 	step = 0.1;
 	loop = false;
@@ -101,8 +101,39 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	// Transform keys quantized to 16 bits per component, in pages of PAGE_SIZE
+	// keys. Location and scale are relative to the bounds of their page, and
+	// rotation keeps the three smallest quaternion components. Times and
+	// transitions are kept as they are, so keys are found as usual.
+	struct CompressedTransforms {
+		enum {
+			PAGE_SIZE = 64,
+			KEY_COMPONENTS = 9,
+		};
+
+		struct Page {
+			Vector3 loc_min;
+			Vector3 loc_size;
+			Vector3 scale_min;
+			Vector3 scale_size;
+		};
+
+		Vector<Key> keys;
+		Vector<Page> pages;
+		Vector<uint16_t> data;
+
+		// Largest difference to the original keys, measured when compressing.
+		float loc_error = 0;
+		float rot_error = 0; // In radians.
+		float scale_error = 0;
+
+		TransformKey get_value(int p_key) const;
+	};
+
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
+		bool compressed = false;
+		CompressedTransforms compressed_transforms; // Used instead of transforms when compressed.
 
 		TransformTrack() { type = TYPE_TRANSFORM; }
 	};
@@ -191,7 +222,7 @@ private:
 	int _insert(float p_time, T &p_keys, const V &p_value);
 
 	template <class K>
-	inline int _find(const Vector<K> &p_keys, float p_time) const;
+	inline int _find(const Vector<K> &p_keys, float p_time, int *r_cursor = nullptr) const;
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
@@ -207,7 +238,16 @@ private:
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
 	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	struct KeyValues;
+	struct CompressedKeyValues;
+
+	template <class T, class V>
+	_FORCE_INLINE_ T _interpolate(const V &p_values, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor) const;
+	template <class T>
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor = nullptr) const;
+
+	void _transform_track_compress(TransformTrack *p_track);
+	void _transform_track_decompress(TransformTrack *p_track);
 
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
@@ -254,6 +294,14 @@ private:
 		return idxr;
 	}
 
+	Variant _value_track_interpolate(int p_track, float p_time) const {
+		return value_track_interpolate(p_track, p_time);
+	}
+
+	float _bezier_track_interpolate(int p_track, float p_time) const {
+		return bezier_track_interpolate(p_track, p_time);
+	}
+
 	bool _transform_track_optimize_key(const TKey<TransformKey> &t0, const TKey<TransformKey> &t1, const TKey<TransformKey> &t2, float p_alowed_linear_err, float p_alowed_angular_err, float p_max_optimizable_angle, const Vector3 &p_norm);
 	void _transform_track_optimize(int p_idx, float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
 
@@ -312,7 +360,7 @@ public:
 	Vector2 bezier_track_get_key_in_handle(int p_track, int p_index) const;
 	Vector2 bezier_track_get_key_out_handle(int p_track, int p_index) const;
 
-	float bezier_track_interpolate(int p_track, float p_time) const;
+	float bezier_track_interpolate(int p_track, float p_time, int *r_cursor = nullptr) const;
 
 	int audio_track_insert_key(int p_track, float p_time, const RES &p_stream, float p_start_offset = 0, float p_end_offset = 0);
 	void audio_track_set_key_stream(int p_track, int p_key, const RES &p_stream);
@@ -329,9 +377,16 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	// The optional cursor keeps the key found for the track between calls, pass
+	// the same one for a playback (starting at -1) to find keys without a search
+	// while it moves forward.
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor = nullptr) const;
+
+	void transform_track_set_compressed(int p_track, bool p_compressed);
+	bool transform_track_is_compressed(int p_track) const;
+	Vector3 transform_track_get_compression_error(int p_track) const;
 
-	Variant value_track_interpolate(int p_track, float p_time) const;
+	Variant value_track_interpolate(int p_track, float p_time, int *r_cursor = nullptr) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
 	void value_track_set_update_mode(int p_track, UpdateMode p_mode);
 	UpdateMode value_track_get_update_mode(int p_track) const;
@@ -356,6 +411,7 @@ public:
 	void clear();
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
+	void compress();
 
 	Animation();
 	~Animation();
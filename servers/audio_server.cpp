@@ -162,6 +162,12 @@ AudioDriver::AudioDriver() {
 #endif
 }
 
+AudioDriver::~AudioDriver() {
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
+
 AudioDriverDummy AudioDriverManager::dummy_driver;
 AudioDriver *AudioDriverManager::drivers[MAX_DRIVERS] = {
 	&AudioDriverManager::dummy_driver,
@@ -329,6 +335,8 @@ void AudioServer::_mix_step() {
 		E->get().callback(E->get().userdata);
 	}
 
+	_mix_voices();
+
 	for (int i = buses.size() - 1; i >= 0; i--) {
 		//go bus by bus
 		Bus *bus = buses[i];
@@ -455,6 +463,76 @@ void AudioServer::_mix_step() {
 	to_mix = buffer_size;
 }
 
+// Plain loops over contiguous frames without dependencies between them, so
+// the compiler vectorizes them. The ramped volume is computed from the frame
+// index instead of being accumulated for the same reason.
+static void _voice_mix_constant(AudioFrame *__restrict p_dst, const AudioFrame *__restrict p_src, AudioFrame p_volume, int p_frames) {
+	for (int i = 0; i < p_frames; i++) {
+		p_dst[i].l += p_src[i].l * p_volume.l;
+		p_dst[i].r += p_src[i].r * p_volume.r;
+	}
+}
+
+static void _voice_mix_ramp(AudioFrame *__restrict p_dst, const AudioFrame *__restrict p_src, AudioFrame p_volume, AudioFrame p_volume_inc, int p_frames) {
+	for (int i = 0; i < p_frames; i++) {
+		float f = float(i);
+		p_dst[i].l += p_src[i].l * (p_volume.l + p_volume_inc.l * f);
+		p_dst[i].r += p_src[i].r * (p_volume.r + p_volume_inc.r * f);
+	}
+}
+
+struct _VoiceSendSort {
+	_FORCE_INLINE_ bool operator()(const AudioServer::VoiceSend &p_a, const AudioServer::VoiceSend &p_b) const {
+		return p_a.bus_index < p_b.bus_index || (p_a.bus_index == p_b.bus_index && p_a.channel < p_b.channel);
+	}
+};
+
+void AudioServer::_mix_voices() {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	voice_sends.clear();
+	uint32_t active_voices = 0;
+
+	for (uint32_t i = 0; i < voices.size(); i++) {
+		uint32_t prev_size = voice_sends.size();
+		voices[i].callback(voices[i].userdata, buffer_size, voice_sends);
+		if (voice_sends.size() > prev_size) {
+			active_voices++;
+		}
+	}
+	active_voice_count.store(active_voices, std::memory_order_relaxed);
+
+	// Group the sends by target buffer, so each one is looked up once and stays in cache.
+	voice_sends.sort_custom<_VoiceSendSort>();
+
+	AudioFrame *target = nullptr;
+	int target_bus = -1;
+	int target_channel = -1;
+
+	for (uint32_t i = 0; i < voice_sends.size(); i++) {
+		const VoiceSend &send = voice_sends[i];
+
+		if (send.bus_index != target_bus || send.channel != target_channel) {
+			target_bus = send.bus_index;
+			target_channel = send.channel;
+			//bus or channel may have been removed, voices update on their next process
+			target = thread_has_channel_mix_buffer(target_bus, target_channel) ? thread_get_channel_mix_buffer(target_bus, target_channel) : nullptr;
+		}
+
+		if (!target || !send.frames) {
+			continue;
+		}
+
+		if (send.volume_inc.l == 0 && send.volume_inc.r == 0) {
+			_voice_mix_constant(target, send.frames, send.volume, buffer_size);
+		} else {
+			_voice_mix_ramp(target, send.frames, send.volume, send.volume_inc, buffer_size);
+		}
+	}
+
+	voice_mix_time.store(OS::get_singleton()->get_ticks_usec() - begin, std::memory_order_relaxed);
+}
+
 bool AudioServer::thread_has_channel_mix_buffer(int p_bus, int p_buffer) const {
 	if (p_bus < 0 || p_bus >= buses.size()) {
 		return false;
@@ -1123,6 +1201,38 @@ void AudioServer::remove_update_callback(AudioCallback p_callback, void *p_userd
 	unlock();
 }
 
+void AudioServer::add_voice(VoiceCallback p_callback, void *p_userdata) {
+	lock();
+	VoiceItem vi;
+	vi.callback = p_callback;
+	vi.userdata = p_userdata;
+	if (voices.find(vi) == -1) {
+		voices.push_back(vi);
+	}
+	unlock();
+}
+
+void AudioServer::remove_voice(VoiceCallback p_callback, void *p_userdata) {
+	lock();
+	VoiceItem vi;
+	vi.callback = p_callback;
+	vi.userdata = p_userdata;
+	voices.erase(vi);
+	unlock();
+}
+
+int AudioServer::get_voice_count() const {
+	return voices.size();
+}
+
+int AudioServer::get_active_voice_count() const {
+	return active_voice_count.load(std::memory_order_relaxed);
+}
+
+float AudioServer::get_voice_mix_time() const {
+	return voice_mix_time.load(std::memory_order_relaxed) / 1000000.0;
+}
+
 void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 	ERR_FAIL_COND(p_bus_layout.is_null() || p_bus_layout->buses.size() == 0);
 
@@ -1279,6 +1389,10 @@ void AudioServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_time_since_last_mix"), &AudioServer::get_time_since_last_mix);
 	ClassDB::bind_method(D_METHOD("get_output_latency"), &AudioServer::get_output_latency);
 
+	ClassDB::bind_method(D_METHOD("get_voice_count"), &AudioServer::get_voice_count);
+	ClassDB::bind_method(D_METHOD("get_active_voice_count"), &AudioServer::get_active_voice_count);
+	ClassDB::bind_method(D_METHOD("get_voice_mix_time"), &AudioServer::get_voice_mix_time);
+
 	ClassDB::bind_method(D_METHOD("capture_get_device_list"), &AudioServer::capture_get_device_list);
 	ClassDB::bind_method(D_METHOD("capture_get_device"), &AudioServer::capture_get_device);
 	ClassDB::bind_method(D_METHOD("capture_set_device", "name"), &AudioServer::capture_set_device);
@@ -31,12 +31,15 @@
 #ifndef AUDIO_SERVER_H
 #define AUDIO_SERVER_H
 
+#include "core/local_vector.h"
 #include "core/math/audio_frame.h"
 #include "core/object.h"
 #include "core/os/os.h"
 #include "core/variant.h"
 #include "servers/audio/audio_effect.h"
 
+#include <atomic>
+
 class AudioDriverDummy;
 class AudioStream;
 class AudioStreamSample;
@@ -117,7 +120,7 @@ public:
 #endif
 
 	AudioDriver();
-	virtual ~AudioDriver() {}
+	virtual ~AudioDriver();
 };
 
 class AudioDriverManager {
@@ -161,6 +164,19 @@ public:
 
 	typedef void (*AudioCallback)(void *p_userdata);
 
+	// Voices don't write to the bus buffers themselves. Every mix step their
+	// callback renders their frames and describes where they go, then the
+	// server accumulates the sends of all voices in a single pass.
+	struct VoiceSend {
+		const AudioFrame *frames = nullptr; // Owned by the voice, must stay valid until the next callback.
+		int bus_index = 0;
+		int channel = 0;
+		AudioFrame volume = AudioFrame(0, 0); // At the first frame.
+		AudioFrame volume_inc = AudioFrame(0, 0); // Added every frame, zero for a constant volume.
+	};
+
+	typedef void (*VoiceCallback)(void *p_userdata, int p_frames, LocalVector<VoiceSend> &r_sends);
+
 private:
 	uint64_t mix_time;
 	int mix_size;
@@ -244,6 +260,23 @@ private:
 	Set<CallbackItem> callbacks;
 	Set<CallbackItem> update_callbacks;
 
+	struct VoiceItem {
+		VoiceCallback callback;
+		void *userdata;
+
+		bool operator==(const VoiceItem &p_item) const {
+			return callback == p_item.callback && userdata == p_item.userdata;
+		}
+	};
+
+	LocalVector<VoiceItem> voices;
+	LocalVector<VoiceSend> voice_sends;
+	// Written by the mixing thread.
+	std::atomic<uint32_t> active_voice_count = { 0 };
+	std::atomic<uint64_t> voice_mix_time = { 0 };
+
+	void _mix_voices();
+
 	friend class AudioDriver;
 	void _driver_process(int p_frames, int32_t *p_buffer);
 
@@ -347,6 +380,13 @@ public:
 	void add_update_callback(AudioCallback p_callback, void *p_userdata);
 	void remove_update_callback(AudioCallback p_callback, void *p_userdata);
 
+	void add_voice(VoiceCallback p_callback, void *p_userdata);
+	void remove_voice(VoiceCallback p_callback, void *p_userdata);
+
+	int get_voice_count() const;
+	int get_active_voice_count() const;
+	float get_voice_mix_time() const;
+
 	void set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout);
 	Ref<AudioBusLayout> generate_bus_layout() const;
 
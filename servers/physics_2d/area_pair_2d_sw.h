@@ -41,9 +41,11 @@ class AreaPair2DSW : public Constraint2DSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	bool process_collision;
 
 public:
 	bool setup(real_t p_step);
+	bool pre_solve(real_t p_step);
 	void solve(real_t p_step);
 
 	AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area, int p_area_shape);
@@ -56,9 +58,11 @@ class Area2Pair2DSW : public Constraint2DSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	bool process_collision;
 
 public:
 	bool setup(real_t p_step);
+	bool pre_solve(real_t p_step);
 	void solve(real_t p_step);
 
 	Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area_b, int p_shape_b);
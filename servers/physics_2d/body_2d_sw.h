@@ -203,16 +203,29 @@ public:
 		linear_velocity += p_impulse * _inv_mass;
 	}
 
+	// Static and kinematic bodies have no inverse mass, so impulses are no-ops for them. Skipping the write
+	// matters: they can be shared by constraint islands that are being solved on different threads.
+	_FORCE_INLINE_ bool _can_apply_impulses() const { return mode > PhysicsServer2D::BODY_MODE_KINEMATIC; }
+
 	_FORCE_INLINE_ void apply_impulse(const Vector2 &p_impulse, const Vector2 &p_position = Vector2()) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 		angular_velocity += _inv_inertia * p_position.cross(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(real_t p_torque) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		angular_velocity += _inv_inertia * p_torque;
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector2 &p_impulse, const Vector2 &p_position = Vector2()) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		biased_linear_velocity += p_impulse * _inv_mass;
 		biased_angular_velocity += _inv_inertia * p_position.cross(p_impulse);
 	}
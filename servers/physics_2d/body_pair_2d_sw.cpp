@@ -236,7 +236,6 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 	_validate_contacts();
 
-	Vector2 offset_A = A->get_transform().get_origin();
 	Transform2D xform_Au = A->get_transform().untranslated();
 	Transform2D xform_A = xform_Au * A->get_shape_transform(shape_A);
 
@@ -284,9 +283,24 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		return false;
 	}
 
-	if (!prev_collided) {
+	// One way shapes test the body velocities, so they are checked in
+	// pre_solve, after the warm start of the constraints solved before.
+	check_oneway = !prev_collided && (A->is_shape_set_as_one_way_collision(shape_A) || B->is_shape_set_as_one_way_collision(shape_B));
+
+	return true;
+}
+
+bool BodyPair2DSW::pre_solve(real_t p_step) {
+	Vector2 offset_A = A->get_transform().get_origin();
+	Transform2D xform_Au = A->get_transform().untranslated();
+	Transform2D xform_Bu = B->get_transform();
+	xform_Bu.elements[2] -= offset_A;
+
+	if (check_oneway) {
+		check_oneway = false;
+
 		if (A->is_shape_set_as_one_way_collision(shape_A)) {
-			Vector2 direction = xform_A.get_axis(1).normalized();
+			Vector2 direction = (xform_Au * A->get_shape_transform(shape_A)).get_axis(1).normalized();
 			bool valid = false;
 			if (B->get_linear_velocity().dot(direction) >= 0) {
 				for (int i = 0; i < contact_count; i++) {
@@ -311,7 +325,7 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		}
 
 		if (B->is_shape_set_as_one_way_collision(shape_B)) {
-			Vector2 direction = xform_B.get_axis(1).normalized();
+			Vector2 direction = (xform_Bu * B->get_shape_transform(shape_B)).get_axis(1).normalized();
 			bool valid = false;
 			if (A->get_linear_velocity().dot(direction) >= 0) {
 				for (int i = 0; i < contact_count; i++) {
@@ -335,6 +349,9 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		}
 	}
 
+	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
+	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
+
 	real_t max_penetration = space->get_contact_max_allowed_penetration();
 
 	real_t bias = 0.3;
@@ -511,6 +528,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	contact_count = 0;
 	collided = false;
 	oneway_disabled = false;
+	check_oneway = false;
 }
 
 BodyPair2DSW::~BodyPair2DSW() {
@@ -76,6 +76,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	int contact_count;
 	bool collided;
 	bool oneway_disabled;
+	bool check_oneway;
 	int cc;
 
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
@@ -85,6 +86,7 @@ class BodyPair2DSW : public Constraint2DSW {
 
 public:
 	bool setup(real_t p_step);
+	bool pre_solve(real_t p_step);
 	void solve(real_t p_step);
 
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
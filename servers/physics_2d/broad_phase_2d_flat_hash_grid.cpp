@@ -0,0 +1,753 @@
+/*************************************************************************/
+/*  broad_phase_2d_flat_hash_grid.cpp                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "broad_phase_2d_flat_hash_grid.h"
+#include "collision_object_2d_sw.h"
+#include "core/project_settings.h"
+
+#define LARGE_ELEMENT_FI 1.01239812
+
+bool BroadPhase2DFlatHashGrid::_is_large(const Rect2 &p_rect) const {
+	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI); //use magic number to avoid floating point issues
+	return sz.width * sz.height > large_object_min_surface;
+}
+
+void BroadPhase2DFlatHashGrid::_get_cell_range(const Rect2 &p_rect, Point2i &r_from, Point2i &r_to) const {
+	r_from = (p_rect.position / cell_size).floor();
+	r_to = ((p_rect.position + p_rect.size) / cell_size).floor();
+}
+
+void BroadPhase2DFlatHashGrid::_pair_attempt(uint32_t p_elem, uint32_t p_with) {
+	ERR_FAIL_COND(elements[p_elem]._static && elements[p_with]._static);
+
+	uint64_t key = _pair_key(p_elem, p_with);
+	uint32_t *existing = pair_map.lookup_ptr(key);
+	if (existing) {
+		pairs[*existing].rc++;
+		return;
+	}
+
+	uint32_t pair_id;
+	if (free_pairs.size()) {
+		pair_id = free_pairs[free_pairs.size() - 1];
+		free_pairs.resize(free_pairs.size() - 1);
+	} else {
+		pair_id = pairs.size();
+		pairs.resize(pair_id + 1);
+	}
+
+	Pair &pair = pairs[pair_id];
+	pair.a = p_elem;
+	pair.b = p_with;
+	pair.index_in_a = elements[p_elem].pairs.size();
+	pair.index_in_b = elements[p_with].pairs.size();
+	pair.rc = 1;
+	pair.colliding = false;
+	pair.ud = nullptr;
+
+	elements[p_elem].pairs.push_back(pair_id);
+	elements[p_with].pairs.push_back(pair_id);
+	pair_map.insert(key, pair_id);
+}
+
+void BroadPhase2DFlatHashGrid::_unpair_attempt(uint32_t p_elem, uint32_t p_with) {
+	uint32_t *existing = pair_map.lookup_ptr(_pair_key(p_elem, p_with));
+	ERR_FAIL_COND(!existing); //this should really be paired..
+
+	uint32_t pair_id = *existing;
+	Pair &pair = pairs[pair_id];
+	pair.rc--;
+
+	if (pair.rc == 0) {
+		if (pair.colliding && unpair_callback) {
+			//uncollide
+			unpair_callback(elements[p_elem].owner, elements[p_elem].subindex, elements[p_with].owner, elements[p_with].subindex, pair.ud, unpair_userdata);
+		}
+		_remove_pair(pair_id);
+	}
+}
+
+void BroadPhase2DFlatHashGrid::_remove_pair_from_element(uint32_t p_elem, uint32_t p_index) {
+	LocalVector<uint32_t> &list = elements[p_elem].pairs;
+	uint32_t last = list.size() - 1;
+
+	if (p_index != last) {
+		uint32_t moved = list[last];
+		list[p_index] = moved;
+		if (pairs[moved].a == p_elem) {
+			pairs[moved].index_in_a = p_index;
+		} else {
+			pairs[moved].index_in_b = p_index;
+		}
+	}
+	list.resize(last);
+}
+
+void BroadPhase2DFlatHashGrid::_remove_pair(uint32_t p_pair) {
+	uint32_t a = pairs[p_pair].a;
+	uint32_t b = pairs[p_pair].b;
+
+	_remove_pair_from_element(a, pairs[p_pair].index_in_a);
+	_remove_pair_from_element(b, pairs[p_pair].index_in_b);
+
+	pair_map.remove(_pair_key(a, b));
+	free_pairs.push_back(p_pair);
+}
+
+void BroadPhase2DFlatHashGrid::_check_motion(uint32_t p_elem) {
+	const Element &e = elements[p_elem];
+
+	for (uint32_t i = 0; i < e.pairs.size(); i++) {
+		Pair &pair = pairs[e.pairs[i]];
+		const Element &other = elements[pair.a == p_elem ? pair.b : pair.a];
+
+		bool physical_collision = e.aabb.intersects(other.aabb);
+		bool logical_collision = e.owner->test_collision_mask(other.owner);
+
+		if (physical_collision) {
+			if (!pair.colliding || (logical_collision && !pair.ud && pair_callback)) {
+				pair.ud = pair_callback(e.owner, e.subindex, other.owner, other.subindex, pair_userdata);
+			} else if (pair.colliding && !logical_collision && pair.ud && unpair_callback) {
+				unpair_callback(e.owner, e.subindex, other.owner, other.subindex, pair.ud, unpair_userdata);
+				pair.ud = nullptr;
+			}
+			pair.colliding = true;
+		} else { // No physical collision
+			if (pair.colliding && unpair_callback) {
+				unpair_callback(e.owner, e.subindex, other.owner, other.subindex, pair.ud, unpair_userdata);
+			}
+			pair.colliding = false;
+		}
+	}
+}
+
+void BroadPhase2DFlatHashGrid::_enter_cell(uint32_t p_elem, int32_t p_x, int32_t p_y, bool p_static) {
+	uint64_t key = _cell_key(p_x, p_y);
+	uint32_t cell_id;
+
+	uint32_t *existing = cell_map.lookup_ptr(key);
+	if (existing) {
+		cell_id = *existing;
+	} else {
+		if (free_cells.size()) {
+			cell_id = free_cells[free_cells.size() - 1];
+			free_cells.resize(free_cells.size() - 1);
+		} else {
+			cell_id = cells.size();
+			cells.resize(cell_id + 1);
+		}
+		cells[cell_id].key = key;
+		cell_map.insert(key, cell_id);
+	}
+
+	Cell &cell = cells[cell_id];
+	LocalVector<CellEntry> &list = p_static ? cell.static_objects : cell.objects;
+
+	for (uint32_t i = 0; i < list.size(); i++) {
+		if (list[i].element == p_elem) {
+			list[i].rc++;
+			return; // Already in this cell.
+		}
+	}
+
+	CellEntry entry;
+	entry.element = p_elem;
+	entry.rc = 1;
+	list.push_back(entry);
+
+	CollisionObject2DSW *owner = elements[p_elem].owner;
+
+	for (uint32_t i = 0; i < cell.objects.size(); i++) {
+		if (elements[cell.objects[i].element].owner == owner) {
+			continue;
+		}
+		_pair_attempt(p_elem, cell.objects[i].element);
+	}
+
+	if (!p_static) {
+		for (uint32_t i = 0; i < cell.static_objects.size(); i++) {
+			if (elements[cell.static_objects[i].element].owner == owner) {
+				continue;
+			}
+			_pair_attempt(p_elem, cell.static_objects[i].element);
+		}
+	}
+}
+
+void BroadPhase2DFlatHashGrid::_exit_cell(uint32_t p_elem, int32_t p_x, int32_t p_y, bool p_static) {
+	uint64_t key = _cell_key(p_x, p_y);
+	uint32_t *existing = cell_map.lookup_ptr(key);
+	ERR_FAIL_COND(!existing); //should exist!!
+
+	uint32_t cell_id = *existing;
+	Cell &cell = cells[cell_id];
+	LocalVector<CellEntry> &list = p_static ? cell.static_objects : cell.objects;
+
+	uint32_t index = 0;
+	while (index < list.size() && list[index].element != p_elem) {
+		index++;
+	}
+	ERR_FAIL_COND(index == list.size());
+
+	list[index].rc--;
+	if (list[index].rc > 0) {
+		return;
+	}
+
+	list[index] = list[list.size() - 1];
+	list.resize(list.size() - 1);
+
+	CollisionObject2DSW *owner = elements[p_elem].owner;
+
+	for (uint32_t i = 0; i < cell.objects.size(); i++) {
+		if (elements[cell.objects[i].element].owner == owner) {
+			continue;
+		}
+		_unpair_attempt(p_elem, cell.objects[i].element);
+	}
+
+	if (!p_static) {
+		for (uint32_t i = 0; i < cell.static_objects.size(); i++) {
+			if (elements[cell.static_objects[i].element].owner == owner) {
+				continue;
+			}
+			_unpair_attempt(p_elem, cell.static_objects[i].element);
+		}
+	}
+
+	if (cell.objects.empty() && cell.static_objects.empty()) {
+		// The lists keep their capacity, so the slot can be reused without allocating.
+		cell_map.remove(key);
+		free_cells.push_back(cell_id);
+	}
+}
+
+void BroadPhase2DFlatHashGrid::_pair_with_large(uint32_t p_elem, bool p_static, bool p_pair) {
+	CollisionObject2DSW *owner = elements[p_elem].owner;
+
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
+		uint32_t large = large_elements[i];
+		if (large == p_elem) {
+			continue; // do not pair against itself
+		}
+		if (elements[large].owner == owner) {
+			continue;
+		}
+		if (elements[large]._static && p_static) {
+			continue;
+		}
+
+		if (p_pair) {
+			_pair_attempt(large, p_elem);
+		} else {
+			_unpair_attempt(p_elem, large);
+		}
+	}
+}
+
+void BroadPhase2DFlatHashGrid::_enter_grid(uint32_t p_elem, const Rect2 &p_rect, bool p_static) {
+	if (_is_large(p_rect)) {
+		//large object, do not use grid, must check against all elements
+		CollisionObject2DSW *owner = elements[p_elem].owner;
+		for (uint32_t i = 0; i < elements.size(); i++) {
+			if (i == p_elem || !elements[i].owner) {
+				continue;
+			}
+			if (elements[i].aabb == Rect2()) {
+				// Not in the grid yet (its first move is still queued), it pairs with the large elements when it enters.
+				continue;
+			}
+			if (elements[i].owner == owner) {
+				continue;
+			}
+			if (elements[i]._static && p_static) {
+				continue;
+			}
+
+			_pair_attempt(p_elem, i);
+		}
+
+		Element &e = elements[p_elem];
+		if (e.large_rc++ == 0) {
+			e.large_index = large_elements.size();
+			large_elements.push_back(p_elem);
+		}
+		return;
+	}
+
+	Point2i from, to;
+	_get_cell_range(p_rect, from, to);
+
+	for (int i = from.x; i <= to.x; i++) {
+		for (int j = from.y; j <= to.y; j++) {
+			_enter_cell(p_elem, i, j, p_static);
+		}
+	}
+
+	//pair separatedly with large elements
+	_pair_with_large(p_elem, p_static, true);
+}
+
+void BroadPhase2DFlatHashGrid::_exit_grid(uint32_t p_elem, const Rect2 &p_rect, bool p_static) {
+	if (_is_large(p_rect)) {
+		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
+		const LocalVector<uint32_t> &paired = elements[p_elem].pairs;
+		unpair_scratch.clear();
+		for (uint32_t i = 0; i < paired.size(); i++) {
+			const Pair &pair = pairs[paired[i]];
+			unpair_scratch.push_back(pair.a == p_elem ? pair.b : pair.a);
+		}
+		for (uint32_t i = 0; i < unpair_scratch.size(); i++) {
+			_unpair_attempt(p_elem, unpair_scratch[i]);
+		}
+
+		Element &e = elements[p_elem];
+		ERR_FAIL_COND(e.large_rc == 0);
+		if (--e.large_rc == 0) {
+			uint32_t last = large_elements[large_elements.size() - 1];
+			large_elements[e.large_index] = last;
+			elements[last].large_index = e.large_index;
+			large_elements.resize(large_elements.size() - 1);
+		}
+		return;
+	}
+
+	Point2i from, to;
+	_get_cell_range(p_rect, from, to);
+
+	for (int i = from.x; i <= to.x; i++) {
+		for (int j = from.y; j <= to.y; j++) {
+			_exit_cell(p_elem, i, j, p_static);
+		}
+	}
+
+	//unpair from large elements
+	_pair_with_large(p_elem, p_static, false);
+}
+
+void BroadPhase2DFlatHashGrid::_apply_move(uint32_t p_elem) {
+	Element &e = elements[p_elem];
+	e.pending = false;
+
+	Rect2 new_aabb = e.pending_aabb;
+
+	if (new_aabb != e.aabb) {
+		Rect2 old_aabb = e.aabb;
+		bool old_in_grid = old_aabb != Rect2();
+		bool new_in_grid = new_aabb != Rect2();
+		bool old_large = old_in_grid && _is_large(old_aabb);
+		bool new_large = new_in_grid && _is_large(new_aabb);
+
+		if (old_in_grid && new_in_grid && !old_large && !new_large) {
+			// Only visit the cells that changed. Entering and exiting the cells both rects share,
+			// as well as pairing and unpairing against large elements, would cancel out.
+			Point2i old_from, old_to, new_from, new_to;
+			_get_cell_range(old_aabb, old_from, old_to);
+			_get_cell_range(new_aabb, new_from, new_to);
+
+			for (int i = new_from.x; i <= new_to.x; i++) {
+				for (int j = new_from.y; j <= new_to.y; j++) {
+					if (i < old_from.x || i > old_to.x || j < old_from.y || j > old_to.y) {
+						_enter_cell(p_elem, i, j, e._static);
+					}
+				}
+			}
+
+			for (int i = old_from.x; i <= old_to.x; i++) {
+				for (int j = old_from.y; j <= old_to.y; j++) {
+					if (i < new_from.x || i > new_to.x || j < new_from.y || j > new_to.y) {
+						_exit_cell(p_elem, i, j, e._static);
+					}
+				}
+			}
+		} else {
+			// Enter before exiting, so pairs that survive the move are not recreated.
+			if (new_in_grid) {
+				_enter_grid(p_elem, new_aabb, e._static);
+			}
+			if (old_in_grid) {
+				_exit_grid(p_elem, old_aabb, e._static);
+			}
+		}
+
+		e.aabb = new_aabb;
+	}
+
+	_check_motion(p_elem);
+}
+
+void BroadPhase2DFlatHashGrid::_process_moves() {
+	for (uint32_t i = 0; i < moved_elements.size(); i++) {
+		uint32_t elem = moved_elements[i];
+		// Elements removed (and maybe recreated) after moving are no longer pending.
+		if (elements[elem].pending) {
+			_apply_move(elem);
+		}
+	}
+	moved_elements.clear();
+}
+
+BroadPhase2DFlatHashGrid::ID BroadPhase2DFlatHashGrid::create(CollisionObject2DSW *p_object, int p_subindex) {
+	ERR_FAIL_COND_V(!p_object, 0);
+
+	uint32_t elem;
+	if (free_elements.size()) {
+		elem = free_elements[free_elements.size() - 1];
+		free_elements.resize(free_elements.size() - 1);
+	} else {
+		elem = elements.size();
+		elements.resize(elem + 1);
+	}
+
+	Element &e = elements[elem];
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e._static = false;
+	e.pending = false;
+	e.aabb = Rect2();
+	e.pass = 0;
+
+	return elem + 1;
+}
+
+void BroadPhase2DFlatHashGrid::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	uint32_t elem = p_id - 1;
+	Element &e = elements[elem];
+	ERR_FAIL_COND(!e.owner);
+
+	e.pending_aabb = p_aabb;
+	if (!e.pending) {
+		e.pending = true;
+		moved_elements.push_back(elem);
+	}
+}
+
+void BroadPhase2DFlatHashGrid::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	uint32_t elem = p_id - 1;
+	ERR_FAIL_COND(!elements[elem].owner);
+
+	if (elements[elem]._static == p_static) {
+		return;
+	}
+
+	// The queued move was done while the element still had the old mode.
+	if (elements[elem].pending) {
+		_apply_move(elem);
+	}
+
+	Element &e = elements[elem];
+
+	if (e.aabb != Rect2()) {
+		_exit_grid(elem, e.aabb, e._static);
+	}
+
+	e._static = p_static;
+
+	if (e.aabb != Rect2()) {
+		_enter_grid(elem, e.aabb, e._static);
+		_check_motion(elem);
+	}
+}
+
+void BroadPhase2DFlatHashGrid::remove(ID p_id) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	uint32_t elem = p_id - 1;
+	Element &e = elements[elem];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e.aabb != Rect2()) {
+		_exit_grid(elem, e.aabb, e._static);
+	}
+
+	// Large elements pair with everything, including elements that never entered the grid,
+	// so make sure no pair outlives the element.
+	while (e.pairs.size()) {
+		uint32_t pair_id = e.pairs[e.pairs.size() - 1];
+		const Pair &pair = pairs[pair_id];
+		if (pair.colliding && unpair_callback) {
+			unpair_callback(elements[pair.a].owner, elements[pair.a].subindex, elements[pair.b].owner, elements[pair.b].subindex, pair.ud, unpair_userdata);
+		}
+		_remove_pair(pair_id);
+	}
+
+	e.owner = nullptr;
+	e.pending = false;
+	e.aabb = Rect2();
+	free_elements.push_back(elem);
+}
+
+CollisionObject2DSW *BroadPhase2DFlatHashGrid::get_object(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), nullptr);
+	ERR_FAIL_COND_V(!elements[p_id - 1].owner, nullptr);
+	return elements[p_id - 1].owner;
+}
+
+bool BroadPhase2DFlatHashGrid::is_static(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), false);
+	ERR_FAIL_COND_V(!elements[p_id - 1].owner, false);
+	return elements[p_id - 1]._static;
+}
+
+int BroadPhase2DFlatHashGrid::get_subindex(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), -1);
+	ERR_FAIL_COND_V(!elements[p_id - 1].owner, -1);
+	return elements[p_id - 1].subindex;
+}
+
+template <bool use_aabb, bool use_segment>
+void BroadPhase2DFlatHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index) {
+	uint32_t *cell_id = cell_map.lookup_ptr(_cell_key(p_cell.x, p_cell.y));
+	if (!cell_id) {
+		return;
+	}
+
+	const Cell &cell = cells[*cell_id];
+
+	for (uint32_t i = 0; i < cell.objects.size(); i++) {
+		if (index >= p_max_results) {
+			break;
+		}
+		Element &e = elements[cell.objects[i].element];
+		if (e.pass == pass) {
+			continue;
+		}
+
+		e.pass = pass;
+
+		if (use_aabb && !p_aabb.intersects(e.aabb)) {
+			continue;
+		}
+
+		if (use_segment && !e.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		p_results[index] = e.owner;
+		p_result_indices[index] = e.subindex;
+		index++;
+	}
+
+	for (uint32_t i = 0; i < cell.static_objects.size(); i++) {
+		if (index >= p_max_results) {
+			break;
+		}
+		Element &e = elements[cell.static_objects[i].element];
+		if (e.pass == pass) {
+			continue;
+		}
+
+		if (use_aabb && !p_aabb.intersects(e.aabb)) {
+			continue;
+		}
+
+		if (use_segment && !e.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		e.pass = pass;
+		p_results[index] = e.owner;
+		p_result_indices[index] = e.subindex;
+		index++;
+	}
+}
+
+int BroadPhase2DFlatHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	_process_moves();
+	pass++;
+
+	Vector2 dir = (p_to - p_from);
+	if (dir == Vector2()) {
+		return 0;
+	}
+	//avoid divisions by zero
+	dir.normalize();
+	if (dir.x == 0.0) {
+		dir.x = 0.000001;
+	}
+	if (dir.y == 0.0) {
+		dir.y = 0.000001;
+	}
+	Vector2 delta = dir.abs();
+
+	delta.x = cell_size / delta.x;
+	delta.y = cell_size / delta.y;
+
+	Point2i pos = (p_from / cell_size).floor();
+	Point2i end = (p_to / cell_size).floor();
+
+	Point2i step = Vector2(SGN(dir.x), SGN(dir.y));
+
+	Vector2 max;
+
+	if (dir.x < 0) {
+		max.x = (Math::floor((double)pos.x) * cell_size - p_from.x) / dir.x;
+	} else {
+		max.x = (Math::floor((double)pos.x + 1) * cell_size - p_from.x) / dir.x;
+	}
+
+	if (dir.y < 0) {
+		max.y = (Math::floor((double)pos.y) * cell_size - p_from.y) / dir.y;
+	} else {
+		max.y = (Math::floor((double)pos.y + 1) * cell_size - p_from.y) / dir.y;
+	}
+
+	int cullcount = 0;
+	_cull<false, true>(pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
+
+	bool reached_x = false;
+	bool reached_y = false;
+
+	while (true) {
+		if (max.x < max.y) {
+			max.x += delta.x;
+			pos.x += step.x;
+		} else {
+			max.y += delta.y;
+			pos.y += step.y;
+		}
+
+		if (step.x > 0) {
+			if (pos.x >= end.x) {
+				reached_x = true;
+			}
+		} else if (pos.x <= end.x) {
+			reached_x = true;
+		}
+
+		if (step.y > 0) {
+			if (pos.y >= end.y) {
+				reached_y = true;
+			}
+		} else if (pos.y <= end.y) {
+			reached_y = true;
+		}
+
+		_cull<false, true>(pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
+
+		if (reached_x && reached_y) {
+			break;
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
+		if (cullcount >= p_max_results) {
+			break;
+		}
+		Element &e = elements[large_elements[i]];
+		if (e.pass == pass) {
+			continue;
+		}
+
+		e.pass = pass;
+
+		if (!e.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		p_results[cullcount] = e.owner;
+		p_result_indices[cullcount] = e.subindex;
+		cullcount++;
+	}
+
+	return cullcount;
+}
+
+int BroadPhase2DFlatHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	_process_moves();
+	pass++;
+
+	Point2i from, to;
+	_get_cell_range(p_aabb, from, to);
+	int cullcount = 0;
+
+	for (int i = from.x; i <= to.x; i++) {
+		for (int j = from.y; j <= to.y; j++) {
+			_cull<true, false>(Point2i(i, j), p_aabb, Point2(), Point2(), p_results, p_max_results, p_result_indices, cullcount);
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
+		if (cullcount >= p_max_results) {
+			break;
+		}
+		Element &e = elements[large_elements[i]];
+		if (e.pass == pass) {
+			continue;
+		}
+
+		e.pass = pass;
+
+		if (!p_aabb.intersects(e.aabb)) {
+			continue;
+		}
+
+		p_results[cullcount] = e.owner;
+		p_result_indices[cullcount] = e.subindex;
+		cullcount++;
+	}
+	return cullcount;
+}
+
+void BroadPhase2DFlatHashGrid::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhase2DFlatHashGrid::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhase2DFlatHashGrid::update() {
+	_process_moves();
+}
+
+BroadPhase2DSW *BroadPhase2DFlatHashGrid::_create() {
+	return memnew(BroadPhase2DFlatHashGrid);
+}
+
+BroadPhase2DFlatHashGrid::BroadPhase2DFlatHashGrid() {
+	uint32_t hash_table_size = GLOBAL_DEF("physics/2d/bp_hash_table_size", 4096);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/bp_hash_table_size", PropertyInfo(Variant::INT, "physics/2d/bp_hash_table_size", PROPERTY_HINT_RANGE, "0,8192,1,or_greater"));
+	if (hash_table_size > cell_map.get_capacity()) {
+		cell_map.reserve(hash_table_size);
+	}
+
+	cell_size = GLOBAL_DEF("physics/2d/cell_size", 128);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/cell_size", PropertyInfo(Variant::INT, "physics/2d/cell_size", PROPERTY_HINT_RANGE, "0,512,1,or_greater"));
+
+	large_object_min_surface = GLOBAL_DEF("physics/2d/large_object_surface_threshold_in_cells", 512);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/large_object_surface_threshold_in_cells", PropertyInfo(Variant::INT, "physics/2d/large_object_surface_threshold_in_cells", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"));
+}
+
+BroadPhase2DFlatHashGrid::~BroadPhase2DFlatHashGrid() {
+}
@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  broad_phase_2d_flat_hash_grid.h                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BROAD_PHASE_2D_FLAT_HASH_GRID_H
+#define BROAD_PHASE_2D_FLAT_HASH_GRID_H
+
+#include "broad_phase_2d_sw.h"
+#include "core/local_vector.h"
+#include "core/oa_hash_map.h"
+
+// Same pairing rules as BroadPhase2DHashGrid, but elements, cells and pairs live in flat pools
+// indexed by open addressing tables, so a warmed up broad phase does not allocate. Moves are
+// queued and processed in update(), or before the next query.
+class BroadPhase2DFlatHashGrid : public BroadPhase2DSW {
+	struct Pair {
+		uint32_t a;
+		uint32_t b;
+		// Position of this pair in the pair lists of a and b.
+		uint32_t index_in_a;
+		uint32_t index_in_b;
+		uint32_t rc;
+		bool colliding;
+		void *ud;
+	};
+
+	struct Element {
+		CollisionObject2DSW *owner = nullptr; // nullptr when the slot is free.
+		int subindex = 0;
+		bool _static = false;
+		bool pending = false;
+		Rect2 aabb;
+		Rect2 pending_aabb;
+		uint64_t pass = 0;
+		uint32_t large_rc = 0;
+		uint32_t large_index = 0;
+		LocalVector<uint32_t> pairs;
+	};
+
+	struct CellEntry {
+		uint32_t element;
+		uint32_t rc;
+	};
+
+	struct Cell {
+		uint64_t key = 0;
+		LocalVector<CellEntry> objects;
+		LocalVector<CellEntry> static_objects;
+	};
+
+	LocalVector<Element> elements;
+	LocalVector<uint32_t> free_elements;
+	LocalVector<uint32_t> large_elements;
+	LocalVector<uint32_t> moved_elements;
+
+	LocalVector<Pair> pairs;
+	LocalVector<uint32_t> free_pairs;
+	OAHashMap<uint64_t, uint32_t> pair_map;
+
+	LocalVector<Cell> cells;
+	LocalVector<uint32_t> free_cells;
+	OAHashMap<uint64_t, uint32_t> cell_map;
+
+	LocalVector<uint32_t> unpair_scratch;
+
+	uint64_t pass = 1;
+
+	int cell_size;
+	int large_object_min_surface;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	_FORCE_INLINE_ static uint64_t _pair_key(uint32_t p_a, uint32_t p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | p_b) : ((uint64_t(p_b) << 32) | p_a);
+	}
+
+	_FORCE_INLINE_ static uint64_t _cell_key(int32_t p_x, int32_t p_y) {
+		return (uint64_t(uint32_t(p_x)) << 32) | uint32_t(p_y);
+	}
+
+	_FORCE_INLINE_ bool _is_large(const Rect2 &p_rect) const;
+	_FORCE_INLINE_ void _get_cell_range(const Rect2 &p_rect, Point2i &r_from, Point2i &r_to) const;
+
+	void _pair_attempt(uint32_t p_elem, uint32_t p_with);
+	void _unpair_attempt(uint32_t p_elem, uint32_t p_with);
+	void _remove_pair(uint32_t p_pair);
+	void _remove_pair_from_element(uint32_t p_elem, uint32_t p_index);
+	void _check_motion(uint32_t p_elem);
+
+	void _enter_cell(uint32_t p_elem, int32_t p_x, int32_t p_y, bool p_static);
+	void _exit_cell(uint32_t p_elem, int32_t p_x, int32_t p_y, bool p_static);
+	void _pair_with_large(uint32_t p_elem, bool p_static, bool p_pair);
+	void _enter_grid(uint32_t p_elem, const Rect2 &p_rect, bool p_static);
+	void _exit_grid(uint32_t p_elem, const Rect2 &p_rect, bool p_static);
+
+	void _apply_move(uint32_t p_elem);
+	void _process_moves();
+
+	template <bool use_aabb, bool use_segment>
+	_FORCE_INLINE_ void _cull(const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index);
+
+public:
+	virtual ID create(CollisionObject2DSW *p_object, int p_subindex = 0);
+	virtual void move(ID p_id, const Rect2 &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObject2DSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+	virtual int cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhase2DSW *_create();
+
+	BroadPhase2DFlatHashGrid();
+	~BroadPhase2DFlatHashGrid();
+};
+
+#endif // BROAD_PHASE_2D_FLAT_HASH_GRID_H
@@ -135,6 +135,10 @@ bool PinJoint2DSW::setup(real_t p_step) {
 
 	bias = delta * -(get_bias() == 0 ? space->get_constraint_bias() : get_bias()) * (1.0 / p_step);
 
+	return true;
+}
+
+bool PinJoint2DSW::pre_solve(real_t p_step) {
 	// apply accumulated impulse
 	A->apply_impulse(-P, rA);
 	if (B) {
@@ -300,11 +304,15 @@ bool GrooveJoint2DSW::setup(real_t p_step) {
 	real_t _b = get_bias();
 	gbias = (delta * -(_b == 0 ? space->get_constraint_bias() : _b) * (1.0 / p_step)).clamped(get_max_bias());
 
+	correct = true;
+	return true;
+}
+
+bool GrooveJoint2DSW::pre_solve(real_t p_step) {
 	// apply accumulated impulse
 	A->apply_impulse(-jn_acc, rA);
 	B->apply_impulse(jn_acc, rB);
 
-	correct = true;
 	return true;
 }
 
@@ -366,12 +374,16 @@ bool DampedSpringJoint2DSW::setup(real_t p_step) {
 	target_vrn = 0.0f;
 	v_coef = 1.0f - Math::exp(-damping * (p_step)*k);
 
-	// apply spring force
+	// spring force, applied in pre_solve()
 	real_t f_spring = (rest_length - dist) * stiffness;
-	Vector2 j = n * f_spring * (p_step);
+	spring_impulse = n * f_spring * (p_step);
 
-	A->apply_impulse(-j, rA);
-	B->apply_impulse(j, rB);
+	return true;
+}
+
+bool DampedSpringJoint2DSW::pre_solve(real_t p_step) {
+	A->apply_impulse(-spring_impulse, rA);
+	B->apply_impulse(spring_impulse, rB);
 
 	return true;
 }
@@ -79,6 +79,7 @@ public:
 	virtual PhysicsServer2D::JointType get_type() const { return PhysicsServer2D::JOINT_PIN; }
 
 	virtual bool setup(real_t p_step);
+	virtual bool pre_solve(real_t p_step);
 	virtual void solve(real_t p_step);
 
 	void set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value);
@@ -116,6 +117,7 @@ public:
 	virtual PhysicsServer2D::JointType get_type() const { return PhysicsServer2D::JOINT_GROOVE; }
 
 	virtual bool setup(real_t p_step);
+	virtual bool pre_solve(real_t p_step);
 	virtual void solve(real_t p_step);
 
 	GrooveJoint2DSW(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, Body2DSW *p_body_a, Body2DSW *p_body_b);
@@ -144,11 +146,13 @@ class DampedSpringJoint2DSW : public Joint2DSW {
 	real_t n_mass;
 	real_t target_vrn;
 	real_t v_coef;
+	Vector2 spring_impulse;
 
 public:
 	virtual PhysicsServer2D::JointType get_type() const { return PhysicsServer2D::JOINT_DAMPED_SPRING; }
 
 	virtual bool setup(real_t p_step);
+	virtual bool pre_solve(real_t p_step);
 	virtual void solve(real_t p_step);
 
 	void set_param(PhysicsServer2D::DampedSpringParam p_param, real_t p_value);
@@ -31,6 +31,7 @@
 #include "physics_server_2d_sw.h"
 
 #include "broad_phase_2d_basic.h"
+#include "broad_phase_2d_flat_hash_grid.h"
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/debugger/engine_debugger.h"
@@ -1335,7 +1336,13 @@ PhysicsServer2DSW *PhysicsServer2DSW::singletonsw = nullptr;
 
 PhysicsServer2DSW::PhysicsServer2DSW() {
 	singletonsw = this;
-	BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	int broad_phase = GLOBAL_DEF_RST("physics/2d/broad_phase", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/broad_phase", PropertyInfo(Variant::INT, "physics/2d/broad_phase", PROPERTY_HINT_ENUM, "HashGrid,FlatHashGrid"));
+	if (broad_phase == 1) {
+		BroadPhase2DSW::create_func = BroadPhase2DFlatHashGrid::_create;
+	} else {
+		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	}
 	//BroadPhase2DSW::create_func=BroadPhase2DBasic::_create;
 
 	active = true;
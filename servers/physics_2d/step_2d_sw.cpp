@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "step_2d_sw.h"
+#include "core/job_system.h"
 #include "core/os/os.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
@@ -58,35 +59,36 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
+void Step2DSW::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
+	constraint_setup_results[p_constraint_index] = all_constraints[p_constraint_index]->setup(delta);
+}
+
+Constraint2DSW *Step2DSW::_pre_solve_island(Constraint2DSW *p_island, uint32_t &r_constraint_index) {
+	// Constraints whose setup or pre_solve failed are removed from the island.
 	Constraint2DSW *ci = p_island;
-	Constraint2DSW *prev_ci = nullptr;
-	bool removed_root = false;
+	Constraint2DSW *prev = nullptr;
 	while (ci) {
-		bool process = ci->setup(p_delta);
-
-		if (!process) {
-			//remove from island if process fails
-			if (prev_ci) {
-				prev_ci->set_island_next(ci->get_island_next());
+		bool keep = constraint_setup_results[r_constraint_index++] && ci->pre_solve(delta);
+		if (!keep) {
+			if (prev) {
+				prev->set_island_next(ci->get_island_next());
 			} else {
-				removed_root = true;
-				prev_ci = ci;
+				p_island = ci->get_island_next();
 			}
 		} else {
-			prev_ci = ci;
+			prev = ci;
 		}
 		ci = ci->get_island_next();
 	}
-
-	return removed_root;
+	return p_island;
 }
 
-void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta) {
-	for (int i = 0; i < p_iterations; i++) {
-		Constraint2DSW *ci = p_island;
+void Step2DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint2DSW *island = constraint_islands[p_island_index];
+	for (int i = 0; i < iterations; i++) {
+		Constraint2DSW *ci = island;
 		while (ci) {
-			ci->solve(p_delta);
+			ci->solve(delta);
 			ci = ci->get_island_next();
 		}
 	}
@@ -211,38 +213,28 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = nullptr;
-		while (ci) {
-			if (_setup_island(ci, p_delta)) {
-				//removed the root from the island graph because it is not to be processed
-
-				Constraint2DSW *next = ci->get_island_next();
-
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
-
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
-			} else {
-				prev_ci = ci;
-			}
+	delta = p_delta;
+	iterations = p_iterations;
 
-			ci = ci->get_island_list_next();
+	// Flatten the islands; constraints keep the island order so the serial passes below are deterministic.
+	constraint_islands.clear();
+	all_constraints.clear();
+	for (Constraint2DSW *island = constraint_island_list; island; island = island->get_island_list_next()) {
+		constraint_islands.push_back(island);
+		for (Constraint2DSW *ci = island; ci; ci = ci->get_island_next()) {
+			all_constraints.push_back(ci);
+		}
+	}
+	constraint_setup_results.resize(all_constraints.size());
+
+	// Narrow phase only writes to each constraint, so it can run in parallel.
+	JobSystem::get_singleton()->parallel_for(all_constraints.size(), this, &Step2DSW::_setup_constraint, nullptr);
+
+	// Contact reporting, warm starting and area notifications touch shared state, keep them serial.
+	{
+		uint32_t constraint_index = 0;
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			constraint_islands[i] = _pre_solve_island(constraint_islands[i], constraint_index);
 		}
 	}
 
@@ -254,14 +246,10 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	// Islands don't share dynamic bodies, and impulses are never applied to the static and kinematic
+	// bodies they may share, so each island can be solved on its own thread. Results don't depend on
+	// the thread count.
+	JobSystem::get_singleton()->parallel_for(constraint_islands.size(), this, &Step2DSW::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
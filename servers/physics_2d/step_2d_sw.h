@@ -33,12 +33,22 @@
 
 #include "space_2d_sw.h"
 
+#include "core/local_vector.h"
+
 class Step2DSW {
 	uint64_t _step;
 
+	real_t delta = 0.0;
+	int iterations = 0;
+
+	LocalVector<Constraint2DSW *> constraint_islands;
+	LocalVector<Constraint2DSW *> all_constraints;
+	LocalVector<bool> constraint_setup_results;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
-	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
+	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata);
+	Constraint2DSW *_pre_solve_island(Constraint2DSW *p_island, uint32_t &r_constraint_index);
+	void _solve_island(uint32_t p_island_index, void *p_userdata);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
 public:
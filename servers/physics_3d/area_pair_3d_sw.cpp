@@ -40,8 +40,15 @@ bool AreaPair3DSW::setup(real_t p_step) {
 		result = true;
 	}
 
-	if (result != colliding) {
-		if (result) {
+	process_collision = result != colliding;
+	colliding = result;
+
+	return process_collision;
+}
+
+bool AreaPair3DSW::pre_solve(real_t p_step) {
+	if (process_collision) {
+		if (colliding) {
 			if (area->get_space_override_mode() != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
 				body->add_area(area);
 			}
@@ -57,8 +64,6 @@ bool AreaPair3DSW::setup(real_t p_step) {
 				area->remove_body_from_query(body, body_shape, area_shape);
 			}
 		}
-
-		colliding = result;
 	}
 
 	return false; //never do any post solving
@@ -73,6 +78,7 @@ AreaPair3DSW::AreaPair3DSW(Body3DSW *p_body, int p_body_shape, Area3DSW *p_area,
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	process_collision = false;
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == PhysicsServer3D::BODY_MODE_KINEMATIC) {
@@ -103,8 +109,15 @@ bool Area2Pair3DSW::setup(real_t p_step) {
 		result = true;
 	}
 
-	if (result != colliding) {
-		if (result) {
+	process_collision = result != colliding;
+	colliding = result;
+
+	return process_collision;
+}
+
+bool Area2Pair3DSW::pre_solve(real_t p_step) {
+	if (process_collision) {
+		if (colliding) {
 			if (area_b->has_area_monitor_callback() && area_a->is_monitorable()) {
 				area_b->add_area_to_query(area_a, shape_a, shape_b);
 			}
@@ -122,8 +135,6 @@ bool Area2Pair3DSW::setup(real_t p_step) {
 				area_a->remove_area_from_query(area_b, shape_b, shape_a);
 			}
 		}
-
-		colliding = result;
 	}
 
 	return false; //never do any post solving
@@ -138,6 +149,7 @@ Area2Pair3DSW::Area2Pair3DSW(Area3DSW *p_area_a, int p_shape_a, Area3DSW *p_area
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	process_collision = false;
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
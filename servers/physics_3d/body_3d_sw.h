@@ -220,16 +220,29 @@ public:
 		linear_velocity += p_impulse * _inv_mass;
 	}
 
+	// Static and kinematic bodies have no inverse mass, so impulses are no-ops for them. Skipping the write
+	// matters: they can be shared by constraint islands that are being solved on different threads.
+	_FORCE_INLINE_ bool _can_apply_impulses() const { return mode > PhysicsServer3D::BODY_MODE_KINEMATIC; }
+
 	_FORCE_INLINE_ void apply_impulse(const Vector3 &p_impulse, const Vector3 &p_position = Vector3()) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 		angular_velocity += _inv_inertia_tensor.xform((p_position - center_of_mass).cross(p_impulse));
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(const Vector3 &p_impulse) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		angular_velocity += _inv_inertia_tensor.xform(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3 &p_impulse, const Vector3 &p_position = Vector3(), real_t p_max_delta_av = -1.0) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		biased_linear_velocity += p_impulse * _inv_mass;
 		if (p_max_delta_av != 0.0) {
 			Vector3 delta_av = _inv_inertia_tensor.xform((p_position - center_of_mass).cross(p_impulse));
@@ -241,6 +254,9 @@ public:
 	}
 
 	_FORCE_INLINE_ void apply_bias_torque_impulse(const Vector3 &p_impulse) {
+		if (!_can_apply_impulses()) {
+			return;
+		}
 		biased_angular_velocity += _inv_inertia_tensor.xform(p_impulse);
 	}
 
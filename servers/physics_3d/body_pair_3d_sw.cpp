@@ -236,10 +236,25 @@ bool BodyPair3DSW::setup(real_t p_step) {
 	Shape3DSW *shape_A_ptr = A->get_shape(shape_A);
 	Shape3DSW *shape_B_ptr = B->get_shape(shape_B);
 
-	bool collided = CollisionSolver3DSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
-	this->collided = collided;
+	collided = CollisionSolver3DSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+
+	return true; // Either prepare the contacts or test CCD in pre_solve().
+}
+
+bool BodyPair3DSW::pre_solve(real_t p_step) {
+	Vector3 offset_A = A->get_transform().get_origin();
+	Transform xform_Au = Transform(A->get_transform().basis, Vector3());
+	Transform xform_Bu = B->get_transform();
+	xform_Bu.origin -= offset_A;
+
+	Shape3DSW *shape_A_ptr = A->get_shape(shape_A);
+	Shape3DSW *shape_B_ptr = B->get_shape(shape_B);
 
 	if (!collided) {
+		// CCD changes the body velocity, so it can't be done in setup().
+		Transform xform_A = xform_Au * A->get_shape_transform(shape_A);
+		Transform xform_B = xform_Bu * B->get_shape_transform(shape_B);
+
 		//test ccd (currently just a raycast)
 
 		if (A->is_continuous_collision_detection_enabled() && A->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
@@ -87,6 +87,7 @@ class BodyPair3DSW : public Constraint3DSW {
 
 public:
 	bool setup(real_t p_step);
+	bool pre_solve(real_t p_step);
 	void solve(real_t p_step);
 
 	BodyPair3DSW(Body3DSW *p_A, int p_shape_A, Body3DSW *p_B, int p_shape_B);
@@ -61,7 +61,7 @@ void BroadPhase3DBasic::set_static(ID p_id, bool p_static) {
 void BroadPhase3DBasic::remove(ID p_id) {
 	Map<ID, Element>::Element *E = element_map.find(p_id);
 	ERR_FAIL_COND(!E);
-	List<PairKey> to_erase;
+	List<PairKey, FrameAllocator> to_erase;
 	//unpair must be done immediately on removal to avoid potential invalid pointers
 	for (Map<PairKey, void *>::Element *F = pair_map.front(); F; F = F->next()) {
 		if (F->key().a == p_id || F->key().b == p_id) {
@@ -75,7 +75,12 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Called for all constraints in parallel: only write to the constraint itself here.
+	// Returning false skips pre_solve() and solve() for this step.
 	virtual bool setup(real_t p_step) = 0;
+	// Called serially in island order, for anything touching bodies, areas or the space.
+	// Returning false skips solve() for this step.
+	virtual bool pre_solve(real_t p_step) { return true; }
 	virtual void solve(real_t p_step) = 0;
 
 	virtual ~Constraint3DSW() {}
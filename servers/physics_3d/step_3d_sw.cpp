@@ -31,6 +31,7 @@
 #include "step_3d_sw.h"
 #include "joints_3d_sw.h"
 
+#include "core/job_system.h"
 #include "core/os/os.h"
 
 void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constraint3DSW **p_constraint_island) {
@@ -60,23 +61,39 @@ void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constrain
 	}
 }
 
-void Step3DSW::_setup_island(Constraint3DSW *p_island, real_t p_delta) {
+void Step3DSW::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
+	constraint_setup_results[p_constraint_index] = all_constraints[p_constraint_index]->setup(delta);
+}
+
+Constraint3DSW *Step3DSW::_pre_solve_island(Constraint3DSW *p_island, uint32_t &r_constraint_index) {
+	// Constraints whose setup or pre_solve failed are removed from the island.
 	Constraint3DSW *ci = p_island;
+	Constraint3DSW *prev = nullptr;
 	while (ci) {
-		ci->setup(p_delta);
-		//todo remove from island if process fails
+		bool keep = constraint_setup_results[r_constraint_index++] && ci->pre_solve(delta);
+		if (!keep) {
+			if (prev) {
+				prev->set_island_next(ci->get_island_next());
+			} else {
+				p_island = ci->get_island_next();
+			}
+		} else {
+			prev = ci;
+		}
 		ci = ci->get_island_next();
 	}
+	return p_island;
 }
 
-void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta) {
+void Step3DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	Constraint3DSW *island = constraint_islands[p_island_index];
 	int at_priority = 1;
 
-	while (p_island) {
-		for (int i = 0; i < p_iterations; i++) {
-			Constraint3DSW *ci = p_island;
+	while (island) {
+		for (int i = 0; i < iterations; i++) {
+			Constraint3DSW *ci = island;
 			while (ci) {
-				ci->solve(p_delta);
+				ci->solve(delta);
 				ci = ci->get_island_next();
 			}
 		}
@@ -84,14 +101,14 @@ void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t
 		at_priority++;
 
 		{
-			Constraint3DSW *ci = p_island;
+			Constraint3DSW *ci = island;
 			Constraint3DSW *prev = nullptr;
 			while (ci) {
 				if (ci->get_priority() < at_priority) {
 					if (prev) {
 						prev->set_island_next(ci->get_island_next()); //remove
 					} else {
-						p_island = ci->get_island_next();
+						island = ci->get_island_next();
 					}
 				} else {
 					prev = ci;
@@ -222,11 +239,28 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
+	delta = p_delta;
+	iterations = p_iterations;
+
+	// Flatten the islands; constraints keep the island order so the serial passes below are deterministic.
+	constraint_islands.clear();
+	all_constraints.clear();
+	for (Constraint3DSW *island = constraint_island_list; island; island = island->get_island_list_next()) {
+		constraint_islands.push_back(island);
+		for (Constraint3DSW *ci = island; ci; ci = ci->get_island_next()) {
+			all_constraints.push_back(ci);
+		}
+	}
+	constraint_setup_results.resize(all_constraints.size());
+
+	// Narrow phase only writes to each constraint, so it can run in parallel.
+	JobSystem::get_singleton()->parallel_for(all_constraints.size(), this, &Step3DSW::_setup_constraint, nullptr);
+
+	// Contact reporting, warm starting and area notifications touch shared state, keep them serial.
 	{
-		Constraint3DSW *ci = constraint_island_list;
-		while (ci) {
-			_setup_island(ci, p_delta);
-			ci = ci->get_island_list_next();
+		uint32_t constraint_index = 0;
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			constraint_islands[i] = _pre_solve_island(constraint_islands[i], constraint_index);
 		}
 	}
 
@@ -238,14 +272,10 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint3DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
-		}
-	}
+	// Islands don't share dynamic bodies, and impulses are never applied to the static and kinematic
+	// bodies they may share, so each island can be solved on its own thread. Results don't depend on
+	// the thread count.
+	JobSystem::get_singleton()->parallel_for(constraint_islands.size(), this, &Step3DSW::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -33,12 +33,22 @@
 
 #include "space_3d_sw.h"
 
+#include "core/local_vector.h"
+
 class Step3DSW {
 	uint64_t _step;
 
+	real_t delta = 0.0;
+	int iterations = 0;
+
+	LocalVector<Constraint3DSW *> constraint_islands;
+	LocalVector<Constraint3DSW *> all_constraints;
+	LocalVector<bool> constraint_setup_results;
+
 	void _populate_island(Body3DSW *p_body, Body3DSW **p_island, Constraint3DSW **p_constraint_island);
-	void _setup_island(Constraint3DSW *p_island, real_t p_delta);
-	void _solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta);
+	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata);
+	Constraint3DSW *_pre_solve_island(Constraint3DSW *p_island, uint32_t &r_constraint_index);
+	void _solve_island(uint32_t p_island_index, void *p_userdata);
 	void _check_suspend(Body3DSW *p_island, real_t p_delta);
 
 public:
@@ -154,12 +154,9 @@ void RasterizerRD::initialize() {
 	}
 }
 
-ThreadWorkPool RasterizerRD::thread_work_pool;
 uint64_t RasterizerRD::frame = 1;
 
 void RasterizerRD::finalize() {
-	thread_work_pool.finish();
-
 	memdelete(scene);
 	memdelete(canvas);
 	memdelete(storage);
@@ -174,7 +171,6 @@ RasterizerRD *RasterizerRD::singleton = nullptr;
 
 RasterizerRD::RasterizerRD() {
 	singleton = this;
-	thread_work_pool.init();
 	time = 0;
 
 	storage = memnew(RasterizerStorageRD);
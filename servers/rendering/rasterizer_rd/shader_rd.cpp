@@ -30,6 +30,7 @@
 
 #include "shader_rd.h"
 
+#include "core/job_system.h"
 #include "core/string_builder.h"
 #include "rasterizer_rd.h"
 #include "servers/rendering/rendering_device.h"
@@ -354,14 +355,8 @@ void ShaderRD::_compile_version(Version *p_version) {
 	p_version->dirty = false;
 
 	p_version->variants = memnew_arr(RID, variant_defines.size());
-#if 1
 
-	RasterizerRD::thread_work_pool.do_work(variant_defines.size(), this, &ShaderRD::_compile_variant, p_version);
-#else
-	for (int i = 0; i < variant_defines.size(); i++) {
-		_compile_variant(i, p_version);
-	}
-#endif
+	JobSystem::get_singleton()->parallel_for(variant_defines.size(), this, &ShaderRD::_compile_variant, p_version);
 
 	bool all_valid = true;
 	for (int i = 0; i < variant_defines.size(); i++) {
@@ -31,6 +31,7 @@
 #include "rendering_server_scene.h"
 
 #include "core/os/os.h"
+#include "core/project_settings.h"
 #include "rendering_server_globals.h"
 #include "rendering_server_raster.h"
 
@@ -104,7 +105,7 @@ void RenderingServerScene::camera_set_use_vertical_aspect(RID p_camera, bool p_e
 
 /* SCENARIO API */
 
-void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
+void *RenderingServerScene::_instance_pair(void *p_self, SpatialPartitionID, Instance *p_A, int, SpatialPartitionID, Instance *p_B, int) {
 	//RenderingServerScene *self = (RenderingServerScene*)p_self;
 	Instance *A = p_A;
 	Instance *B = p_B;
@@ -200,7 +201,7 @@ void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instan
 	return nullptr;
 }
 
-void RenderingServerScene::_instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *udata) {
+void RenderingServerScene::_instance_unpair(void *p_self, SpatialPartitionID, Instance *p_A, int, SpatialPartitionID, Instance *p_B, int, void *udata) {
 	//RenderingServerScene *self = (RenderingServerScene*)p_self;
 	Instance *A = p_A;
 	Instance *B = p_B;
@@ -281,14 +282,362 @@ void RenderingServerScene::_instance_unpair(void *p_self, OctreeElementID, Insta
 	}
 }
 
+/* SPATIAL PARTITIONING (BVH) */
+
+struct RenderingServerScene::SpatialPartitioningScene_BVH::PairQuery {
+	SpatialPartitioningScene_BVH *self;
+	uint32_t item;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_other) {
+		if (p_other == item) {
+			return false;
+		}
+		const Item &a = self->items[item];
+		const Item &b = self->items[p_other];
+		if (self->_can_pair(a, b) && a.aabb.intersects_inclusive(b.aabb) && !self->_is_paired(item, p_other)) {
+			self->_pair(item, p_other);
+		}
+		return false;
+	}
+};
+
+template <class T>
+struct RenderingServerScene::SpatialPartitioningScene_BVH::CullQuery {
+	const SpatialPartitioningScene_BVH *self;
+	T test;
+	Instance **result_array;
+	int result_max;
+	int result_count;
+	uint32_t mask;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_item) {
+		const Item &item = self->items[p_item];
+		if (!(item.pairable_type & mask) || !test(item.aabb)) {
+			return false;
+		}
+		result_array[result_count++] = item.userdata;
+		return result_count == result_max;
+	}
+};
+
+namespace {
+
+struct CullTestConvex {
+	const Plane *planes;
+	int plane_count;
+	const Vector3 *points;
+	int point_count;
+
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const {
+		return p_aabb.intersects_convex_shape(planes, plane_count, points, point_count);
+	}
+};
+
+struct CullTestAABB {
+	AABB aabb;
+
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const {
+		return aabb.intersects_inclusive(p_aabb);
+	}
+};
+
+struct CullTestSegment {
+	Vector3 from;
+	Vector3 to;
+
+	_FORCE_INLINE_ bool operator()(const AABB &p_aabb) const {
+		return p_aabb.intersects_segment(from, to);
+	}
+};
+
+} // namespace
+
+bool RenderingServerScene::SpatialPartitioningScene_BVH::_is_paired(uint32_t p_a, uint32_t p_b) const {
+	// Lights and probes may pair with many geometries, so scan the shorter list.
+	const Item &a = items[p_a];
+	const Item &b = items[p_b];
+	const LocalVector<uint32_t> &list = a.pairs.size() <= b.pairs.size() ? a.pairs : b.pairs;
+	for (uint32_t i = 0; i < list.size(); i++) {
+		const Pair &pair = pairs[list[i]];
+		if ((pair.a == p_a && pair.b == p_b) || (pair.a == p_b && pair.b == p_a)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_pair(uint32_t p_a, uint32_t p_b) {
+	uint32_t pair_id;
+	if (free_pairs.size()) {
+		pair_id = free_pairs[free_pairs.size() - 1];
+		free_pairs.resize(free_pairs.size() - 1);
+	} else {
+		pair_id = pairs.size();
+		pairs.push_back(Pair());
+	}
+
+	Pair &pair = pairs[pair_id];
+	pair.a = p_a;
+	pair.b = p_b;
+	pair.ud = nullptr;
+
+	Item &a = items[p_a];
+	Item &b = items[p_b];
+	a.pairs.push_back(pair_id);
+	b.pairs.push_back(pair_id);
+
+	if (pair_callback) {
+		pair.ud = pair_callback(pair_callback_userdata, p_a + 1, a.userdata, a.subindex, p_b + 1, b.userdata, b.subindex);
+	}
+}
+
+static _FORCE_INLINE_ void _erase_pair_from_list(LocalVector<uint32_t> &r_list, uint32_t p_pair) {
+	for (uint32_t i = 0; i < r_list.size(); i++) {
+		if (r_list[i] == p_pair) {
+			r_list[i] = r_list[r_list.size() - 1];
+			r_list.resize(r_list.size() - 1);
+			return;
+		}
+	}
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_unpair(uint32_t p_pair) {
+	const Pair &pair = pairs[p_pair];
+	Item &a = items[pair.a];
+	Item &b = items[pair.b];
+
+	if (unpair_callback) {
+		unpair_callback(unpair_callback_userdata, pair.a + 1, a.userdata, a.subindex, pair.b + 1, b.userdata, b.subindex, pair.ud);
+	}
+
+	_erase_pair_from_list(a.pairs, p_pair);
+	_erase_pair_from_list(b.pairs, p_pair);
+	free_pairs.push_back(p_pair);
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_unpair_all(uint32_t p_item) {
+	const LocalVector<uint32_t> &list = items[p_item].pairs;
+	while (list.size()) {
+		_unpair(list[list.size() - 1]);
+	}
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_update_pairs(uint32_t p_item) {
+	Item &item = items[p_item];
+
+	// Pairs that stopped overlapping. Unpairing swaps the last pair into the erased slot, so walk backwards.
+	for (int i = int(item.pairs.size()) - 1; i >= 0; i--) {
+		const Pair &pair = pairs[item.pairs[i]];
+		uint32_t other = pair.a == p_item ? pair.b : pair.a;
+		if (!items[other].aabb.intersects_inclusive(item.aabb)) {
+			_unpair(item.pairs[i]);
+		}
+	}
+
+	if (item.leaf == DynamicBVH::INVALID_ID) {
+		return;
+	}
+
+	// New pairs; non-pairable items can only pair with pairable ones.
+	PairQuery query;
+	query.self = this;
+	query.item = p_item;
+	trees[TREE_PAIRABLE].aabb_query(item.aabb, query);
+	if (item.pairable) {
+		trees[TREE_NON_PAIRABLE].aabb_query(item.aabb, query);
+	}
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_tree_insert(uint32_t p_item) {
+	Item &item = items[p_item];
+	if (item.aabb.has_no_surface()) {
+		return;
+	}
+	item.leaf = trees[item.get_tree()].insert(item.aabb, p_item);
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::_tree_remove(uint32_t p_item) {
+	Item &item = items[p_item];
+	if (item.leaf == DynamicBVH::INVALID_ID) {
+		return;
+	}
+	trees[item.get_tree()].remove(item.leaf);
+	item.leaf = DynamicBVH::INVALID_ID;
+}
+
+RenderingServerScene::SpatialPartitionID RenderingServerScene::SpatialPartitioningScene_BVH::create(Instance *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+	uint32_t id;
+	if (free_items.size()) {
+		id = free_items[free_items.size() - 1];
+		free_items.resize(free_items.size() - 1);
+	} else {
+		id = items.size();
+		items.resize(id + 1);
+	}
+
+	Item &item = items[id];
+	item.userdata = p_userdata;
+	item.aabb = p_aabb;
+	item.subindex = p_subindex;
+	item.pairable = p_pairable;
+	item.pairable_type = p_pairable_type;
+	item.pairable_mask = p_pairable_mask;
+	item.leaf = DynamicBVH::INVALID_ID;
+	item.used = true;
+
+	_tree_insert(id);
+	_update_pairs(id);
+
+	return id + 1;
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::erase(SpatialPartitionID p_id) {
+	uint32_t id = p_id - 1;
+	ERR_FAIL_UNSIGNED_INDEX(id, items.size());
+	ERR_FAIL_COND(!items[id].used);
+
+	_unpair_all(id);
+	_tree_remove(id);
+
+	Item &item = items[id];
+	item.used = false;
+	item.userdata = nullptr;
+	free_items.push_back(id);
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::move(SpatialPartitionID p_id, const AABB &p_aabb) {
+	uint32_t id = p_id - 1;
+	ERR_FAIL_UNSIGNED_INDEX(id, items.size());
+	ERR_FAIL_COND(!items[id].used);
+
+	Item &item = items[id];
+	item.aabb = p_aabb;
+
+	if (p_aabb.has_no_surface()) {
+		_unpair_all(id);
+		_tree_remove(id);
+		return;
+	}
+
+	if (item.leaf == DynamicBVH::INVALID_ID) {
+		_tree_insert(id);
+	} else {
+		trees[item.get_tree()].update(item.leaf, p_aabb);
+	}
+
+	_update_pairs(id);
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::set_pairable(SpatialPartitionID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+	uint32_t id = p_id - 1;
+	ERR_FAIL_UNSIGNED_INDEX(id, items.size());
+	ERR_FAIL_COND(!items[id].used);
+
+	Item &item = items[id];
+	if (item.pairable == p_pairable && item.pairable_type == p_pairable_type && item.pairable_mask == p_pairable_mask) {
+		return;
+	}
+
+	_unpair_all(id);
+	_tree_remove(id);
+
+	item.pairable = p_pairable;
+	item.pairable_type = p_pairable_type;
+	item.pairable_mask = p_pairable_mask;
+
+	_tree_insert(id);
+	_update_pairs(id);
+}
+
+int RenderingServerScene::SpatialPartitioningScene_BVH::cull_convex(const Plane *p_convex, int p_convex_count, Instance **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (p_convex_count == 0 || p_result_max <= 0) {
+		return 0;
+	}
+
+	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(p_convex, p_convex_count);
+	if (convex_points.size() == 0) {
+		return 0;
+	}
+
+	CullQuery<CullTestConvex> query;
+	query.self = this;
+	query.test.planes = p_convex;
+	query.test.plane_count = p_convex_count;
+	query.test.points = &convex_points[0];
+	query.test.point_count = convex_points.size();
+	query.result_array = p_result_array;
+	query.result_max = p_result_max;
+	query.result_count = 0;
+	query.mask = p_mask;
+
+	for (int i = 0; i < TREE_MAX && query.result_count < p_result_max; i++) {
+		trees[i].convex_query(p_convex, p_convex_count, query);
+	}
+	return query.result_count;
+}
+
+int RenderingServerScene::SpatialPartitioningScene_BVH::cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
+	CullQuery<CullTestAABB> query;
+	query.self = this;
+	query.test.aabb = p_aabb;
+	query.result_array = p_result_array;
+	query.result_max = p_result_max;
+	query.result_count = 0;
+	query.mask = p_mask;
+
+	for (int i = 0; i < TREE_MAX && query.result_count < p_result_max; i++) {
+		trees[i].aabb_query(p_aabb, query);
+	}
+	return query.result_count;
+}
+
+int RenderingServerScene::SpatialPartitioningScene_BVH::cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
+	CullQuery<CullTestSegment> query;
+	query.self = this;
+	query.test.from = p_from;
+	query.test.to = p_to;
+	query.result_array = p_result_array;
+	query.result_max = p_result_max;
+	query.result_count = 0;
+	query.mask = p_mask;
+
+	for (int i = 0; i < TREE_MAX && query.result_count < p_result_max; i++) {
+		trees[i].segment_query(p_from, p_to, query);
+	}
+	return query.result_count;
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::set_pair_callback(PairCallback p_callback, void *p_userdata) {
+	pair_callback = p_callback;
+	pair_callback_userdata = p_userdata;
+}
+
+void RenderingServerScene::SpatialPartitioningScene_BVH::set_unpair_callback(UnpairCallback p_callback, void *p_userdata) {
+	unpair_callback = p_callback;
+	unpair_callback_userdata = p_userdata;
+}
+
 RID RenderingServerScene::scenario_create() {
 	Scenario *scenario = memnew(Scenario);
 	ERR_FAIL_COND_V(!scenario, RID());
 	RID scenario_rid = scenario_owner.make_rid(scenario);
 	scenario->self = scenario_rid;
 
-	scenario->octree.set_pair_callback(_instance_pair, this);
-	scenario->octree.set_unpair_callback(_instance_unpair, this);
+	if (use_bvh) {
+		scenario->sps = memnew(SpatialPartitioningScene_BVH);
+	} else {
+		scenario->sps = memnew(SpatialPartitioningScene_Octree);
+	}
+	scenario->sps->set_pair_callback(_instance_pair, this);
+	scenario->sps->set_unpair_callback(_instance_unpair, this);
 	scenario->reflection_probe_shadow_atlas = RSG::scene_render->shadow_atlas_create();
 	RSG::scene_render->shadow_atlas_set_size(scenario->reflection_probe_shadow_atlas, 1024); //make enough shadows for close distance, don't bother with rest
 	RSG::scene_render->shadow_atlas_set_quadrant_subdivision(scenario->reflection_probe_shadow_atlas, 0, 4);
@@ -365,9 +714,9 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 	if (instance->base_type != RS::INSTANCE_NONE) {
 		//free anything related to that base
 
-		if (scenario && instance->octree_id) {
-			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (scenario && instance->spatial_partition_id) {
+			scenario->sps->erase(instance->spatial_partition_id); //make dependencies generated by the spatial partitioning go away
+			instance->spatial_partition_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -520,9 +869,9 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 	if (instance->scenario) {
 		instance->scenario->instances.remove(&instance->scenario_item);
 
-		if (instance->octree_id) {
-			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (instance->spatial_partition_id) {
+			instance->scenario->sps->erase(instance->spatial_partition_id); //make dependencies generated by the spatial partitioning go away
+			instance->spatial_partition_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -680,38 +1029,38 @@ void RenderingServerScene::instance_set_visible(RID p_instance, bool p_visible)
 
 	switch (instance->base_type) {
 		case RS::INSTANCE_LIGHT: {
-			if (RSG::storage->light_get_type(instance->base) != RS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_LIGHT, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (RSG::storage->light_get_type(instance->base) != RS::LIGHT_DIRECTIONAL && instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_LIGHT, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_REFLECTION_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_REFLECTION_PROBE, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_REFLECTION_PROBE, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_DECAL: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_DECAL, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_DECAL, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_LIGHTMAP: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_LIGHTMAP, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_LIGHTMAP, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_GI_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_GI_PROBE, p_visible ? (RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT)) : 0);
+			if (instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_GI_PROBE, p_visible ? (RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT)) : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_PARTICLES_COLLISION: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_PARTICLES_COLLISION, p_visible ? (1 << RS::INSTANCE_PARTICLES) : 0);
+			if (instance->spatial_partition_id && instance->scenario) {
+				instance->scenario->sps->set_pairable(instance->spatial_partition_id, p_visible, 1 << RS::INSTANCE_PARTICLES_COLLISION, p_visible ? (1 << RS::INSTANCE_PARTICLES) : 0);
 			}
 
 		} break;
@@ -786,7 +1135,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_aabb(const AABB &p_aabb, R
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_aabb(p_aabb, cull, 1024);
+	culled = scenario->sps->cull_aabb(p_aabb, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -809,7 +1158,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_ray(const Vector3 &p_from,
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
+	culled = scenario->sps->cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -833,7 +1182,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_convex(const Vector<Plane>
 	int culled = 0;
 	Instance *cull[1024];
 
-	culled = scenario->octree.cull_convex(p_convex, cull, 1024);
+	culled = scenario->sps->cull_convex(p_convex.ptr(), p_convex.size(), cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -865,14 +1214,14 @@ void RenderingServerScene::instance_geometry_set_flag(RID p_instance, RS::Instan
 				return;
 			}
 
-			if (instance->octree_id != 0) {
-				//remove from octree, it needs to be re-paired
-				instance->scenario->octree.erase(instance->octree_id);
-				instance->octree_id = 0;
+			if (instance->spatial_partition_id != 0) {
+				//remove from spatial partitioning, it needs to be re-paired
+				instance->scenario->sps->erase(instance->spatial_partition_id);
+				instance->spatial_partition_id = 0;
 				_instance_queue_update(instance, true, true);
 			}
 
-			//once out of octree, can be changed
+			//once out of spatial partitioning, can be changed
 			instance->dynamic_gi = p_enabled;
 
 		} break;
@@ -1095,7 +1444,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	if (p_instance->octree_id == 0) {
+	if (p_instance->spatial_partition_id == 0) {
 		uint32_t base_type = 1 << p_instance->base_type;
 		uint32_t pairable_mask = 0;
 		bool pairable = false;
@@ -1116,8 +1465,8 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 			pairable = true;
 		}
 
-		// not inside octree
-		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		// not inside spatial partitioning
+		p_instance->spatial_partition_id = p_instance->scenario->sps->create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
 
 	} else {
 		/*
@@ -1125,7 +1474,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 			return;
 		*/
 
-		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		p_instance->scenario->sps->move(p_instance->spatial_partition_id, new_aabb);
 	}
 }
 
@@ -1309,8 +1658,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 			if (depth_range_mode == RS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
-				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				Plane planes[6];
+				p_cam_projection.get_projection_planes(p_cam_transform, planes);
+				int cull_count = p_scenario->sps->cull_convex(planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1521,20 +1871,19 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 				//now that we now all ranges, we can proceed to make the light frustum planes, for culling octree
 
-				Vector<Plane> light_frustum_planes;
-				light_frustum_planes.resize(6);
+				Plane light_frustum_planes[6];
 
 				//right/left
-				light_frustum_planes.write[0] = Plane(x_vec, x_max);
-				light_frustum_planes.write[1] = Plane(-x_vec, -x_min);
+				light_frustum_planes[0] = Plane(x_vec, x_max);
+				light_frustum_planes[1] = Plane(-x_vec, -x_min);
 				//top/bottom
-				light_frustum_planes.write[2] = Plane(y_vec, y_max);
-				light_frustum_planes.write[3] = Plane(-y_vec, -y_min);
+				light_frustum_planes[2] = Plane(y_vec, y_max);
+				light_frustum_planes[3] = Plane(-y_vec, -y_min);
 				//near/far
-				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
-				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
+				light_frustum_planes[4] = Plane(z_vec, z_max + 1e6);
+				light_frustum_planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = p_scenario->sps->cull_convex(light_frustum_planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
@@ -1672,16 +2021,15 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 
 					real_t z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(6);
-					planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
-
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+					Plane planes[6];
+					planes[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
+					planes[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+					planes[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+					planes[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+					planes[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+					planes[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
+
+					int cull_count = p_scenario->sps->cull_convex(planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 
 					for (int j = 0; j < cull_count; j++) {
@@ -1732,9 +2080,10 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 					Transform xform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
 
-					Vector<Plane> planes = cm.get_projection_planes(xform);
+					Plane planes[6];
+					cm.get_projection_planes(xform, planes);
 
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+					int cull_count = p_scenario->sps->cull_convex(planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 
 					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
 					for (int j = 0; j < cull_count; j++) {
@@ -1770,8 +2119,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 			CameraMatrix cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
-			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+			Plane planes[6];
+			cm.get_projection_planes(light_transform, planes);
+			int cull_count = p_scenario->sps->cull_convex(planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 
 			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
 			for (int j = 0; j < cull_count; j++) {
@@ -1952,13 +2302,14 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
 
-	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	Plane planes[6];
+	p_cam_projection.get_projection_planes(p_cam_transform, planes);
 
 	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	instance_cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+	instance_cull_count = scenario->sps->cull_convex(planes, 6, instance_cull_result, MAX_INSTANCE_CULL);
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -2309,7 +2660,7 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				sdfgi_light_cull_pass++;
 				prev_cascade = region_cascade;
 			}
-			uint32_t sdfgi_cull_count = scenario->octree.cull_aabb(region, instance_shadow_cull_result, MAX_INSTANCE_CULL);
+			uint32_t sdfgi_cull_count = scenario->sps->cull_aabb(region, instance_shadow_cull_result, MAX_INSTANCE_CULL);
 
 			for (uint32_t j = 0; j < sdfgi_cull_count; j++) {
 				Instance *ins = instance_shadow_cull_result[j];
@@ -2714,7 +3065,7 @@ void RenderingServerScene::render_particle_colliders() {
 
 		if (hfpc->scenario && hfpc->base_type == RS::INSTANCE_PARTICLES_COLLISION && RSG::storage->particles_collision_is_heightfield(hfpc->base)) {
 			//update heightfield
-			int cull_count = hfpc->scenario->octree.cull_aabb(hfpc->transformed_aabb, instance_cull_result, MAX_INSTANCE_CULL); //@TODO: cull mask missing
+			int cull_count = hfpc->scenario->sps->cull_aabb(hfpc->transformed_aabb, instance_cull_result, MAX_INSTANCE_CULL); //@TODO: cull mask missing
 			for (int i = 0; i < cull_count; i++) {
 				Instance *instance = instance_cull_result[i];
 				if (!instance->visible || !((1 << instance->base_type) & (RS::INSTANCE_GEOMETRY_MASK & (~(1 << RS::INSTANCE_PARTICLES))))) { //all but particles to avoid self collision
@@ -3034,6 +3385,7 @@ RenderingServerScene *RenderingServerScene::singleton = nullptr;
 RenderingServerScene::RenderingServerScene() {
 	render_pass = 1;
 	singleton = this;
+	use_bvh = GLOBAL_GET("rendering/quality/spatial_partitioning/use_bvh");
 }
 
 RenderingServerScene::~RenderingServerScene() {
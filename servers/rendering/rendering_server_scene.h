@@ -34,6 +34,7 @@
 #include "servers/rendering/rasterizer.h"
 
 #include "core/local_vector.h"
+#include "core/math/dynamic_bvh.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/octree.h"
 #include "core/os/semaphore.h"
@@ -57,6 +58,7 @@ public:
 	};
 
 	uint64_t render_pass;
+	bool use_bvh;
 
 	static RenderingServerScene *singleton;
 
@@ -108,11 +110,129 @@ public:
 
 	struct Instance;
 
+	/* SPATIAL PARTITIONING */
+
+	typedef uint32_t SpatialPartitionID;
+
+	// Scenarios keep their instances in one of these; both notify the same pair/unpair callbacks.
+	class SpatialPartitioningScene {
+	public:
+		typedef void *(*PairCallback)(void *, SpatialPartitionID, Instance *, int, SpatialPartitionID, Instance *, int);
+		typedef void (*UnpairCallback)(void *, SpatialPartitionID, Instance *, int, SpatialPartitionID, Instance *, int, void *);
+
+		virtual SpatialPartitionID create(Instance *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) = 0;
+		virtual void erase(SpatialPartitionID p_id) = 0;
+		virtual void move(SpatialPartitionID p_id, const AABB &p_aabb) = 0;
+		virtual void set_pairable(SpatialPartitionID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) = 0;
+
+		virtual int cull_convex(const Plane *p_convex, int p_convex_count, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) = 0;
+		virtual int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) = 0;
+		virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) = 0;
+
+		virtual void set_pair_callback(PairCallback p_callback, void *p_userdata) = 0;
+		virtual void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) = 0;
+
+		virtual ~SpatialPartitioningScene() {}
+	};
+
+	class SpatialPartitioningScene_Octree : public SpatialPartitioningScene {
+		Octree<Instance, true> octree;
+
+	public:
+		SpatialPartitionID create(Instance *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) override { return octree.create(p_userdata, p_aabb, p_subindex, p_pairable, p_pairable_type, p_pairable_mask); }
+		void erase(SpatialPartitionID p_id) override { octree.erase(p_id); }
+		void move(SpatialPartitionID p_id, const AABB &p_aabb) override { octree.move(p_id, p_aabb); }
+		void set_pairable(SpatialPartitionID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) override { octree.set_pairable(p_id, p_pairable, p_pairable_type, p_pairable_mask); }
+
+		int cull_convex(const Plane *p_convex, int p_convex_count, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override { return octree.cull_convex(p_convex, p_convex_count, p_result_array, p_result_max, p_mask); }
+		int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override { return octree.cull_aabb(p_aabb, p_result_array, p_result_max, nullptr, p_mask); }
+		int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override { return octree.cull_segment(p_from, p_to, p_result_array, p_result_max, nullptr, p_mask); }
+
+		void set_pair_callback(PairCallback p_callback, void *p_userdata) override { octree.set_pair_callback(p_callback, p_userdata); }
+		void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) override { octree.set_unpair_callback(p_callback, p_userdata); }
+	};
+
+	// Dynamic AABB tree with fattened leaves. Moving instances only touch the tree
+	// when they leave their fat box, and pairs are kept in flat pooled arrays.
+	class SpatialPartitioningScene_BVH : public SpatialPartitioningScene {
+		enum {
+			TREE_NON_PAIRABLE,
+			TREE_PAIRABLE,
+			TREE_MAX
+		};
+
+		struct Item {
+			Instance *userdata = nullptr;
+			AABB aabb;
+			int subindex = 0;
+			bool pairable = false;
+			uint32_t pairable_type = 0;
+			uint32_t pairable_mask = 0;
+			DynamicBVH::ID leaf = DynamicBVH::INVALID_ID;
+			LocalVector<uint32_t> pairs; // Indices into pairs.
+			bool used = false;
+
+			_FORCE_INLINE_ int get_tree() const { return pairable ? TREE_PAIRABLE : TREE_NON_PAIRABLE; }
+		};
+
+		struct Pair {
+			uint32_t a = 0;
+			uint32_t b = 0;
+			void *ud = nullptr;
+		};
+
+		DynamicBVH trees[TREE_MAX];
+		LocalVector<Item> items;
+		LocalVector<uint32_t> free_items;
+		LocalVector<Pair> pairs;
+		LocalVector<uint32_t> free_pairs;
+
+		PairCallback pair_callback = nullptr;
+		void *pair_callback_userdata = nullptr;
+		UnpairCallback unpair_callback = nullptr;
+		void *unpair_callback_userdata = nullptr;
+
+		struct PairQuery;
+		template <class T>
+		struct CullQuery;
+
+		_FORCE_INLINE_ bool _can_pair(const Item &p_a, const Item &p_b) const {
+			if (p_a.userdata == p_b.userdata) {
+				return false;
+			}
+			if (!p_a.pairable && !p_b.pairable) {
+				return false;
+			}
+			return (p_a.pairable_type & p_b.pairable_mask) || (p_b.pairable_type & p_a.pairable_mask);
+		}
+
+		bool _is_paired(uint32_t p_a, uint32_t p_b) const;
+		void _pair(uint32_t p_a, uint32_t p_b);
+		void _unpair(uint32_t p_pair);
+		void _unpair_all(uint32_t p_item);
+		void _update_pairs(uint32_t p_item);
+		void _tree_insert(uint32_t p_item);
+		void _tree_remove(uint32_t p_item);
+
+	public:
+		SpatialPartitionID create(Instance *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) override;
+		void erase(SpatialPartitionID p_id) override;
+		void move(SpatialPartitionID p_id, const AABB &p_aabb) override;
+		void set_pairable(SpatialPartitionID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1) override;
+
+		int cull_convex(const Plane *p_convex, int p_convex_count, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override;
+		int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override;
+		int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) override;
+
+		void set_pair_callback(PairCallback p_callback, void *p_userdata) override;
+		void set_unpair_callback(UnpairCallback p_callback, void *p_userdata) override;
+	};
+
 	struct Scenario {
 		RS::ScenarioDebugMode debug;
 		RID self;
 
-		Octree<Instance, true> octree;
+		SpatialPartitioningScene *sps;
 
 		List<Instance *> directional_lights;
 		RID environment;
@@ -125,13 +245,21 @@ public:
 
 		LocalVector<RID> dynamic_lights;
 
-		Scenario() { debug = RS::SCENARIO_DEBUG_DISABLED; }
+		Scenario() {
+			debug = RS::SCENARIO_DEBUG_DISABLED;
+			sps = nullptr;
+		}
+		~Scenario() {
+			if (sps) {
+				memdelete(sps);
+			}
+		}
 	};
 
 	mutable RID_PtrOwner<Scenario> scenario_owner;
 
-	static void *_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
-	static void _instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
+	static void *_instance_pair(void *p_self, SpatialPartitionID, Instance *p_A, int, SpatialPartitionID, Instance *p_B, int);
+	static void _instance_unpair(void *p_self, SpatialPartitionID, Instance *p_A, int, SpatialPartitionID, Instance *p_B, int, void *);
 
 	virtual RID scenario_create();
 
@@ -150,7 +278,7 @@ public:
 	struct Instance : RasterizerScene::InstanceBase {
 		RID self;
 		//scenario stuff
-		OctreeElementID octree_id;
+		SpatialPartitionID spatial_partition_id;
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
@@ -196,7 +324,7 @@ public:
 		Instance() :
 				scenario_item(this),
 				update_item(this) {
-			octree_id = 0;
+			spatial_partition_id = 0;
 			scenario = nullptr;
 
 			update_aabb = false;
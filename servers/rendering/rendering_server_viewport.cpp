@@ -127,7 +127,9 @@ void RenderingServerViewport::_draw_viewport(Viewport *p_viewport, XRInterface::
 	if (!p_viewport->hide_canvas) {
 		int i = 0;
 
-		Map<Viewport::CanvasKey, Viewport::CanvasData *> canvas_map;
+		// Rebuilt for every draw, so keep it off the heap.
+		typedef Map<Viewport::CanvasKey, Viewport::CanvasData *, Comparator<Viewport::CanvasKey>, FrameAllocator> CanvasMap;
+		CanvasMap canvas_map;
 
 		Rect2 clip_rect(0, 0, p_viewport->size.x, p_viewport->size.y);
 		RasterizerCanvas::Light *lights = nullptr;
@@ -238,7 +240,7 @@ void RenderingServerViewport::_draw_viewport(Viewport *p_viewport, XRInterface::
 			scenario_draw_canvas_bg = false;
 		}
 
-		for (Map<Viewport::CanvasKey, Viewport::CanvasData *>::Element *E = canvas_map.front(); E; E = E->next()) {
+		for (CanvasMap::Element *E = canvas_map.front(); E; E = E->next()) {
 			RenderingServerCanvas::Canvas *canvas = static_cast<RenderingServerCanvas::Canvas *>(E->get()->canvas);
 
 			Transform2D xform = _canvas_get_transform(p_viewport, canvas, E->get(), clip_rect.size);
@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  benchmark_containers.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BENCHMARK_CONTAINERS_H
+#define BENCHMARK_CONTAINERS_H
+
+#include "core/hash_map.h"
+#include "core/map.h"
+#include "core/math/random_pcg.h"
+#include "core/oa_hash_map.h"
+#include "core/vector.h"
+
+#include "tests/benchmark_macros.h"
+
+namespace BenchmarkContainers {
+
+// Lookups go over a fixed set of keys, shuffled with a fixed seed so runs are comparable.
+static const int LOOKUP_KEYS = 4096;
+
+static Vector<int> _make_keys(int p_count) {
+	Vector<int> keys;
+	keys.resize(p_count);
+	RandomPCG rng(0x5eed);
+	for (int i = 0; i < p_count; i++) {
+		keys.write[i] = rng.rand();
+	}
+	return keys;
+}
+
+BENCHMARK(HashMap, insert_int) {
+	HashMap<int, int> map;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		map.set(int(i * 2654435761u), int(i));
+	}
+	state.stop();
+	state.sink(map.size());
+}
+
+BENCHMARK(HashMap, lookup_int) {
+	Vector<int> keys = _make_keys(LOOKUP_KEYS);
+	HashMap<int, int> map;
+	for (int i = 0; i < LOOKUP_KEYS; i++) {
+		map.set(keys[i], i);
+	}
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(*map.getptr(keys[i & (LOOKUP_KEYS - 1)]));
+	}
+	state.stop();
+}
+
+BENCHMARK(HashMap, lookup_string) {
+	Vector<String> keys;
+	HashMap<String, int> map;
+	for (int i = 0; i < LOOKUP_KEYS; i++) {
+		keys.push_back("key_" + itos(i));
+		map.set(keys[i], i);
+	}
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(*map.getptr(keys[i & (LOOKUP_KEYS - 1)]));
+	}
+	state.stop();
+}
+
+BENCHMARK(OAHashMap, insert_int) {
+	OAHashMap<int, int> map;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		map.set(int(i * 2654435761u), int(i));
+	}
+	state.stop();
+	state.sink(map.get_num_elements());
+}
+
+BENCHMARK(OAHashMap, lookup_int) {
+	Vector<int> keys = _make_keys(LOOKUP_KEYS);
+	OAHashMap<int, int> map;
+	for (int i = 0; i < LOOKUP_KEYS; i++) {
+		map.set(keys[i], i);
+	}
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(*map.lookup_ptr(keys[i & (LOOKUP_KEYS - 1)]));
+	}
+	state.stop();
+}
+
+BENCHMARK(Map, insert_int) {
+	Map<int, int> map;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		map.insert(int(i * 2654435761u), int(i));
+	}
+	state.stop();
+	state.sink(map.size());
+}
+
+BENCHMARK(Map, lookup_int) {
+	Vector<int> keys = _make_keys(LOOKUP_KEYS);
+	Map<int, int> map;
+	for (int i = 0; i < LOOKUP_KEYS; i++) {
+		map.insert(keys[i], i);
+	}
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(map.find(keys[i & (LOOKUP_KEYS - 1)])->get());
+	}
+	state.stop();
+}
+
+BENCHMARK(Vector, push_back) {
+	Vector<int> vector;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		vector.push_back(int(i));
+	}
+	state.stop();
+	state.sink(vector.size());
+}
+
+BENCHMARK(Vector, copy_shared) {
+	Vector<int> source = _make_keys(1024);
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		// Copies only share the buffer, reading does not detach.
+		Vector<int> copy = source;
+		state.sink(copy[i & 1023]);
+	}
+	state.stop();
+}
+
+BENCHMARK(Vector, copy_on_write) {
+	Vector<int> source = _make_keys(1024);
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		// Writing to a shared copy duplicates the 1024 elements.
+		Vector<int> copy = source;
+		copy.write[i & 1023] = int(i);
+		state.sink(copy[0]);
+	}
+	state.stop();
+}
+
+} // namespace BenchmarkContainers
+
+#endif // BENCHMARK_CONTAINERS_H
@@ -0,0 +1,162 @@
+/*************************************************************************/
+/*  benchmark_image.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BENCHMARK_IMAGE_H
+#define BENCHMARK_IMAGE_H
+
+#include "core/image.h"
+#include "core/math/random_pcg.h"
+
+#include "tests/benchmark_macros.h"
+
+namespace BenchmarkImage {
+
+// Noise rather than a flat color, so no kernel can take shortcuts.
+static Ref<Image> _make_image(int p_width, int p_height, Image::Format p_format) {
+	Ref<Image> image;
+	image.instance();
+	image->create(p_width, p_height, false, p_format);
+
+	Vector<uint8_t> data = image->get_data();
+	uint8_t *w = data.ptrw();
+	RandomPCG rng(0x5eed);
+	if (p_format == Image::FORMAT_RGBAF || p_format == Image::FORMAT_RGBF) {
+		float *wf = (float *)w;
+		for (int i = 0; i < data.size() / 4; i++) {
+			wf[i] = rng.randf() * 2.0;
+		}
+	} else {
+		for (int i = 0; i < data.size(); i++) {
+			w[i] = rng.rand() & 0xFF;
+		}
+	}
+	image->create(p_width, p_height, false, p_format, data);
+	return image;
+}
+
+// Each iteration works on a copy sharing the source data, so only the
+// operation itself is timed. Throughput is in destination pixels.
+static void _benchmark_resize(BenchmarkState &state, Image::Format p_format, Image::Interpolation p_interpolation) {
+	Ref<Image> src = _make_image(2048, 2048, p_format);
+	Ref<Image> image;
+	image.instance();
+
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		image->copy_internals_from(src);
+		image->resize(1536, 1536, p_interpolation);
+		state.sink(image->get_data()[i & 0xFF]);
+	}
+	state.stop();
+	state.add_items(state.get_iterations() * 1536 * 1536);
+}
+
+BENCHMARK(Image, resize_bilinear_rgba8) {
+	_benchmark_resize(state, Image::FORMAT_RGBA8, Image::INTERPOLATE_BILINEAR);
+}
+
+BENCHMARK(Image, resize_cubic_rgba8) {
+	_benchmark_resize(state, Image::FORMAT_RGBA8, Image::INTERPOLATE_CUBIC);
+}
+
+BENCHMARK(Image, resize_lanczos_rgba8) {
+	_benchmark_resize(state, Image::FORMAT_RGBA8, Image::INTERPOLATE_LANCZOS);
+}
+
+BENCHMARK(Image, resize_bilinear_rgb8) {
+	_benchmark_resize(state, Image::FORMAT_RGB8, Image::INTERPOLATE_BILINEAR);
+}
+
+BENCHMARK(Image, resize_bilinear_rgbaf) {
+	_benchmark_resize(state, Image::FORMAT_RGBAF, Image::INTERPOLATE_BILINEAR);
+}
+
+BENCHMARK(Image, resize_lanczos_rgbaf) {
+	_benchmark_resize(state, Image::FORMAT_RGBAF, Image::INTERPOLATE_LANCZOS);
+}
+
+static void _benchmark_convert(BenchmarkState &state, Image::Format p_from, Image::Format p_to) {
+	Ref<Image> src = _make_image(2048, 2048, p_from);
+	Ref<Image> image;
+	image.instance();
+
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		image->copy_internals_from(src);
+		image->convert(p_to);
+		state.sink(image->get_data()[i & 0xFF]);
+	}
+	state.stop();
+	state.add_items(state.get_iterations() * 2048 * 2048);
+}
+
+BENCHMARK(Image, convert_rgba8_to_rgb8) {
+	_benchmark_convert(state, Image::FORMAT_RGBA8, Image::FORMAT_RGB8);
+}
+
+BENCHMARK(Image, convert_rgb8_to_rgba8) {
+	_benchmark_convert(state, Image::FORMAT_RGB8, Image::FORMAT_RGBA8);
+}
+
+BENCHMARK(Image, convert_rgba8_to_rgbaf) {
+	_benchmark_convert(state, Image::FORMAT_RGBA8, Image::FORMAT_RGBAF);
+}
+
+// Throughput is in pixels of the base level.
+static void _benchmark_mipmaps(BenchmarkState &state, Image::Format p_format) {
+	Ref<Image> src = _make_image(2048, 2048, p_format);
+	Ref<Image> image;
+	image.instance();
+
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		image->copy_internals_from(src);
+		image->generate_mipmaps();
+		state.sink(image->get_data()[image->get_data().size() - 1]);
+	}
+	state.stop();
+	state.add_items(state.get_iterations() * 2048 * 2048);
+}
+
+BENCHMARK(Image, generate_mipmaps_rgba8) {
+	_benchmark_mipmaps(state, Image::FORMAT_RGBA8);
+}
+
+BENCHMARK(Image, generate_mipmaps_rgb8) {
+	_benchmark_mipmaps(state, Image::FORMAT_RGB8);
+}
+
+BENCHMARK(Image, generate_mipmaps_rgbaf) {
+	_benchmark_mipmaps(state, Image::FORMAT_RGBAF);
+}
+
+} // namespace BenchmarkImage
+
+#endif // BENCHMARK_IMAGE_H
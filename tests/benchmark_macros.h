@@ -1,5 +1,5 @@
 /*************************************************************************/
-/*  threaded_array_processor.h                                           */
+/*  benchmark_macros.h                                                   */
 /*************************************************************************/
 /*                       This file is part of:                           */
 /*                           GODOT ENGINE                                */
@@ -28,81 +28,46 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
-#ifndef THREADED_ARRAY_PROCESSOR_H
-#define THREADED_ARRAY_PROCESSOR_H
+#ifndef BENCHMARK_MACROS_H
+#define BENCHMARK_MACROS_H
 
-#include "core/os/mutex.h"
 #include "core/os/os.h"
-#include "core/os/thread.h"
-#include "core/os/thread_safe.h"
-#include "core/safe_refcount.h"
 
-template <class C, class U>
-struct ThreadArrayProcessData {
-	uint32_t elements;
-	uint32_t index;
-	C *instance;
-	U userdata;
-	void (C::*method)(uint32_t, U);
+// Benchmarks receive the amount of iterations to run and time themselves
+// between `start()` and `stop()`, so setup and teardown are not measured.
+// Results should go through `sink()` so the work is not optimized out.
+// Benchmarks that process a known amount of items (e.g. pixels) report it
+// with `add_items()` to get a throughput next to the time per operation.
+class BenchmarkState {
+	uint64_t iterations = 0;
+	uint64_t begin_usec = 0;
+	uint64_t end_usec = 0;
+	uint64_t checksum = 0;
+	uint64_t items = 0;
 
-	void process(uint32_t p_index) {
-		(instance->*method)(p_index, userdata);
-	}
-};
-
-#ifndef NO_THREADS
-
-template <class T>
-void process_array_thread(void *ud) {
-	T &data = *(T *)ud;
-	while (true) {
-		uint32_t index = atomic_increment(&data.index);
-		if (index >= data.elements) {
-			break;
-		}
-		data.process(index);
-	}
-}
+public:
+	_FORCE_INLINE_ uint64_t get_iterations() const { return iterations; }
 
-template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-	ThreadArrayProcessData<C, U> data;
-	data.method = p_method;
-	data.instance = p_instance;
-	data.userdata = p_userdata;
-	data.index = 0;
-	data.elements = p_elements;
-	data.process(data.index); //process first, let threads increment for next
+	_FORCE_INLINE_ void start() { begin_usec = OS::get_singleton()->get_ticks_usec(); }
+	_FORCE_INLINE_ void stop() { end_usec = OS::get_singleton()->get_ticks_usec(); }
+	_FORCE_INLINE_ void sink(uint64_t p_value) { checksum += p_value; }
+	_FORCE_INLINE_ void add_items(uint64_t p_items) { items += p_items; }
 
-	Vector<Thread *> threads;
+	uint64_t get_elapsed_usec() const { return end_usec > begin_usec ? end_usec - begin_usec : 0; }
+	uint64_t get_checksum() const { return checksum; }
+	uint64_t get_items() const { return items; }
 
-	threads.resize(OS::get_singleton()->get_processor_count());
-
-	for (int i = 0; i < threads.size(); i++) {
-		threads.write[i] = Thread::create(process_array_thread<ThreadArrayProcessData<C, U>>, &data);
-	}
-
-	for (int i = 0; i < threads.size(); i++) {
-		Thread::wait_to_finish(threads[i]);
-		memdelete(threads[i]);
-	}
-}
+	BenchmarkState(uint64_t p_iterations) { iterations = p_iterations; }
+};
 
-#else
+typedef void (*BenchmarkFunc)(BenchmarkState &p_state);
 
-template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-	ThreadArrayProcessData<C, U> data;
-	data.method = p_method;
-	data.instance = p_instance;
-	data.userdata = p_userdata;
-	data.index = 0;
-	data.elements = p_elements;
-	for (uint32_t i = 0; i < p_elements; i++) {
-		data.process(i);
-	}
-}
+int register_benchmark(const char *p_name, BenchmarkFunc p_function);
 
-#endif
+// Names are "Suite/name", `--benchmark-filter` matches on them.
+#define BENCHMARK(m_suite, m_name)                                                                                                \
+	static void _benchmark_##m_suite##_##m_name(BenchmarkState &state);                                                           \
+	static int _benchmark_##m_suite##_##m_name##_reg = register_benchmark(#m_suite "/" #m_name, _benchmark_##m_suite##_##m_name); \
+	static void _benchmark_##m_suite##_##m_name(BenchmarkState &state)
 
-#endif // THREADED_ARRAY_PROCESSOR_H
+#endif // BENCHMARK_MACROS_H
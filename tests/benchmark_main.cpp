@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  benchmark_main.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "benchmark_main.h"
+
+#include "core/engine.h"
+#include "core/io/json.h"
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/os/file_access.h"
+#include "core/sort_array.h"
+
+#include "tests/benchmark_macros.h"
+
+struct BenchmarkEntry {
+	const char *name = nullptr;
+	BenchmarkFunc function = nullptr;
+};
+
+static LocalVector<BenchmarkEntry> &_get_benchmarks() {
+	// Function local, as benchmarks register themselves during static initialization.
+	static LocalVector<BenchmarkEntry> benchmarks;
+	return benchmarks;
+}
+
+int register_benchmark(const char *p_name, BenchmarkFunc p_function) {
+	BenchmarkEntry entry;
+	entry.name = p_name;
+	entry.function = p_function;
+	_get_benchmarks().push_back(entry);
+	return 0;
+}
+
+#include "benchmark_containers.h"
+#include "benchmark_image.h"
+#include "benchmark_physics_2d.h"
+#include "benchmark_string.h"
+#include "benchmark_variant.h"
+
+// Keeps results observable so the compiler can't drop the benchmarked work.
+static volatile uint64_t benchmark_checksum = 0;
+
+static uint64_t _run_benchmark(BenchmarkFunc p_function, uint64_t p_iterations, uint64_t *r_items = nullptr) {
+	BenchmarkState state(p_iterations);
+	p_function(state);
+	benchmark_checksum = benchmark_checksum + state.get_checksum();
+	if (r_items) {
+		*r_items = state.get_items();
+	}
+	return state.get_elapsed_usec();
+}
+
+int benchmark_main(int argc, char *argv[]) {
+	List<String> args;
+	for (int i = 0; i < argc; i++) {
+		args.push_back(String::utf8(argv[i]));
+	}
+
+	String filter;
+	String output_path;
+	int runs = 5;
+	uint64_t min_time_usec = 50000;
+
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (!E->next()) {
+			break;
+		}
+		if (E->get() == "--benchmark-filter") {
+			filter = E->next()->get();
+		} else if (E->get() == "--benchmark-output") {
+			output_path = E->next()->get();
+		} else if (E->get() == "--benchmark-runs") {
+			runs = MAX(1, E->next()->get().to_int());
+		} else if (E->get() == "--benchmark-min-time") {
+			min_time_usec = MAX(1, E->next()->get().to_int()) * 1000;
+		}
+	}
+
+	LocalVector<BenchmarkEntry> &benchmarks = _get_benchmarks();
+	Array results;
+
+	for (uint32_t i = 0; i < benchmarks.size(); i++) {
+		String name = benchmarks[i].name;
+		if (filter != String() && name.find(filter) == -1) {
+			continue;
+		}
+
+		// Grow the iteration count until a run takes long enough to time reliably.
+		uint64_t iterations = 1;
+		while (true) {
+			uint64_t elapsed = _run_benchmark(benchmarks[i].function, iterations);
+			if (elapsed >= min_time_usec || iterations >= (uint64_t(1) << 32)) {
+				break;
+			}
+			uint64_t scale = elapsed > 0 ? (min_time_usec * 3 / 2) / elapsed : 10;
+			iterations *= CLAMP(scale, (uint64_t)2, (uint64_t)10);
+		}
+
+		LocalVector<double> ns_per_op;
+		double total = 0;
+		uint64_t total_items = 0;
+		uint64_t total_usec = 0;
+		for (int j = 0; j < runs; j++) {
+			uint64_t items = 0;
+			uint64_t elapsed = _run_benchmark(benchmarks[i].function, iterations, &items);
+			double ns = double(elapsed) * 1000.0 / double(iterations);
+			ns_per_op.push_back(ns);
+			total += ns;
+			total_items += items;
+			total_usec += elapsed;
+		}
+		SortArray<double> sorter;
+		sorter.sort(ns_per_op.ptr(), ns_per_op.size());
+
+		Dictionary result;
+		result["name"] = name;
+		result["iterations"] = iterations;
+		result["runs"] = runs;
+		result["ns_per_op_min"] = ns_per_op[0];
+		result["ns_per_op_median"] = ns_per_op[ns_per_op.size() / 2];
+		result["ns_per_op_mean"] = total / runs;
+		result["ns_per_op_max"] = ns_per_op[ns_per_op.size() - 1];
+		// Items per microsecond, i.e. millions of items (megapixels for images) per second.
+		double mitems_per_sec = total_items > 0 && total_usec > 0 ? double(total_items) / double(total_usec) : 0.0;
+		if (total_items > 0) {
+			result["mitems_per_sec"] = mitems_per_sec;
+		}
+		results.push_back(result);
+
+		if (output_path != String()) {
+			if (total_items > 0) {
+				print_line(vformat("%-40s %12.2f ns/op %10.2f M/s (median of %d x %d)", name, ns_per_op[ns_per_op.size() / 2], mitems_per_sec, runs, iterations));
+			} else {
+				print_line(vformat("%-40s %12.2f ns/op (median of %d x %d)", name, ns_per_op[ns_per_op.size() / 2], runs, iterations));
+			}
+		}
+	}
+
+	Dictionary report;
+	report["engine"] = Engine::get_singleton()->get_version_info();
+	report["benchmarks"] = results;
+	String json = JSON::print(report, "\t");
+
+	if (output_path == String()) {
+		print_line(json);
+		return 0;
+	}
+
+	FileAccessRef f = FileAccess::open(output_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(!f, 1, "Can't open benchmark output file: " + output_path + ".");
+	f->store_string(json);
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*************************************************************************/
+/*  benchmark_physics_2d.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BENCHMARK_PHYSICS_2D_H
+#define BENCHMARK_PHYSICS_2D_H
+
+#include "core/local_vector.h"
+#include "core/math/random_pcg.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_flat_hash_grid.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+
+#include "tests/benchmark_macros.h"
+
+namespace BenchmarkPhysics2D {
+
+static const int BROAD_PHASE_OBJECTS = 2000;
+
+static void *_pair(CollisionObject2DSW *, int, CollisionObject2DSW *, int, void *p_pairs) {
+	(*(uint64_t *)p_pairs)++;
+	return nullptr;
+}
+
+static void _unpair(CollisionObject2DSW *, int, CollisionObject2DSW *, int, void *, void *p_pairs) {
+	(*(uint64_t *)p_pairs)--;
+}
+
+// Objects wander around a crowded area, as bodies in a busy scene, and the
+// broad phase is updated once per iteration, as once per physics step.
+// Throughput is in moved objects.
+static void _benchmark_broad_phase(BenchmarkState &state, BroadPhase2DSW::CreateFunction p_create) {
+	BroadPhase2DSW *broad_phase = p_create();
+	uint64_t pairs = 0;
+	broad_phase->set_pair_callback(_pair, &pairs);
+	broad_phase->set_unpair_callback(_unpair, &pairs);
+
+	RandomPCG rng(0x5eed);
+	LocalVector<Body2DSW *> owners;
+	LocalVector<BroadPhase2DSW::ID> ids;
+	LocalVector<Rect2> rects;
+	for (int i = 0; i < BROAD_PHASE_OBJECTS; i++) {
+		owners.push_back(memnew(Body2DSW));
+		ids.push_back(broad_phase->create(owners[i]));
+		rects.push_back(Rect2(rng.randf() * 4000, rng.randf() * 4000, 16 + rng.randf() * 48, 16 + rng.randf() * 48));
+		broad_phase->move(ids[i], rects[i]);
+	}
+	broad_phase->update();
+
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		for (int j = 0; j < BROAD_PHASE_OBJECTS; j++) {
+			rects[j].position += Vector2(rng.randf() - 0.5, rng.randf() - 0.5) * 16;
+			broad_phase->move(ids[j], rects[j]);
+		}
+		broad_phase->update();
+		state.sink(pairs);
+	}
+	state.stop();
+	state.add_items(state.get_iterations() * BROAD_PHASE_OBJECTS);
+
+	for (int i = 0; i < BROAD_PHASE_OBJECTS; i++) {
+		broad_phase->remove(ids[i]);
+		memdelete(owners[i]);
+	}
+	memdelete(broad_phase);
+}
+
+BENCHMARK(BroadPhase2D, move_hash_grid) {
+	_benchmark_broad_phase(state, BroadPhase2DHashGrid::_create);
+}
+
+BENCHMARK(BroadPhase2D, move_flat_hash_grid) {
+	_benchmark_broad_phase(state, BroadPhase2DFlatHashGrid::_create);
+}
+
+} // namespace BenchmarkPhysics2D
+
+#endif // BENCHMARK_PHYSICS_2D_H
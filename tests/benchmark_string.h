@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  benchmark_string.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BENCHMARK_STRING_H
+#define BENCHMARK_STRING_H
+
+#include "core/string_name.h"
+#include "core/ustring.h"
+#include "core/variant.h"
+
+#include "tests/benchmark_macros.h"
+
+namespace BenchmarkString {
+
+BENCHMARK(StringName, intern_existing) {
+	// The names stay referenced, so construction only looks them up.
+	Vector<String> strings;
+	Vector<StringName> names;
+	for (int i = 0; i < 1024; i++) {
+		strings.push_back("benchmark_name_" + itos(i));
+		names.push_back(strings[i]);
+	}
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		StringName name = strings[i & 1023];
+		state.sink(name.hash());
+	}
+	state.stop();
+}
+
+BENCHMARK(StringName, intern_new) {
+	Vector<String> strings;
+	strings.resize(state.get_iterations());
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		strings.write[i] = "benchmark_unique_" + itos(i);
+	}
+	Vector<StringName> names;
+	names.resize(state.get_iterations());
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		names.write[i] = strings[i];
+	}
+	state.stop();
+	state.sink(names.size());
+}
+
+BENCHMARK(StringName, compare) {
+	StringName a = "benchmark_name_a";
+	StringName b = "benchmark_name_b";
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(a == ((i & 1) ? a : b));
+	}
+	state.stop();
+}
+
+BENCHMARK(String, itos) {
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(itos(int64_t(i)).length());
+	}
+	state.stop();
+}
+
+BENCHMARK(String, num_real) {
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(String::num_real(double(i) * 0.37).length());
+	}
+	state.stop();
+}
+
+BENCHMARK(String, vformat) {
+	String name = "benchmark";
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(vformat("%s: %d (%.2f)", name, int64_t(i), double(i) * 0.5).length());
+	}
+	state.stop();
+}
+
+BENCHMARK(String, concatenate) {
+	String a = "res://benchmark/";
+	String b = "file_name.tscn";
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink((a + b).length());
+	}
+	state.stop();
+}
+
+BENCHMARK(String, plus_file) {
+	String a = "res://benchmark";
+	String b = "file_name.tscn";
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		state.sink(a.plus_file(b).length());
+	}
+	state.stop();
+}
+
+} // namespace BenchmarkString
+
+#endif // BENCHMARK_STRING_H
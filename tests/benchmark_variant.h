@@ -0,0 +1,167 @@
+/*************************************************************************/
+/*  benchmark_variant.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BENCHMARK_VARIANT_H
+#define BENCHMARK_VARIANT_H
+
+#include "core/variant.h"
+#include "core/variant_parser.h"
+
+#include "tests/benchmark_macros.h"
+
+namespace BenchmarkVariant {
+
+BENCHMARK(Variant, evaluate_int_add) {
+	Variant a = 1;
+	Variant b = 2;
+	Variant ret;
+	bool valid = false;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		Variant::evaluate(Variant::OP_ADD, a, b, ret, valid);
+		a = ret;
+	}
+	state.stop();
+	state.sink(int64_t(a));
+}
+
+BENCHMARK(Variant, evaluate_float_multiply) {
+	Variant a = 1.0;
+	Variant b = 1.0000001;
+	Variant ret;
+	bool valid = false;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		Variant::evaluate(Variant::OP_MULTIPLY, a, b, ret, valid);
+		a = ret;
+	}
+	state.stop();
+	state.sink(uint64_t(double(a)));
+}
+
+BENCHMARK(Variant, evaluate_vector3_add) {
+	Variant a = Vector3();
+	Variant b = Vector3(1, 2, 3);
+	Variant ret;
+	bool valid = false;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		Variant::evaluate(Variant::OP_ADD, a, b, ret, valid);
+		a = ret;
+	}
+	state.stop();
+	state.sink(uint64_t(Vector3(a).x));
+}
+
+BENCHMARK(Variant, evaluate_string_compare) {
+	Variant a = "benchmark string a";
+	Variant b = "benchmark string b";
+	Variant ret;
+	bool valid = false;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		Variant::evaluate(Variant::OP_LESS, a, b, ret, valid);
+		state.sink(bool(ret));
+	}
+	state.stop();
+}
+
+BENCHMARK(Variant, call_string_length) {
+	Variant string = "benchmark";
+	StringName method = "length";
+	Variant ret;
+	Callable::CallError ce;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		string.call_ptr(method, nullptr, 0, &ret, ce);
+		state.sink(int64_t(ret));
+	}
+	state.stop();
+}
+
+BENCHMARK(Variant, call_vector3_dot) {
+	Variant vector = Vector3(1, 2, 3);
+	Variant arg = Vector3(4, 5, 6);
+	const Variant *args[1] = { &arg };
+	StringName method = "dot";
+	Variant ret;
+	Callable::CallError ce;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		vector.call_ptr(method, args, 1, &ret, ce);
+		state.sink(uint64_t(double(ret)));
+	}
+	state.stop();
+}
+
+static const char *parser_text =
+		"{\n"
+		"\"name\": \"benchmark\",\n"
+		"\"values\": [ 1, 2, 3, 4.5, true, null ],\n"
+		"\"position\": Vector3( 1, 2, 3 ),\n"
+		"\"transform\": Transform2D( 1, 0, 0, 1, 10, 20 ),\n"
+		"\"color\": Color( 0.5, 0.25, 1, 1 ),\n"
+		"\"nested\": { \"a\": [ \"x\", \"y\", \"z\" ], \"b\": PackedInt32Array( 1, 2, 3, 4 ) }\n"
+		"}";
+
+BENCHMARK(VariantParser, parse) {
+	String text = parser_text;
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		VariantParser::StreamString stream;
+		stream.s = text;
+		Variant ret;
+		String err_str;
+		int err_line = 0;
+		VariantParser::parse(&stream, ret, err_str, err_line);
+		state.sink(Dictionary(ret).size());
+	}
+	state.stop();
+}
+
+BENCHMARK(VariantParser, write) {
+	VariantParser::StreamString stream;
+	stream.s = parser_text;
+	Variant value;
+	String err_str;
+	int err_line = 0;
+	VariantParser::parse(&stream, value, err_str, err_line);
+	state.start();
+	for (uint64_t i = 0; i < state.get_iterations(); i++) {
+		String text;
+		VariantWriter::write_to_string(value, text);
+		state.sink(text.length());
+	}
+	state.stop();
+}
+
+} // namespace BenchmarkVariant
+
+#endif // BENCHMARK_VARIANT_H
@@ -0,0 +1,324 @@
+/*************************************************************************/
+/*  test_animation.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_H
+#define TEST_ANIMATION_H
+
+#include "core/message_queue.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/animation/animation_blend_tree.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_tree.h"
+#include "scene/resources/animation.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestAnimation {
+
+static Ref<Animation> create_transform_animation(int p_key_count) {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(p_key_count * 0.1);
+	animation->add_track(Animation::TYPE_TRANSFORM);
+	for (int i = 0; i < p_key_count; i++) {
+		float t = i * 0.1;
+		Vector3 loc(Math::sin(t) * 2.0, t, -t * 0.5);
+		Quat rot(Vector3(0, 1, 0).rotated(Vector3(1, 0, 0), t).normalized(), t * 3.0);
+		Vector3 scale(1.0 + t * 0.1, 1.0, 1.0 - t * 0.05);
+		animation->transform_track_insert_key(0, t, loc, rot, scale);
+	}
+	return animation;
+}
+
+TEST_CASE("[Animation] Key cursors") {
+	Ref<Animation> animation = create_transform_animation(100);
+
+	int cursor = -1;
+	for (float t = 0; t < animation->get_length(); t += 0.013) {
+		Vector3 loc, loc_cursor;
+		Quat rot, rot_cursor;
+		Vector3 scale, scale_cursor;
+		animation->transform_track_interpolate(0, t, &loc, &rot, &scale);
+		animation->transform_track_interpolate(0, t, &loc_cursor, &rot_cursor, &scale_cursor, &cursor);
+		CHECK(loc.is_equal_approx(loc_cursor));
+		CHECK(rot.is_equal_approx(rot_cursor));
+		CHECK(scale.is_equal_approx(scale_cursor));
+	}
+
+	// Seeking backwards must not be thrown off by a stale cursor.
+	Vector3 loc, loc_cursor;
+	animation->transform_track_interpolate(0, 0.25, &loc, nullptr, nullptr);
+	animation->transform_track_interpolate(0, 0.25, &loc_cursor, nullptr, nullptr, &cursor);
+	CHECK(loc.is_equal_approx(loc_cursor));
+	CHECK(cursor == 2);
+
+	cursor = 12345;
+	animation->transform_track_interpolate(0, 0.25, &loc_cursor, nullptr, nullptr, &cursor);
+	CHECK_MESSAGE(loc.is_equal_approx(loc_cursor), "Out of range cursors should be ignored.");
+}
+
+TEST_CASE("[Animation] Compressed transform tracks") {
+	// More keys than fit in a page.
+	Ref<Animation> animation = create_transform_animation(150);
+	Ref<Animation> original = create_transform_animation(150);
+
+	animation->compress();
+	CHECK(animation->transform_track_is_compressed(0));
+	CHECK(animation->track_get_key_count(0) == 150);
+
+	Vector3 error = animation->transform_track_get_compression_error(0);
+	CHECK(error.x < 0.001);
+	CHECK(error.y < 0.001);
+	CHECK(error.z < 0.001);
+
+	for (float t = 0; t < animation->get_length(); t += 0.037) {
+		Vector3 loc, loc_orig;
+		Quat rot, rot_orig;
+		Vector3 scale, scale_orig;
+		animation->transform_track_interpolate(0, t, &loc, &rot, &scale);
+		original->transform_track_interpolate(0, t, &loc_orig, &rot_orig, &scale_orig);
+		CHECK(loc.distance_to(loc_orig) <= error.x + CMP_EPSILON);
+		CHECK(Math::abs(rot.dot(rot_orig)) > 0.9999);
+		CHECK(scale.distance_to(scale_orig) <= error.z + CMP_EPSILON);
+	}
+
+	CHECK(animation->track_get_key_time(0, 70) == doctest::Approx(original->track_get_key_time(0, 70)));
+	CHECK(animation->track_find_key(0, 7.0, true) == 70);
+
+	// Saving and loading keeps the compressed data as it is.
+	Ref<Animation> copy = memnew(Animation);
+	copy->set("tracks/0/type", animation->get("tracks/0/type"));
+	copy->set("tracks/0/keys", animation->get("tracks/0/keys"));
+	CHECK(copy->transform_track_is_compressed(0));
+	Dictionary copy_key = copy->track_get_key_value(0, 70);
+	Dictionary key = animation->track_get_key_value(0, 70);
+	CHECK(Vector3(copy_key["location"]) == Vector3(key["location"]));
+	CHECK(Quat(copy_key["rotation"]) == Quat(key["rotation"]));
+	CHECK(Vector3(copy_key["scale"]) == Vector3(key["scale"]));
+
+	// Editing a key decompresses the track.
+	animation->track_set_key_transition(0, 10, 0.5);
+	CHECK(!animation->transform_track_is_compressed(0));
+	CHECK(animation->track_get_key_count(0) == 150);
+	CHECK(animation->track_get_key_transition(0, 10) == doctest::Approx(0.5));
+}
+
+// Blends samples in the order of the animations, like AnimationTree did per track
+// before blending in structure of arrays form.
+struct ReferenceBlend {
+	bool processed = false;
+	Vector3 loc;
+	Quat rot;
+	float rot_blend_accum = 0;
+	Vector3 scale;
+	float value = 0;
+
+	void blend_transform(const Ref<Animation> &p_animation, int p_track, float p_time, float p_blend) {
+		if (p_blend < CMP_EPSILON) {
+			return;
+		}
+		Vector3 sample_loc;
+		Quat sample_rot;
+		Vector3 sample_scale;
+		p_animation->transform_track_interpolate(p_track, p_time, &sample_loc, &sample_rot, &sample_scale);
+		if (!processed) {
+			processed = true;
+			loc = sample_loc;
+			rot = sample_rot;
+			rot_blend_accum = 0;
+			scale = sample_scale;
+		}
+		loc = loc.lerp(sample_loc, p_blend);
+		if (rot_blend_accum == 0) {
+			rot = sample_rot;
+			rot_blend_accum = p_blend;
+		} else {
+			float rot_total = rot_blend_accum + p_blend;
+			rot = sample_rot.slerp(rot, rot_blend_accum / rot_total).normalized();
+			rot_blend_accum = rot_total;
+		}
+		scale = scale.lerp(sample_scale, p_blend);
+	}
+
+	void blend_bezier(const Ref<Animation> &p_animation, int p_track, float p_time, float p_blend) {
+		if (p_blend < CMP_EPSILON) {
+			return;
+		}
+		float sample = p_animation->bezier_track_interpolate(p_track, p_time);
+		if (!processed) {
+			processed = true;
+			value = sample;
+		}
+		value = Math::lerp(value, sample, p_blend);
+	}
+
+	void check_transform(const Transform &p_transform) const {
+		REQUIRE(processed);
+		CHECK(p_transform.origin.is_equal_approx(loc));
+		CHECK(Math::abs(p_transform.basis.get_rotation_quat().dot(rot)) == doctest::Approx(1.0));
+		CHECK(p_transform.basis.get_scale().is_equal_approx(scale));
+	}
+};
+
+static void insert_transform_keys(Ref<Animation> &p_animation, int p_track, float p_phase) {
+	for (int i = 0; i <= 10; i++) {
+		float t = i * 0.1;
+		Vector3 loc(Math::sin(t + p_phase) * 2.0, t * p_phase, -t);
+		Quat rot(Vector3(p_phase, 1, 0).normalized(), t * 2.0 + p_phase);
+		Vector3 scale(1.0 + t * p_phase, 1.0 - t * 0.3, 1.0 + t);
+		p_animation->transform_track_insert_key(p_track, t, loc, rot, scale);
+	}
+}
+
+TEST_CASE("[AnimationTree] Blending matches per track blending") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Node3D *scene = memnew(Node3D);
+
+	Node3D *node_a = memnew(Node3D);
+	node_a->set_name("a");
+	scene->add_child(node_a);
+	Node3D *node_b = memnew(Node3D);
+	node_b->set_name("b");
+	scene->add_child(node_b);
+	Node3D *node_c = memnew(Node3D);
+	node_c->set_name("c");
+	scene->add_child(node_c);
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	skeleton->set_name("skeleton");
+	skeleton->add_bone("bone0");
+	skeleton->add_bone("bone1");
+	skeleton->set_bone_parent(1, 0);
+	scene->add_child(skeleton);
+
+	// Node "b" and the second bone are only animated by the second animation.
+	Ref<Animation> anim_first = memnew(Animation);
+	anim_first->set_length(1.0);
+	anim_first->set_loop(true);
+	anim_first->add_track(Animation::TYPE_TRANSFORM);
+	anim_first->track_set_path(0, NodePath("a"));
+	insert_transform_keys(anim_first, 0, 0.3);
+	anim_first->add_track(Animation::TYPE_TRANSFORM);
+	anim_first->track_set_path(1, NodePath("skeleton:bone0"));
+	insert_transform_keys(anim_first, 1, 0.7);
+	anim_first->add_track(Animation::TYPE_BEZIER);
+	anim_first->track_set_path(2, NodePath("c:translation:x"));
+	anim_first->bezier_track_insert_key(2, 0.0, 1.0, Vector2(), Vector2());
+	anim_first->bezier_track_insert_key(2, 1.0, 3.0, Vector2(), Vector2());
+
+	Ref<Animation> anim_second = memnew(Animation);
+	anim_second->set_length(1.0);
+	anim_second->set_loop(true);
+	anim_second->add_track(Animation::TYPE_BEZIER);
+	anim_second->track_set_path(0, NodePath("c:translation:x"));
+	anim_second->bezier_track_insert_key(0, 0.0, -2.0, Vector2(), Vector2());
+	anim_second->bezier_track_insert_key(0, 1.0, 5.0, Vector2(), Vector2());
+	anim_second->add_track(Animation::TYPE_TRANSFORM);
+	anim_second->track_set_path(1, NodePath("skeleton:bone1"));
+	insert_transform_keys(anim_second, 1, 1.1);
+	anim_second->add_track(Animation::TYPE_TRANSFORM);
+	anim_second->track_set_path(2, NodePath("skeleton:bone0"));
+	insert_transform_keys(anim_second, 2, -0.4);
+	anim_second->add_track(Animation::TYPE_TRANSFORM);
+	anim_second->track_set_path(3, NodePath("b"));
+	insert_transform_keys(anim_second, 3, 0.9);
+	anim_second->add_track(Animation::TYPE_TRANSFORM);
+	anim_second->track_set_path(4, NodePath("a"));
+	insert_transform_keys(anim_second, 4, -1.2);
+
+	AnimationPlayer *player = memnew(AnimationPlayer);
+	player->set_name("player");
+	player->add_animation("first", anim_first);
+	player->add_animation("second", anim_second);
+	scene->add_child(player);
+
+	Ref<AnimationNodeBlendTree> blend_tree = memnew(AnimationNodeBlendTree);
+	Ref<AnimationNodeAnimation> node_first = memnew(AnimationNodeAnimation);
+	node_first->set_animation("first");
+	blend_tree->add_node("first", node_first);
+	Ref<AnimationNodeAnimation> node_second = memnew(AnimationNodeAnimation);
+	node_second->set_animation("second");
+	blend_tree->add_node("second", node_second);
+	blend_tree->add_node("blend", memnew(AnimationNodeBlend2));
+	blend_tree->connect_node("blend", 0, "first");
+	blend_tree->connect_node("blend", 1, "second");
+	blend_tree->connect_node("output", 0, "blend");
+
+	AnimationTree *tree = memnew(AnimationTree);
+	tree->set_tree_root(blend_tree);
+	tree->set_animation_player(NodePath("../player"));
+	scene->add_child(tree);
+	// The first advance also blends in the seek to the start, which the reference doesn't do.
+	tree->advance(0);
+
+	const float weights[] = { 0.0, 0.25, 0.5, 0.8, 1.0 };
+	for (int i = 0; i < 5; i++) {
+		tree->set("parameters/blend/blend_amount", weights[i]);
+		tree->advance(0.13);
+
+		const float time_first = tree->get("parameters/first/time");
+		const float time_second = tree->get("parameters/second/time");
+		const float blend_first = 1.0 - weights[i];
+		const float blend_second = weights[i];
+
+		ReferenceBlend a;
+		a.blend_transform(anim_first, 0, time_first, blend_first);
+		a.blend_transform(anim_second, 4, time_second, blend_second);
+		a.check_transform(node_a->get_transform());
+
+		ReferenceBlend b;
+		b.blend_transform(anim_second, 3, time_second, blend_second);
+		if (b.processed) {
+			b.check_transform(node_b->get_transform());
+		}
+
+		ReferenceBlend bone0;
+		bone0.blend_transform(anim_first, 1, time_first, blend_first);
+		bone0.blend_transform(anim_second, 2, time_second, blend_second);
+		bone0.check_transform(skeleton->get_bone_pose(0));
+
+		ReferenceBlend bone1;
+		bone1.blend_transform(anim_second, 1, time_second, blend_second);
+		if (bone1.processed) {
+			bone1.check_transform(skeleton->get_bone_pose(1));
+		}
+
+		ReferenceBlend c;
+		c.blend_bezier(anim_first, 2, time_first, blend_first);
+		c.blend_bezier(anim_second, 0, time_second, blend_second);
+		REQUIRE(c.processed);
+		CHECK(node_c->get_translation().x == doctest::Approx(c.value));
+	}
+
+	memdelete(scene);
+	memdelete(message_queue);
+}
+
+} // namespace TestAnimation
+
+#endif // TEST_ANIMATION_H
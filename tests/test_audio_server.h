@@ -0,0 +1,185 @@
+/*************************************************************************/
+/*  test_audio_server.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_AUDIO_SERVER_H
+#define TEST_AUDIO_SERVER_H
+
+#include "servers/audio_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioServer {
+
+// Mixes on demand instead of from a thread.
+class TestAudioDriver : public AudioDriver {
+public:
+	const char *get_name() const override { return "Test"; }
+	Error init() override { return OK; }
+	void start() override {}
+	int get_mix_rate() const override { return 44100; }
+	SpeakerMode get_speaker_mode() const override { return SPEAKER_MODE_STEREO; }
+	void lock() override {}
+	void unlock() override {}
+	void finish() override {}
+
+	void mix(int p_frames, int32_t *p_buffer) {
+		audio_server_process(p_frames, p_buffer, false);
+	}
+};
+
+struct TestVoice {
+	LocalVector<AudioFrame> frames;
+	LocalVector<AudioServer::VoiceSend> sends; // Their frames are set when sending.
+
+	static void send(void *p_userdata, int p_frames, LocalVector<AudioServer::VoiceSend> &r_sends) {
+		TestVoice *voice = (TestVoice *)p_userdata;
+		CHECK(p_frames == (int)voice->frames.size());
+		for (uint32_t i = 0; i < voice->sends.size(); i++) {
+			AudioServer::VoiceSend send = voice->sends[i];
+			send.frames = voice->frames.ptr();
+			r_sends.push_back(send);
+		}
+	}
+
+	TestVoice(int p_frames, float p_phase) {
+		frames.resize(p_frames);
+		for (int i = 0; i < p_frames; i++) {
+			frames[i] = AudioFrame(Math::sin(i * 0.05 + p_phase) * 0.2, Math::cos(i * 0.03 + p_phase) * 0.2);
+		}
+	}
+};
+
+static AudioServer::VoiceSend make_send(int p_bus, AudioFrame p_volume, AudioFrame p_volume_inc = AudioFrame(0, 0)) {
+	AudioServer::VoiceSend send;
+	send.bus_index = p_bus;
+	send.volume = p_volume;
+	send.volume_inc = p_volume_inc;
+	return send;
+}
+
+// Adds what a send contributes to the output.
+static void accumulate(LocalVector<AudioFrame> &r_expected, const TestVoice &p_voice, const AudioServer::VoiceSend &p_send) {
+	for (uint32_t i = 0; i < r_expected.size(); i++) {
+		r_expected[i].l += p_voice.frames[i].l * (p_send.volume.l + p_send.volume_inc.l * i);
+		r_expected[i].r += p_voice.frames[i].r * (p_send.volume.r + p_send.volume_inc.r * i);
+	}
+}
+
+static bool output_matches(const LocalVector<int32_t> &p_output, const LocalVector<AudioFrame> &p_expected) {
+	// The driver output has 20 bits of precision.
+	const double scale = double((1 << 20) - 1) * (1 << 11);
+	for (uint32_t i = 0; i < p_expected.size(); i++) {
+		if (Math::abs(p_output[i * 2 + 0] / scale - p_expected[i].l) > 1e-5 || Math::abs(p_output[i * 2 + 1] / scale - p_expected[i].r) > 1e-5) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[AudioServer] Voice sends") {
+	AudioDriver *previous_driver = AudioDriver::get_singleton();
+	TestAudioDriver driver;
+	driver.set_singleton();
+	AudioServer *server = memnew(AudioServer);
+	server->init();
+	server->set_bus_count(3);
+
+	const int frames = server->thread_get_mix_buffer_size();
+	LocalVector<int32_t> output;
+	output.resize(frames * 2);
+	LocalVector<AudioFrame> expected;
+	expected.resize(frames);
+	for (int i = 0; i < frames; i++) {
+		expected[i] = AudioFrame(0, 0);
+	}
+
+	TestVoice constant(frames, 0.0);
+	TestVoice ramp(frames, 1.0);
+	TestVoice spread(frames, 2.0);
+	TestVoice silent(frames, 3.0);
+
+	SUBCASE("Constant volume") {
+		constant.sends.push_back(make_send(0, AudioFrame(0.5, 0.25)));
+		server->add_voice(TestVoice::send, &constant);
+	}
+
+	SUBCASE("Ramped volume") {
+		ramp.sends.push_back(make_send(0, AudioFrame(0.0, 1.0), AudioFrame(1.0 / frames, -0.5 / frames)));
+		server->add_voice(TestVoice::send, &ramp);
+	}
+
+	SUBCASE("Sends to several buses in any order") {
+		// Sorted by bus before mixing, the sum has to be the same.
+		spread.sends.push_back(make_send(2, AudioFrame(0.3, 0.3)));
+		spread.sends.push_back(make_send(0, AudioFrame(0.2, 0.1), AudioFrame(0.0001, 0.0)));
+		spread.sends.push_back(make_send(1, AudioFrame(0.4, 0.5)));
+		constant.sends.push_back(make_send(1, AudioFrame(0.5, 0.25)));
+		constant.sends.push_back(make_send(2, AudioFrame(0.1, 0.6)));
+		ramp.sends.push_back(make_send(0, AudioFrame(0.0, 1.0), AudioFrame(1.0 / frames, -0.5 / frames)));
+		server->add_voice(TestVoice::send, &spread);
+		server->add_voice(TestVoice::send, &constant);
+		server->add_voice(TestVoice::send, &ramp);
+	}
+
+	// Voices without sends don't count as active.
+	server->add_voice(TestVoice::send, &silent);
+
+	TestVoice *voices[] = { &constant, &ramp, &spread };
+	int active_voices = 0;
+	for (int i = 0; i < 3; i++) {
+		for (uint32_t j = 0; j < voices[i]->sends.size(); j++) {
+			accumulate(expected, *voices[i], voices[i]->sends[j]);
+		}
+		active_voices += voices[i]->sends.size() ? 1 : 0;
+	}
+
+	driver.mix(frames, output.ptr());
+	CHECK(output_matches(output, expected));
+	CHECK(server->get_voice_count() == active_voices + 1);
+	CHECK(server->get_active_voice_count() == active_voices);
+
+	for (int i = 0; i < 3; i++) {
+		server->remove_voice(TestVoice::send, voices[i]);
+	}
+	server->remove_voice(TestVoice::send, &silent);
+	CHECK(server->get_voice_count() == 0);
+
+	server->finish();
+	memdelete(server);
+
+	// Otherwise cleared when the driver is destroyed.
+	if (previous_driver) {
+		previous_driver->set_singleton();
+	}
+}
+
+} // namespace TestAudioServer
+
+#endif // TEST_AUDIO_SERVER_H
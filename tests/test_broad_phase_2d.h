@@ -0,0 +1,221 @@
+/*************************************************************************/
+/*  test_broad_phase_2d.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_BROAD_PHASE_2D_H
+#define TEST_BROAD_PHASE_2D_H
+
+#include "core/math/random_pcg.h"
+#include "core/set.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_flat_hash_grid.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBroadPhase2D {
+
+// Pairs are keyed by element index, elements being identified by their owner and subindex.
+struct PairTracker {
+	const LocalVector<Body2DSW *> *owners = nullptr;
+	Set<uint64_t> pairs;
+	int errors = 0;
+
+	uint32_t index(CollisionObject2DSW *p_owner, int p_subindex) const {
+		for (uint32_t i = 0; i < owners->size(); i++) {
+			if ((*owners)[i] == p_owner) {
+				return i * 2 + p_subindex;
+			}
+		}
+		return 0xFFFFFFFF;
+	}
+
+	uint64_t key(CollisionObject2DSW *p_a, int p_subindex_a, CollisionObject2DSW *p_b, int p_subindex_b) const {
+		uint64_t a = index(p_a, p_subindex_a);
+		uint64_t b = index(p_b, p_subindex_b);
+		return a < b ? (a << 32) | b : (b << 32) | a;
+	}
+
+	static void *pair(CollisionObject2DSW *p_a, int p_subindex_a, CollisionObject2DSW *p_b, int p_subindex_b, void *p_self) {
+		PairTracker *self = (PairTracker *)p_self;
+		uint64_t key = self->key(p_a, p_subindex_a, p_b, p_subindex_b);
+		if (self->pairs.has(key)) {
+			self->errors++;
+		}
+		self->pairs.insert(key);
+		// Pairs without user data are reported again on every motion check.
+		return self;
+	}
+
+	static void unpair(CollisionObject2DSW *p_a, int p_subindex_a, CollisionObject2DSW *p_b, int p_subindex_b, void *p_data, void *p_self) {
+		PairTracker *self = (PairTracker *)p_self;
+		if (!self->pairs.erase(self->key(p_a, p_subindex_a, p_b, p_subindex_b))) {
+			self->errors++;
+		}
+	}
+};
+
+struct TestElement {
+	BroadPhase2DSW::ID ids[2] = {};
+	Rect2 aabb;
+	bool is_static = false;
+	bool alive = false;
+};
+
+bool sets_match(const Set<uint64_t> &p_a, const Set<uint64_t> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (const Set<uint64_t>::Element *E = p_a.front(); E; E = E->next()) {
+		if (!p_b.has(E->get())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Set<uint64_t> cull_to_set(const PairTracker &p_tracker, CollisionObject2DSW **p_results, int *p_indices, int p_count) {
+	Set<uint64_t> set;
+	for (int i = 0; i < p_count; i++) {
+		set.insert(p_tracker.index(p_results[i], p_indices[i]));
+	}
+	return set;
+}
+
+Rect2 random_rect(RandomPCG &r_rng, bool p_large) {
+	// Cells are 128 units wide, large rects go over the large object threshold.
+	const real_t size = p_large ? 4000 : 200;
+	return Rect2(r_rng.randf() * 3000 - 1500, r_rng.randf() * 3000 - 1500, 1 + r_rng.randf() * size, 1 + r_rng.randf() * size);
+}
+
+TEST_CASE("[BroadPhase2D] Flat hash grid matches the hash grid") {
+	RandomPCG rng(777);
+
+	const int owner_count = 100;
+	LocalVector<Body2DSW *> owners;
+	for (int i = 0; i < owner_count; i++) {
+		owners.push_back(memnew(Body2DSW));
+	}
+
+	BroadPhase2DSW *broad_phases[2] = {
+		BroadPhase2DHashGrid::_create(),
+		BroadPhase2DFlatHashGrid::_create(),
+	};
+	PairTracker trackers[2];
+	for (int b = 0; b < 2; b++) {
+		trackers[b].owners = &owners;
+		broad_phases[b]->set_pair_callback(&PairTracker::pair, &trackers[b]);
+		broad_phases[b]->set_unpair_callback(&PairTracker::unpair, &trackers[b]);
+	}
+
+	// Two elements per owner; elements of the same owner never pair.
+	LocalVector<TestElement> elements;
+	elements.resize(owner_count * 2);
+
+	for (int step = 0; step < 3000; step++) {
+		const uint32_t e = rng.rand() % elements.size();
+		TestElement &element = elements[e];
+		const uint32_t action = rng.rand() % 8;
+
+		if (!element.alive) {
+			element.alive = true;
+			element.is_static = false;
+			element.aabb = random_rect(rng, action == 0);
+			for (int b = 0; b < 2; b++) {
+				element.ids[b] = broad_phases[b]->create(owners[e / 2], e % 2);
+				broad_phases[b]->move(element.ids[b], element.aabb);
+			}
+		} else if (action == 0) {
+			element.alive = false;
+			for (int b = 0; b < 2; b++) {
+				broad_phases[b]->remove(element.ids[b]);
+			}
+		} else if (action == 1) {
+			element.is_static = !element.is_static;
+			for (int b = 0; b < 2; b++) {
+				broad_phases[b]->set_static(element.ids[b], element.is_static);
+			}
+		} else {
+			// Mostly small moves, which may stay in the same cells.
+			if (action < 6) {
+				element.aabb.position += Vector2(rng.randf() - 0.5, rng.randf() - 0.5) * 64;
+			} else {
+				element.aabb = random_rect(rng, action == 7);
+			}
+			for (int b = 0; b < 2; b++) {
+				broad_phases[b]->move(element.ids[b], element.aabb);
+			}
+		}
+
+		if (step % 50 != 0) {
+			continue;
+		}
+
+		for (int b = 0; b < 2; b++) {
+			broad_phases[b]->update();
+		}
+		CHECK_MESSAGE(sets_match(trackers[0].pairs, trackers[1].pairs), "Both broad phases should report the same pairs.");
+
+		CollisionObject2DSW *results[2][owner_count * 2];
+		int indices[2][owner_count * 2];
+		const Rect2 rect = random_rect(rng, false);
+		const Vector2 from = random_rect(rng, false).position;
+		const Vector2 to = random_rect(rng, false).position;
+		int counts[2];
+		for (int b = 0; b < 2; b++) {
+			counts[b] = broad_phases[b]->cull_aabb(rect, results[b], owner_count * 2, indices[b]);
+		}
+		CHECK_MESSAGE(sets_match(cull_to_set(trackers[0], results[0], indices[0], counts[0]), cull_to_set(trackers[1], results[1], indices[1], counts[1])), "AABB culling should match.");
+		for (int b = 0; b < 2; b++) {
+			counts[b] = broad_phases[b]->cull_segment(from, to, results[b], owner_count * 2, indices[b]);
+		}
+		CHECK_MESSAGE(sets_match(cull_to_set(trackers[0], results[0], indices[0], counts[0]), cull_to_set(trackers[1], results[1], indices[1], counts[1])), "Segment culling should match.");
+	}
+
+	for (uint32_t e = 0; e < elements.size(); e++) {
+		if (elements[e].alive) {
+			for (int b = 0; b < 2; b++) {
+				broad_phases[b]->remove(elements[e].ids[b]);
+			}
+		}
+	}
+	for (int b = 0; b < 2; b++) {
+		broad_phases[b]->update();
+		CHECK_MESSAGE(trackers[b].pairs.empty(), "Removing every element should unpair everything.");
+		CHECK(trackers[b].errors == 0);
+		memdelete(broad_phases[b]);
+	}
+	for (int i = 0; i < owner_count; i++) {
+		memdelete(owners[i]);
+	}
+}
+
+} // namespace TestBroadPhase2D
+
+#endif // TEST_BROAD_PHASE_2D_H
@@ -0,0 +1,143 @@
+/*************************************************************************/
+/*  test_command_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COMMAND_QUEUE_H
+#define TEST_COMMAND_QUEUE_H
+
+#include "core/command_queue_mt.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCommandQueue {
+
+struct Receiver {
+	uint32_t count = 0;
+	uint32_t last = 0;
+	bool in_order = true;
+	bool exit = false;
+
+	void receive(uint32_t p_value) {
+		if (count > 0 && p_value != last + 1) {
+			in_order = false;
+		}
+		last = p_value;
+		count++;
+	}
+
+	uint32_t get_count() {
+		return count;
+	}
+
+	void quit() {
+		exit = true;
+	}
+};
+
+struct Consumer {
+	CommandQueueMT *queue = nullptr;
+	Receiver *receiver = nullptr;
+
+	static void thread_func(void *p_userdata) {
+		Consumer *consumer = (Consumer *)p_userdata;
+		while (!consumer->receiver->exit) {
+			consumer->queue->wait_and_flush_one();
+		}
+	}
+};
+
+TEST_CASE("[CommandQueueMT] Commands run in order in both modes") {
+	for (int lock_free = 0; lock_free < 2; lock_free++) {
+		CommandQueueMT queue(false, lock_free);
+		Receiver receiver;
+
+		for (uint32_t i = 0; i < 1000; i++) {
+			queue.push(&receiver, &Receiver::receive, i);
+		}
+		CHECK(queue.get_pending_commands() == 1000);
+
+		queue.flush_all();
+		CHECK(queue.get_pending_commands() == 0);
+		CHECK(receiver.count == 1000);
+		CHECK(receiver.in_order);
+	}
+}
+
+TEST_CASE("[CommandQueueMT] Lock-free mode spills instead of blocking when full") {
+	CommandQueueMT queue(false, true);
+	Receiver receiver;
+
+	// Far more than the ring can hold, with nothing consuming.
+	const uint32_t amount = 100000;
+	for (uint32_t i = 0; i < amount; i++) {
+		queue.push(&receiver, &Receiver::receive, i);
+	}
+	CHECK_MESSAGE(queue.get_stall_count() > 0, "The ring should have filled up.");
+	CHECK(queue.get_pending_commands() == amount);
+
+	queue.flush_all();
+	CHECK(receiver.count == amount);
+	CHECK_MESSAGE(receiver.in_order, "Spilled commands should run after the ones in the ring, in push order.");
+
+	// Once drained, pushes go through the ring again.
+	queue.push(&receiver, &Receiver::receive, amount);
+	queue.flush_all();
+	CHECK(receiver.count == amount + 1);
+	CHECK(receiver.in_order);
+}
+
+TEST_CASE("[CommandQueueMT] Lock-free mode with a consumer thread") {
+	CommandQueueMT queue(true, true);
+	Receiver receiver;
+	Consumer consumer;
+	consumer.queue = &queue;
+	consumer.receiver = &receiver;
+
+	Thread *thread = Thread::create(Consumer::thread_func, &consumer);
+
+	const uint32_t amount = 200000;
+	for (uint32_t i = 0; i < amount; i++) {
+		queue.push(&receiver, &Receiver::receive, i);
+	}
+
+	uint32_t count = 0;
+	queue.push_and_ret(&receiver, &Receiver::get_count, &count);
+	CHECK_MESSAGE(count == amount, "Commands pushed before a synced one should have run.");
+
+	queue.push(&receiver, &Receiver::quit);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+
+	CHECK(receiver.in_order);
+	CHECK(queue.get_pending_commands() == 0);
+}
+
+} // namespace TestCommandQueue
+
+#endif // TEST_COMMAND_QUEUE_H
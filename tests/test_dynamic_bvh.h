@@ -0,0 +1,389 @@
+/*************************************************************************/
+/*  test_dynamic_bvh.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DYNAMIC_BVH_H
+#define TEST_DYNAMIC_BVH_H
+
+#include "core/math/dynamic_bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/set.h"
+#include "servers/rendering/rendering_server_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDynamicBVH {
+
+AABB random_aabb(RandomPCG &r_rng, real_t p_extent, real_t p_max_size) {
+	Vector3 position(r_rng.randf() * p_extent, r_rng.randf() * p_extent, r_rng.randf() * p_extent);
+	Vector3 size(0.1 + r_rng.randf() * p_max_size, 0.1 + r_rng.randf() * p_max_size, 0.1 + r_rng.randf() * p_max_size);
+	return AABB(position, size);
+}
+
+template <class T>
+bool sets_match(const Set<T> &p_a, const Set<T> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (const typename Set<T>::Element *E = p_a.front(); E; E = E->next()) {
+		if (!p_b.has(E->get())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Collects what the tree reports, after the exact test the tree leaves to its users.
+template <class T>
+struct Collector {
+	const Vector<AABB> *boxes = nullptr;
+	T test;
+	Set<uint32_t> found;
+
+	bool operator()(uint32_t p_userdata) {
+		if (test((*boxes)[p_userdata])) {
+			found.insert(p_userdata);
+		}
+		return false;
+	}
+};
+
+struct TestAABB {
+	AABB aabb;
+	bool operator()(const AABB &p_aabb) const { return aabb.intersects_inclusive(p_aabb); }
+};
+
+struct TestSegment {
+	Vector3 from;
+	Vector3 to;
+	bool operator()(const AABB &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+};
+
+struct Tree {
+	DynamicBVH bvh;
+	Vector<AABB> boxes;
+	Vector<DynamicBVH::ID> leaves;
+	Vector<bool> alive;
+
+	void check_queries(RandomPCG &r_rng) {
+		for (int q = 0; q < 20; q++) {
+			Collector<TestAABB> aabb_collector;
+			aabb_collector.boxes = &boxes;
+			aabb_collector.test.aabb = random_aabb(r_rng, 100, 30);
+			bvh.aabb_query(aabb_collector.test.aabb, aabb_collector);
+
+			// The box planes make a convex query equivalent to the box query.
+			Collector<TestAABB> convex_collector;
+			convex_collector.boxes = &boxes;
+			convex_collector.test = aabb_collector.test;
+			const AABB &box = aabb_collector.test.aabb;
+			const Plane planes[6] = {
+				Plane(Vector3(1, 0, 0), box.position.x + box.size.x),
+				Plane(Vector3(-1, 0, 0), -box.position.x),
+				Plane(Vector3(0, 1, 0), box.position.y + box.size.y),
+				Plane(Vector3(0, -1, 0), -box.position.y),
+				Plane(Vector3(0, 0, 1), box.position.z + box.size.z),
+				Plane(Vector3(0, 0, -1), -box.position.z),
+			};
+			bvh.convex_query(planes, 6, convex_collector);
+
+			Collector<TestSegment> segment_collector;
+			segment_collector.boxes = &boxes;
+			segment_collector.test.from = random_aabb(r_rng, 100, 1).position;
+			segment_collector.test.to = random_aabb(r_rng, 100, 1).position;
+			bvh.segment_query(segment_collector.test.from, segment_collector.test.to, segment_collector);
+
+			Set<uint32_t> expected_aabb;
+			Set<uint32_t> expected_segment;
+			for (int i = 0; i < boxes.size(); i++) {
+				if (!alive[i]) {
+					continue;
+				}
+				if (aabb_collector.test(boxes[i])) {
+					expected_aabb.insert(i);
+				}
+				if (segment_collector.test(boxes[i])) {
+					expected_segment.insert(i);
+				}
+			}
+
+			CHECK_MESSAGE(sets_match(aabb_collector.found, expected_aabb), "AABB queries should find every overlapping box.");
+			CHECK_MESSAGE(sets_match(convex_collector.found, expected_aabb), "Convex queries should find every box inside the planes.");
+			CHECK_MESSAGE(sets_match(segment_collector.found, expected_segment), "Segment queries should find every box crossed by the segment.");
+		}
+	}
+};
+
+TEST_CASE("[DynamicBVH] Insert, update, remove and query") {
+	RandomPCG rng(1234);
+	Tree tree;
+
+	const int count = 500;
+	for (int i = 0; i < count; i++) {
+		tree.boxes.push_back(random_aabb(rng, 100, 5));
+		tree.leaves.push_back(tree.bvh.insert(tree.boxes[i], i));
+		tree.alive.push_back(true);
+	}
+	CHECK(tree.bvh.get_leaf_count() == count);
+	CHECK_MESSAGE(tree.bvh.get_height() <= 20, "The tree should stay balanced.");
+	for (int i = 0; i < count; i++) {
+		CHECK(tree.bvh.get_userdata(tree.leaves[i]) == uint32_t(i));
+	}
+	tree.check_queries(rng);
+
+	// Small moves stay in the fattened box, big ones reinsert the leaf.
+	const real_t margin = tree.bvh.get_margin();
+	for (int i = 0; i < count; i++) {
+		AABB box = tree.boxes[i];
+		if (i % 2) {
+			box.position += Vector3(margin * 0.5, 0, 0);
+			CHECK_FALSE(tree.bvh.update(tree.leaves[i], box));
+			CHECK(tree.bvh.get_fat_aabb(tree.leaves[i]).encloses(box));
+		} else {
+			box = random_aabb(rng, 100, 5);
+			CHECK(tree.bvh.update(tree.leaves[i], box));
+		}
+		tree.boxes.write[i] = box;
+	}
+	CHECK_MESSAGE(tree.bvh.get_height() <= 20, "The tree should stay balanced.");
+	tree.check_queries(rng);
+
+	for (int i = 0; i < count; i += 3) {
+		tree.bvh.remove(tree.leaves[i]);
+		tree.alive.write[i] = false;
+	}
+	CHECK(tree.bvh.get_leaf_count() == uint32_t(count - (count + 2) / 3));
+	tree.check_queries(rng);
+
+	// Removed nodes are recycled.
+	for (int i = 0; i < count; i += 3) {
+		tree.boxes.write[i] = random_aabb(rng, 100, 5);
+		tree.leaves.write[i] = tree.bvh.insert(tree.boxes[i], i);
+		tree.alive.write[i] = true;
+	}
+	CHECK(tree.bvh.get_leaf_count() == count);
+	tree.check_queries(rng);
+
+	tree.bvh.clear();
+	CHECK(tree.bvh.is_empty());
+	CHECK(tree.bvh.get_leaf_count() == 0);
+}
+
+TEST_CASE("[DynamicBVH] Queries stop when the callback returns true") {
+	DynamicBVH bvh;
+	for (int i = 0; i < 10; i++) {
+		bvh.insert(AABB(Vector3(i, 0, 0), Vector3(0.5, 0.5, 0.5)), i);
+	}
+
+	struct First {
+		int calls = 0;
+		bool operator()(uint32_t p_userdata) {
+			calls++;
+			return true;
+		}
+	} first;
+	bvh.aabb_query(AABB(Vector3(-1, -1, -1), Vector3(20, 2, 2)), first);
+	CHECK(first.calls == 1);
+}
+
+// Scenarios pick the Octree or the BVH through a project setting; both
+// must report the same pairs and cull results.
+
+typedef RenderingServerScene::Instance Instance;
+typedef RenderingServerScene::SpatialPartitionID SpatialPartitionID;
+
+struct PairTracker {
+	Set<uint64_t> pairs;
+	int unpair_errors = 0;
+
+	static uint64_t key(Instance *p_a, Instance *p_b) {
+		uint64_t a = (uintptr_t)p_a;
+		uint64_t b = (uintptr_t)p_b;
+		return a < b ? (a << 32) | b : (b << 32) | a;
+	}
+
+	static void *pair(void *p_self, SpatialPartitionID, Instance *p_a, int, SpatialPartitionID, Instance *p_b, int) {
+		PairTracker *self = (PairTracker *)p_self;
+		self->pairs.insert(key(p_a, p_b));
+		return nullptr;
+	}
+
+	static void unpair(void *p_self, SpatialPartitionID, Instance *p_a, int, SpatialPartitionID, Instance *p_b, int, void *) {
+		PairTracker *self = (PairTracker *)p_self;
+		if (!self->pairs.erase(key(p_a, p_b))) {
+			self->unpair_errors++;
+		}
+	}
+};
+
+struct SceneItem {
+	AABB aabb;
+	bool pairable = false;
+	uint32_t type = 0;
+	uint32_t mask = 0;
+	bool alive = false;
+	SpatialPartitionID ids[2] = {};
+};
+
+Set<Instance *> cull_to_set(Instance **p_results, int p_count) {
+	Set<Instance *> set;
+	for (int i = 0; i < p_count; i++) {
+		set.insert(p_results[i]);
+	}
+	return set;
+}
+
+TEST_CASE("[DynamicBVH] BVH spatial partitioning matches the Octree") {
+	RandomPCG rng(4321);
+
+	RenderingServerScene::SpatialPartitioningScene *scenes[2] = {
+		memnew(RenderingServerScene::SpatialPartitioningScene_Octree),
+		memnew(RenderingServerScene::SpatialPartitioningScene_BVH),
+	};
+	PairTracker trackers[2];
+	for (int s = 0; s < 2; s++) {
+		scenes[s]->set_pair_callback(&PairTracker::pair, &trackers[s]);
+		scenes[s]->set_unpair_callback(&PairTracker::unpair, &trackers[s]);
+	}
+
+	const int count = 200;
+	Vector<SceneItem> items;
+	items.resize(count);
+	// Instances are only used as keys, never dereferenced.
+	auto instance = [](int p_index) { return (Instance *)(uintptr_t(p_index + 1) * 64); };
+
+	const int steps = 2000;
+	for (int step = 0; step < steps; step++) {
+		const int i = rng.rand() % count;
+		SceneItem &item = items.write[i];
+		const uint32_t action = rng.rand() % 4;
+
+		if (!item.alive) {
+			item.aabb = random_aabb(rng, 50, 8);
+			item.pairable = rng.rand() % 3 == 0;
+			item.type = 1 << (rng.rand() % 3);
+			item.mask = rng.rand() % 8;
+			item.alive = true;
+			for (int s = 0; s < 2; s++) {
+				item.ids[s] = scenes[s]->create(instance(i), item.aabb, 0, item.pairable, item.type, item.mask);
+			}
+		} else if (action == 0) {
+			item.alive = false;
+			for (int s = 0; s < 2; s++) {
+				scenes[s]->erase(item.ids[s]);
+			}
+		} else if (action == 1) {
+			item.pairable = !item.pairable;
+			for (int s = 0; s < 2; s++) {
+				scenes[s]->set_pairable(item.ids[s], item.pairable, item.type, item.mask);
+			}
+		} else {
+			// Mix small moves, which stay in the BVH fattened boxes, with teleports.
+			if (action == 2) {
+				item.aabb.position += Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5) * 0.1;
+			} else {
+				item.aabb = random_aabb(rng, 50, 8);
+			}
+			for (int s = 0; s < 2; s++) {
+				scenes[s]->move(item.ids[s], item.aabb);
+			}
+		}
+
+		if (step % 100 != 0) {
+			continue;
+		}
+
+		Set<uint64_t> expected_pairs;
+		for (int a = 0; a < count; a++) {
+			for (int b = a + 1; b < count; b++) {
+				const SceneItem &A = items[a];
+				const SceneItem &B = items[b];
+				if (!A.alive || !B.alive || (!A.pairable && !B.pairable)) {
+					continue;
+				}
+				if (!(A.type & B.mask) && !(B.type & A.mask)) {
+					continue;
+				}
+				if (A.aabb.intersects_inclusive(B.aabb)) {
+					expected_pairs.insert(PairTracker::key(instance(a), instance(b)));
+				}
+			}
+		}
+		CHECK_MESSAGE(sets_match(trackers[0].pairs, expected_pairs), "The Octree should pair every overlapping instance.");
+		CHECK_MESSAGE(sets_match(trackers[1].pairs, expected_pairs), "The BVH should pair every overlapping instance.");
+
+		Instance *results[2][count];
+		const AABB box = random_aabb(rng, 50, 20);
+		const uint32_t mask = 1 + rng.rand() % 7;
+		const int aabb_counts[2] = {
+			scenes[0]->cull_aabb(box, results[0], count, mask),
+			scenes[1]->cull_aabb(box, results[1], count, mask),
+		};
+		CHECK_MESSAGE(sets_match(cull_to_set(results[0], aabb_counts[0]), cull_to_set(results[1], aabb_counts[1])), "AABB culling should match.");
+
+		const Vector3 from = random_aabb(rng, 50, 1).position;
+		const Vector3 to = random_aabb(rng, 50, 1).position;
+		const int segment_counts[2] = {
+			scenes[0]->cull_segment(from, to, results[0], count, mask),
+			scenes[1]->cull_segment(from, to, results[1], count, mask),
+		};
+		CHECK_MESSAGE(sets_match(cull_to_set(results[0], segment_counts[0]), cull_to_set(results[1], segment_counts[1])), "Segment culling should match.");
+
+		const Plane planes[6] = {
+			Plane(Vector3(1, 0, 0), box.position.x + box.size.x),
+			Plane(Vector3(-1, 0, 0), -box.position.x),
+			Plane(Vector3(0, 1, 0), box.position.y + box.size.y),
+			Plane(Vector3(0, -1, 0), -box.position.y),
+			Plane(Vector3(0, 0, 1), box.position.z + box.size.z),
+			Plane(Vector3(0, 0, -1), -box.position.z),
+		};
+		const int convex_counts[2] = {
+			scenes[0]->cull_convex(planes, 6, results[0], count, mask),
+			scenes[1]->cull_convex(planes, 6, results[1], count, mask),
+		};
+		CHECK_MESSAGE(sets_match(cull_to_set(results[0], convex_counts[0]), cull_to_set(results[1], convex_counts[1])), "Convex culling should match.");
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (items[i].alive) {
+			for (int s = 0; s < 2; s++) {
+				scenes[s]->erase(items[i].ids[s]);
+			}
+		}
+	}
+	for (int s = 0; s < 2; s++) {
+		CHECK_MESSAGE(trackers[s].pairs.empty(), "Erasing every instance should unpair everything.");
+		CHECK(trackers[s].unpair_errors == 0);
+		memdelete(scenes[s]);
+	}
+}
+
+} // namespace TestDynamicBVH
+
+#endif // TEST_DYNAMIC_BVH_H
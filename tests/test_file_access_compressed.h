@@ -0,0 +1,195 @@
+/*************************************************************************/
+/*  test_file_access_compressed.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FILE_ACCESS_COMPRESSED_H
+#define TEST_FILE_ACCESS_COMPRESSED_H
+
+#include "core/io/file_access_compressed.h"
+#include "core/job_system.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFileAccessCompressed {
+
+static const int BLOCK_SIZE = 1024;
+
+static uint8_t byte_at(int p_pos) {
+	// Compressible, but not trivially.
+	return (p_pos * 7 + (p_pos >> 5) + ((p_pos * p_pos) >> 11)) & 0xFF;
+}
+
+static bool bytes_match(const uint8_t *p_data, int p_pos, int p_length) {
+	for (int i = 0; i < p_length; i++) {
+		if (p_data[i] != byte_at(p_pos + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static String write_compressed(int p_size, Compression::Mode p_mode) {
+	String path = OS::get_singleton()->get_cache_path().plus_file("test_file_access_compressed.bin");
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("TEST", p_mode, BLOCK_SIZE);
+	REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+
+	// Mix byte and buffer stores, and overwrite some data after seeking back.
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		data.write[i] = byte_at(i);
+	}
+	int half = p_size / 2;
+	for (int i = 0; i < half; i++) {
+		fac->store_8(0);
+	}
+	fac->store_buffer(data.ptr() + half, p_size - half);
+	fac->seek(0);
+	fac->store_buffer(data.ptr(), half);
+	CHECK(fac->get_len() == (size_t)p_size);
+
+	fac->close();
+	memdelete(fac);
+	return path;
+}
+
+static void check_reads(const String &p_path, int p_size, bool p_read_ahead) {
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("TEST");
+	fac->set_read_ahead(p_read_ahead);
+	REQUIRE(fac->_open(p_path, FileAccess::READ) == OK);
+	CHECK(fac->get_len() == (size_t)p_size);
+
+	// Sequential reads in chunks that don't line up with blocks.
+	Vector<uint8_t> buffer;
+	buffer.resize(p_size + 100);
+	uint8_t *dst = buffer.ptrw();
+	int pos = 0;
+	bool match = true;
+	while (pos < p_size) {
+		int chunk = MIN(700, p_size - pos);
+		CHECK(fac->get_buffer(dst, chunk) == chunk);
+		match = match && bytes_match(dst, pos, chunk);
+		pos += chunk;
+		CHECK(fac->get_position() == (size_t)pos);
+	}
+	CHECK_MESSAGE(match, "Sequential reads should return the written data.");
+	CHECK(!fac->eof_reached());
+
+	// Reading past the end.
+	CHECK(fac->get_8() == 0);
+	CHECK(fac->eof_reached());
+	CHECK(fac->get_buffer(dst, 10) == 0);
+
+	if (p_size > 3 * BLOCK_SIZE) {
+		// Backwards into an earlier block, then across block boundaries.
+		fac->seek(BLOCK_SIZE + 100);
+		CHECK(!fac->eof_reached());
+		CHECK(fac->get_buffer(dst, 2 * BLOCK_SIZE) == 2 * BLOCK_SIZE);
+		CHECK(bytes_match(dst, BLOCK_SIZE + 100, 2 * BLOCK_SIZE));
+
+		// Back to the start, byte by byte.
+		fac->seek(0);
+		match = true;
+		for (int i = 0; i < BLOCK_SIZE + 10; i++) {
+			match = match && fac->get_8() == byte_at(i);
+		}
+		CHECK(match);
+
+		// Forwards, skipping blocks.
+		fac->seek(3 * BLOCK_SIZE + 1);
+		CHECK(fac->get_8() == byte_at(3 * BLOCK_SIZE + 1));
+		fac->seek(BLOCK_SIZE - 1);
+		CHECK(fac->get_buffer(dst, 2) == 2);
+		CHECK(bytes_match(dst, BLOCK_SIZE - 1, 2));
+	}
+
+	// The rest of the file after a seek, then a read that goes past the end.
+	fac->seek(p_size / 3);
+	int rest = p_size - p_size / 3;
+	CHECK(fac->get_buffer(dst, rest + 50) == rest);
+	CHECK(bytes_match(dst, p_size / 3, rest));
+	CHECK(fac->eof_reached());
+
+	fac->seek_end();
+	CHECK(fac->get_position() == (size_t)p_size);
+	CHECK(fac->get_8() == 0);
+	CHECK(fac->eof_reached());
+
+	// The last bytes.
+	fac->seek_end(-1);
+	CHECK(fac->get_8() == byte_at(p_size - 1));
+	CHECK(!fac->eof_reached());
+	fac->get_8();
+	CHECK(fac->eof_reached());
+
+	fac->close();
+	memdelete(fac);
+}
+
+TEST_CASE("[FileAccessCompressed] Round trips") {
+	const int sizes[] = {
+		5 * BLOCK_SIZE + 123,
+		5 * BLOCK_SIZE, // The last block is empty.
+		4 * BLOCK_SIZE - 1,
+		BLOCK_SIZE + 7,
+		100,
+	};
+	const Compression::Mode modes[] = { Compression::MODE_ZSTD, Compression::MODE_DEFLATE };
+
+	for (int m = 0; m < 2; m++) {
+		for (int s = 0; s < 5; s++) {
+			CAPTURE(m);
+			CAPTURE(sizes[s]);
+			String path = write_compressed(sizes[s], modes[m]);
+			check_reads(path, sizes[s], true);
+			check_reads(path, sizes[s], false);
+			DirAccess::remove_file_or_error(path);
+		}
+	}
+}
+
+TEST_CASE("[FileAccessCompressed] Blocks compressed in parallel") {
+	// More blocks than worker threads, written on the calling thread if there are none.
+	JobSystem *job_system = JobSystem::get_singleton();
+	REQUIRE(job_system);
+	const int size = (job_system->get_thread_count() + 4) * 3 * BLOCK_SIZE + 11;
+
+	String path = write_compressed(size, Compression::MODE_ZSTD);
+	check_reads(path, size, true);
+	check_reads(path, size, false);
+	DirAccess::remove_file_or_error(path);
+}
+
+} // namespace TestFileAccessCompressed
+
+#endif // TEST_FILE_ACCESS_COMPRESSED_H
@@ -0,0 +1,322 @@
+/*************************************************************************/
+/*  test_file_access_pack.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FILE_ACCESS_PACK_H
+#define TEST_FILE_ACCESS_PACK_H
+
+#include "core/io/file_access_memory.h"
+#include "core/io/file_access_pack.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFileAccessPack {
+
+struct TestPackFile {
+	const char *path;
+	uint64_t offset; // Zero erases the file.
+};
+
+struct TestPack {
+	bool replace;
+	Vector<TestPackFile> files;
+};
+
+static Vector<uint8_t> write_index(const TestPack &p_pack) {
+	Vector<PackedData::IndexedFile> indexed;
+	for (int i = 0; i < p_pack.files.size(); i++) {
+		PackedData::IndexedFile file;
+		file.path = String(p_pack.files[i].path).utf8();
+		file.offset = p_pack.files[i].offset;
+		file.size = p_pack.files[i].offset + 1;
+		indexed.push_back(file);
+	}
+
+	Vector<uint8_t> data;
+	data.resize(64 * 1024);
+	FileAccessMemory *f = memnew(FileAccessMemory);
+	f->open_custom(data.ptrw(), data.size());
+	PackedData::store_index(f, indexed);
+	data.resize(f->get_position());
+	memdelete(f);
+	return data;
+}
+
+// Adds the test packs either to the file table, like packs without an index,
+// or as directory indexes.
+class TestPackSource : public PackSource {
+public:
+	const Vector<TestPack> *packs = nullptr;
+	uint32_t indexed_mask = 0;
+	PackedData::PackedFile last_file;
+
+	virtual bool try_open_pack(const String &p_path, bool p_replace_files, size_t p_offset) {
+		if (!p_path.begins_with("test_pack_")) {
+			return false;
+		}
+		int pack_idx = p_path.get_slice("_", 2).to_int();
+		const TestPack &pack = (*packs)[pack_idx];
+
+		if (indexed_mask & (1 << pack_idx)) {
+			PackedData::PackIndex *index = memnew(PackedData::PackIndex);
+			index->storage = write_index(pack);
+			if (!index->set_data(index->storage.ptr(), index->storage.ptr() + PackedData::PackIndex::HEADER_SIZE)) {
+				memdelete(index);
+				return false;
+			}
+			index->pack = p_path;
+			index->src = this;
+			PackedData::get_singleton()->add_index(index, p_replace_files);
+			return true;
+		}
+
+		uint8_t md5[16] = {};
+		for (int i = 0; i < pack.files.size(); i++) {
+			PackedData::get_singleton()->add_path(p_path, pack.files[i].path, pack.files[i].offset, pack.files[i].offset + 1, md5, this, p_replace_files);
+		}
+		return true;
+	}
+
+	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file) {
+		last_file = *p_file;
+		return nullptr;
+	}
+};
+
+static Vector<TestPack> create_packs() {
+	Vector<TestPack> packs;
+	TestPack pack;
+
+	pack.replace = false;
+	pack.files.clear();
+	pack.files.push_back({ "res://a.txt", 1001 });
+	pack.files.push_back({ "res://dir/b.txt", 1002 });
+	pack.files.push_back({ "res://dir/sub/c.txt", 1003 });
+	packs.push_back(pack);
+
+	pack.replace = true;
+	pack.files.clear();
+	pack.files.push_back({ "res://a.txt", 2001 });
+	pack.files.push_back({ "res://dir/d.txt", 2002 });
+	packs.push_back(pack);
+
+	pack.replace = false;
+	pack.files.clear();
+	pack.files.push_back({ "res://a.txt", 3001 });
+	pack.files.push_back({ "res://dir/b.txt", 3002 });
+	pack.files.push_back({ "res://other/e.txt", 3003 });
+	pack.files.push_back({ "res://other/deep/er/f.txt", 3004 });
+	packs.push_back(pack);
+
+	pack.replace = true;
+	pack.files.clear();
+	pack.files.push_back({ "res://dir/sub/c.txt", 4001 });
+	pack.files.push_back({ "res://other/e.txt", 4002 });
+	pack.files.push_back({ "res://dir/d.txt", 0 });
+	packs.push_back(pack);
+
+	pack.replace = false;
+	pack.files.clear();
+	pack.files.push_back({ "res://dir/d.txt", 5001 });
+	pack.files.push_back({ "res://dir/sub/g.txt", 5002 });
+	pack.files.push_back({ "res://a.txt", 5003 });
+	packs.push_back(pack);
+
+	return packs;
+}
+
+static const char *lookup_paths[] = {
+	"res://a.txt",
+	"res://dir/b.txt",
+	"res://dir/sub/c.txt",
+	"res://dir/d.txt",
+	"res://other/e.txt",
+	"res://other/deep/er/f.txt",
+	"res://dir/sub/g.txt",
+	"res://missing.txt",
+	"res://dir/missing.txt",
+};
+
+struct LookupResult {
+	bool exists = false;
+	String pack;
+	uint64_t offset = 0;
+};
+
+static String list_dir(const String &p_dir) {
+	DirAccessPack *da = memnew(DirAccessPack);
+	Vector<String> names;
+	if (da->change_dir(p_dir) == OK) {
+		da->list_dir_begin();
+		String name = da->get_next();
+		while (name != String()) {
+			names.push_back(da->current_is_dir() ? name + "/" : name);
+			name = da->get_next();
+		}
+		da->list_dir_end();
+	}
+	memdelete(da);
+	names.sort();
+	return String(", ").join(names);
+}
+
+static const char *list_dirs[] = {
+	"res://",
+	"res://dir",
+	"res://dir/sub",
+	"res://other",
+	"res://other/deep",
+	"res://other/deep/er",
+	"res://missing",
+};
+
+// Loads the packs, indexed or not according to the mask, and records what every lookup finds.
+static void load_packs(const Vector<TestPack> &p_packs, uint32_t p_indexed_mask, Vector<LookupResult> &r_lookups, Vector<String> &r_listings) {
+	PackedData *packed_data = memnew(PackedData);
+	TestPackSource *source = memnew(TestPackSource);
+	source->packs = &p_packs;
+	source->indexed_mask = p_indexed_mask;
+	packed_data->add_pack_source(source);
+
+	for (int i = 0; i < p_packs.size(); i++) {
+		packed_data->add_pack("test_pack_" + itos(i), p_packs[i].replace, 0);
+	}
+
+	r_lookups.clear();
+	for (uint32_t i = 0; i < sizeof(lookup_paths) / sizeof(lookup_paths[0]); i++) {
+		LookupResult result;
+		result.exists = packed_data->has_path(lookup_paths[i]);
+		source->last_file = PackedData::PackedFile();
+		source->last_file.offset = 0;
+		packed_data->try_open_path(lookup_paths[i]);
+		result.pack = source->last_file.pack;
+		result.offset = source->last_file.offset;
+		r_lookups.push_back(result);
+	}
+
+	r_listings.clear();
+	for (uint32_t i = 0; i < sizeof(list_dirs) / sizeof(list_dirs[0]); i++) {
+		r_listings.push_back(list_dir(list_dirs[i]));
+	}
+
+	memdelete(packed_data);
+}
+
+TEST_CASE("[PackedData] Directory index lookups") {
+	Vector<TestPack> packs = create_packs();
+	Vector<uint8_t> data = write_index(packs[2]);
+
+	PackedData::PackIndex index;
+	REQUIRE(data.size() >= PackedData::PackIndex::HEADER_SIZE);
+	CHECK(uint64_t(data.size()) == PackedData::PackIndex::HEADER_SIZE + PackedData::PackIndex::get_size(data.ptr()));
+	REQUIRE(index.set_data(data.ptr(), data.ptr() + PackedData::PackIndex::HEADER_SIZE));
+	index.base = 100;
+	CHECK(index.entry_count == 4);
+
+	for (int i = 0; i < packs[2].files.size(); i++) {
+		String path = packs[2].files[i].path;
+		Vector<uint8_t> md5 = path.md5_buffer();
+		int entry = index.find_entry(decode_uint64(&md5[0]), decode_uint64(&md5[8]));
+		REQUIRE(entry >= 0);
+		CHECK(index.get_entry_name(entry) == path.get_file());
+		PackedData::PackedFile file;
+		index.get_entry(entry, file);
+		CHECK(file.offset == 100 + packs[2].files[i].offset);
+		CHECK(file.size == packs[2].files[i].offset + 1);
+		CHECK(!file.encrypted);
+	}
+	Vector<uint8_t> md5 = String("res://dir/d.txt").md5_buffer();
+	CHECK(index.find_entry(decode_uint64(&md5[0]), decode_uint64(&md5[8])) == -1);
+
+	// Every parent directory is indexed, children and files are sorted by name.
+	int root = index.find_dir("");
+	REQUIRE(root >= 0);
+	CHECK(index.get_dir_child_count(root) == 2);
+	CHECK(index.get_dir_child(root, 0) == "dir");
+	CHECK(index.get_dir_child(root, 1) == "other");
+	CHECK(index.get_dir_file_count(root) == 1);
+	CHECK(index.get_dir_file(root, 0) == "a.txt");
+	CHECK(index.has_dir_child(root, "other"));
+	CHECK(!index.has_dir_child(root, "sub"));
+	CHECK(index.has_dir_file(root, "a.txt"));
+	CHECK(!index.has_dir_file(root, "b.txt"));
+
+	int deep = index.find_dir("other/deep");
+	REQUIRE(deep >= 0);
+	CHECK(index.get_dir_file_count(deep) == 0);
+	CHECK(index.get_dir_child(deep, 0) == "er");
+	CHECK(index.has_dir_file(index.find_dir("other/deep/er"), "f.txt"));
+	CHECK(index.find_dir("dir/sub") == -1);
+	CHECK(index.find_dir("other/deep/e") == -1);
+}
+
+TEST_CASE("[PackedData] Directory indexes resolve paths like the file table") {
+	Vector<TestPack> packs = create_packs();
+
+	Vector<LookupResult> expected_lookups;
+	Vector<String> expected_listings;
+	load_packs(packs, 0, expected_lookups, expected_listings);
+
+	// Sanity check the file table itself.
+	CHECK(expected_lookups[0].offset == 2001); // Replaced, not by later packs that don't replace.
+	CHECK(expected_lookups[2].offset == 4001);
+	CHECK(expected_lookups[3].exists);
+	CHECK(expected_lookups[3].pack.empty()); // Erased.
+	CHECK(expected_lookups[4].pack == "test_pack_3");
+	CHECK(expected_lookups[6].offset == 5002);
+	CHECK(!expected_lookups[7].exists);
+	CHECK(expected_listings[0] == "a.txt, dir/, other/");
+	CHECK(expected_listings[2] == "c.txt, g.txt");
+	CHECK(expected_listings[6] == "");
+
+	// Every mix of packs with and without an index.
+	for (uint32_t mask = 1; mask < (1u << packs.size()); mask++) {
+		Vector<LookupResult> lookups;
+		Vector<String> listings;
+		load_packs(packs, mask, lookups, listings);
+
+		CAPTURE(mask);
+		for (int i = 0; i < lookups.size(); i++) {
+			INFO(lookup_paths[i]);
+			CHECK(lookups[i].exists == expected_lookups[i].exists);
+			CHECK(lookups[i].pack == expected_lookups[i].pack);
+			CHECK(lookups[i].offset == expected_lookups[i].offset);
+		}
+		for (int i = 0; i < listings.size(); i++) {
+			INFO(list_dirs[i]);
+			CHECK(listings[i] == expected_listings[i]);
+		}
+	}
+
+	CHECK(PackedData::get_singleton() == nullptr);
+}
+
+} // namespace TestFileAccessPack
+
+#endif // TEST_FILE_ACCESS_PACK_H
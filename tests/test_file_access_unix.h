@@ -0,0 +1,212 @@
+/*************************************************************************/
+/*  test_file_access_unix.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FILE_ACCESS_UNIX_H
+#define TEST_FILE_ACCESS_UNIX_H
+
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "drivers/unix/file_access_unix.h"
+
+#include "tests/test_macros.h"
+
+#ifdef UNIX_ENABLED
+
+namespace TestFileAccessUnix {
+
+// Large enough to be memory mapped, for packs.
+static const int MAPPED_SIZE = 200 * 1024 + 3;
+
+static uint8_t byte_at(int p_pos) {
+	return (p_pos * 7 + (p_pos >> 8)) & 0xFF;
+}
+
+static String write_test_file(const String &p_name, int p_size) {
+	String path = OS::get_singleton()->get_cache_path().plus_file(p_name);
+	FileAccessRef f = FileAccess::open(path, FileAccess::WRITE);
+	for (int i = 0; i < p_size; i++) {
+		f->store_8(byte_at(i));
+	}
+	return path;
+}
+
+static bool bytes_match(const uint8_t *p_data, int p_pos, int p_length) {
+	for (int i = 0; i < p_length; i++) {
+		if (p_data[i] != byte_at(p_pos + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads the same way whether the file is mapped or not.
+static void check_reads(FileAccess *p_file, int p_size) {
+	CHECK(p_file->get_len() == (size_t)p_size);
+	CHECK(p_file->get_8() == byte_at(0));
+	CHECK(p_file->get_position() == 1);
+
+	p_file->seek(100);
+	uint32_t expected = byte_at(100) | (byte_at(101) << 8) | (byte_at(102) << 16) | (uint32_t(byte_at(103)) << 24);
+	CHECK(p_file->get_32() == expected);
+
+	uint8_t buffer[300];
+	p_file->seek(p_size / 2);
+	CHECK(p_file->get_buffer(buffer, 300) == 300);
+	CHECK(bytes_match(buffer, p_size / 2, 300));
+	CHECK(p_file->get_position() == (size_t)(p_size / 2 + 300));
+
+	// Backwards.
+	p_file->seek(10);
+	CHECK(p_file->get_buffer(buffer, 20) == 20);
+	CHECK(bytes_match(buffer, 10, 20));
+	CHECK(!p_file->eof_reached());
+
+	p_file->seek_end(-5);
+	CHECK(p_file->get_position() == (size_t)(p_size - 5));
+	CHECK(p_file->get_buffer(buffer, 300) == 5);
+	CHECK(bytes_match(buffer, p_size - 5, 5));
+	CHECK(p_file->eof_reached());
+
+	// Seeking clears the end of file.
+	p_file->seek(p_size - 1);
+	CHECK(!p_file->eof_reached());
+	CHECK(p_file->get_8() == byte_at(p_size - 1));
+	CHECK(!p_file->eof_reached());
+	p_file->get_8();
+	CHECK(p_file->eof_reached());
+}
+
+TEST_CASE("[FileAccessUnix] Mapped reads") {
+	String path = write_test_file("test_file_access_unix_mapped.pck", MAPPED_SIZE);
+
+	FileAccessRef f = FileAccess::open(path, FileAccess::READ);
+	REQUIRE(f);
+	REQUIRE_MESSAGE(f->get_mapped_buffer(0) != nullptr, "Large read only files should be mapped.");
+	check_reads(f, MAPPED_SIZE);
+
+	// Mapped buffers point into the file and advance the position.
+	f->seek(5000);
+	const uint8_t *ptr = f->get_mapped_buffer(64);
+	REQUIRE(ptr != nullptr);
+	CHECK(bytes_match(ptr, 5000, 64));
+	CHECK(f->get_position() == 5064);
+	ptr = f->get_mapped_buffer(16);
+	REQUIRE(ptr != nullptr);
+	CHECK(bytes_match(ptr, 5064, 16));
+
+	// Buffers past the end are not returned, and the position stays.
+	f->seek_end(-8);
+	CHECK(f->get_mapped_buffer(8) != nullptr);
+	CHECK(f->get_mapped_buffer(1) == nullptr);
+	CHECK(f->get_position() == (size_t)MAPPED_SIZE);
+	f->seek_end(-8);
+	CHECK(f->get_mapped_buffer(9) == nullptr);
+	CHECK(f->get_position() == (size_t)(MAPPED_SIZE - 8));
+	CHECK(f->get_mapped_buffer(-1) == nullptr);
+
+	// Files opened at the same time share their mapping.
+	FileAccessRef other = FileAccess::open(path, FileAccess::READ);
+	f->seek(0);
+	CHECK(other->get_mapped_buffer(16) == f->get_mapped_buffer(16));
+
+	f->close();
+	other->close();
+	DirAccess::remove_file_or_error(path);
+}
+
+TEST_CASE("[FileAccessUnix] Unmapped reads") {
+	String small_path = write_test_file("test_file_access_unix_small.bin", 1000);
+	String path = write_test_file("test_file_access_unix_unmapped.pck", MAPPED_SIZE);
+	String other_path = write_test_file("test_file_access_unix_unmapped.bin", MAPPED_SIZE);
+
+	{
+		FileAccessRef f = FileAccess::open(small_path, FileAccess::READ);
+		REQUIRE(f);
+		CHECK_MESSAGE(f->get_mapped_buffer(0) == nullptr, "Small files should not be mapped.");
+		check_reads(f, 1000);
+	}
+
+	{
+		FileAccessRef f = FileAccess::open(other_path, FileAccess::READ);
+		REQUIRE(f);
+		CHECK_MESSAGE(f->get_mapped_buffer(0) == nullptr, "Files other than packs and imported resources should not be mapped.");
+		check_reads(f, MAPPED_SIZE);
+	}
+
+	{
+		FileAccessUnix::set_use_mmap(false);
+		FileAccessRef f = FileAccess::open(path, FileAccess::READ);
+		FileAccessUnix::set_use_mmap(true);
+		REQUIRE(f);
+		CHECK(f->get_mapped_buffer(0) == nullptr);
+		check_reads(f, MAPPED_SIZE);
+	}
+
+	{
+		// Files opened for writing are not mapped.
+		FileAccessRef f = FileAccess::open(path, FileAccess::READ_WRITE);
+		REQUIRE(f);
+		CHECK(f->get_mapped_buffer(0) == nullptr);
+		check_reads(f, MAPPED_SIZE);
+	}
+
+	DirAccess::remove_file_or_error(small_path);
+	DirAccess::remove_file_or_error(path);
+	DirAccess::remove_file_or_error(other_path);
+}
+
+TEST_CASE("[FileAccessUnix] Reopening releases the mapping") {
+	String small_path = write_test_file("test_file_access_unix_reopen_small.bin", 1000);
+	String path = write_test_file("test_file_access_unix_reopen.pck", MAPPED_SIZE);
+
+	FileAccess *f = FileAccess::create(FileAccess::ACCESS_FILESYSTEM);
+	REQUIRE(f->reopen(path, FileAccess::READ) == OK);
+	CHECK(f->get_mapped_buffer(0) != nullptr);
+
+	// The new file is read, not the old mapping.
+	REQUIRE(f->reopen(small_path, FileAccess::READ) == OK);
+	CHECK(f->get_mapped_buffer(0) == nullptr);
+	check_reads(f, 1000);
+
+	REQUIRE(f->reopen(path, FileAccess::READ) == OK);
+	CHECK(f->get_mapped_buffer(0) != nullptr);
+	check_reads(f, MAPPED_SIZE);
+	memdelete(f);
+
+	DirAccess::remove_file_or_error(small_path);
+	DirAccess::remove_file_or_error(path);
+}
+
+} // namespace TestFileAccessUnix
+
+#endif // UNIX_ENABLED
+
+#endif // TEST_FILE_ACCESS_UNIX_H
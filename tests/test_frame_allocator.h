@@ -0,0 +1,127 @@
+/*************************************************************************/
+/*  test_frame_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ALLOCATOR_H
+#define TEST_FRAME_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/os/thread.h"
+#include "core/print_string.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameAllocator {
+
+struct ThreadData {
+	void *allocated = nullptr;
+	void *to_free = nullptr;
+};
+
+static void alloc_and_free_in_thread(void *p_userdata) {
+	ThreadData *data = (ThreadData *)p_userdata;
+	if (data->to_free) {
+		FrameAllocator::free(data->to_free);
+	}
+	data->allocated = FrameAllocator::alloc(64);
+	memset(data->allocated, 0x5A, 64);
+}
+
+static bool is_filled(const void *p_ptr, uint8_t p_value, int p_size) {
+	for (int i = 0; i < p_size; i++) {
+		if (((const uint8_t *)p_ptr)[i] != p_value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[FrameAllocator] Rewind once everything is freed") {
+	FrameAllocator::begin_frame();
+
+	void *a = FrameAllocator::alloc(64);
+	void *b = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(a != b, "Live allocations should not overlap.");
+	FrameAllocator::free(a);
+	FrameAllocator::free(b);
+
+	void *c = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(c == a, "The arena should be rewound when everything was freed.");
+
+	// Large allocations go to the regular allocator and don't hold the arena.
+	void *large = FrameAllocator::alloc(FrameAllocator::MAX_ARENA_ALLOCATION + 1);
+	memset(large, 0x11, FrameAllocator::MAX_ARENA_ALLOCATION + 1);
+	FrameAllocator::free(c);
+	void *d = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(d == a, "Large allocations should not keep the arena from being rewound.");
+	CHECK(is_filled(large, 0x11, FrameAllocator::MAX_ARENA_ALLOCATION + 1));
+	FrameAllocator::free(large);
+	FrameAllocator::free(d);
+}
+
+TEST_CASE("[FrameAllocator] Free from other threads") {
+	FrameAllocator::begin_frame();
+
+	// Memory of this thread freed by another thread.
+	ThreadData data;
+	data.to_free = FrameAllocator::alloc(64);
+	Thread *thread = Thread::create(alloc_and_free_in_thread, &data);
+	Thread::wait_to_finish(thread);
+	void *a = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(a == data.to_free, "Freeing from another thread should allow the arena to be rewound.");
+	FrameAllocator::free(a);
+
+	// Memory of a thread that already exited, freeing it deletes its arena.
+	REQUIRE(data.allocated);
+	CHECK(is_filled(data.allocated, 0x5A, 64));
+	FrameAllocator::free(data.allocated);
+}
+
+TEST_CASE("[FrameAllocator] Memory kept past its frame") {
+	FrameAllocator::begin_frame();
+
+	void *kept = FrameAllocator::alloc(64);
+	memset(kept, 0x33, 64);
+
+	FrameAllocator::begin_frame();
+	ERR_PRINT_OFF;
+	void *a = FrameAllocator::alloc(64);
+	ERR_PRINT_ON;
+	FrameAllocator::free(a);
+	void *b = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(b == a, "A new arena should be used and rewound while the old memory is alive.");
+	CHECK(is_filled(kept, 0x33, 64));
+
+	FrameAllocator::free(kept);
+	FrameAllocator::free(b);
+}
+
+} // namespace TestFrameAllocator
+
+#endif // TEST_FRAME_ALLOCATOR_H
@@ -0,0 +1,356 @@
+/*************************************************************************/
+/*  test_image.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_IMAGE_H
+#define TEST_IMAGE_H
+
+#include "core/image.h"
+#include "core/job_system.h"
+#include "core/math/random_pcg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestImage {
+
+// Big enough to be split across worker threads.
+static const int IMAGE_SIZE = 320;
+
+static Ref<Image> create_noise_image(int p_width, int p_height, Image::Format p_format) {
+	Ref<Image> image;
+	image.instance();
+	image->create(p_width, p_height, false, p_format);
+
+	RandomPCG rng(0x5eed);
+	for (int y = 0; y < p_height; y++) {
+		for (int x = 0; x < p_width; x++) {
+			image->set_pixel(x, y, Color(rng.randf(), rng.randf(), rng.randf(), rng.randf()));
+		}
+	}
+	return image;
+}
+
+// Runs p_function on a copy of p_image with the engine-wide worker threads
+// stopped (the scalar reference) and with several worker threads running.
+template <class F>
+static void check_parity(const Ref<Image> &p_image, F p_function) {
+	JobSystem *job_system = JobSystem::get_singleton();
+	REQUIRE(job_system);
+	uint32_t thread_count = job_system->get_thread_count();
+
+	job_system->finish();
+	Ref<Image> reference = p_image->duplicate();
+	p_function(reference);
+
+	job_system->init(3);
+	Ref<Image> threaded = p_image->duplicate();
+	p_function(threaded);
+
+	job_system->finish();
+	job_system->init(thread_count);
+
+	CHECK(threaded->get_width() == reference->get_width());
+	CHECK(threaded->get_height() == reference->get_height());
+	CHECK(threaded->get_format() == reference->get_format());
+	Vector<uint8_t> threaded_data = threaded->get_data();
+	Vector<uint8_t> reference_data = reference->get_data();
+	REQUIRE(threaded_data.size() == reference_data.size());
+	CHECK_MESSAGE(memcmp(threaded_data.ptr(), reference_data.ptr(), reference_data.size()) == 0, "Threaded result should match the single threaded one bit for bit.");
+}
+
+TEST_CASE("[Image] Resize parity with the single threaded result") {
+	const Image::Format formats[] = { Image::FORMAT_L8, Image::FORMAT_RGB8, Image::FORMAT_RGBA8, Image::FORMAT_RGBAH, Image::FORMAT_RGBAF };
+	const Image::Interpolation interpolations[] = { Image::INTERPOLATE_NEAREST, Image::INTERPOLATE_BILINEAR, Image::INTERPOLATE_CUBIC, Image::INTERPOLATE_TRILINEAR, Image::INTERPOLATE_LANCZOS };
+
+	for (int i = 0; i < 5; i++) {
+		Ref<Image> image = create_noise_image(IMAGE_SIZE, IMAGE_SIZE, formats[i]);
+		for (int j = 0; j < 5; j++) {
+			INFO(vformat("Format: %s, interpolation: %d.", Image::get_format_name(formats[i]), j).utf8().ptr());
+			// Upscale and downscale, with sizes not matching the thread bands.
+			check_parity(image, [&](Ref<Image> p_image) { p_image->resize(IMAGE_SIZE + 77, IMAGE_SIZE * 2 - 3, interpolations[j]); });
+			check_parity(image, [&](Ref<Image> p_image) { p_image->resize(IMAGE_SIZE / 3, IMAGE_SIZE / 2 + 1, interpolations[j]); });
+		}
+	}
+}
+
+TEST_CASE("[Image] Convert parity with the single threaded result") {
+	const Image::Format formats[] = { Image::FORMAT_L8, Image::FORMAT_LA8, Image::FORMAT_RGB8, Image::FORMAT_RGBA8, Image::FORMAT_RGBAH, Image::FORMAT_RGBAF };
+
+	for (int i = 0; i < 6; i++) {
+		Ref<Image> image = create_noise_image(IMAGE_SIZE, IMAGE_SIZE, formats[i]);
+		for (int j = 0; j < 6; j++) {
+			if (i == j) {
+				continue;
+			}
+			INFO(vformat("From: %s, to: %s.", Image::get_format_name(formats[i]), Image::get_format_name(formats[j])).utf8().ptr());
+			check_parity(image, [&](Ref<Image> p_image) { p_image->convert(formats[j]); });
+		}
+	}
+}
+
+TEST_CASE("[Image] Mipmap parity with the single threaded result") {
+	const Image::Format formats[] = { Image::FORMAT_RGB8, Image::FORMAT_RGBA8, Image::FORMAT_RGBAH, Image::FORMAT_RGBAF };
+
+	for (int i = 0; i < 4; i++) {
+		INFO(vformat("Format: %s.", Image::get_format_name(formats[i])).utf8().ptr());
+		Ref<Image> image = create_noise_image(IMAGE_SIZE * 2, IMAGE_SIZE + 1, formats[i]);
+		check_parity(image, [](Ref<Image> p_image) { p_image->generate_mipmaps(); });
+		check_parity(image, [](Ref<Image> p_image) { p_image->generate_mipmaps(true); });
+	}
+}
+
+// Two of the components of an RGBA8 or RGBAF image, as an RG8 or RGF image.
+static Ref<Image> extract_components(const Ref<Image> &p_image, int p_first) {
+	int component_size = p_image->get_format() == Image::FORMAT_RGBAF ? 4 : 1;
+	Vector<uint8_t> data = p_image->get_data();
+	Vector<uint8_t> components;
+	components.resize(data.size() / 2);
+	for (int i = 0; i < components.size() / (component_size * 2); i++) {
+		memcpy(components.ptrw() + i * component_size * 2, data.ptr() + (i * 4 + p_first) * component_size, component_size * 2);
+	}
+
+	Ref<Image> image;
+	image.instance();
+	image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), component_size == 4 ? Image::FORMAT_RGF : Image::FORMAT_RG8, components);
+	return image;
+}
+
+// RGBA images go through the SIMD kernels where available, RG images don't.
+// Components are computed independently, so both have to give the same values.
+template <class F>
+static void check_rgba_parity(const Ref<Image> &p_image, F p_function) {
+	Ref<Image> rgba = p_image->duplicate();
+	p_function(rgba);
+
+	for (int first = 0; first < 4; first += 2) {
+		Ref<Image> components = extract_components(p_image, first);
+		p_function(components);
+
+		Vector<uint8_t> expected = components->get_data();
+		Vector<uint8_t> result = extract_components(rgba, first)->get_data();
+		REQUIRE(result.size() == expected.size());
+		CHECK_MESSAGE(memcmp(result.ptr(), expected.ptr(), expected.size()) == 0, "RGBA result should match the per component one bit for bit.");
+	}
+}
+
+TEST_CASE("[Image] RGBA kernels match the per component ones") {
+	const Image::Format formats[] = { Image::FORMAT_RGBA8, Image::FORMAT_RGBAF };
+
+	for (int i = 0; i < 2; i++) {
+		INFO(vformat("Format: %s.", Image::get_format_name(formats[i])).utf8().ptr());
+		Ref<Image> image = create_noise_image(IMAGE_SIZE * 2 - 6, IMAGE_SIZE + 1, formats[i]);
+		check_rgba_parity(image, [](Ref<Image> p_image) { p_image->resize(IMAGE_SIZE + 77, IMAGE_SIZE * 2 - 3, Image::INTERPOLATE_BILINEAR); });
+		check_rgba_parity(image, [](Ref<Image> p_image) { p_image->resize(IMAGE_SIZE / 3, IMAGE_SIZE / 2 + 1, Image::INTERPOLATE_BILINEAR); });
+		check_rgba_parity(image, [](Ref<Image> p_image) { p_image->generate_mipmaps(); });
+	}
+}
+
+TEST_CASE("[Image] Mipmaps average each 2x2 block") {
+	Ref<Image> image = create_noise_image(IMAGE_SIZE * 2, IMAGE_SIZE * 2, Image::FORMAT_RGBA8);
+	Vector<uint8_t> base = image->get_data();
+	image->generate_mipmaps();
+
+	Vector<uint8_t> data = image->get_data();
+	int ofs = image->get_mipmap_offset(1);
+	int width = IMAGE_SIZE * 2;
+	bool matches = true;
+	for (int y = 0; y < IMAGE_SIZE; y++) {
+		for (int x = 0; x < IMAGE_SIZE; x++) {
+			for (int c = 0; c < 4; c++) {
+				int a = base[((y * 2) * width + x * 2) * 4 + c];
+				int b = base[((y * 2) * width + x * 2 + 1) * 4 + c];
+				int d = base[((y * 2 + 1) * width + x * 2) * 4 + c];
+				int e = base[((y * 2 + 1) * width + x * 2 + 1) * 4 + c];
+				matches = matches && data[ofs + (y * IMAGE_SIZE + x) * 4 + c] == ((a + b + d + e + 2) >> 2);
+			}
+		}
+	}
+	CHECK(matches);
+}
+
+// Pixels of a 64x48 noise image resized and mipmapped with the single threaded
+// implementation the parallel one replaced.
+struct GoldenPixel {
+	int x;
+	int y;
+	Color color;
+};
+
+static const GoldenPixel RGBA8_LANCZOS_UP[5] = {
+	{ 0, 0, Color(0.596078, 0.886275, 0.913725, 0.337255) },
+	{ 100, 0, Color(0.807843, 0.917647, 0.596078, 0.109804) },
+	{ 50, 25, Color(0.592157, 0.603922, 0.803922, 0.658824) },
+	{ 33, 76, Color(0.47451, 0.513726, 0.180392, 0.619608) },
+	{ 100, 76, Color(0.0, 0.956863, 0.12549, 0.682353) },
+};
+static const GoldenPixel RGBA8_LANCZOS_DOWN[5] = {
+	{ 0, 0, Color(0.466667, 0.411765, 0.403922, 0.529412) },
+	{ 22, 0, Color(0.584314, 0.403922, 0.458824, 0.384314) },
+	{ 11, 6, Color(0.470588, 0.443137, 0.615686, 0.403922) },
+	{ 7, 18, Color(0.541176, 0.486275, 0.466667, 0.403922) },
+	{ 22, 18, Color(0.494118, 0.6, 0.333333, 0.478431) },
+};
+static const GoldenPixel RGBA8_BILINEAR_UP[5] = {
+	{ 0, 0, Color(0.513726, 0.823529, 0.760784, 0.352941) },
+	{ 100, 0, Color(0.792157, 0.878431, 0.509804, 0.078431) },
+	{ 50, 25, Color(0.556863, 0.533333, 0.670588, 0.54902) },
+	{ 33, 76, Color(0.564706, 0.4, 0.258824, 0.505882) },
+	{ 100, 76, Color(0.094118, 0.847059, 0.2, 0.678431) },
+};
+static const GoldenPixel RGBA8_BILINEAR_DOWN[5] = {
+	{ 0, 0, Color(0.337255, 0.854902, 0.717647, 0.568627) },
+	{ 22, 0, Color(0.682353, 0.156863, 0.654902, 0.701961) },
+	{ 11, 6, Color(0.588235, 0.098039, 0.552941, 0.494118) },
+	{ 7, 18, Color(0.654902, 0.423529, 0.627451, 0.462745) },
+	{ 22, 18, Color(0.239216, 0.568627, 0.266667, 0.235294) },
+};
+static const GoldenPixel RGBA8_MIPMAP_1[5] = {
+	{ 0, 0, Color(0.368627, 0.682353, 0.505882, 0.490196) },
+	{ 31, 0, Color(0.737255, 0.517647, 0.47451, 0.345098) },
+	{ 16, 8, Color(0.317647, 0.27451, 0.627451, 0.25098) },
+	{ 10, 23, Color(0.639216, 0.372549, 0.52549, 0.470588) },
+	{ 31, 23, Color(0.337255, 0.603922, 0.341176, 0.501961) },
+};
+static const GoldenPixel RGBA8_MIPMAP_3[5] = {
+	{ 0, 0, Color(0.509804, 0.419608, 0.501961, 0.498039) },
+	{ 7, 0, Color(0.552941, 0.545098, 0.498039, 0.505882) },
+	{ 4, 2, Color(0.478431, 0.494118, 0.4, 0.45098) },
+	{ 2, 5, Color(0.533333, 0.482353, 0.529412, 0.482353) },
+	{ 7, 5, Color(0.478431, 0.521569, 0.486275, 0.486275) },
+};
+static const GoldenPixel RGBAF_LANCZOS_UP[5] = {
+	{ 0, 0, Color(0.595119, 0.885493, 0.91636, 0.338478) },
+	{ 100, 0, Color(0.809246, 0.919534, 0.596965, 0.110553) },
+	{ 50, 25, Color(0.592368, 0.606653, 0.805971, 0.660939) },
+	{ 33, 76, Color(0.475466, 0.5136, 0.184278, 0.621859) },
+	{ 100, 76, Color(-0.010487, 0.957916, 0.126279, 0.683372) },
+};
+static const GoldenPixel RGBAF_LANCZOS_DOWN[5] = {
+	{ 0, 0, Color(0.468457, 0.414708, 0.407798, 0.532537) },
+	{ 22, 0, Color(0.583999, 0.406209, 0.460717, 0.386151) },
+	{ 11, 6, Color(0.473377, 0.444846, 0.616437, 0.404148) },
+	{ 7, 18, Color(0.544197, 0.487701, 0.468999, 0.406189) },
+	{ 22, 18, Color(0.497057, 0.601512, 0.334445, 0.482047) },
+};
+static const GoldenPixel RGBAF_BILINEAR_UP[5] = {
+	{ 0, 0, Color(0.514669, 0.82383, 0.761838, 0.35539) },
+	{ 100, 0, Color(0.794227, 0.880426, 0.511097, 0.080604) },
+	{ 50, 25, Color(0.56037, 0.536762, 0.673439, 0.551069) },
+	{ 33, 76, Color(0.567279, 0.405499, 0.264143, 0.509626) },
+	{ 100, 76, Color(0.097964, 0.847425, 0.201835, 0.679247) },
+};
+static const GoldenPixel RGBAF_BILINEAR_DOWN[5] = {
+	{ 0, 0, Color(0.340287, 0.861744, 0.719019, 0.572558) },
+	{ 22, 0, Color(0.686615, 0.162457, 0.660074, 0.706053) },
+	{ 11, 6, Color(0.590017, 0.103266, 0.557859, 0.498257) },
+	{ 7, 18, Color(0.658492, 0.425878, 0.629856, 0.465021) },
+	{ 22, 18, Color(0.242123, 0.571012, 0.271285, 0.237259) },
+};
+static const GoldenPixel RGBAF_MIPMAP_1[5] = {
+	{ 0, 0, Color(0.371206, 0.685188, 0.507369, 0.490153) },
+	{ 31, 0, Color(0.737096, 0.518784, 0.47709, 0.348208) },
+	{ 16, 8, Color(0.319471, 0.277302, 0.630221, 0.250755) },
+	{ 10, 23, Color(0.639804, 0.374677, 0.528619, 0.470017) },
+	{ 31, 23, Color(0.340419, 0.604043, 0.342076, 0.50486) },
+};
+static const GoldenPixel RGBAF_MIPMAP_3[5] = {
+	{ 0, 0, Color(0.508131, 0.421167, 0.503939, 0.498306) },
+	{ 7, 0, Color(0.552221, 0.543408, 0.497465, 0.505191) },
+	{ 4, 2, Color(0.479751, 0.494347, 0.400694, 0.450417) },
+	{ 2, 5, Color(0.532955, 0.483586, 0.529215, 0.481166) },
+	{ 7, 5, Color(0.479799, 0.52343, 0.48712, 0.484863) },
+};
+
+static Ref<Image> get_mipmap(const Ref<Image> &p_image, int p_mipmap) {
+	int ofs;
+	int size;
+	p_image->get_mipmap_offset_and_size(p_mipmap, ofs, size);
+	Vector<uint8_t> data = p_image->get_data();
+
+	Vector<uint8_t> mipmap_data;
+	mipmap_data.resize(size);
+	memcpy(mipmap_data.ptrw(), data.ptr() + ofs, size);
+
+	Ref<Image> mipmap;
+	mipmap.instance();
+	mipmap->create(MAX(p_image->get_width() >> p_mipmap, 1), MAX(p_image->get_height() >> p_mipmap, 1), false, p_image->get_format(), mipmap_data);
+	return mipmap;
+}
+
+static void check_golden(const Ref<Image> &p_image, const GoldenPixel *p_golden, float p_tolerance) {
+	for (int i = 0; i < 5; i++) {
+		const GoldenPixel &golden = p_golden[i];
+		Color color = p_image->get_pixel(golden.x, golden.y);
+		INFO(vformat("Pixel (%d, %d): %s, expected %s.", golden.x, golden.y, color, golden.color).utf8().ptr());
+		CHECK(Math::abs(color.r - golden.color.r) <= p_tolerance);
+		CHECK(Math::abs(color.g - golden.color.g) <= p_tolerance);
+		CHECK(Math::abs(color.b - golden.color.b) <= p_tolerance);
+		CHECK(Math::abs(color.a - golden.color.a) <= p_tolerance);
+	}
+}
+
+TEST_CASE("[Image] Resize and mipmaps match the previous implementation") {
+	const Image::Format formats[] = { Image::FORMAT_RGBA8, Image::FORMAT_RGBAF };
+	const GoldenPixel *goldens[2][6] = {
+		{ RGBA8_LANCZOS_UP, RGBA8_LANCZOS_DOWN, RGBA8_BILINEAR_UP, RGBA8_BILINEAR_DOWN, RGBA8_MIPMAP_1, RGBA8_MIPMAP_3 },
+		{ RGBAF_LANCZOS_UP, RGBAF_LANCZOS_DOWN, RGBAF_BILINEAR_UP, RGBAF_BILINEAR_DOWN, RGBAF_MIPMAP_1, RGBAF_MIPMAP_3 },
+	};
+	// Up to one step of 8 bit rounding.
+	const float tolerances[] = { 1.0 / 255.0 + CMP_EPSILON, 1e-4 };
+
+	for (int i = 0; i < 2; i++) {
+		INFO(vformat("Format: %s.", Image::get_format_name(formats[i])).utf8().ptr());
+		const Ref<Image> image = create_noise_image(64, 48, formats[i]);
+
+		Ref<Image> resized = image->duplicate();
+		resized->resize(101, 77, Image::INTERPOLATE_LANCZOS);
+		check_golden(resized, goldens[i][0], tolerances[i]);
+
+		resized = image->duplicate();
+		resized->resize(23, 19, Image::INTERPOLATE_LANCZOS);
+		check_golden(resized, goldens[i][1], tolerances[i]);
+
+		resized = image->duplicate();
+		resized->resize(101, 77, Image::INTERPOLATE_BILINEAR);
+		check_golden(resized, goldens[i][2], tolerances[i]);
+
+		resized = image->duplicate();
+		resized->resize(23, 19, Image::INTERPOLATE_BILINEAR);
+		check_golden(resized, goldens[i][3], tolerances[i]);
+
+		Ref<Image> mipmapped = image->duplicate();
+		mipmapped->generate_mipmaps();
+		check_golden(get_mipmap(mipmapped, 1), goldens[i][4], tolerances[i]);
+		check_golden(get_mipmap(mipmapped, 3), goldens[i][5], tolerances[i]);
+	}
+}
+
+} // namespace TestImage
+
+#endif // TEST_IMAGE_H
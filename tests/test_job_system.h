@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  test_job_system.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_JOB_SYSTEM_H
+#define TEST_JOB_SYSTEM_H
+
+#include "core/job_system.h"
+
+#include "tests/test_macros.h"
+
+namespace TestJobSystem {
+
+struct Counter {
+	std::atomic<uint64_t> sum;
+	std::atomic<uint32_t> order;
+	uint32_t first_stamp = 0;
+	uint32_t second_stamp = 0;
+
+	void add(uint32_t p_index, uint32_t p_multiplier) {
+		sum.fetch_add(p_index * p_multiplier);
+	}
+
+	void nested(uint32_t p_index, JobSystem *p_job_system) {
+		p_job_system->parallel_for(100, this, &Counter::add, 1);
+	}
+
+	void first(int p_unused) {
+		first_stamp = order.fetch_add(1) + 1;
+	}
+
+	void second(int p_unused) {
+		second_stamp = order.fetch_add(1) + 1;
+	}
+
+	Counter() {
+		sum.store(0);
+		order.store(0);
+	}
+};
+
+TEST_CASE("[JobSystem] Parallel for visits every element once") {
+	for (int threads = 0; threads < 4; threads++) {
+		JobSystem job_system;
+		job_system.init(threads);
+
+		Counter counter;
+		job_system.parallel_for(1000, &counter, &Counter::add, 2);
+		CHECK_MESSAGE(counter.sum.load() == 999000, "Every index should be processed exactly once.");
+	}
+}
+
+TEST_CASE("[JobSystem] Nested parallel for") {
+	JobSystem job_system;
+	job_system.init(3);
+
+	Counter counter;
+	job_system.parallel_for(50, &counter, &Counter::nested, &job_system);
+	CHECK(counter.sum.load() == 50 * 4950);
+}
+
+TEST_CASE("[JobSystem] Dependencies run in order") {
+	for (int threads = 0; threads < 4; threads++) {
+		JobSystem job_system;
+		job_system.init(threads);
+
+		Counter counter;
+		JobSystem::Handle first = job_system.add_job(&counter, &Counter::first, 0);
+		JobSystem::Handle second = job_system.add_job(&counter, &Counter::second, 0, &first, 1);
+		JobSystem::Handle group = job_system.add_group_job(10, &counter, &Counter::add, 1, &second, 1);
+		group.wait();
+
+		CHECK(first.is_completed());
+		CHECK(second.is_completed());
+		CHECK(counter.first_stamp == 1);
+		CHECK(counter.second_stamp == 2);
+		CHECK(counter.sum.load() == 45);
+		CHECK(group.get_completed_elements() == 10);
+	}
+}
+
+TEST_CASE("[JobSystem] Empty group completes") {
+	JobSystem job_system;
+	job_system.init(2);
+
+	Counter counter;
+	JobSystem::Handle handle = job_system.add_group_job(0, &counter, &Counter::add, 1);
+	handle.wait();
+	CHECK(handle.is_completed());
+	CHECK(counter.sum.load() == 0);
+}
+
+} // namespace TestJobSystem
+
+#endif // TEST_JOB_SYSTEM_H
@@ -31,22 +31,49 @@
 #include "test_main.h"
 
 #include "core/list.h"
+#include "core/message_queue.h"
+#include "core/project_settings.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "scene/main/scene_tree.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering/rendering_server_raster.h"
+#include "tests/display_server_headless.h"
 
+#include "test_animation.h"
 #include "test_astar.h"
+#include "test_audio_server.h"
 #include "test_basis.h"
+#include "test_broad_phase_2d.h"
 #include "test_class_db.h"
 #include "test_color.h"
+#include "test_command_queue.h"
+#include "test_dynamic_bvh.h"
 #include "test_expression.h"
+#include "test_file_access_compressed.h"
+#include "test_file_access_pack.h"
+#include "test_file_access_unix.h"
+#include "test_frame_allocator.h"
 #include "test_gradient.h"
 #include "test_gui.h"
+#include "test_image.h"
+#include "test_job_system.h"
 #include "test_list.h"
 #include "test_math.h"
+#include "test_message_queue.h"
+#include "test_multiplayer_api.h"
+#include "test_node.h"
+#include "test_node_3d.h"
+#include "test_object.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics_2d.h"
+#include "test_physics_2d_sw.h"
 #include "test_physics_3d.h"
 #include "test_render.h"
+#include "test_resource_loader.h"
 #include "test_shader_lang.h"
+#include "test_skeleton_3d.h"
 #include "test_string.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
@@ -55,6 +82,78 @@
 
 #include "tests/test_macros.h"
 
+// Runs test cases tagged with "[SceneTree]" inside a SceneTree, with
+// servers that don't need a display or a GPU.
+struct SceneTreeTestListener : public doctest::IReporter {
+	MessageQueue *message_queue = nullptr;
+	DisplayServer *display_server = nullptr;
+	RenderingServer *rendering_server = nullptr;
+	PhysicsServer3D *physics_server_3d = nullptr;
+	PhysicsServer2D *physics_server_2d = nullptr;
+	SceneTree *scene_tree = nullptr;
+
+	SceneTreeTestListener(const doctest::ContextOptions &p_in) {}
+
+	void test_case_start(const doctest::TestCaseData &p_in) override {
+		if (String(p_in.m_name).find("[SceneTree]") == -1) {
+			return;
+		}
+
+		GLOBAL_DEF("memory/limits/multithreaded_server/rid_pool_prealloc", 60);
+		message_queue = memnew(MessageQueue);
+		display_server = memnew(DisplayServerHeadless);
+
+		// The server feature callback queries the rendering server while it is being constructed.
+		OS::get_singleton()->set_has_server_feature_callback(nullptr);
+		RasterizerDummy::make_current();
+		rendering_server = memnew(RenderingServerRaster);
+		rendering_server->init();
+
+		physics_server_3d = PhysicsServer3DManager::new_default_server();
+		physics_server_3d->init();
+		physics_server_2d = PhysicsServer2DManager::new_default_server();
+		physics_server_2d->init();
+
+		scene_tree = memnew(SceneTree);
+		scene_tree->init();
+	}
+
+	void test_case_end(const doctest::CurrentTestCaseStats &) override {
+		if (!scene_tree) {
+			return;
+		}
+
+		scene_tree->finish();
+		memdelete(scene_tree);
+		scene_tree = nullptr;
+		message_queue->flush();
+
+		physics_server_2d->finish();
+		memdelete(physics_server_2d);
+		physics_server_3d->finish();
+		memdelete(physics_server_3d);
+
+		rendering_server->finish();
+		memdelete(rendering_server);
+
+		memdelete(display_server);
+		memdelete(message_queue);
+	}
+
+	void report_query(const doctest::QueryData &) override {}
+	void test_run_start() override {}
+	void test_run_end(const doctest::TestRunStats &) override {}
+	void test_case_reenter(const doctest::TestCaseData &) override {}
+	void test_case_exception(const doctest::TestCaseException &) override {}
+	void subcase_start(const doctest::SubcaseSignature &) override {}
+	void subcase_end() override {}
+	void log_assert(const doctest::AssertData &) override {}
+	void log_message(const doctest::MessageData &) override {}
+	void test_case_skipped(const doctest::TestCaseData &) override {}
+};
+
+REGISTER_LISTENER("SceneTreeTestListener", 1, SceneTreeTestListener);
+
 int test_main(int argc, char *argv[]) {
 	bool run_tests = true;
 
@@ -0,0 +1,235 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/message_queue.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+struct Log {
+	Object *object = nullptr;
+	LocalVector<int> values;
+};
+
+// Records its value in the log when called.
+class RecordCallable : public CallableCustom {
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a < p_b;
+	}
+
+protected:
+	Log *log;
+	int value;
+
+public:
+	uint32_t hash() const override { return value; }
+	String get_as_text() const override { return "RecordCallable"; }
+	CompareEqualFunc get_compare_equal_func() const override { return compare_equal; }
+	CompareLessFunc get_compare_less_func() const override { return compare_less; }
+	ObjectID get_object() const override { return log->object->get_instance_id(); }
+
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override {
+		log->values.push_back(p_argcount ? int(*p_arguments[0]) : value);
+		r_call_error.error = Callable::CallError::CALL_OK;
+	}
+
+	RecordCallable(Log *p_log, int p_value) {
+		log = p_log;
+		value = p_value;
+	}
+};
+
+// Pushes another message when called, which has to run in the same flush.
+class RequeueCallable : public RecordCallable {
+public:
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override {
+		RecordCallable::call(p_arguments, p_argcount, r_return_value, r_call_error);
+		MessageQueue::get_singleton()->push_callable(Callable(memnew(RecordCallable(log, 2))));
+	}
+
+	RequeueCallable(Log *p_log) :
+			RecordCallable(p_log, 1) {}
+};
+
+void push_from_thread(void *p_log) {
+	MessageQueue::get_singleton()->push_callable(Callable(memnew(RecordCallable((Log *)p_log, 1))));
+}
+
+struct FlushSync {
+	Log *log = nullptr;
+	Semaphore pushed;
+	Semaphore flushed;
+};
+
+void push_and_wait_for_flush(void *p_sync) {
+	FlushSync *sync = (FlushSync *)p_sync;
+	push_from_thread(sync->log);
+	sync->pushed.post();
+	sync->flushed.wait();
+}
+
+TEST_CASE("[MessageQueue] Messages are flushed in push order and the queue grows") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Log log;
+	log.object = memnew(Object);
+
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		Variant arg = i;
+		const Variant *argptr = &arg;
+		CHECK(message_queue->push_callable(Callable(memnew(RecordCallable(&log, 0))), &argptr, 1) == OK);
+	}
+	message_queue->flush();
+
+	REQUIRE(log.values.size() == count);
+	bool ordered = true;
+	for (int i = 0; i < count; i++) {
+		ordered = ordered && log.values[i] == i;
+	}
+	CHECK_MESSAGE(ordered, "Messages should be called in the order they were pushed.");
+	CHECK(message_queue->get_max_buffer_usage() > 16384);
+
+	memdelete(log.object);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Messages from other threads keep the push order") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Log log;
+	log.object = memnew(Object);
+
+	message_queue->push_callable(Callable(memnew(RecordCallable(&log, 0))));
+	Thread *thread = Thread::create(push_from_thread, &log);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	message_queue->push_callable(Callable(memnew(RecordCallable(&log, 2))));
+	message_queue->flush();
+
+	REQUIRE(log.values.size() == 3);
+	CHECK(log.values[0] == 0);
+	CHECK(log.values[1] == 1);
+	CHECK(log.values[2] == 2);
+
+	memdelete(log.object);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Queues of exited threads are freed") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Log log;
+	log.object = memnew(Object);
+
+	message_queue->push_callable(Callable(memnew(RecordCallable(&log, 0))));
+	CHECK(message_queue->get_thread_queue_count() == 1);
+
+	// Pending messages are still flushed after their thread exits.
+	Thread *thread = nullptr;
+	for (int i = 0; i < 4; i++) {
+		thread = Thread::create(push_from_thread, &log);
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+	}
+	CHECK(message_queue->get_thread_queue_count() == 5);
+	message_queue->flush();
+	CHECK(log.values.size() == 5);
+	CHECK(message_queue->get_thread_queue_count() == 1);
+
+	// Queues already flushed are freed when their thread exits.
+	FlushSync sync;
+	sync.log = &log;
+	thread = Thread::create(push_and_wait_for_flush, &sync);
+	sync.pushed.wait();
+	CHECK(message_queue->get_thread_queue_count() == 2);
+	message_queue->flush();
+	sync.flushed.post();
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	CHECK(log.values.size() == 6);
+	CHECK(message_queue->get_thread_queue_count() == 1);
+
+	memdelete(log.object);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Messages pushed while flushing are flushed too") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Log log;
+	log.object = memnew(Object);
+
+	message_queue->push_callable(Callable(memnew(RequeueCallable(&log))));
+	message_queue->flush();
+
+	REQUIRE(log.values.size() == 2);
+	CHECK(log.values[0] == 1);
+	CHECK(log.values[1] == 2);
+	CHECK_FALSE(message_queue->is_flushing());
+
+	memdelete(log.object);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Duplicate pending notifications are coalesced") {
+	Object *object = memnew(Object);
+
+	MessageQueue *message_queue = memnew(MessageQueue);
+	message_queue->push_notification(object, 1000);
+	message_queue->flush();
+	int single_usage = message_queue->get_max_buffer_usage();
+	memdelete(message_queue);
+
+	message_queue = memnew(MessageQueue);
+	message_queue->push_notification(object, 1000);
+	message_queue->push_notification(object, 1000);
+	message_queue->flush();
+	CHECK_MESSAGE(message_queue->get_max_buffer_usage() == single_usage, "The second notification should not be queued.");
+
+	// Once flushed, the notification can be queued again.
+	message_queue->push_notification(object, 1000);
+	message_queue->push_notification(object, 1001);
+	message_queue->flush();
+	CHECK(message_queue->get_max_buffer_usage() == single_usage * 2);
+	memdelete(message_queue);
+
+	memdelete(object);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -0,0 +1,475 @@
+/*************************************************************************/
+/*  test_multiplayer_api.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MULTIPLAYER_API_H
+#define TEST_MULTIPLAYER_API_H
+
+#include "core/io/marshalls.h"
+#include "core/io/multiplayer_api.h"
+#include "core/io/networked_multiplayer_peer.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMultiplayerAPI {
+
+// Hands packets straight to the remote peers and keeps a copy of everything sent.
+class LoopbackPeer : public NetworkedMultiplayerPeer {
+public:
+	struct Packet {
+		int peer = 0;
+		TransferMode mode = TRANSFER_MODE_RELIABLE;
+		Vector<uint8_t> data;
+	};
+
+	int unique_id = 1;
+	Map<int, LoopbackPeer *> remotes;
+	bool dropping = false; // Packets are recorded but never arrive.
+	Vector<Packet> sent;
+
+	List<Packet> incoming;
+	Vector<uint8_t> current;
+	TransferMode transfer_mode = TRANSFER_MODE_RELIABLE;
+	int target_peer = 0;
+
+	virtual int get_available_packet_count() const override { return incoming.size(); }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) override {
+		ERR_FAIL_COND_V(incoming.empty(), ERR_UNAVAILABLE);
+		current = incoming.front()->get().data;
+		incoming.pop_front();
+		*r_buffer = current.ptr();
+		r_buffer_size = current.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) override {
+		Packet packet;
+		packet.peer = target_peer;
+		packet.mode = transfer_mode;
+		packet.data.resize(p_buffer_size);
+		memcpy(packet.data.ptrw(), p_buffer, p_buffer_size);
+		sent.push_back(packet);
+
+		if (dropping) {
+			return OK;
+		}
+		const int target = packet.peer;
+		packet.peer = unique_id;
+		for (Map<int, LoopbackPeer *>::Element *E = remotes.front(); E; E = E->next()) {
+			if (target == 0 || target == E->key() || (target < 0 && -target != E->key())) {
+				E->get()->incoming.push_back(packet);
+			}
+		}
+		return OK;
+	}
+
+	virtual int get_max_packet_size() const override { return 1 << 24; }
+
+	virtual void set_transfer_mode(TransferMode p_mode) override { transfer_mode = p_mode; }
+	virtual TransferMode get_transfer_mode() const override { return transfer_mode; }
+	virtual void set_target_peer(int p_peer_id) override { target_peer = p_peer_id; }
+	virtual int get_packet_peer() const override { return incoming.empty() ? 0 : incoming.front()->get().peer; }
+	virtual bool is_server() const override { return unique_id == 1; }
+	virtual void poll() override {}
+	virtual int get_unique_id() const override { return unique_id; }
+	virtual void set_refuse_new_connections(bool p_enable) override {}
+	virtual bool is_refusing_new_connections() const override { return false; }
+	virtual ConnectionStatus get_connection_status() const override { return CONNECTION_CONNECTED; }
+};
+
+// A server (peer 1) and a client (peer 2), optionally with a second client
+// (peer 3). Each has its own root holding a "Player" node mastered by the server.
+struct Session {
+	Ref<LoopbackPeer> server_peer;
+	Ref<LoopbackPeer> client_peer;
+	Ref<LoopbackPeer> second_peer;
+	Ref<MultiplayerAPI> server;
+	Ref<MultiplayerAPI> client;
+	Ref<MultiplayerAPI> second;
+	Node *server_root = nullptr;
+	Node *client_root = nullptr;
+	Node *second_root = nullptr;
+	Node2D *server_player = nullptr;
+	Node2D *client_player = nullptr;
+	Node2D *second_player = nullptr;
+
+	static Node2D *add_player(Node *p_root, const Ref<MultiplayerAPI> &p_api) {
+		Node2D *player = memnew(Node2D);
+		player->set_name("Player");
+		player->set_custom_multiplayer(p_api);
+		p_root->add_child(player);
+		return player;
+	}
+
+	// Paths take two rounds to be confirmed, and acknowledgments are only
+	// processed after the next snapshot went out, so syncing takes four.
+	void pump(int p_times) {
+		for (int i = 0; i < p_times; i++) {
+			server->poll();
+			client->poll();
+			if (second.is_valid()) {
+				second->poll();
+			}
+		}
+	}
+
+	// Connects a client with the given id to the server.
+	void add_client(int p_id, const String &p_name, Ref<LoopbackPeer> &r_peer, Ref<MultiplayerAPI> &r_api, Node *&r_root, Node2D *&r_player) {
+		r_peer.instance();
+		r_peer->unique_id = p_id;
+		r_peer->remotes[1] = server_peer.ptr();
+		server_peer->remotes[p_id] = r_peer.ptr();
+
+		r_root = memnew(Node);
+		r_root->set_name(p_name);
+		SceneTree::get_singleton()->get_root()->add_child(r_root);
+
+		r_api.instance();
+		r_api->set_root_node(r_root);
+		r_api->set_network_peer(r_peer);
+		r_api->_add_peer(1);
+		server->_add_peer(p_id);
+
+		r_player = add_player(r_root, r_api);
+	}
+
+	Session(int p_clients = 1) {
+		server_peer.instance();
+		server_peer->unique_id = 1;
+
+		server_root = memnew(Node);
+		server_root->set_name("Server");
+		SceneTree::get_singleton()->get_root()->add_child(server_root);
+
+		server.instance();
+		server->set_root_node(server_root);
+		server->set_network_peer(server_peer);
+		server_player = add_player(server_root, server);
+
+		add_client(2, "Client", client_peer, client, client_root, client_player);
+		if (p_clients > 1) {
+			add_client(3, "Second", second_peer, second, second_root, second_player);
+		}
+	}
+
+	~Session() {
+		server->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+		client->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+		memdelete(server_root);
+		memdelete(client_root);
+		if (second.is_valid()) {
+			second->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+			memdelete(second_root);
+		}
+	}
+};
+
+// Returns the last snapshot the peer sent, or an empty packet.
+static Vector<uint8_t> last_snapshot(const Ref<LoopbackPeer> &p_peer) {
+	for (int i = p_peer->sent.size() - 1; i >= 0; i--) {
+		const Vector<uint8_t> &data = p_peer->sent[i].data;
+		if (data.size() && data[0] == MultiplayerAPI::NETWORK_COMMAND_SNAPSHOT) {
+			return data;
+		}
+	}
+	return Vector<uint8_t>();
+}
+
+// Snapshots start with the command, sequence and base sequence, and the first
+// node block with its path cache id and changed properties mask.
+static uint32_t snapshot_base(const Vector<uint8_t> &p_snapshot) {
+	return decode_uint32(&p_snapshot[5]);
+}
+
+static uint32_t snapshot_first_mask(const Vector<uint8_t> &p_snapshot) {
+	return decode_uint32(&p_snapshot[13]);
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Batched packets") {
+	Session session;
+	session.server->set_rpc_batching(true);
+	session.server_player->rset_config("position", MultiplayerAPI::RPC_MODE_REMOTE);
+	session.server_player->rset_config("rotation", MultiplayerAPI::RPC_MODE_REMOTE);
+	session.server_player->rset_config("z_index", MultiplayerAPI::RPC_MODE_REMOTE);
+	session.client_player->rset_config("position", MultiplayerAPI::RPC_MODE_REMOTE);
+	session.client_player->rset_config("rotation", MultiplayerAPI::RPC_MODE_REMOTE);
+	session.client_player->rset_config("z_index", MultiplayerAPI::RPC_MODE_REMOTE);
+
+	session.server_player->rset("position", Vector2(1, 2));
+	session.server_player->rset("rotation", 0.5);
+	session.server_player->rset("z_index", 3);
+	CHECK_MESSAGE(session.server_peer->sent.empty(), "Packets should wait for the next poll.");
+
+	session.server->poll();
+	REQUIRE(session.server_peer->sent.size() == 1);
+	const Vector<uint8_t> batch = session.server_peer->sent[0].data;
+	CHECK(batch[0] == MultiplayerAPI::NETWORK_COMMAND_BATCH);
+
+	// Each packet is prefixed with its length, and the lengths add up to the batch.
+	int ofs = 1;
+	int count = 0;
+	while (ofs + 2 <= batch.size()) {
+		const int len = decode_uint16(&batch[ofs]);
+		ofs += 2;
+		REQUIRE(len > 0);
+		REQUIRE(ofs + len <= batch.size());
+		CHECK((batch[ofs] & 7) != MultiplayerAPI::NETWORK_COMMAND_BATCH);
+		ofs += len;
+		count++;
+	}
+	CHECK(ofs == batch.size());
+	CHECK(count >= 3);
+
+	session.client->poll();
+	CHECK(session.client_player->get_position() == Vector2(1, 2));
+	CHECK(session.client_player->get_rotation() == doctest::Approx(0.5));
+	CHECK(session.client_player->get_z_index() == 3);
+
+	// A single queued packet is sent without the batch header.
+	session.server->poll();
+	session.server_peer->sent.clear();
+	session.server_player->rset("z_index", 4);
+	session.server->poll();
+	REQUIRE(session.server_peer->sent.size() == 1);
+	CHECK((session.server_peer->sent[0].data[0] & 7) == MultiplayerAPI::NETWORK_COMMAND_REMOTE_SET);
+	session.client->poll();
+	CHECK(session.client_player->get_z_index() == 4);
+
+	// Packets of different transfer modes don't share a batch.
+	session.server_peer->sent.clear();
+	session.server_player->rset_unreliable("rotation", 1.0);
+	session.server_player->rset("z_index", 5);
+	session.server->poll();
+	REQUIRE(session.server_peer->sent.size() == 2);
+	CHECK(session.server_peer->sent[0].mode != session.server_peer->sent[1].mode);
+	session.client->poll();
+	CHECK(session.client_player->get_rotation() == doctest::Approx(1.0));
+	CHECK(session.client_player->get_z_index() == 5);
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Reliable packets for different peers share batches") {
+	Session session(2);
+	session.server->set_rpc_batching(true);
+	Node2D *players[3] = { session.server_player, session.client_player, session.second_player };
+	for (int i = 0; i < 3; i++) {
+		players[i]->rset_config("z_index", MultiplayerAPI::RPC_MODE_REMOTE);
+	}
+
+	// Sent to each client in turn, but queued in one batch per client.
+	for (int i = 1; i <= 5; i++) {
+		session.server_player->rset_id(2, "z_index", i);
+		session.server_player->rset_id(3, "z_index", i * 10);
+	}
+	CHECK(session.server_peer->sent.empty());
+
+	session.server->poll();
+	REQUIRE(session.server_peer->sent.size() == 2);
+	CHECK(session.server_peer->sent[0].peer == 2);
+	CHECK(session.server_peer->sent[1].peer == 3);
+	CHECK(session.server_peer->sent[0].data[0] == MultiplayerAPI::NETWORK_COMMAND_BATCH);
+	CHECK(session.server_peer->sent[1].data[0] == MultiplayerAPI::NETWORK_COMMAND_BATCH);
+
+	session.client->poll();
+	session.second->poll();
+	CHECK(session.client_player->get_z_index() == 5);
+	CHECK(session.second_player->get_z_index() == 50);
+
+	// A broadcast in between reaches both clients, so what follows it can't
+	// join the older batches, but each client still gets everything in order.
+	session.server->poll();
+	session.server_peer->sent.clear();
+	session.server_player->rset_id(2, "z_index", 6);
+	session.server_player->rset("z_index", 7);
+	session.server_player->rset_id(2, "z_index", 8);
+	session.server_player->rset_id(-2, "z_index", 9);
+	session.server->poll();
+	session.client->poll();
+	session.second->poll();
+	CHECK(session.client_player->get_z_index() == 8);
+	CHECK(session.second_player->get_z_index() == 9);
+	CHECK(session.server_peer->sent.size() == 4);
+
+	// Excluding a client doesn't hold back packets for it.
+	session.server_peer->sent.clear();
+	session.server_player->rset_id(2, "z_index", 10);
+	session.server_player->rset_id(-2, "z_index", 11);
+	session.server_player->rset_id(2, "z_index", 12);
+	session.server->poll();
+	CHECK(session.server_peer->sent.size() == 2);
+	session.client->poll();
+	session.second->poll();
+	CHECK(session.client_player->get_z_index() == 12);
+	CHECK(session.second_player->get_z_index() == 11);
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Snapshots send quantized deltas of changed properties") {
+	Session session;
+	Vector<String> properties;
+	properties.push_back("position");
+	properties.push_back("rotation");
+	session.server->replicate(session.server_player, properties, 0.01);
+	session.client->replicate(session.client_player, properties, 0.01);
+
+	session.server_player->set_position(Vector2(1.234, -5.678));
+	session.server_player->set_rotation(0.5);
+	session.pump(4);
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(1.23, -5.68)));
+	CHECK(session.client_player->get_rotation() == doctest::Approx(0.5));
+
+	// Only the rotation changed, so only it is sent, against an acknowledged snapshot.
+	session.server_peer->sent.clear();
+	session.server_player->set_rotation(0.25);
+	session.server->poll();
+	const Vector<uint8_t> snapshot = last_snapshot(session.server_peer);
+	REQUIRE(snapshot.size() > 17);
+	CHECK(snapshot_base(snapshot) != 0);
+	CHECK(snapshot_first_mask(snapshot) == 2);
+
+	session.client->poll();
+	CHECK(session.client_player->get_rotation() == doctest::Approx(0.25));
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(1.23, -5.68)));
+
+	// Values off the quantization step are rounded to it.
+	session.server_player->set_rotation(-0.126);
+	session.pump(1);
+	CHECK(session.client_player->get_rotation() == doctest::Approx(-0.13));
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Snapshots send values that can't be quantized as they are") {
+	Session session;
+	Vector<String> properties;
+	properties.push_back("position");
+	session.server->replicate(session.server_player, properties, 0.01);
+	session.client->replicate(session.client_player, properties, 0.01);
+
+	session.server_player->set_position(Vector2(Math_INF, 1));
+	session.pump(4);
+	CHECK(Math::is_inf(session.client_player->get_position().x));
+	CHECK(session.client_player->get_position().y == doctest::Approx(1));
+
+	// Way past the 64-bit range once divided by the step.
+	session.server_player->set_position(Vector2(1e30, -1e30));
+	session.pump(1);
+	CHECK(session.client_player->get_position() == Vector2(1e30, -1e30));
+
+	// And back to a value that can, against a base that couldn't.
+	session.server_player->set_position(Vector2(1.5, 2.5));
+	session.pump(1);
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(1.5, 2.5)));
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Snapshots rebase on the last acknowledged snapshot") {
+	Session session;
+	Vector<String> properties;
+	properties.push_back("position");
+	session.server->replicate(session.server_player, properties, 0.01);
+	session.client->replicate(session.client_player, properties, 0.01);
+
+	session.server_player->set_position(Vector2(1, 1));
+	session.pump(4);
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(1, 1)));
+
+	// Acknowledgments get lost, so snapshots stay relative to the last one that arrived.
+	session.client_peer->dropping = true;
+	session.pump(1);
+
+	session.server_player->set_position(Vector2(2, 1));
+	session.server->poll();
+	const uint32_t acked = snapshot_base(last_snapshot(session.server_peer));
+	CHECK(acked != 0);
+	session.client->poll();
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(2, 1)));
+
+	session.server_player->set_position(Vector2(3, 1));
+	session.server->poll();
+	CHECK(snapshot_base(last_snapshot(session.server_peer)) == acked);
+	CHECK(snapshot_first_mask(last_snapshot(session.server_peer)) == 1);
+	session.client->poll();
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(3, 1)));
+
+	// Going back to the acknowledged value sends nothing for the node, but still applies.
+	session.server_player->set_position(Vector2(1, 1));
+	session.server->poll();
+	CHECK(last_snapshot(session.server_peer).size() == 9);
+	session.client->poll();
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(1, 1)));
+
+	// Once acknowledgments arrive again, the base moves forward.
+	session.client_peer->dropping = false;
+	session.server_player->set_position(Vector2(4, 1));
+	session.pump(2);
+	session.server->poll();
+	CHECK(snapshot_base(last_snapshot(session.server_peer)) > acked);
+	session.client->poll();
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(4, 1)));
+
+	// A lost snapshot doesn't matter, the next one is against an acknowledged base.
+	session.server_peer->dropping = true;
+	session.server_player->set_position(Vector2(5, 2));
+	session.server->poll();
+	session.server_peer->dropping = false;
+	session.client->poll();
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(4, 1)));
+
+	session.server_player->set_position(Vector2(6, 3));
+	session.pump(1);
+	CHECK(session.client_player->get_position().is_equal_approx(Vector2(6, 3)));
+}
+
+TEST_CASE("[SceneTree][MultiplayerAPI] Snapshots with 32 properties") {
+	Session session;
+	// The last property uses the highest bit of the mask.
+	Vector<String> properties;
+	for (int i = 0; i < 31; i++) {
+		properties.push_back("z_index");
+	}
+	properties.push_back("position");
+	session.server->replicate(session.server_player, properties);
+	session.client->replicate(session.client_player, properties);
+
+	session.server_player->set_z_index(2);
+	session.server_player->set_position(Vector2(1, 2));
+	session.pump(4);
+	CHECK(session.client_player->get_z_index() == 2);
+	CHECK(session.client_player->get_position() == Vector2(1, 2));
+
+	session.server_player->set_position(Vector2(3, 4));
+	session.server->poll();
+	CHECK(snapshot_first_mask(last_snapshot(session.server_peer)) == 0x80000000u);
+	session.client->poll();
+	CHECK(session.client_player->get_position() == Vector2(3, 4));
+}
+
+} // namespace TestMultiplayerAPI
+
+#endif // TEST_MULTIPLAYER_API_H
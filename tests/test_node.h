@@ -0,0 +1,214 @@
+/*************************************************************************/
+/*  test_node.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_H
+#define TEST_NODE_H
+
+#include "core/job_system.h"
+#include "core/os/thread.h"
+#include "scene/main/node.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+#include <atomic>
+
+namespace TestNode {
+
+TEST_CASE("[Node] Process flags follow their groups") {
+	Node *node = memnew(Node);
+
+	node->set_process(true);
+	node->set_physics_process_internal(true);
+	CHECK(node->is_processing());
+	CHECK(node->is_in_group("idle_process"));
+	CHECK(node->is_physics_processing_internal());
+	CHECK(node->is_in_group("physics_process_internal"));
+
+	node->set_process(false);
+	CHECK(!node->is_processing());
+	CHECK(!node->is_in_group("idle_process"));
+	CHECK(node->is_in_group("physics_process_internal"));
+
+	node->set_physics_process_internal(false);
+	CHECK(!node->is_in_group("physics_process_internal"));
+
+	memdelete(node);
+}
+
+TEST_CASE("[Node] Process thread group") {
+	Node *parent = memnew(Node);
+	Node *child = memnew(Node);
+	parent->add_child(child);
+
+	CHECK(child->get_process_thread_group() == Node::PROCESS_THREAD_GROUP_INHERIT);
+	parent->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	CHECK(parent->get_process_thread_group() == Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+
+	// Groups are only formed inside the tree.
+	CHECK(parent->get_process_thread_group_owner() == nullptr);
+	CHECK(child->get_process_thread_group_owner() == nullptr);
+
+	memdelete(parent);
+}
+
+// Records when and where it was processed, and can change the tree from there.
+class ProcessRecorder : public Node {
+	GDCLASS(ProcessRecorder, Node);
+
+public:
+	std::atomic<int> *sequence = nullptr;
+	int order = -1;
+	Thread::ID thread = 0;
+
+	Node *add_to_parent = nullptr;
+	bool add_refused = false;
+	bool free_self = false;
+
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PROCESS) {
+			return;
+		}
+		order = (*sequence)++;
+		thread = Thread::get_caller_id();
+
+		if (add_to_parent) {
+			get_parent()->add_child(add_to_parent);
+			add_refused = add_to_parent->get_parent() == nullptr;
+			get_parent()->call_deferred("add_child", add_to_parent);
+			add_to_parent = nullptr;
+		}
+		if (free_self) {
+			queue_delete();
+		}
+	}
+
+	ProcessRecorder(std::atomic<int> *p_sequence, int p_priority) {
+		sequence = p_sequence;
+		set_process_priority(p_priority);
+		set_process(true);
+	}
+};
+
+// Thread groups are only used with worker threads, start some if the engine has none.
+struct ThreadGroupScope {
+	bool started = false;
+
+	ThreadGroupScope() {
+		if (JobSystem::get_singleton()->get_thread_count() == 0) {
+			JobSystem::get_singleton()->init(2);
+			started = true;
+		}
+	}
+
+	~ThreadGroupScope() {
+		if (started) {
+			JobSystem::get_singleton()->finish();
+		}
+	}
+};
+
+TEST_CASE("[SceneTree][Node] Sub-thread groups are processed after the main thread") {
+	ThreadGroupScope scope;
+	std::atomic<int> sequence;
+	sequence.store(0);
+
+	Node *root = memnew(Node);
+	ProcessRecorder *main = memnew(ProcessRecorder(&sequence, 0));
+	root->add_child(main);
+
+	Node *group_a = memnew(Node);
+	group_a->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	ProcessRecorder *a_late = memnew(ProcessRecorder(&sequence, 2));
+	ProcessRecorder *a_early = memnew(ProcessRecorder(&sequence, 1));
+	group_a->add_child(a_late);
+	group_a->add_child(a_early);
+	root->add_child(group_a);
+
+	Node *group_b = memnew(Node);
+	group_b->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	ProcessRecorder *b = memnew(ProcessRecorder(&sequence, -1));
+	group_b->add_child(b);
+	root->add_child(group_b);
+
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	CHECK(a_early->get_process_thread_group_owner() == group_a);
+	CHECK(b->get_process_thread_group_owner() == group_b);
+	CHECK(main->get_process_thread_group_owner() == nullptr);
+
+	SceneTree::get_singleton()->idle(0.016);
+
+	CHECK(main->thread == Thread::get_caller_id());
+	CHECK(main->order >= 0);
+	CHECK(a_early->order >= 0);
+	CHECK(a_late->order >= 0);
+	CHECK_MESSAGE(main->order < b->order, "Groups should run after the main thread nodes, whatever their priority.");
+	CHECK_MESSAGE(a_early->order < a_late->order, "Nodes in a group should keep their priority order.");
+	CHECK_MESSAGE(a_early->thread == a_late->thread, "A group should run on a single thread.");
+
+	memdelete(root);
+}
+
+TEST_CASE("[SceneTree][Node] Scene changes from sub-thread groups") {
+	ThreadGroupScope scope;
+	std::atomic<int> sequence;
+	sequence.store(0);
+
+	Node *group = memnew(Node);
+	group->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	ProcessRecorder *adder = memnew(ProcessRecorder(&sequence, 0));
+	ProcessRecorder *freed = memnew(ProcessRecorder(&sequence, 0));
+	group->add_child(adder);
+	group->add_child(freed);
+	SceneTree::get_singleton()->get_root()->add_child(group);
+
+	Node *added = memnew(Node);
+	adder->add_to_parent = added;
+	freed->free_self = true;
+	const ObjectID freed_id = freed->get_instance_id();
+
+	// Adding right away is refused with an error, but the deferred call goes through.
+	ERR_PRINT_OFF;
+	SceneTree::get_singleton()->idle(0.016);
+	ERR_PRINT_ON;
+
+	CHECK(adder->add_refused);
+	CHECK(added->get_parent() == group);
+	CHECK(added->get_process_thread_group_owner() == group);
+	CHECK_MESSAGE(ObjectDB::get_instance(freed_id) == nullptr, "queue_delete() should work from a group.");
+	CHECK(group->get_child_count() == 2);
+
+	memdelete(group);
+}
+
+} // namespace TestNode
+
+#endif // TEST_NODE_H
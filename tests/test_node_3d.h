@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  test_node_3d.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_3D_H
+#define TEST_NODE_3D_H
+
+#include "scene/3d/node_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode3D {
+
+// Counts the transform notifications it receives.
+class TransformWatcher : public Node3D {
+	GDCLASS(TransformWatcher, Node3D);
+
+public:
+	int transform_changes = 0;
+
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			transform_changes++;
+		}
+	}
+
+	TransformWatcher() {
+		set_notify_transform(true);
+	}
+};
+
+TEST_CASE("[SceneTree][Node3D] Children follow their parent before and after the flush") {
+	SceneTree *tree = SceneTree::get_singleton();
+
+	Node3D *parent = memnew(Node3D);
+	TransformWatcher *child = memnew(TransformWatcher);
+	child->set_translation(Vector3(0, 1, 0));
+	Node3D *grandchild = memnew(Node3D);
+	grandchild->set_translation(Vector3(0, 0, 1));
+	parent->add_child(child);
+	child->add_child(grandchild);
+	tree->get_root()->add_child(parent);
+	tree->flush_transform_notifications();
+	child->transform_changes = 0;
+
+	parent->set_translation(Vector3(2, 0, 0));
+	// Children are updated on demand before the flush.
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(2, 1, 0)));
+	CHECK(grandchild->get_global_transform().origin.is_equal_approx(Vector3(2, 1, 1)));
+	CHECK(child->transform_changes == 0);
+
+	tree->flush_transform_notifications();
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(2, 1, 0)));
+	CHECK(grandchild->get_global_transform().origin.is_equal_approx(Vector3(2, 1, 1)));
+	CHECK(child->transform_changes == 1);
+
+	// Several pending parents, read from the deepest node first.
+	child->set_translation(Vector3(0, 3, 0));
+	parent->set_rotation(Vector3(0, Math_PI / 2, 0));
+	parent->set_translation(Vector3(-1, 0, 0));
+	CHECK(grandchild->get_global_transform().origin.is_equal_approx(Vector3(0, 3, 0)));
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(-1, 3, 0)));
+	CHECK(child->get_global_transform().basis.is_equal_approx(Basis(Vector3(0, 1, 0), Math_PI / 2)));
+
+	tree->flush_transform_notifications();
+	CHECK(grandchild->get_global_transform().origin.is_equal_approx(Vector3(0, 3, 0)));
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(-1, 3, 0)));
+	CHECK(child->transform_changes == 2);
+
+	// Top level nodes don't follow their parent.
+	grandchild->set_as_top_level(true);
+	const Transform top_level_transform = grandchild->get_global_transform();
+	parent->set_translation(Vector3(5, 0, 0));
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(5, 3, 0)));
+	CHECK(grandchild->get_global_transform().is_equal_approx(top_level_transform));
+	tree->flush_transform_notifications();
+	CHECK(grandchild->get_global_transform().is_equal_approx(top_level_transform));
+
+	memdelete(parent);
+}
+
+} // namespace TestNode3D
+
+#endif // TEST_NODE_3D_H
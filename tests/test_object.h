@@ -0,0 +1,201 @@
+/*************************************************************************/
+/*  test_object.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OBJECT_H
+#define TEST_OBJECT_H
+
+#include "core/callable_method_pointer.h"
+#include "core/object.h"
+
+#include "tests/test_macros.h"
+
+namespace TestObject {
+
+class SignalReceiver : public Object {
+public:
+	Object *emitter = nullptr;
+	SignalReceiver *other = nullptr;
+	int calls = 0;
+	int last_value = 0;
+	int last_bind = 0;
+
+	void on_signal(int p_value) {
+		calls++;
+		last_value = p_value;
+	}
+
+	void on_signal_bound(int p_value, int p_bind) {
+		calls++;
+		last_value = p_value;
+		last_bind = p_bind;
+	}
+
+	void on_signal_disconnect_other(int p_value) {
+		calls++;
+		emitter->disconnect("test_signal", callable_mp(other, &SignalReceiver::on_signal_disconnect_other));
+	}
+
+	void on_signal_connect_other(int p_value) {
+		calls++;
+		if (!emitter->is_connected("test_signal", callable_mp(other, &SignalReceiver::on_signal))) {
+			emitter->connect("test_signal", callable_mp(other, &SignalReceiver::on_signal));
+		}
+	}
+};
+
+// Refuses to be freed while keep_alive is set.
+class FreeCanceller : public Object {
+	GDCLASS(FreeCanceller, Object);
+
+public:
+	bool keep_alive = false;
+
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PREDELETE && keep_alive) {
+			cancel_free();
+		}
+	}
+};
+
+static Object *create_emitter() {
+	Object *emitter = memnew(Object);
+	emitter->add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::INT, "value")));
+	return emitter;
+}
+
+TEST_CASE("[Object] Signal binds are appended to the arguments") {
+	Object *emitter = create_emitter();
+	SignalReceiver receiver;
+	Vector<Variant> binds;
+	binds.push_back(7);
+	emitter->connect("test_signal", callable_mp(&receiver, &SignalReceiver::on_signal_bound), binds);
+
+	emitter->emit_signal("test_signal", 3);
+	CHECK(receiver.calls == 1);
+	CHECK(receiver.last_value == 3);
+	CHECK(receiver.last_bind == 7);
+
+	memdelete(emitter);
+}
+
+TEST_CASE("[Object] Disconnecting during emission") {
+	Object *emitter = create_emitter();
+	SignalReceiver a;
+	SignalReceiver b;
+	a.emitter = emitter;
+	a.other = &b;
+	b.emitter = emitter;
+	b.other = &a;
+	emitter->connect("test_signal", callable_mp(&a, &SignalReceiver::on_signal_disconnect_other));
+	emitter->connect("test_signal", callable_mp(&b, &SignalReceiver::on_signal_disconnect_other));
+
+	// Whichever is called first disconnects the other, which must not be called anymore.
+	emitter->emit_signal("test_signal", 1);
+	CHECK(a.calls + b.calls == 1);
+
+	List<Object::Connection> connections;
+	emitter->get_signal_connection_list("test_signal", &connections);
+	CHECK(connections.size() == 1);
+
+	memdelete(emitter);
+}
+
+TEST_CASE("[Object] Connecting during emission") {
+	Object *emitter = create_emitter();
+	SignalReceiver a;
+	SignalReceiver b;
+	a.emitter = emitter;
+	a.other = &b;
+	emitter->connect("test_signal", callable_mp(&a, &SignalReceiver::on_signal_connect_other));
+
+	// The new connection is only called from the next emission.
+	emitter->emit_signal("test_signal", 1);
+	CHECK(a.calls == 1);
+	CHECK(b.calls == 0);
+	CHECK(emitter->is_connected("test_signal", callable_mp(&b, &SignalReceiver::on_signal)));
+
+	emitter->emit_signal("test_signal", 2);
+	CHECK(a.calls == 2);
+	CHECK(b.calls == 1);
+	CHECK(b.last_value == 2);
+
+	memdelete(emitter);
+}
+
+TEST_CASE("[Object] One shot connections") {
+	Object *emitter = create_emitter();
+	SignalReceiver receiver;
+	emitter->connect("test_signal", callable_mp(&receiver, &SignalReceiver::on_signal), Vector<Variant>(), Object::CONNECT_ONESHOT);
+
+	emitter->emit_signal("test_signal", 1);
+	emitter->emit_signal("test_signal", 2);
+	CHECK(receiver.calls == 1);
+	CHECK(receiver.last_value == 1);
+	CHECK(!emitter->is_connected("test_signal", callable_mp(&receiver, &SignalReceiver::on_signal)));
+
+	memdelete(emitter);
+}
+
+TEST_CASE("[Object] Signal profiling") {
+	Object *emitter = create_emitter();
+	SignalReceiver receiver;
+	emitter->connect("test_signal", callable_mp(&receiver, &SignalReceiver::on_signal));
+
+	Object::signal_profiling_start();
+	for (int i = 0; i < 5; i++) {
+		emitter->emit_signal("test_signal", i);
+	}
+	List<Object::SignalProfilingInfo> info;
+	Object::signal_profiling_get_frame_data(&info);
+	Object::signal_profiling_stop();
+
+	REQUIRE(info.size() == 1);
+	CHECK(info.front()->get().signal == StringName("test_signal"));
+	CHECK(info.front()->get().emit_count == 5);
+
+	memdelete(emitter);
+}
+
+TEST_CASE("[Object] Cancelling free") {
+	FreeCanceller *object = memnew(FreeCanceller);
+	ObjectID id = object->get_instance_id();
+
+	object->keep_alive = true;
+	memdelete(object);
+	CHECK(ObjectDB::get_instance(id) == object);
+
+	object->keep_alive = false;
+	memdelete(object);
+	CHECK(ObjectDB::get_instance(id) == nullptr);
+}
+
+} // namespace TestObject
+
+#endif // TEST_OBJECT_H
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  test_physics_2d_sw.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_2D_SW_H
+#define TEST_PHYSICS_2D_SW_H
+
+#include "servers/physics_2d/physics_server_2d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysics2DSW {
+
+struct World {
+	PhysicsServer2DSW *server = nullptr;
+	RID space;
+	LocalVector<RID> rids;
+
+	RID add_body(PhysicsServer2D::BodyMode p_mode, RID p_shape, const Vector2 &p_position) {
+		RID body = server->body_create();
+		server->body_set_mode(body, p_mode);
+		server->body_set_space(body, space);
+		server->body_add_shape(body, p_shape);
+		server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, p_position));
+		rids.push_back(body);
+		return body;
+	}
+
+	RID add_rectangle(const Vector2 &p_half_extents) {
+		RID shape = server->rectangle_shape_create();
+		server->shape_set_data(shape, p_half_extents);
+		rids.push_back(shape);
+		return shape;
+	}
+
+	Vector2 get_position(RID p_body) {
+		return Transform2D(server->body_get_state(p_body, PhysicsServer2D::BODY_STATE_TRANSFORM)).get_origin();
+	}
+
+	void simulate(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			server->step(1.0 / 60.0);
+		}
+	}
+
+	World() {
+		server = memnew(PhysicsServer2DSW);
+		server->init();
+		space = server->space_create();
+		server->space_set_active(space, true);
+		server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 98);
+		server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	}
+
+	~World() {
+		// Bodies before their shapes.
+		for (int i = int(rids.size()) - 1; i >= 0; i--) {
+			server->free(rids[i]);
+		}
+		server->free(space);
+		server->finish();
+		memdelete(server);
+	}
+};
+
+TEST_CASE("[Physics2DSW] One way platforms") {
+	World world;
+	RID platform_shape = world.add_rectangle(Vector2(200, 5));
+	RID platform = world.add_body(PhysicsServer2D::BODY_MODE_STATIC, platform_shape, Vector2());
+	world.server->body_set_shape_as_one_way_collision(platform, 0, true, 1);
+
+	RID box_shape = world.add_rectangle(Vector2(10, 10));
+
+	// Bodies falling on the platform land on it, including a stack whose
+	// lower body is pushed by the upper one while it touches the platform.
+	RID falling = world.add_body(PhysicsServer2D::BODY_MODE_RIGID, box_shape, Vector2(-100, -40));
+	RID stack_bottom = world.add_body(PhysicsServer2D::BODY_MODE_RIGID, box_shape, Vector2(100, -40));
+	RID stack_top = world.add_body(PhysicsServer2D::BODY_MODE_RIGID, box_shape, Vector2(100, -61));
+	world.server->body_set_state(stack_top, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(0, 200));
+
+	// Bodies coming from below go through.
+	RID rising = world.add_body(PhysicsServer2D::BODY_MODE_RIGID, box_shape, Vector2(0, 40));
+	world.server->body_set_state(rising, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(0, -300));
+
+	world.simulate(120);
+
+	CHECK_MESSAGE(world.get_position(falling).y < -5, "A body falling on a one way platform should land on it.");
+	CHECK_MESSAGE(world.get_position(stack_bottom).y < -5, "A stack falling on a one way platform should land on it.");
+	CHECK_MESSAGE(world.get_position(stack_top).y < world.get_position(stack_bottom).y, "The stack should stay stacked.");
+	CHECK_MESSAGE(world.get_position(rising).y < -20, "A body moving up should go through a one way platform.");
+}
+
+} // namespace TestPhysics2DSW
+
+#endif // TEST_PHYSICS_2D_SW_H
@@ -0,0 +1,229 @@
+/*************************************************************************/
+/*  test_resource_loader.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_LOADER_H
+#define TEST_RESOURCE_LOADER_H
+
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+#include <atomic>
+
+namespace TestResourceLoader {
+
+// Each load waits until `wanted` loads run at the same time, or gives up after
+// a while, and records how many ran in parallel at most.
+class ConcurrentLoader : public ResourceFormatLoader {
+public:
+	std::atomic<int> running;
+	std::atomic<int> max_running;
+	std::atomic<int> wanted;
+
+	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, bool p_no_cache = false) override {
+		int now = ++running;
+		int highest = max_running.load();
+		while (now > highest && !max_running.compare_exchange_weak(highest, now)) {
+		}
+
+		uint64_t start = OS::get_singleton()->get_ticks_msec();
+		while (max_running.load() < wanted.load() && OS::get_singleton()->get_ticks_msec() - start < 2000) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+		running--;
+
+		if (r_error) {
+			*r_error = OK;
+		}
+		Ref<Resource> resource;
+		resource.instance();
+		return resource;
+	}
+
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {
+		p_extensions->push_back("concurrenttest");
+	}
+
+	virtual bool handles_type(const String &p_type) const override {
+		return p_type == "Resource";
+	}
+
+	virtual String get_resource_type(const String &p_path) const override {
+		return p_path.get_extension() == "concurrenttest" ? "Resource" : "";
+	}
+
+	ConcurrentLoader() {
+		running = 0;
+		max_running = 0;
+		wanted = 1;
+	}
+};
+
+TEST_CASE("[ResourceLoader] Threaded requests load in parallel") {
+	Ref<ConcurrentLoader> loader;
+	loader.instance();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	// A finished load leaves an idle worker behind. Requests coming in at once
+	// must not all count on that single worker.
+	CHECK(ResourceLoader::load_threaded_request("res://warmup.concurrenttest") == OK);
+	CHECK(ResourceLoader::load_threaded_get("res://warmup.concurrenttest").is_valid());
+
+	// The pool grows up to one worker per processor.
+	const int wanted = MIN(OS::get_singleton()->get_processor_count(), 4);
+	loader->max_running = 0;
+	loader->wanted = wanted;
+	for (int i = 0; i < wanted; i++) {
+		CHECK(ResourceLoader::load_threaded_request("res://parallel_" + itos(i) + ".concurrenttest") == OK);
+	}
+	for (int i = 0; i < wanted; i++) {
+		CHECK(ResourceLoader::load_threaded_get("res://parallel_" + itos(i) + ".concurrenttest").is_valid());
+	}
+	CHECK_MESSAGE(loader->max_running.load() == wanted, "Requests should have been loaded in parallel.");
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+TEST_CASE("[ResourceLoader] Threaded requests beyond the worker count") {
+	Ref<ConcurrentLoader> loader;
+	loader.instance();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	// Queued requests are picked up by workers as they become free.
+	const int count = OS::get_singleton()->get_processor_count() * 4;
+	for (int i = 0; i < count; i++) {
+		CHECK(ResourceLoader::load_threaded_request("res://queued_" + itos(i) + ".concurrenttest") == OK);
+	}
+	for (int i = count - 1; i >= 0; i--) {
+		CHECK(ResourceLoader::load_threaded_get("res://queued_" + itos(i) + ".concurrenttest").is_valid());
+	}
+	CHECK(loader->max_running.load() <= OS::get_singleton()->get_processor_count());
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+// Saves a main resource referencing sub-resources 1 and 4, where 1 and 2 point
+// at each other and 1 also points at 3.
+static String save_sub_resource_graph(const String &p_name) {
+	Ref<Resource> sub[4];
+	for (int i = 0; i < 4; i++) {
+		sub[i].instance();
+		sub[i]->set_subindex(i + 1);
+		sub[i]->set_name("sub" + itos(i + 1));
+	}
+	sub[0]->set_meta("peer", sub[1]);
+	sub[1]->set_meta("peer", sub[0]);
+	sub[0]->set_meta("leaf", sub[2]);
+
+	Ref<Resource> main;
+	main.instance();
+	main->set_meta("first", sub[0]);
+	main->set_meta("unrelated", sub[3]);
+
+	String path = OS::get_singleton()->get_cache_path().plus_file(p_name);
+	CHECK(ResourceSaver::save(path, main) == OK);
+
+	// Break the cycle so the saved graph gets freed.
+	sub[0]->remove_meta("peer");
+	return path;
+}
+
+// Breaks the cycle in a loaded graph.
+static void free_sub_resource_graph(const Ref<Resource> &p_first) {
+	Ref<Resource> peer = p_first->get_meta("peer");
+	peer->remove_meta("peer");
+}
+
+TEST_CASE("[ResourceLoader] Sub-resource loads parse only what they reference") {
+	const String path = save_sub_resource_graph("sub_resource_test.res");
+
+	Ref<Resource> first = ResourceLoader::load(path + "::1");
+	REQUIRE(first.is_valid());
+	CHECK(first->get_name() == "sub1");
+	CHECK(first->get_path().ends_with("::1"));
+
+	// Cached under the file path as the loader saw it.
+	const String local_path = first->get_path().get_slice("::", 0);
+
+	Ref<Resource> peer = first->get_meta("peer");
+	REQUIRE(peer.is_valid());
+	CHECK(peer->get_name() == "sub2");
+	CHECK_MESSAGE(Ref<Resource>(peer->get_meta("peer")) == first, "The cycle should resolve to the resource being loaded.");
+
+	Ref<Resource> leaf = first->get_meta("leaf");
+	REQUIRE(leaf.is_valid());
+	CHECK(leaf->get_name() == "sub3");
+
+	CHECK(ResourceCache::has(local_path + "::2"));
+	CHECK(ResourceCache::has(local_path + "::3"));
+	CHECK_MESSAGE(!ResourceCache::has(local_path + "::4"), "Unreferenced sub-resources should not be parsed.");
+	CHECK(!ResourceCache::has(local_path));
+
+	// A later full load reuses the sub-resources that are already loaded.
+	Ref<Resource> main = ResourceLoader::load(path);
+	REQUIRE(main.is_valid());
+	CHECK(Ref<Resource>(main->get_meta("first")) == first);
+	CHECK(Ref<Resource>(first->get_meta("peer")) == peer);
+	Ref<Resource> unrelated = main->get_meta("unrelated");
+	REQUIRE(unrelated.is_valid());
+	CHECK(unrelated->get_name() == "sub4");
+
+	// And so does loading a sub-resource again.
+	CHECK(ResourceLoader::load(path + "::2") == peer);
+
+	free_sub_resource_graph(first);
+	DirAccess::remove_file_or_error(path);
+}
+
+TEST_CASE("[ResourceLoader] Threaded sub-resource requests") {
+	const String path = save_sub_resource_graph("sub_resource_threaded_test.res");
+
+	CHECK(ResourceLoader::load_threaded_request(path + "::2") == OK);
+	Error err = FAILED;
+	Ref<Resource> second = ResourceLoader::load_threaded_get(path + "::2", &err);
+	CHECK(err == OK);
+	REQUIRE(second.is_valid());
+	CHECK(second->get_name() == "sub2");
+
+	Ref<Resource> first = second->get_meta("peer");
+	REQUIRE(first.is_valid());
+	CHECK(first->get_name() == "sub1");
+	CHECK(Ref<Resource>(first->get_meta("peer")) == second);
+
+	free_sub_resource_graph(first);
+	DirAccess::remove_file_or_error(path);
+}
+
+} // namespace TestResourceLoader
+
+#endif // TEST_RESOURCE_LOADER_H
@@ -0,0 +1,158 @@
+/*************************************************************************/
+/*  test_skeleton_3d.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SKELETON_3D_H
+#define TEST_SKELETON_3D_H
+
+#include "core/message_queue.h"
+#include "scene/3d/skeleton_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSkeleton3D {
+
+// Changes a bone of another skeleton when the bone it is bound to is applied.
+class BonePoseSetter : public Node3D {
+	GDCLASS(BonePoseSetter, Node3D);
+
+public:
+	Skeleton3D *target = nullptr;
+	Transform pose;
+	bool read_back = false;
+	Transform read_pose;
+
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_LOCAL_TRANSFORM_CHANGED && target) {
+			target->set_bone_custom_pose(0, pose);
+			if (read_back) {
+				read_pose = target->get_bone_global_pose(1);
+			}
+			target = nullptr;
+		}
+	}
+};
+
+static Skeleton3D *create_skeleton() {
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	skeleton->add_bone("root");
+	skeleton->add_bone("child");
+	skeleton->set_bone_parent(1, 0);
+	skeleton->set_bone_rest(1, Transform(Basis(), Vector3(0, 1, 0)));
+	return skeleton;
+}
+
+TEST_CASE("[Skeleton3D] Global poses follow bone changes") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Skeleton3D *skeleton = create_skeleton();
+
+	const Transform custom_pose(Basis(Vector3(0, 0, 1), Math_PI / 2), Vector3(2, 0, 0));
+	skeleton->set_bone_custom_pose(0, custom_pose);
+	CHECK(skeleton->get_bone_global_pose(0).is_equal_approx(custom_pose));
+	CHECK(skeleton->get_bone_global_pose(1).is_equal_approx(custom_pose * Transform(Basis(), Vector3(0, 1, 0))));
+
+	// Changing the parent again after an update recomputes its subtree.
+	skeleton->set_bone_custom_pose(0, Transform());
+	CHECK(skeleton->get_bone_global_pose(1).is_equal_approx(Transform(Basis(), Vector3(0, 1, 0))));
+
+	message_queue->flush();
+	memdelete(skeleton);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[Skeleton3D] Bones changed while other skeletons apply their poses") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Skeleton3D *first = create_skeleton();
+	Skeleton3D *second = create_skeleton();
+
+	BonePoseSetter *setter = memnew(BonePoseSetter);
+	setter->set_notify_local_transform(true);
+	first->add_child(setter);
+	first->bind_child_node_to_bone(0, setter);
+
+	// Both are updated together, the second one after the first applied its poses.
+	first->set_bone_custom_pose(0, Transform());
+	second->set_bone_custom_pose(0, Transform());
+
+	const Transform pose(Basis(), Vector3(0, 0, 3));
+	setter->target = second;
+	setter->pose = pose;
+
+	message_queue->flush();
+	CHECK_MESSAGE(!setter->target, "The bound node should have been updated.");
+	CHECK_MESSAGE(second->get_bone_global_pose(0).is_equal_approx(pose), "The change should not be lost.");
+	CHECK(second->get_bone_global_pose(1).is_equal_approx(pose * Transform(Basis(), Vector3(0, 1, 0))));
+
+	message_queue->flush();
+	memdelete(first);
+	memdelete(second);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[Skeleton3D] Poses read right after changing bones while other skeletons apply theirs") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	Skeleton3D *first = create_skeleton();
+	Skeleton3D *second = create_skeleton();
+
+	BonePoseSetter *setter = memnew(BonePoseSetter);
+	setter->set_notify_local_transform(true);
+	first->add_child(setter);
+	first->bind_child_node_to_bone(0, setter);
+
+	first->set_bone_custom_pose(0, Transform());
+	second->set_bone_custom_pose(0, Transform());
+	message_queue->flush();
+
+	// Only the child of the second one is up for an update when the setter changes its root.
+	first->set_bone_custom_pose(0, Transform(Basis(), Vector3(1, 0, 0)));
+	second->set_bone_custom_pose(1, Transform());
+
+	const Transform pose(Basis(), Vector3(0, 0, 3));
+	setter->target = second;
+	setter->pose = pose;
+	setter->read_back = true;
+
+	message_queue->flush();
+	CHECK_MESSAGE(!setter->target, "The bound node should have been updated.");
+	CHECK_MESSAGE(setter->read_pose.is_equal_approx(pose * Transform(Basis(), Vector3(0, 1, 0))), "The pose read should include the change.");
+	CHECK(second->get_bone_global_pose(0).is_equal_approx(pose));
+
+	// Later changes are still picked up.
+	second->set_bone_custom_pose(0, Transform());
+	CHECK(second->get_bone_global_pose(1).is_equal_approx(Transform(Basis(), Vector3(0, 1, 0))));
+
+	message_queue->flush();
+	memdelete(first);
+	memdelete(second);
+	memdelete(message_queue);
+}
+
+} // namespace TestSkeleton3D
+
+#endif // TEST_SKELETON_3D_H
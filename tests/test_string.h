@@ -38,6 +38,7 @@
 #include "core/io/ip_address.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
+#include "core/string_name.h"
 #include "core/ustring.h"
 
 #ifdef MODULE_REGEX_ENABLED
@@ -1297,6 +1298,33 @@ TEST_CASE("[String] humanize_size") {
 	CHECK(String::humanize_size(5345555000) == "4.97 GiB");
 }
 
+TEST_CASE("[StringName] Interning") {
+	StringName::TableStats before = StringName::get_table_stats();
+
+	// Enough names to make the shards grow.
+	Vector<StringName> names;
+	for (int i = 0; i < 20000; i++) {
+		names.push_back("test_string_name_" + itos(i));
+	}
+	StringName::TableStats grown = StringName::get_table_stats();
+	CHECK(grown.names >= before.names + 20000);
+	CHECK(grown.capacity > grown.names);
+
+	for (int i = 0; i < 20000; i += 97) {
+		String s = "test_string_name_" + itos(i);
+		CHECK(StringName(s) == names[i]);
+		CHECK(StringName::search(s) == names[i]);
+		CHECK(String(names[i]) == s);
+	}
+	// Static and dynamic names with the same text are the same name.
+	CHECK(StringName(StaticCString::create("test_string_name_5")) == names[5]);
+	CHECK(StringName::search(U"test_string_name_5") == names[5]);
+
+	names.clear();
+	CHECK(StringName::search("test_string_name_5") == StringName());
+	CHECK(StringName::get_table_stats().names == before.names);
+}
+
 } // namespace TestString
 
 #endif // TEST_STRING_H